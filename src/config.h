@@ -60,6 +60,44 @@
 #define GLIMMER_MAX_ITEMGRID_COLUMN_CATEGORY_LEVEL 4
 #endif
 
+#ifndef GLIMMER_ITEMGRID_ROW_OVERSCAN
+#define GLIMMER_ITEMGRID_ROW_OVERSCAN 2
+#endif
+
+// Rows processed by a single worker task while sorting/filtering item grid rows in background
+#ifndef GLIMMER_ITEMGRID_SORT_CHUNK_SIZE
+#define GLIMMER_ITEMGRID_SORT_CHUNK_SIZE 16384
+#endif
+
+// Rows per page requested from item grid data sources, number of pages kept in cache
+// and pages fetched ahead in scroll direction
+#ifndef GLIMMER_ITEMGRID_PAGE_SIZE
+#define GLIMMER_ITEMGRID_PAGE_SIZE 128
+#endif
+
+#ifndef GLIMMER_ITEMGRID_MAX_CACHED_PAGES
+#define GLIMMER_ITEMGRID_MAX_CACHED_PAGES 64
+#endif
+
+#ifndef GLIMMER_ITEMGRID_PREFETCH_PAGES
+#define GLIMMER_ITEMGRID_PREFETCH_PAGES 2
+#endif
+
+// Minimum size of gap in text editor's buffer, larger gaps need fewer reallocations when typing
+#ifndef GLIMMER_TEXT_EDITOR_GAP_SIZE
+#define GLIMMER_TEXT_EDITOR_GAP_SIZE 4096
+#endif
+
+// Memory budget in bytes for undo history of each text input/editor, oldest edits are dropped beyond it
+#ifndef GLIMMER_TEXT_UNDO_CAPACITY
+#define GLIMMER_TEXT_UNDO_CAPACITY 16384
+#endif
+
+// Consecutive keystrokes within this interval (in seconds) are undone together
+#ifndef GLIMMER_TEXT_UNDO_MERGE_INTERVAL
+#define GLIMMER_TEXT_UNDO_MERGE_INTERVAL 1.f
+#endif
+
 #ifndef GLIMMER_MAX_LAYOUT_NESTING 
 #define GLIMMER_MAX_LAYOUT_NESTING 8
 #endif
@@ -72,10 +110,25 @@
 #define GLIMMER_MAX_OVERLAYS 32
 #endif
 
+// Number of background worker threads used for layout/sort jobs, 0 implies hardware concurrency - 1
+#ifndef GLIMMER_MAX_WORKER_THREADS
+#define GLIMMER_MAX_WORKER_THREADS 0
+#endif
+
 #ifndef GLIMMER_GLOBAL_ANIMATION_FRAMETIME
 #define GLIMMER_GLOBAL_ANIMATION_FRAMETIME 18
 #endif
 
+// Frames rendered after input in event-driven mode, so that widgets reflect the new state
+#ifndef GLIMMER_EVENT_SETTLE_FRAMES
+#define GLIMMER_EVENT_SETTLE_FRAMES 3
+#endif
+
+// Ranges of deferred events smaller than this are hit-tested linearly rather than through the hit grid
+#ifndef GLIMMER_EVENT_GRID_MIN_EVENTS
+#define GLIMMER_EVENT_GRID_MIN_EVENTS 16
+#endif
+
 #ifndef GLIMMER_NKEY_ROLLOVER_MAX
 #define GLIMMER_NKEY_ROLLOVER_MAX 8
 #endif
@@ -95,7 +148,7 @@
 
 #ifndef GLIMMER_FLEXBOX_ENGINE
 #define GLIMMER_FLEXBOX_ENGINE GLIMMER_YOGA_ENGINE
-#elif GLIMMER_FLEXBOX_ENGINE != GLIMMER_YOGA_ENGINE
+#elif GLIMMER_FLEXBOX_ENGINE != GLIMMER_YOGA_ENGINE && GLIMMER_FLEXBOX_ENGINE != GLIMMER_FLAT_ENGINE
 #error "Other layout enfines haven'tbeen tested throroughly..."
 #endif
 
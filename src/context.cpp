@@ -4,7 +4,15 @@
 #include "style.h"
 #include "widgets.h"
 #include "libs/inc/implot/implot.h"
+#ifndef GLIMMER_DISABLE_RICHTEXT
+#include "imrichtext.h"
+#endif
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
 #include <list>
+#include <numeric>
 
 #include "draw.h"
 
@@ -37,6 +45,8 @@ namespace glimmer
         WidgetDrawResult& result);
     void HandleTextInputEvent(int32_t id, const ImRect& content, const ImRect& clear, const IODescriptor& io,
         IRenderer& renderer, WidgetDrawResult& result);
+    void HandleTextEditorEvent(int32_t id, const ImRect& content, const IODescriptor& io,
+        IRenderer& renderer, WidgetDrawResult& result);
     void HandleDropDownEvent(int32_t id, const ImRect& margin, const ImRect& border, const ImRect& padding,
         const ImRect& content, const IODescriptor& io, IRenderer& renderer, WidgetDrawResult& result);
     void HandleSpinnerEvent(int32_t id, const ImRect& extent, const ImRect& incbtn, const ImRect& decbtn, const IODescriptor& io,
@@ -47,59 +57,1261 @@ namespace glimmer
     void HandleAccordionEvent(int32_t id, const ImRect& region, int ridx, const IODescriptor& io, WidgetDrawResult& result);
     void HandleMediaResourceEvent(int32_t id, const ImRect& padding, const ImRect& content, const IODescriptor& io, WidgetDrawResult& result);
 
-    void LayoutBuilder::reset()
+    void LayoutBuilder::reset()
+    {
+        type = Layout::Invalid;
+        id = 0;
+        fill = FD_None;
+        alignment = TextAlignLeading;
+        from = -1, to = -1, itemidx = -1;
+        currow = -1, currcol = -1;
+        geometry = ImRect{ { FIT_SZ, FIT_SZ },{ FIT_SZ, FIT_SZ } };
+        available = ImRect{ };
+        nextpos = ImVec2{ 0.f, 0.f };
+        prevpos = ImVec2{ 0.f, 0.f };
+        spacing = ImVec2{ 0.f, 0.f };
+        maxdim = ImVec2{ 0.f, 0.f };
+        startpos = ImVec2{ 0.f, 0.f };
+        cumulative = ImVec2{ 0.f, 0.f };
+        size = ImVec2{ 0.f, 0.f };
+        hofmode = OverflowMode::Scroll;
+        vofmode = OverflowMode::Scroll;
+        scroll = ScrollableRegion{};
+        tabbar.reset();
+        popSizingOnEnd = false;
+        fingerprint = 0;
+        currspan.first = currspan.second = 1;
+
+        for (auto idx = 0; idx < WSI_Total; ++idx)
+        {
+            styleStartIdx[idx] = -1;
+        }
+
+        itemIndexes.clear(true);
+        griditems.clear(true);
+        containerStack.clear(true);
+        rows.clear(true);
+        cols.clear(true);
+        rowTracks.clear(true);
+        colTracks.clear(true);
+    }
+
+    void TabBarBuilder::reset()
+    {
+        id = -1;
+        geometry = 0;
+        sizing = TabBarItemSizing::ResizeToFit;
+        neighbors = NeighborWidgets{};
+        items.clear(true);
+        newTabButton = false;
+    }
+
+    void NavDrawerBuilder::reset()
+    {
+        geometry = 0;
+        neighbors = NeighborWidgets{};
+        items.clear(true);
+    }
+
+    void ItemGridPersistentState::RowHeightIndex::resize(int32_t count, bool uniformHeights)
+    {
+        if (count == rows && uniformHeights == uniform) return;
+
+        rows = count;
+        uniform = uniformHeights;
+        heights.clear(false); sums.clear(false); counts.clear(false);
+        total = 0.f; measured = 0;
+        if (uniform) return;
+
+        // Measurements are discarded as row identities are unknown after row count changes
+        heights.resize(count, 0.f);
+        sums.resize(count, 0.f);
+        counts.resize(count, 0);
+    }
+
+    void ItemGridPersistentState::RowHeightIndex::update(int32_t row, float height)
+    {
+        if (uniform)
+        {
+            total = height; measured = 1;
+            return;
+        }
+
+        auto& current = heights[row];
+        if (current == height || height <= 0.f) return;
+
+        auto delta = height - current;
+        auto added = current == 0.f ? 1 : 0;
+        current = height;
+        total += delta;
+        measured += added;
+
+        for (auto idx = row + 1; idx <= rows; idx += idx & -idx)
+        {
+            sums[idx - 1] += delta;
+            counts[idx - 1] += added;
+        }
+    }
+
+    float ItemGridPersistentState::RowHeightIndex::estimate() const
+    {
+        return measured > 0 ? total / (float)measured : 0.f;
+    }
+
+    float ItemGridPersistentState::RowHeightIndex::offset(int32_t row) const
+    {
+        if (uniform) return (float)row * estimate();
+
+        auto sum = 0.f;
+        auto count = 0;
+
+        for (auto idx = row; idx > 0; idx -= idx & -idx)
+        {
+            sum += sums[idx - 1];
+            count += counts[idx - 1];
+        }
+
+        return sum + (float)(row - count) * estimate();
+    }
+
+    int32_t ItemGridPersistentState::RowHeightIndex::seek(float offset) const
+    {
+        auto avg = estimate();
+        if (rows == 0 || offset <= 0.f || avg == 0.f) return 0;
+        if (uniform) return std::min((int32_t)(offset / avg), rows - 1);
+
+        // Descend the Fenwick tree, finding the most rows whose total height does not exceed offset
+        auto pos = 0, count = 0;
+        auto sum = 0.f;
+
+        for (auto step = (int32_t)std::bit_floor((uint32_t)rows); step > 0; step >>= 1)
+        {
+            auto next = pos + step;
+            if (next > rows) continue;
+
+            auto nsum = sum + sums[next - 1];
+            auto ncount = count + counts[next - 1];
+            if (nsum + (float)(next - ncount) * avg <= offset)
+            {
+                pos = next; sum = nsum; count = ncount;
+            }
+        }
+
+        return std::min(pos, rows - 1);
+    }
+
+    bool ItemGridPersistentState::TreeIndex::reset(int32_t rootCount)
+    {
+        if (rootCount == roots) return false;
+
+        roots = rootCount;
+        nodes.clear();
+        freeBlocks.clear();
+        nodes.emplace_back();
+        update(0, true, rootCount);
+        return true;
+    }
+
+    int32_t ItemGridPersistentState::TreeIndex::at(int32_t row) const
+    {
+        // Descend from root, at each level find the child whose subtree spans the remaining rows
+        auto node = 0;
+
+        while (true)
+        {
+            const auto& parent = nodes[node];
+            auto pos = 0;
+
+            for (auto step = (int32_t)std::bit_floor((uint32_t)parent.children); step > 0; step >>= 1)
+            {
+                auto next = pos + step;
+                if (next > parent.children) continue;
+
+                const auto& entry = nodes[parent.first + next - 1];
+                if (entry.fsize <= row)
+                {
+                    pos = next;
+                    row -= entry.fsize;
+                }
+            }
+
+            if (pos == parent.children) return parent.first + parent.children - 1;
+
+            node = parent.first + pos;
+            if (row == 0) return node;
+            --row;
+        }
+    }
+
+    int32_t ItemGridPersistentState::TreeIndex::position(int32_t node) const
+    {
+        auto row = -1;
+
+        for (; node != 0; node = nodes[node].parent)
+        {
+            row += 1;
+            for (auto idx = sibling(node); idx > 0; idx -= idx & -idx)
+                row += nodes[nodes[nodes[node].parent].first + idx - 1].fsize;
+        }
+
+        return row;
+    }
+
+    int32_t ItemGridPersistentState::TreeIndex::next(int32_t node) const
+    {
+        return nodes[node].children > 0 ? nodes[node].first : skip(node);
+    }
+
+    int32_t ItemGridPersistentState::TreeIndex::skip(int32_t node) const
+    {
+        for (; node != 0; node = nodes[node].parent)
+        {
+            const auto& parent = nodes[nodes[node].parent];
+            if (node + 1 < parent.first + parent.children) return node + 1;
+        }
+
+        return 0;
+    }
+
+    int32_t ItemGridPersistentState::TreeIndex::parent(int32_t row) const
+    {
+        auto node = nodes[at(row)].parent;
+        return node == 0 ? -1 : position(node);
+    }
+
+    int32_t ItemGridPersistentState::TreeIndex::allocate(int32_t count)
+    {
+        for (auto idx = 0; idx < (int32_t)freeBlocks.size(); ++idx)
+        {
+            auto& block = freeBlocks[idx];
+            if (block.count < count) continue;
+
+            auto first = block.first;
+            block.first += count;
+            block.count -= count;
+            if (block.count == 0) freeBlocks.erase(freeBlocks.begin() + idx);
+            return first;
+        }
+
+        auto first = (int32_t)nodes.size();
+        nodes.resize(nodes.size() + count);
+        return first;
+    }
+
+    void ItemGridPersistentState::TreeIndex::release(int32_t node)
+    {
+        // Return child blocks of node's visible subtree to the free list, without recursion
+        std::vector<int32_t> pending{ node };
+
+        while (!pending.empty())
+        {
+            auto current = pending.back();
+            pending.pop_back();
+
+            const auto& parent = nodes[current];
+            if (parent.children == 0) continue;
+
+            for (auto child = parent.first; child < parent.first + parent.children; ++child)
+                if (nodes[child].children > 0) pending.push_back(child);
+            freeBlocks.push_back(Block{ parent.first, parent.children });
+        }
+    }
+
+    void ItemGridPersistentState::TreeIndex::propagate(int32_t node, int32_t size, int32_t measured, float total)
+    {
+        while (true)
+        {
+            auto& current = nodes[node];
+            current.size += size;
+            current.measured += measured;
+            current.total += total;
+            if (node == 0) break;
+
+            auto parent = current.parent;
+            auto first = nodes[parent].first, count = nodes[parent].children;
+
+            for (auto idx = node - first + 1; idx <= count; idx += idx & -idx)
+            {
+                auto& entry = nodes[first + idx - 1];
+                entry.fsize += size;
+                entry.fmeasured += measured;
+                entry.ftotal += total;
+            }
+
+            node = parent;
+        }
+    }
+
+    std::pair<int32_t, int32_t> ItemGridPersistentState::TreeIndex::update(int32_t node, bool expanded, int32_t children)
+    {
+        auto target = expanded ? std::max(children, 0) : 0;
+        if (nodes[node].children == target) return { 0, 0 };
+
+        // Descendants of previously expanded children are dropped, they are re-expanded
+        // as the children are discovered and report their state
+        auto removed = nodes[node].size - 1;
+        auto self = nodes[node].height > 0.f ? 1 : 0;
+        auto measured = nodes[node].measured - self;
+        auto total = nodes[node].total - nodes[node].height;
+        release(node);
+
+        auto first = target > 0 ? allocate(target) : 0;
+        for (auto idx = 0; idx < target; ++idx)
+        {
+            auto& child = nodes[first + idx];
+            child = Node{};
+            child.parent = node;
+            child.depth = nodes[node].depth + 1;
+            child.fsize = (idx + 1) & -(idx + 1);
+        }
+
+        nodes[node].first = first;
+        nodes[node].children = target;
+        propagate(node, target - removed, -measured, -total);
+        return { removed, target };
+    }
+
+    void ItemGridPersistentState::TreeIndex::measure(int32_t node, float height)
+    {
+        auto current = nodes[node].height;
+        if (current == height || height <= 0.f) return;
+
+        nodes[node].height = height;
+        propagate(node, 0, current == 0.f ? 1 : 0, height - current);
+    }
+
+    float ItemGridPersistentState::TreeIndex::estimate() const
+    {
+        return !nodes.empty() && nodes[0].measured > 0 ? nodes[0].total / (float)nodes[0].measured : 0.f;
+    }
+
+    float ItemGridPersistentState::TreeIndex::offset(int32_t row) const
+    {
+        auto avg = estimate();
+        if (row >= rows()) return nodes.empty() ? 0.f : extent(nodes[0], avg) - avg;
+
+        // Same descent as `at`, accumulating heights of rows skipped at each level
+        auto node = 0;
+        auto sum = 0.f;
+
+        while (true)
+        {
+            const auto& parent = nodes[node];
+            auto pos = 0;
+
+            for (auto step = (int32_t)std::bit_floor((uint32_t)parent.children); step > 0; step >>= 1)
+            {
+                auto next = pos + step;
+                if (next > parent.children) continue;
+
+                const auto& entry = nodes[parent.first + next - 1];
+                if (entry.fsize <= row)
+                {
+                    pos = next;
+                    row -= entry.fsize;
+                    sum += entry.ftotal + (float)(entry.fsize - entry.fmeasured) * avg;
+                }
+            }
+
+            node = parent.first + pos;
+            if (row == 0) return sum;
+
+            sum += nodes[node].height > 0.f ? nodes[node].height : avg;
+            --row;
+        }
+    }
+
+    int32_t ItemGridPersistentState::TreeIndex::seek(float offset) const
+    {
+        auto avg = estimate();
+        auto count = rows();
+        if (count == 0 || offset <= 0.f || avg == 0.f) return 0;
+
+        // Descend from root, at each level find the child whose subtree spans the remaining offset
+        auto node = 0, row = 0;
+
+        while (true)
+        {
+            const auto& parent = nodes[node];
+            auto pos = 0;
+
+            for (auto step = (int32_t)std::bit_floor((uint32_t)parent.children); step > 0; step >>= 1)
+            {
+                auto next = pos + step;
+                if (next > parent.children) continue;
+
+                const auto& entry = nodes[parent.first + next - 1];
+                auto height = entry.ftotal + (float)(entry.fsize - entry.fmeasured) * avg;
+                if (height <= offset)
+                {
+                    pos = next;
+                    offset -= height;
+                    row += entry.fsize;
+                }
+            }
+
+            if (pos == parent.children) return std::min(row, count) - 1;
+
+            node = parent.first + pos;
+            auto height = nodes[node].height > 0.f ? nodes[node].height : avg;
+            if (offset < height || nodes[node].children == 0) return row;
+
+            offset -= height;
+            ++row;
+        }
+    }
+
+    static uint64_t SelectedCellKey(int32_t row, int16_t col, int16_t depth)
+    {
+        return ((uint64_t)(uint16_t)depth << 48) | ((uint64_t)(uint16_t)col << 32) | (uint64_t)(uint32_t)row;
+    }
+
+    void ItemGridPersistentState::SelectionSet::clear()
+    {
+        for (auto& ranges : rows) ranges.clear();
+        std::fill(cols.begin(), cols.end(), 0u);
+        cells.clear();
+        anchor = ItemId{};
+    }
+
+    int32_t ItemGridPersistentState::SelectionSet::size() const
+    {
+        auto total = (int32_t)cells.size();
+        for (const auto& ranges : rows)
+            for (const auto& range : ranges)
+                total += range.to - range.from + 1;
+        for (auto bits : cols)
+            total += std::popcount(bits);
+        return total;
+    }
+
+    void ItemGridPersistentState::SelectionSet::addRows(int32_t from, int32_t to, int16_t depth)
+    {
+        if (from > to) std::swap(from, to);
+        if ((int16_t)rows.size() <= depth) rows.resize(depth + 1);
+
+        // Ranges overlapping or adjacent to [from, to] are merged with it
+        auto& ranges = rows[depth];
+        auto first = std::lower_bound(ranges.begin(), ranges.end(), from, [](const RowRange& range, int32_t row) {
+            return range.to < row - 1; });
+        auto last = std::upper_bound(first, ranges.end(), to, [](int32_t row, const RowRange& range) {
+            return row + 1 < range.from; });
+
+        RowRange merged{ from, to };
+        if (first != last)
+        {
+            merged.from = std::min(from, first->from);
+            merged.to = std::max(to, (last - 1)->to);
+            first = ranges.erase(first, last);
+        }
+
+        ranges.insert(first, merged);
+    }
+
+    void ItemGridPersistentState::SelectionSet::addColumns(int16_t from, int16_t to)
+    {
+        if (from > to) std::swap(from, to);
+        if ((int32_t)cols.size() * 64 <= to) cols.resize((to / 64) + 1, 0u);
+        for (auto col = from; col <= to; ++col)
+            cols[col / 64] |= (uint64_t)1 << (col % 64);
+    }
+
+    void ItemGridPersistentState::SelectionSet::addCell(int32_t row, int16_t col, int16_t depth)
+    {
+        cells.insert(SelectedCellKey(row, col, depth));
+    }
+
+    bool ItemGridPersistentState::SelectionSet::isRowSelected(int32_t row, int16_t depth) const
+    {
+        if ((int16_t)rows.size() <= depth) return false;
+
+        const auto& ranges = rows[depth];
+        auto it = std::upper_bound(ranges.begin(), ranges.end(), row, [](int32_t row, const RowRange& range) {
+            return row < range.from; });
+        return it != ranges.begin() && (it - 1)->to >= row;
+    }
+
+    bool ItemGridPersistentState::SelectionSet::isColumnSelected(int16_t col) const
+    {
+        return col >= 0 && (int32_t)cols.size() * 64 > col && (cols[col / 64] & ((uint64_t)1 << (col % 64)));
+    }
+
+    bool ItemGridPersistentState::SelectionSet::isCellSelected(int32_t row, int16_t col, int16_t depth) const
+    {
+        return !cells.empty() && cells.find(SelectedCellKey(row, col, depth)) != cells.end();
+    }
+
+    void ItemGridPersistentState::SelectionSet::spliceRows(int32_t from, int32_t removed, int32_t added)
+    {
+        auto end = from + removed, delta = added - removed;
+        auto shift = [&](int32_t row) { return row < from ? row : row >= end ? row + delta : -1; };
+
+        // Ranges are clipped to rows before and after removed ones, the latter being shifted
+        for (auto& ranges : rows)
+        {
+            std::vector<RowRange> result;
+            result.reserve(ranges.size() + 1);
+
+            for (const auto& range : ranges)
+            {
+                if (range.from < from)
+                    result.push_back(RowRange{ range.from, std::min(range.to, from - 1) });
+                if (range.to >= end)
+                {
+                    RowRange shifted{ std::max(range.from, end) + delta, range.to + delta };
+                    if (!result.empty() && result.back().to + 1 >= shifted.from) result.back().to = shifted.to;
+                    else result.push_back(shifted);
+                }
+            }
+
+            ranges = std::move(result);
+        }
+
+        if (!cells.empty())
+        {
+            std::unordered_set<uint64_t> shifted;
+            shifted.reserve(cells.size());
+
+            for (auto key : cells)
+            {
+                auto row = shift((int32_t)(uint32_t)key);
+                if (row != -1) shifted.insert((key & ~(uint64_t)UINT32_MAX) | (uint64_t)(uint32_t)row);
+            }
+
+            cells = std::move(shifted);
+        }
+
+        // Anchor inside removed rows moves to their parent i.e. row before them
+        if (anchor.row != -1)
+        {
+            auto row = shift(anchor.row);
+            anchor.row = row != -1 ? row : std::max(from - 1, 0);
+        }
+    }
+
+    void ItemGridPersistentState::SelectionSet::permuteRows(const std::vector<int32_t>& moved)
+    {
+        auto move = [&moved](int32_t row) { return row >= 0 && row < (int32_t)moved.size() ? moved[row] : -1; };
+        std::vector<int32_t> selected;
+
+        // Moved rows are no longer contiguous in general, hence ranges are rebuilt from sorted rows
+        for (auto& ranges : rows)
+        {
+            selected.clear();
+            for (const auto& range : ranges)
+                for (auto row = range.from; row <= range.to; ++row)
+                    if (auto target = move(row); target != -1) selected.push_back(target);
+
+            std::sort(selected.begin(), selected.end());
+            ranges.clear();
+
+            for (auto row : selected)
+            {
+                if (!ranges.empty() && ranges.back().to + 1 >= row) ranges.back().to = std::max(ranges.back().to, row);
+                else ranges.push_back(RowRange{ row, row });
+            }
+        }
+
+        if (!cells.empty())
+        {
+            std::unordered_set<uint64_t> permuted;
+            permuted.reserve(cells.size());
+
+            for (auto key : cells)
+            {
+                auto row = move((int32_t)(uint32_t)key);
+                if (row != -1) permuted.insert((key & ~(uint64_t)UINT32_MAX) | (uint64_t)(uint32_t)row);
+            }
+
+            cells = std::move(permuted);
+        }
+
+        // Anchor of deselected row moves to a remaining selected row, if any
+        if (anchor.row != -1)
+        {
+            auto row = move(anchor.row);
+            if (row == -1)
+            {
+                for (const auto& ranges : rows)
+                    if (!ranges.empty()) { row = ranges.front().from; break; }
+                if (row == -1 && !cells.empty()) row = (int32_t)(uint32_t)*cells.begin();
+            }
+
+            anchor.row = row;
+        }
+    }
+
+#pragma region Item grid row order
+
+    struct ItemGridSortJob
+    {
+        using Entry = std::pair<ItemGridCellKey, int32_t>;
+
+        std::shared_ptr<ItemGridRowOrder> owner;
+        ItemGridRowOrder::Request request;
+        std::shared_ptr<const std::vector<int32_t>> base; // Rows to filter, all rows if null
+        std::vector<std::vector<int32_t>> filtered; // Rows passing filters, per chunk
+        std::vector<int32_t> rows;
+        std::vector<Entry> entries;
+        std::atomic<int32_t> remaining = 0;
+        int32_t generation = 0;
+        int32_t total = 0; // Rows to filter
+        int32_t width = 0; // Length of sorted runs while merging
+
+        bool cancelled() const { return owner->generation.load(std::memory_order_relaxed) != generation; }
+        int32_t chunks(int32_t count) const { return (count + GLIMMER_ITEMGRID_SORT_CHUNK_SIZE - 1) / GLIMMER_ITEMGRID_SORT_CHUNK_SIZE; }
+    };
+
+    using ItemGridSortJobPtr = std::shared_ptr<ItemGridSortJob>;
+
+    static bool IsKeyLess(const ItemGridCellKey& lhs, const ItemGridCellKey& rhs)
+    {
+        return lhs.text.empty() && rhs.text.empty() ? lhs.number < rhs.number : lhs.text < rhs.text;
+    }
+
+    static bool ContainsNoCase(std::string_view text, std::string_view pattern)
+    {
+        return std::search(text.begin(), text.end(), pattern.begin(), pattern.end(), [](char lhs, char rhs) {
+            return std::tolower((unsigned char)lhs) == std::tolower((unsigned char)rhs); }) != text.end();
+    }
+
+    static bool IsRowFilteredIn(const ItemGridRowOrder::Request& request, int32_t row)
+    {
+        char buffer[32];
+
+        for (int16_t col = 0; col < (int16_t)request.filters.size(); ++col)
+        {
+            const auto& filter = request.filters[col];
+            if (filter.empty()) continue;
+
+            auto key = request.cellkey(row, col);
+            auto text = key.text;
+
+            if (text.empty())
+            {
+                auto sz = std::snprintf(buffer, 31, "%g", key.number);
+                text = std::string_view{ buffer, (size_t)sz };
+            }
+
+            if (!ContainsNoCase(text, filter)) return false;
+        }
+
+        return true;
+    }
+
+    // Filters only narrow if every filter contains the previous one, rows which did not match
+    // earlier cannot match now, and the previous permutation is already sorted
+    static bool IsNarrowerFilter(const ItemGridRowOrder::Request& next, const ItemGridRowOrder::Request& prev)
+    {
+        if (next.cellkey != prev.cellkey || next.rows != prev.rows || next.version != prev.version ||
+            next.sortcol != prev.sortcol || next.ascending != prev.ascending ||
+            next.filters.size() != prev.filters.size())
+            return false;
+
+        for (auto idx = 0; idx < (int)next.filters.size(); ++idx)
+            if (next.filters[idx].find(prev.filters[idx]) == std::string::npos)
+                return false;
+        return true;
+    }
+
+    // Runs fn(job, idx) for idx in [0, count) as separate worker tasks, the task which finishes last
+    // continues with next. Tasks are skipped once the job is cancelled.
+    static void RunSortJobStage(ItemGridSortJobPtr job, int32_t count, void (*fn)(ItemGridSortJob&, int32_t),
+        void (*next)(ItemGridSortJobPtr))
+    {
+        if (count <= 0) { next(job); return; }
+
+        job->remaining = count;
+        for (auto idx = 0; idx < count; ++idx)
+            GetWorkerPool().Enqueue([job, idx, fn, next] {
+                if (!job->cancelled()) fn(*job, idx);
+                if (job->remaining.fetch_sub(1) == 1 && !job->cancelled()) next(job);
+            });
+    }
+
+    static void PublishRowOrder(ItemGridSortJobPtr job)
+    {
+        if (!job->entries.empty())
+            for (auto idx = 0; idx < (int32_t)job->entries.size(); ++idx)
+                job->rows[idx] = job->entries[idx].second;
+
+        auto rows = std::make_shared<const std::vector<int32_t>>(std::move(job->rows));
+        auto& owner = *job->owner;
+
+        {
+            std::lock_guard<std::mutex> lock{ owner.mutex };
+            if (job->cancelled()) return;
+
+            owner.current = std::move(rows);
+            owner.applied = std::move(job->request);
+            owner.published = job->generation;
+        }
+
+        // Event-driven loops may be blocked waiting for input, the new order is shown in next frame
+        Config.platform->RequestFrame();
+    }
+
+    // Sorted runs of `width` entries are merged pairwise, until there is a single run
+    static void MergeSortedRuns(ItemGridSortJobPtr job)
+    {
+        auto count = (int32_t)job->entries.size();
+        if (job->width >= count) { PublishRowOrder(job); return; }
+
+        job->width *= 2;
+        RunSortJobStage(job, (count + job->width - 1) / job->width, [](ItemGridSortJob& job, int32_t idx) {
+            auto count = (int32_t)job.entries.size();
+            auto from = idx * job.width, mid = std::min(from + job.width / 2, count), to = std::min(from + job.width, count);
+            auto ascending = job.request.ascending;
+            std::inplace_merge(job.entries.begin() + from, job.entries.begin() + mid, job.entries.begin() + to,
+                [ascending](const ItemGridSortJob::Entry& lhs, const ItemGridSortJob::Entry& rhs) {
+                    return ascending ? IsKeyLess(lhs.first, rhs.first) : IsKeyLess(rhs.first, lhs.first); });
+        }, &MergeSortedRuns);
+    }
+
+    static void SortFilteredRows(ItemGridSortJobPtr job)
+    {
+        auto count = 0;
+        for (const auto& chunk : job->filtered) count += (int32_t)chunk.size();
+        job->rows.reserve(count);
+        for (const auto& chunk : job->filtered) job->rows.insert(job->rows.end(), chunk.begin(), chunk.end());
+        job->filtered.clear();
+
+        if (job->base != nullptr || job->request.sortcol == -1)
+        {
+            PublishRowOrder(job);
+            return;
+        }
+
+        // Extract keys and sort chunks in parallel, then merge the sorted chunks
+        job->entries.resize(job->rows.size());
+        job->width = GLIMMER_ITEMGRID_SORT_CHUNK_SIZE;
+        RunSortJobStage(job, job->chunks(count), [](ItemGridSortJob& job, int32_t idx) {
+            auto from = idx * GLIMMER_ITEMGRID_SORT_CHUNK_SIZE;
+            auto to = std::min(from + GLIMMER_ITEMGRID_SORT_CHUNK_SIZE, (int32_t)job.rows.size());
+            auto ascending = job.request.ascending;
+
+            for (auto pos = from; pos < to; ++pos)
+                job.entries[pos] = { job.request.cellkey(job.rows[pos], job.request.sortcol), job.rows[pos] };
+
+            std::stable_sort(job.entries.begin() + from, job.entries.begin() + to,
+                [ascending](const ItemGridSortJob::Entry& lhs, const ItemGridSortJob::Entry& rhs) {
+                    return ascending ? IsKeyLess(lhs.first, rhs.first) : IsKeyLess(rhs.first, lhs.first); });
+        }, &MergeSortedRuns);
+    }
+
+    void ItemGridRowOrder::update(const Request& request)
+    {
+        if (request == submitted) return;
+
+        submitted = request;
+        auto job = std::make_shared<ItemGridSortJob>();
+        job->owner = shared_from_this();
+        job->request = request;
+        job->generation = ++generation;
+
+        auto filtered = std::any_of(request.filters.begin(), request.filters.end(),
+            [](const std::string& filter) { return !filter.empty(); });
+
+        // Neither sorted nor filtered, rows are displayed in source order
+        if (!filtered && request.sortcol == -1)
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            current.reset();
+            applied = request;
+            published = job->generation;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            if (current != nullptr && IsNarrowerFilter(request, applied))
+                job->base = current;
+        }
+
+        job->total = job->base != nullptr ? (int32_t)job->base->size() : request.rows;
+        job->filtered.resize(job->chunks(job->total));
+        RunSortJobStage(job, (int32_t)job->filtered.size(), [](ItemGridSortJob& job, int32_t idx) {
+            auto from = idx * GLIMMER_ITEMGRID_SORT_CHUNK_SIZE;
+            auto to = std::min(from + GLIMMER_ITEMGRID_SORT_CHUNK_SIZE, job.total);
+            auto& rows = job.filtered[idx];
+            rows.reserve(to - from);
+
+            for (auto pos = from; pos < to; ++pos)
+            {
+                auto row = job.base != nullptr ? (*job.base)[pos] : pos;
+                if (IsRowFilteredIn(job.request, row)) rows.push_back(row);
+            }
+        }, &SortFilteredRows);
+    }
+
+    std::shared_ptr<const std::vector<int32_t>> ItemGridRowOrder::rows(int32_t total)
+    {
+        // Source rows may have been removed after the permutation was computed
+        std::lock_guard<std::mutex> lock{ mutex };
+        return applied.rows <= total ? current : nullptr;
+    }
+
+#pragma endregion
+
+#pragma region Item grid page cache
+
+    void ItemGridPageCache::beginFrame(IItemGridDataSource* next, int32_t totalRows)
+    {
+        if (source != next) clear();
+        source = next;
+        rows = totalRows;
+        firstPage = INT32_MAX; lastPage = -1;
+        ++frame;
+
+        decltype(inbox) delivered;
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            delivered.swap(inbox);
+        }
+
+        // Rows of pages which were evicted or invalidated after being requested are dropped
+        for (auto& [gen, data] : delivered)
+        {
+            auto it = pages.find(data.rowStart / GLIMMER_ITEMGRID_PAGE_SIZE);
+            if (gen != generation || it == pages.end() || it->second.loaded) continue;
+
+            it->second.cells = std::move(data.cells);
+            it->second.columns = data.columns;
+            it->second.loaded = true;
+        }
+    }
+
+    void ItemGridPageCache::endFrame(float scroll)
+    {
+        if (scroll != lastScroll) direction = scroll > lastScroll ? 1 : -1;
+        lastScroll = scroll;
+
+        if (lastPage != -1)
+        {
+            auto totalPages = (rows + GLIMMER_ITEMGRID_PAGE_SIZE - 1) / GLIMMER_ITEMGRID_PAGE_SIZE;
+            auto page = direction > 0 ? lastPage + 1 : firstPage - 1;
+
+            for (auto count = 0; count < GLIMMER_ITEMGRID_PREFETCH_PAGES && page >= 0 && page < totalPages; 
+                ++count, page += direction)
+                if (pages.find(page) == pages.end()) request(page);
+        }
+
+        // Pages accessed or requested in current frame are retained
+        while ((int32_t)pages.size() > GLIMMER_ITEMGRID_MAX_CACHED_PAGES)
+        {
+            auto lru = pages.begin();
+            for (auto it = pages.begin(); it != pages.end(); ++it)
+                if (it->second.lastUsed < lru->second.lastUsed) lru = it;
+
+            if (lru->second.lastUsed == frame) break;
+            pages.erase(lru);
+        }
+    }
+
+    void ItemGridPageCache::clear()
+    {
+        pages.clear();
+        ++generation;
+
+        std::lock_guard<std::mutex> lock{ mutex };
+        inbox.clear();
+    }
+
+    std::optional<std::string_view> ItemGridPageCache::cell(int32_t row, int16_t col)
+    {
+        auto index = row / GLIMMER_ITEMGRID_PAGE_SIZE;
+        firstPage = std::min(firstPage, index);
+        lastPage = std::max(lastPage, index);
+
+        auto it = pages.find(index);
+        if (it == pages.end())
+        {
+            request(index);
+            return std::nullopt;
+        }
+
+        auto& page = it->second;
+        page.lastUsed = frame;
+        if (!page.loaded) return std::nullopt;
+
+        auto idx = (size_t)(row - index * GLIMMER_ITEMGRID_PAGE_SIZE) * page.columns + col;
+        return col < page.columns && idx < page.cells.size() ? std::string_view{ page.cells[idx] } : std::string_view{};
+    }
+
+    void ItemGridPageCache::request(int32_t page)
+    {
+        pages[page].lastUsed = frame;
+
+        auto from = page * GLIMMER_ITEMGRID_PAGE_SIZE;
+        auto to = std::min(from + GLIMMER_ITEMGRID_PAGE_SIZE, rows);
+        source->RequestRange(from, to, [cache = weak_from_this(), gen = generation](ItemGridRowData&& data) {
+            if (auto self = cache.lock())
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ self->mutex };
+                    self->inbox.emplace_back(gen, std::move(data));
+                }
+
+                // Delivered rows are moved into the cache at the start of next frame
+                Config.platform->RequestFrame();
+            }
+        });
+    }
+
+#pragma endregion
+
+#pragma region Text editor buffer
+
+    int32_t TextEditorBuffer::lineStart(int32_t line) const
+    {
+        auto split = (int32_t)head.size();
+        return line < split ? head[line] : size() - tail[tail.size() - 1 - (line - split)];
+    }
+
+    int32_t TextEditorBuffer::lineEnd(int32_t line) const
+    {
+        return line + 1 < lines() ? lineStart(line + 1) - 1 : size();
+    }
+
+    int32_t TextEditorBuffer::lineOf(int32_t pos) const
+    {
+        if (pos < head.back())
+            return (int32_t)(std::upper_bound(head.begin(), head.end(), pos) - head.begin()) - 1;
+
+        // Distances from end increase towards back of tail, the first one not less than
+        // distance of `pos` is the last line starting at or before it
+        auto it = std::lower_bound(tail.begin(), tail.end(), size() - pos);
+        return (int32_t)(head.size() + (tail.end() - it)) - 1;
+    }
+
+    void TextEditorBuffer::assign(std::string_view text)
+    {
+        data.assign(text.begin(), text.end());
+        data.resize(text.size() + GLIMMER_TEXT_EDITOR_GAP_SIZE);
+        gapStart = (int32_t)text.size();
+        gapEnd = (int32_t)data.size();
+        head.assign(1, 0);
+        tail.clear();
+
+        for (auto idx = 0; idx < (int32_t)text.size(); ++idx)
+            if (text[idx] == '\n') head.push_back(idx + 1);
+    }
+
+    void TextEditorBuffer::insert(int32_t pos, std::string_view text)
+    {
+        if (text.empty()) return;
+
+        // Lines after `pos` are stored relative to end of text, hence remain valid
+        moveSplit(pos);
+        moveGap(pos, (int32_t)text.size());
+        std::copy(text.begin(), text.end(), data.begin() + gapStart);
+        gapStart += (int32_t)text.size();
+
+        for (auto idx = 0; idx < (int32_t)text.size(); ++idx)
+            if (text[idx] == '\n') head.push_back(pos + idx + 1);
+    }
+
+    void TextEditorBuffer::erase(int32_t pos, int32_t count)
+    {
+        count = std::min(count, size() - pos);
+        if (count <= 0) return;
+
+        // Lines starting inside erased range are merged with the line at `pos`
+        moveSplit(pos);
+        auto total = size();
+        while (!tail.empty() && total - tail.back() <= pos + count) tail.pop_back();
+
+        moveGap(pos, 0);
+        gapEnd += count;
+    }
+
+    std::string_view TextEditorBuffer::view(int32_t from, int32_t to, std::string& scratch) const
+    {
+        auto gap = gapEnd - gapStart;
+        if (to <= gapStart) return std::string_view{ data.data() + from, (size_t)(to - from) };
+        if (from >= gapStart) return std::string_view{ data.data() + from + gap, (size_t)(to - from) };
+
+        scratch.assign(data.data() + from, data.data() + gapStart);
+        scratch.append(data.data() + gapEnd, data.data() + to + gap);
+        return scratch;
+    }
+
+    void TextEditorBuffer::moveGap(int32_t pos, int32_t space)
+    {
+        if (gapEnd - gapStart < space)
+        {
+            // Gap grows in proportion to text, making insertions amortised O(1)
+            auto total = size();
+            auto gap = std::max({ space, total / 2, GLIMMER_TEXT_EDITOR_GAP_SIZE });
+            std::vector<char> grown(total + gap);
+            std::copy(data.begin(), data.begin() + gapStart, grown.begin());
+            std::copy(data.begin() + gapEnd, data.end(), grown.end() - (data.size() - gapEnd));
+            gapEnd = gapStart + gap;
+            data.swap(grown);
+        }
+
+        if (pos < gapStart)
+        {
+            auto count = gapStart - pos;
+            std::copy_backward(data.begin() + pos, data.begin() + gapStart, data.begin() + gapEnd);
+            gapStart -= count; gapEnd -= count;
+        }
+        else if (pos > gapStart)
+        {
+            auto count = pos - gapStart;
+            std::copy(data.begin() + gapEnd, data.begin() + gapEnd + count, data.begin() + gapStart);
+            gapStart += count; gapEnd += count;
+        }
+    }
+
+    void TextEditorBuffer::moveSplit(int32_t pos)
     {
-        type = Layout::Invalid;
-        id = 0;
-        fill = FD_None;
-        alignment = TextAlignLeading;
-        from = -1, to = -1, itemidx = -1;
-        currow = -1, currcol = -1;
-        geometry = ImRect{ { FIT_SZ, FIT_SZ },{ FIT_SZ, FIT_SZ } };
-        available = ImRect{ };
-        nextpos = ImVec2{ 0.f, 0.f };
-        prevpos = ImVec2{ 0.f, 0.f };
-        spacing = ImVec2{ 0.f, 0.f };
-        maxdim = ImVec2{ 0.f, 0.f };
-        startpos = ImVec2{ 0.f, 0.f };
-        cumulative = ImVec2{ 0.f, 0.f };
-        size = ImVec2{ 0.f, 0.f };
-        hofmode = OverflowMode::Scroll;
-        vofmode = OverflowMode::Scroll;
-        scroll = ScrollableRegion{};
-        tabbar.reset();
-        popSizingOnEnd = false;
-        currspan.first = currspan.second = 1;
+        auto total = size();
 
-        for (auto idx = 0; idx < WSI_Total; ++idx)
+        while (!tail.empty() && total - tail.back() <= pos)
         {
-            styleStartIdx[idx] = -1;
+            head.push_back(total - tail.back());
+            tail.pop_back();
         }
 
-        itemIndexes.clear(true);
-        griditems.clear(true);
-        containerStack.clear(true);
-        rows.clear(true);
-        cols.clear(true);
+        while (head.size() > 1u && head.back() > pos)
+        {
+            tail.push_back(total - head.back());
+            head.pop_back();
+        }
     }
 
-    void TabBarBuilder::reset()
+#pragma endregion
+
+#pragma region Text undo log
+
+    void TextUndoLog::record(int32_t position, std::string_view removed, std::string_view added, int32_t caretpos)
     {
-        id = -1;
-        geometry = 0;
-        sizing = TabBarItemSizing::ResizeToFit;
-        neighbors = NeighborWidgets{};
-        items.clear(true);
-        newTabButton = false;
+        if (removed.empty() && added.empty()) return;
+
+        auto mergeable = sinceLastEdit < GLIMMER_TEXT_UNDO_MERGE_INTERVAL && pos > 0 && pos == (int32_t)ops.size() &&
+            removed.size() <= 1u && added.size() <= 1u;
+        sinceLastEdit = 0.f;
+        if (mergeable && merge(position, removed, added)) return;
+
+        // A new edit discards the redoable operations
+        if (pos < (int32_t)ops.size())
+        {
+            arena.resize(ops[pos].offset);
+            ops.resize(pos);
+        }
+
+        auto& op = ops.emplace_back();
+        op.position = position;
+        op.removed = (int32_t)removed.size();
+        op.added = (int32_t)added.size();
+        op.offset = (int32_t)arena.size();
+        op.caretpos = caretpos;
+        op.type = removed.empty() ? TextOpType::Addition : added.empty() ? TextOpType::Deletion : TextOpType::Replacement;
+        arena.insert(arena.end(), removed.begin(), removed.end());
+        arena.insert(arena.end(), added.begin(), added.end());
+        pos++;
+
+        // Evict oldest operations down to 3/4th of budget so that the arena is not shifted on every
+        // edit once full, the latest operation is always retained even if it alone exceeds the budget
+        if (memory() > capacity)
+        {
+            auto target = capacity - (capacity / 4), mem = memory();
+            auto count = 0;
+
+            while (count < (int32_t)ops.size() - 1 && mem > target)
+            {
+                mem -= (int32_t)sizeof(TextInputOperation) + ops[count].removed + ops[count].added;
+                count++;
+            }
+
+            auto bytes = ops[count].offset;
+            arena.erase(arena.begin(), arena.begin() + bytes);
+            ops.erase(ops.begin(), ops.begin() + count);
+            for (auto& rest : ops) rest.offset -= bytes;
+            pos -= count;
+        }
     }
 
-    void NavDrawerBuilder::reset()
+    bool TextUndoLog::merge(int32_t position, std::string_view removed, std::string_view added)
     {
-        geometry = 0;
-        neighbors = NeighborWidgets{};
-        items.clear(true);
+        auto& last = ops.back();
+        auto type = removed.empty() ? TextOpType::Addition : added.empty() ? TextOpType::Deletion : TextOpType::Replacement;
+        if (type != last.type) return false;
+
+        // Merged run of edits ends at the start of a word i.e. whitespace followed by non-whitespace
+        auto isboundary = [](char left, char right) {
+            return std::isspace((unsigned char)left) && !std::isspace((unsigned char)right);
+        };
+
+        if (position == last.position + last.added)
+        {
+            // Continues after last edit: typing, overwriting or deleting forward
+            auto left = last.added > 0 ? arena.back() : arena[last.offset + last.removed - 1];
+            auto right = added.empty() ? removed.front() : added.front();
+            if (isboundary(left, right)) return false;
+
+            arena.insert(arena.begin() + last.offset + last.removed, removed.begin(), removed.end());
+            arena.insert(arena.end(), added.begin(), added.end());
+            last.removed += (int32_t)removed.size();
+            last.added += (int32_t)added.size();
+            return true;
+        }
+        else if (type == TextOpType::Deletion && position + (int32_t)removed.size() == last.position)
+        {
+            // Precedes last deletion: backspace
+            if (isboundary(removed.front(), arena[last.offset])) return false;
+
+            arena.insert(arena.begin() + last.offset, removed.begin(), removed.end());
+            last.position = position;
+            last.removed += (int32_t)removed.size();
+            return true;
+        }
+
+        return false;
+    }
+
+    const TextInputOperation* TextUndoLog::undo()
+    {
+        sinceLastEdit = FLT_MAX;
+        return pos > 0 ? &ops[--pos] : nullptr;
+    }
+
+    const TextInputOperation* TextUndoLog::redo()
+    {
+        sinceLastEdit = FLT_MAX;
+        return pos < (int32_t)ops.size() ? &ops[pos++] : nullptr;
+    }
+
+    void TextUndoLog::clear()
+    {
+        ops.clear();
+        arena.clear();
+        pos = 0;
+        sinceLastEdit = FLT_MAX;
+    }
+
+#pragma endregion
+
+#pragma region Option search index
+
+    static uint32_t Trigram(const char* str)
+    {
+        return ((uint32_t)(unsigned char)str[0] << 16) | ((uint32_t)(unsigned char)str[1] << 8) | (uint32_t)(unsigned char)str[2];
+    }
+
+    void OptionSearchIndex::clear()
+    {
+        text.clear();
+        offsets.assign(1, 0);
+        trigrams.clear();
+        postingStart.clear();
+        postings.clear();
+    }
+
+    void OptionSearchIndex::add(std::string_view str)
+    {
+        for (auto ch : str) text.push_back((char)std::tolower((unsigned char)ch));
+        offsets.push_back((int32_t)text.size());
+    }
+
+    void OptionSearchIndex::finalize()
+    {
+        // Sorting (trigram, string) pairs groups strings by trigram, and makes
+        // repeated trigrams of a string adjacent so that they can be dropped
+        std::vector<uint64_t> pairs;
+        pairs.reserve(text.size());
+        for (auto idx = 0; idx < size(); ++idx)
+            for (auto pos = offsets[idx]; pos + 3 <= offsets[idx + 1]; ++pos)
+                pairs.push_back(((uint64_t)Trigram(text.data() + pos) << 32) | (uint64_t)idx);
+
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        trigrams.clear();
+        postingStart.clear();
+        postings.clear();
+        postings.reserve(pairs.size());
+
+        for (auto pair : pairs)
+        {
+            auto trigram = (uint32_t)(pair >> 32);
+            if (trigrams.empty() || trigrams.back() != trigram)
+            {
+                trigrams.push_back(trigram);
+                postingStart.push_back((int32_t)postings.size());
+            }
+
+            postings.push_back((int32_t)(pair & 0xFFFFFFFFu));
+        }
+
+        postingStart.push_back((int32_t)postings.size());
     }
 
+    void OptionSearchIndex::search(std::string_view query, const std::vector<int32_t>* within, std::vector<int32_t>& out) const
+    {
+        static std::string lowered;
+        lowered.clear();
+        for (auto ch : query) lowered.push_back((char)std::tolower((unsigned char)ch));
+        out.clear();
+
+        if (within == nullptr && lowered.empty())
+        {
+            out.resize(size());
+            std::iota(out.begin(), out.end(), 0);
+            return;
+        }
+        else if (within == nullptr && lowered.size() < 3u)
+        {
+            // Without trigrams to narrow down candidates, scan through all text at once, a match
+            // is valid if it does not span across strings, after which rest of the string is skipped
+            std::string_view all{ text.data(), text.size() };
+            auto option = 0;
+
+            for (auto pos = all.find(lowered); pos != std::string_view::npos; pos = all.find(lowered, pos))
+            {
+                while (offsets[option + 1] <= (int32_t)pos) ++option;
+
+                if ((int32_t)(pos + lowered.size()) <= offsets[option + 1])
+                {
+                    out.push_back(option);
+                    pos = offsets[++option];
+                }
+                else pos++;
+            }
+
+            return;
+        }
+
+        // Candidates are the fewest of `within` and strings of each of query's trigrams,
+        // each candidate is then verified for containing the query
+        const int32_t* candidates = within != nullptr ? within->data() : nullptr;
+        auto count = within != nullptr ? (int32_t)within->size() : size();
+
+        for (auto pos = 0; pos + 3 <= (int32_t)lowered.size(); ++pos)
+        {
+            auto trigram = Trigram(lowered.data() + pos);
+            auto it = std::lower_bound(trigrams.begin(), trigrams.end(), trigram);
+            if (it == trigrams.end() || *it != trigram) return;
+
+            auto tidx = it - trigrams.begin();
+            auto total = postingStart[tidx + 1] - postingStart[tidx];
+            if (total < count)
+            {
+                candidates = postings.data() + postingStart[tidx];
+                count = total;
+            }
+        }
+
+        for (auto idx = 0; idx < count; ++idx)
+        {
+            auto option = candidates != nullptr ? candidates[idx] : idx;
+            std::string_view str{ text.data() + offsets[option], (size_t)(offsets[option + 1] - offsets[option]) };
+            if (str.find(lowered) != std::string_view::npos) out.push_back(option);
+        }
+    }
+
+#pragma endregion
+
     void ItemGridBuilder::reset()
     {
         id = -1;
@@ -108,11 +1320,12 @@ namespace glimmer
         levels = currlevel = depth = 0;
         selectedCol = -1;
         movingCols = std::make_pair<int16_t, int16_t>(-1, -1);
+        visibleCols = std::make_pair<int16_t, int16_t>(0, -1);
         phase = ItemGridConstructPhase::None;
-        perDepthRowCount.clear(true);
         cellvals.clear(true);
-        rowYs.clear(true);
+        colEnds.clear(true);
         clickedItem.row = clickedItem.col = clickedItem.depth = -1;
+        rowOrder.reset();
         resizecol = -1;
 
         for (auto idx = 0; idx < 5; ++idx)
@@ -212,6 +1425,15 @@ namespace glimmer
             context.adhocLayout.push();
         }
 
+        ReloadThemeIfChanged();
+        anim::UpdateTracks(Config.platform->desc.deltaTime);
+
+#ifndef GLIMMER_DISABLE_RICHTEXT
+        // Documents outdated by a config change (scaling, theme) are laid out in parallel
+        // up front, rather than one by one when each rich text label is measured
+        if (Config.richTextConfig != nullptr) ImRichText::RelayoutRichTexts();
+#endif
+
         for (auto idx = 0; idx < WSI_Total; ++idx)
             AddFontPtr(WidgetContextData::StyleStack[idx].top().font);
 
@@ -241,6 +1463,14 @@ namespace glimmer
             
             context.ResetLayoutData();
             context.maxids[WT_SplitterRegion] = 0;
+
+            // Widgets which were not dispatched this frame are no longer engaged
+            for (auto it = context.engagedWidgets.begin(); it != context.engagedWidgets.end();)
+            {
+                if (!it->second) it = context.engagedWidgets.erase(it);
+                else { it->second = false; ++it; }
+            }
+
             context.maxids[WT_Layout] = 0;
             context.maxids[WT_Charts] = 0;
             context.lastLayoutIdx = -1;
@@ -297,8 +1527,9 @@ namespace glimmer
                 states[type].emplace_back(WidgetConfigData{ type });
                 auto& styles = WidgetStyles[type][idx + oldsz];
 
+                // Memory is uninitialized, hence constructed in place rather than assigned to
                 for (auto ws = 0; ws < WSI_Total; ++ws)
-                    styles[ws] = StyleDescriptor{};
+                    ::new (styles + ws) CompactStyle{};
             }
 
             switch (type)
@@ -321,6 +1552,12 @@ namespace glimmer
                     inputTextStates.emplace_back();
                 break;
             }
+            case WT_TextEditor: {
+                textEditorStates.reserve(textEditorStates.size() + sz);
+                for (auto idx = 0; idx < sz; ++idx)
+                    textEditorStates.emplace_back();
+                break;
+            }
             case WT_ToggleButton: {
                 toggleStates.reserve(toggleStates.size() + sz);
                 for (auto idx = 0; idx < sz; ++idx)
@@ -396,29 +1633,103 @@ namespace glimmer
         IgnoreStyleStackBits = -1;
     }
 
-    StyleDescriptor WidgetContextData::GetStyle(int32_t state, int32_t id)
+    const StyleDescriptor& WidgetContextData::GetStyle(int32_t state, int32_t id)
     {
         return glimmer::GetStyle(*this, id, StyleStack, state);
     }
 
     void WidgetContextData::RegisterWidgetIdClass(WidgetType wt, int32_t index, const WidgetIdClasses& idClasses)
     {
-        if (!idClasses.classes.empty())
+        auto id = (wt << WidgetTypeBits) | index;
+        auto& selectors = widgetSelectors[id];
+        selectors.clear();
+
+        // Id is applied last, as it takes precedence over classes
+        for (int i = 0; i < idClasses.classes.size(); ++i)
+            selectors.push_back(idClasses.classes[i]);
+        selectors.push_back(idClasses.id);
+
+        ComputeWidgetStyles(id);
+    }
+
+    void WidgetContextData::ComputeWidgetStyles(int32_t id, int32_t states)
+    {
+        auto wt = (WidgetType)(id >> WidgetTypeBits);
+        auto index = id & WidgetIndexMask;
+        auto it = widgetSelectors.find(id);
+        StyleDescriptor styles[WSI_Total];
+
+        if (it != widgetSelectors.end())
         {
-            for (int i = 0; i < idClasses.classes.size(); ++i)
+            for (auto selector : it->second)
             {
                 for (auto idx = 0; idx < WSI_Total; ++idx)
                 {
-                    auto& style = glimmer::GetStyle(idClasses.classes[i], (WidgetStateIndex)idx);
-                    WidgetStyles[wt][index][idx].From(style);
+                    if (!(states & (1 << idx))) continue;
+                    auto& style = glimmer::GetStyle(selector, (WidgetStateIndex)idx);
+                    styles[idx].From(style);
                 }
             }
         }
 
         for (auto idx = 0; idx < WSI_Total; ++idx)
+            if (states & (1 << idx)) WidgetStyles[wt][index][idx].assign(styles[idx]);
+
+        InvalidateResolvedStyles(id, states);
+    }
+
+    void WidgetContextData::InvalidateResolvedStyles(int32_t id, int32_t states)
+    {
+        auto wt = id >> WidgetTypeBits;
+        auto index = id & WidgetIndexMask;
+        auto& indices = resolvedStyleIndices[wt];
+
+        if (index < (int)indices.size())
+        {
+            for (auto idx = 0; idx < WSI_Total; ++idx)
+            {
+                auto resolved = indices[index][idx];
+                if (resolved != -1 && (states & (1 << idx))) resolvedStyles[resolved].stack = nullptr;
+            }
+        }
+    }
+
+    void WidgetContextData::InvalidateResolvedStyles(WidgetType wt, int32_t states)
+    {
+        for (const auto& indices : resolvedStyleIndices[wt])
+        {
+            for (auto idx = 0; idx < WSI_Total; ++idx)
+            {
+                auto resolved = indices[idx];
+                if (resolved != -1 && (states & (1 << idx))) resolvedStyles[resolved].stack = nullptr;
+            }
+        }
+    }
+
+    void InvalidateWidgetStyles(const std::vector<std::pair<std::string_view, int32_t>>& selectors)
+    {
+        auto statesOf = [&selectors](std::string_view selector) {
+            auto states = 0;
+            for (const auto& [name, mask] : selectors)
+                if (name == selector) states |= mask;
+            return states;
+        };
+
+        for (auto& context : WidgetContexts)
         {
-            auto& style = glimmer::GetStyle(idClasses.id, (WidgetStateIndex)idx);
-            WidgetStyles[wt][index][idx].From(style);
+            for (const auto& [id, widgetSelectors] : context.widgetSelectors)
+            {
+                auto states = 0;
+                for (auto selector : widgetSelectors) states |= statesOf(selector);
+                if (states != 0) context.ComputeWidgetStyles(id, states);
+            }
+
+            for (auto wt = 0; wt < WT_TotalTypes; ++wt)
+            {
+                if (Config.widgetNames[wt].empty()) continue;
+                if (auto states = statesOf(Config.widgetNames[wt]); states != 0)
+                    context.InvalidateResolvedStyles((WidgetType)wt, states);
+            }
         }
     }
 
@@ -726,6 +2037,15 @@ namespace glimmer
         return info;
     }
 
+    EventDeferInfo EventDeferInfo::ForTextEditor(int32_t id, const ImRect& content)
+    {
+        EventDeferInfo info;
+        info.type = WT_TextEditor;
+        info.id = id;
+        info.params.editor.content = content;
+        return info;
+    }
+
     EventDeferInfo EventDeferInfo::ForCustom(int32_t id)
     {
         EventDeferInfo info;
@@ -734,14 +2054,207 @@ namespace glimmer
         return info;
     }
 
+    // Area (in coordinates of deferred event) inside which mouse interacts with the widget,
+    // widgets which handle events irrespective of mouse position have empty bounds
+    static ImRect GetEventBounds(const EventDeferInfo& ev)
+    {
+        const auto& params = ev.params;
+
+        switch (ev.type)
+        {
+        case WT_Label: return params.label.margin;
+        case WT_Button: return params.button.margin;
+        case WT_Checkbox: return params.checkbox.extent;
+        case WT_RadioButton: return params.radio.extent;
+        case WT_ToggleButton: return params.toggle.extent;
+        case WT_Spinner:
+        {
+            auto bounds = params.spinner.extent;
+            bounds.Add(params.spinner.incbtn);
+            bounds.Add(params.spinner.decbtn);
+            return bounds;
+        }
+        case WT_Slider:
+        {
+            auto bounds = params.slider.extent;
+            bounds.Add(params.slider.thumb);
+            return bounds;
+        }
+        case WT_RangeSlider:
+        {
+            auto bounds = params.rangeslider.extent;
+            bounds.Add(params.rangeslider.minThumb);
+            bounds.Add(params.rangeslider.maxThumb);
+            return bounds;
+        }
+        case WT_TextInput:
+        {
+            auto bounds = params.input.content;
+            if (params.input.clear.GetArea() > 0.f) bounds.Add(params.input.clear);
+            return bounds;
+        }
+        case WT_TextEditor: return params.editor.content;
+        case WT_DropDown: return params.dropdown.margin;
+        case WT_MediaResource: return params.media.padding;
+        default: return ImRect{};
+        }
+    }
+
+    // Whether widget is in the middle of an interaction or animation as of last frame, such
+    // widgets are dispatched events even if mouse is not over them, so that they can update
+    // their state i.e. lose hover, end a drag, fade scrollbars or handle keyboard input
+    static bool IsEventEngaged(WidgetContextData& context, const EventDeferInfo& ev)
+    {
+        constexpr int32_t EngagedStates = WS_Focused | WS_Hovered | WS_Pressed | WS_Dragged;
+
+        switch (ev.type)
+        {
+        case WT_Label: return context.GetState(ev.id).state.label.state & EngagedStates;
+        case WT_Button: return context.GetState(ev.id).state.button.state & EngagedStates;
+        case WT_Checkbox: return (context.GetState(ev.id).state.checkbox.state & EngagedStates) ||
+            anim::IsTrackActive(context.CheckboxState(ev.id).track);
+        case WT_RadioButton: return (context.GetState(ev.id).state.radio.state & EngagedStates) ||
+            context.RadioState(ev.id).animate;
+        case WT_ToggleButton: return (context.GetState(ev.id).state.toggle.state & EngagedStates) ||
+            context.ToggleState(ev.id).animate;
+        case WT_Spinner: return context.GetState(ev.id).state.spinner.state & EngagedStates;
+        case WT_Slider: return context.GetState(ev.id).state.slider.state & EngagedStates;
+        case WT_RangeSlider: return context.GetState(ev.id).state.rangeSlider.state & EngagedStates;
+        case WT_TextInput:
+        {
+            const auto& scroll = context.InputTextState(ev.id).scroll.state;
+            return (context.GetState(ev.id).state.input.state & EngagedStates) || scroll.opacity.x > 0.f || 
+                scroll.mouseDownOnHGrip;
+        }
+        case WT_TextEditor:
+        {
+            const auto& scroll = context.TextEditorState(ev.id).scroll.state;
+            return (context.GetState(ev.id).state.editor.state & EngagedStates) || scroll.opacity.x > 0.f || 
+                scroll.opacity.y > 0.f || scroll.mouseDownOnHGrip || scroll.mouseDownOnVGrip;
+        }
+        case WT_DropDown: return (context.GetState(ev.id).state.dropdown.state & EngagedStates) ||
+            context.GetState(ev.id).state.dropdown.opened;
+        case WT_MediaResource: return context.GetState(ev.id).state.media.state & EngagedStates;
+        case WT_Scrollable: return false;
+        default: return true; // Regions, tab bars, nav drawers, accordions and custom widgets
+        }
+    }
+
+    void EventHitGrid::build(const Vector<EventDeferInfo, int16_t>& events, const EngagedWidgets& engaged)
+    {
+        bounds.clear(false);
+        always.clear(false);
+        extent = ImRect{ ImVec2{ FLT_MAX, FLT_MAX }, ImVec2{ -FLT_MAX, -FLT_MAX } };
+        built = events.size();
+        auto count = 0;
+
+        for (auto idx = 0; idx < built; ++idx)
+        {
+            auto area = GetEventBounds(events[idx]);
+            bounds.push_back(area);
+
+            if (area.GetArea() <= 0.f || engaged.find(events[idx].id) != engaged.end()) always.push_back(idx);
+            else { extent.Add(area); ++count; }
+        }
+
+        // Roughly four areas per cell, area spanning multiple cells is added to each of them
+        cols = rows = std::clamp((int32_t)std::sqrt((float)count * 0.25f), 1, 64);
+        cellsz.x = std::max(extent.GetWidth() / (float)cols, 1.f);
+        cellsz.y = std::max(extent.GetHeight() / (float)rows, 1.f);
+        cells.clear(false);
+        cells.resize(cols * rows + 1, 0);
+        if (count == 0) return;
+
+        auto forEachCell = [this](const ImRect& area, auto&& func) {
+            auto minx = std::clamp((int32_t)((area.Min.x - extent.Min.x) / cellsz.x), 0, cols - 1);
+            auto maxx = std::clamp((int32_t)((area.Max.x - extent.Min.x) / cellsz.x), 0, cols - 1);
+            auto miny = std::clamp((int32_t)((area.Min.y - extent.Min.y) / cellsz.y), 0, rows - 1);
+            auto maxy = std::clamp((int32_t)((area.Max.y - extent.Min.y) / cellsz.y), 0, rows - 1);
+
+            for (auto y = miny; y <= maxy; ++y)
+                for (auto x = minx; x <= maxx; ++x)
+                    func(y * cols + x);
+        };
+
+        // Count entries per cell, convert counts to start offsets and then place entries
+        for (auto idx = 0; idx < bounds.size(); ++idx)
+            if (bounds[idx].GetArea() > 0.f && engaged.find(events[idx].id) == engaged.end())
+                forEachCell(bounds[idx], [this](int32_t cell) { ++cells[cell + 1]; });
+
+        for (auto cell = 1; cell < cells.size(); ++cell) cells[cell] += cells[cell - 1];
+        entries.clear(false);
+        entries.resize(cells[cells.size() - 1], false);
+
+        for (auto idx = 0; idx < bounds.size(); ++idx)
+            if (bounds[idx].GetArea() > 0.f && engaged.find(events[idx].id) == engaged.end())
+                forEachCell(bounds[idx], [&, this](int32_t cell) { entries[cells[cell]++] = idx; });
+
+        // Placing entries advanced each cell's offset to the start of next one
+        for (auto cell = cells.size() - 1; cell > 0; --cell) cells[cell] = cells[cell - 1];
+        cells[0] = 0;
+    }
+
+    const Vector<int32_t, int32_t>& EventHitGrid::query(ImVec2 mousepos, int32_t start, int32_t end)
+    {
+        candidates.clear(false);
+        auto first = 0, last = 0;
+
+        if (extent.Contains(mousepos))
+        {
+            auto x = std::clamp((int32_t)((mousepos.x - extent.Min.x) / cellsz.x), 0, cols - 1);
+            auto y = std::clamp((int32_t)((mousepos.y - extent.Min.y) / cellsz.y), 0, rows - 1);
+            first = cells[y * cols + x];
+            last = cells[y * cols + x + 1];
+        }
+
+        // Both cell entries and events dispatched always are in ascending order, merge the ones in range
+        auto other = (int32_t)(std::lower_bound(always.begin(), always.end(), start) - always.begin());
+        for (auto entry = first; entry < last; ++entry)
+        {
+            auto idx = entries[entry];
+            if (idx < start) continue;
+            if (idx >= end) break;
+            if (!bounds[idx].Contains(mousepos)) continue;
+
+            while (other < always.size() && always[other] < idx) candidates.push_back(always[other++]);
+            candidates.push_back(idx);
+        }
+
+        while (other < always.size() && always[other] < end) candidates.push_back(always[other++]);
+        return candidates;
+    }
+
+    const Vector<int32_t, int32_t>& EventHitGrid::scan(const Vector<EventDeferInfo, int16_t>& events, int32_t start, 
+        int32_t end, ImVec2 mousepos, const EngagedWidgets& engaged)
+    {
+        candidates.clear(false);
+
+        for (auto idx = start; idx < end; ++idx)
+        {
+            auto area = GetEventBounds(events[idx]);
+            if (area.GetArea() <= 0.f || area.Contains(mousepos) || engaged.find(events[idx].id) != engaged.end())
+                candidates.push_back(idx);
+        }
+
+        return candidates;
+    }
+
     WidgetDrawResult WidgetContextData::HandleEvents(ImVec2 origin, int from, int to)
     {
         auto io = Config.platform->CurrentIO();
         auto& renderer = usingDeferred ? *deferedRenderer : *Config.renderer;
+        auto mousepos = io.mousepos - origin;
         WidgetDrawResult result;
         to = to == -1 ? deferedEvents.size() : to;
 
-        for (auto idx = from; idx < to; ++idx)
+        // Mouse is hit-tested in coordinates of deferred events, handlers are invoked only for widgets
+        // under mouse and the ones which are engaged in an interaction. The grid spans all events deferred
+        // so far, it is only rebuilt if the range includes events deferred after it was built.
+        if (to - from >= GLIMMER_EVENT_GRID_MIN_EVENTS && to > eventGrid.built) eventGrid.build(deferedEvents, engagedWidgets);
+        const auto& candidates = to - from < GLIMMER_EVENT_GRID_MIN_EVENTS ?
+            eventGrid.scan(deferedEvents, from, to, mousepos, engagedWidgets) : eventGrid.query(mousepos, from, to);
+
+        for (auto idx : candidates)
         {
             auto ev = deferedEvents[idx];
 
@@ -812,6 +2325,10 @@ namespace glimmer
                 ev.params.input.clear.Translate(origin);
                 HandleTextInputEvent(ev.id, ev.params.input.content, ev.params.input.clear, io, renderer, result);
                 break;
+            case WT_TextEditor:
+                ev.params.editor.content.Translate(origin);
+                HandleTextEditorEvent(ev.id, ev.params.editor.content, io, renderer, result);
+                break;
             case WT_DropDown:
                 ev.params.dropdown.margin.Translate(origin);
                 ev.params.dropdown.border.Translate(origin);
@@ -848,9 +2365,14 @@ namespace glimmer
             default:
                 break;
             }
+
+            // Engagement only changes when widget's events are handled, track it for next dispatch
+            if (GetEventBounds(deferedEvents[idx]).GetArea() <= 0.f) continue;
+            if (IsEventEngaged(*this, deferedEvents[idx])) engagedWidgets[ev.id] = true;
+            else engagedWidgets.erase(ev.id);
         }
 
-        if (to == -1) deferedEvents.clear(true);
+        if (to == -1) ClearDeferredEvents();
         return result;
     }
 
@@ -866,10 +2388,16 @@ namespace glimmer
 
     void WidgetContextData::ClearDeferredData()
     {
-        deferedEvents.clear(true);
+        ClearDeferredEvents();
         deferedRenderer->Reset();
     }
 
+    void WidgetContextData::ClearDeferredEvents()
+    {
+        deferedEvents.clear(true);
+        eventGrid.reset();
+    }
+
     const ImRect& WidgetContextData::GetGeometry(int32_t id) const
     {
         auto index = id & WidgetIndexMask;
@@ -997,10 +2525,37 @@ namespace glimmer
             case WT_Splitter: return 4;
             case WT_Accordion: return 4;
             case WT_DropDown: return 16;
+            case WT_TextEditor: return 4;
             default: return 32; // Default for other widget types
         }
     }
     
+    void TabBarPersistentState::ItemDescriptor::releaseTracks()
+    {
+        anim::ReleaseTrack(tabHoverTrack);
+        anim::ReleaseTrack(pinHoverTrack);
+        anim::ReleaseTrack(closeHoverTrack);
+    }
+
+    // Animation tracks and compact styles are owned by persistent widget states, and returned with them.
+    // Vector does not destroy its elements, hence compact style words are released explicitly.
+    WidgetContextData::~WidgetContextData()
+    {
+        for (auto wt = 0; wt < WT_TotalTypes; ++wt)
+            for (auto& styles : WidgetStyles[wt])
+                for (auto& style : styles) style.release();
+
+        for (auto& state : toggleStates) anim::ReleaseTrack(state.track);
+        for (auto& state : radioStates) anim::ReleaseTrack(state.track);
+        for (auto& state : checkboxStates) anim::ReleaseTrack(state.track);
+
+        for (auto& state : tabBarStates)
+        {
+            for (auto& tab : state.tabs) tab.releaseTracks();
+            anim::ReleaseTrack(state.createHoverTrack);
+        }
+    }
+
     WidgetContextData::WidgetContextData()
     {
         for (auto idx = 0; idx < WT_TotalTypes; ++idx)
@@ -1024,6 +2579,7 @@ namespace glimmer
                 case WT_RadioButton: radioStates.resize(count); break;
                 case WT_Checkbox: checkboxStates.resize(count); break;
                 case WT_TextInput: inputTextStates.resize(count); break;
+                case WT_TextEditor: textEditorStates.resize(count); break;
                 case WT_Spinner: spinnerStates.resize(count); break;
                 case WT_Splitter: 
                     splitterStates.resize(count); 
@@ -1204,29 +2760,72 @@ namespace glimmer
         if (Config.logger) Config.logger->Finish();
     }
 
-    StyleDescriptor GetStyle(WidgetContextData& context, int32_t id, StyleStackT const* StyleStack, int32_t state)
+    const StyleDescriptor& GetStyle(WidgetContextData& context, int32_t id, StyleStackT const* StyleStack, int32_t state)
     {
-        StyleDescriptor res;
         StyleDescriptor const* defstyle = nullptr;
         auto style = (WidgetStateIndex)log2((unsigned)state);
         auto wtype = (WidgetType)(id >> WidgetTypeBits);
         auto index = id & WidgetIndexMask;
+        auto useStack = (IgnoreStyleStackBits == -1) || !(IgnoreStyleStackBits & (1 << wtype));
+
+        // The resolved style only depends on style sheet, and style stack entries used below
+        auto version = CombineStyleVersion(GetStyleSheetVersion(), useStack ?
+            CombineStyleVersion(StyleStack[style].version(), StyleStack[WSI_Default].version()) :
+            CombineStyleVersion(StyleStack[WSI_Default].version(0), (uint64_t)wtype + 1u));
+
+        auto& indices = context.resolvedStyleIndices[wtype];
+        if ((int)indices.size() <= index)
+        {
+            std::array<int32_t, WSI_Total> unresolved;
+            unresolved.fill(-1);
+            indices.resize(index + 1, unresolved);
+        }
+
+        auto& resolvedIdx = indices[index][style];
+        if (resolvedIdx == -1)
+        {
+            resolvedIdx = (int32_t)context.resolvedStyles.size();
+            context.resolvedStyles.emplace_back();
+        }
+
+        auto& entry = context.resolvedStyles[resolvedIdx];
+        if (entry.version == version && entry.stack == StyleStack) return entry.style;
+
+        auto& res = entry.style;
+        res = StyleDescriptor{};
+        entry.stack = StyleStack;
+        entry.version = version;
 
         defstyle = &glimmer::GetWidgetStyle(wtype, WidgetStateIndex::WSI_Default);
         res.From(glimmer::GetWidgetStyle(wtype, style));
 
-        if (defstyle->specified == 0) defstyle = &(context.WidgetStyles[wtype][index][WSI_Default]);
+        // Widget specific default is expanded only if it is used for copying to res
+        const CompactStyle* widgetDefault = nullptr;
+        if (defstyle->specified == 0) widgetDefault = &(context.WidgetStyles[wtype][index][WSI_Default]);
         res.From(context.WidgetStyles[wtype][index][style]);
 
-        if ((IgnoreStyleStackBits == -1) || !(IgnoreStyleStackBits & (1 << wtype)))
+        if (useStack)
         {
             res.From(StyleStack[style].top());
             defstyle = &(StyleStack[WSI_Default].top());
+            widgetDefault = nullptr;
         }
-        else if (defstyle->specified == 0)
+        else if (widgetDefault != nullptr && widgetDefault->specified == 0)
+        {
             defstyle = StyleStack[WSI_Default].begin();
+            widgetDefault = nullptr;
+        }
 
-        if (style != WSI_Default) CopyStyle(*defstyle, res);
+        if (style != WSI_Default)
+        {
+            if (widgetDefault != nullptr)
+            {
+                StyleDescriptor expanded;
+                expanded.From(*widgetDefault);
+                CopyStyle(expanded, res);
+            }
+            else CopyStyle(*defstyle, res);
+        }
         AddFontPtr(res.font);
         return res;
     }
@@ -25,6 +25,8 @@
 // instead of capturing lambda's as `std::function`, which is both heavy-weight and incurs virtual
 // function call, only the data required to handle events is recorded. It is replayed once the 
 // geometry of widgets are computed and rendered.
+// Solver output of every layout is cached against a fingerprint of its inputs, so that only
+// layout subtrees whose children's sizes or parameters changed are solved again.
 // 
 // It also maintains a style stack, which is shared across all contexts i.e. independent of
 // stacked contexts. Style data is maintained per "predefined widget state". Refer to WidgetState
@@ -37,7 +39,14 @@
 #include "types.h"
 #include "style.h"
 
+#include <array>
+#include <atomic>
 #include <bit>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace glimmer
 {
@@ -89,6 +98,27 @@ namespace glimmer
 
     struct WidgetContextData;
 
+    // Case-insensitive substring search over a fixed list of strings. Lowercase text of all
+    // strings is stored contiguously, and each trigram maps to the (ascending) list of strings
+    // containing it, so that a query only verifies strings containing its rarest trigram.
+    struct OptionSearchIndex
+    {
+        std::vector<char> text; // Lowercase text of all strings, back to back
+        std::vector<int32_t> offsets{ 0 }; // Start of each string in text, with one past the end
+        std::vector<uint32_t> trigrams; // Distinct trigrams in ascending order
+        std::vector<int32_t> postingStart; // Start of each trigram's list in postings, with one past the end
+        std::vector<int32_t> postings;
+
+        int32_t size() const { return (int32_t)offsets.size() - 1; }
+        void clear();
+        void add(std::string_view str);
+        void finalize();
+
+        // Indexes of strings containing query in ascending order, if `within` is provided
+        // only those strings are considered (i.e. when refining results of a shorter query)
+        void search(std::string_view query, const std::vector<int32_t>* within, std::vector<int32_t>& out) const;
+    };
+
     struct DropDownPersistentState
     {
         struct ChildWidget
@@ -99,6 +129,24 @@ namespace glimmer
 
         Vector<ChildWidget, int16_t, 16> children;
         WidgetContextData* context = nullptr;
+
+        // Search index being built on the worker pool, swapped into `search` once ready
+        struct PendingSearchIndex
+        {
+            OptionSearchIndex index;
+            std::atomic<bool> ready = false;
+        };
+
+        // State of virtualised options popup
+        OptionSearchIndex search;
+        std::shared_ptr<PendingSearchIndex> pending;
+        std::string filter, matchedFilter;
+        std::vector<int32_t> matches, scratch; // Options matching filter, in order
+        ScrollableRegion scroll;
+        int32_t cursor = -1; // Entry of matches highlighted through keyboard
+        bool indexed = false;
+        bool filtered = false;
+        bool revealSelection = false;
     };
 
     struct ItemGridStyleDescriptor
@@ -111,6 +159,69 @@ namespace glimmer
         Default, ResizingColumns, ReorderingColumns
     };
 
+    // Sorted and filtered permutation of rows of an item grid, computed on worker threads. The last
+    // published permutation stays in use while a newer request is processed, and a newer request
+    // cancels the job in progress. Narrowed filters only re-filter the published permutation.
+    struct ItemGridRowOrder : public std::enable_shared_from_this<ItemGridRowOrder>
+    {
+        struct Request
+        {
+            ItemGridCellKey (*cellkey)(int32_t, int16_t) = nullptr;
+            std::vector<std::string> filters; // Filter text per column, empty if column is not filtered
+            int32_t rows = 0;
+            int32_t version = 0; // Incremented when underlying data changes
+            int16_t sortcol = -1;
+            bool ascending = true;
+
+            bool operator==(const Request&) const = default;
+        };
+
+        Request submitted; // Last request sent to workers, only accessed from UI thread
+        int32_t version = 0;
+
+        std::mutex mutex; // Guards below two
+        std::shared_ptr<const std::vector<int32_t>> current; // Published permutation, null implies identity
+        Request applied; // Request which published permutation was computed for
+
+        std::atomic<int32_t> generation = 0; // Generation of latest request, older jobs are cancelled
+        std::atomic<int32_t> published = 0; // Generation of published permutation
+
+        void update(const Request& request);
+        std::shared_ptr<const std::vector<int32_t>> rows(int32_t total); // Null if identity or computed for more rows
+        bool pending() const { return generation.load() != published.load(); }
+    };
+
+    // Pages of rows fetched from an item grid data source, least recently used pages are evicted.
+    // Sources deliver rows from any thread into the inbox, which is merged on the UI thread.
+    struct ItemGridPageCache : public std::enable_shared_from_this<ItemGridPageCache>
+    {
+        struct Page
+        {
+            std::vector<std::string> cells;
+            int64_t lastUsed = 0; // Frame in which page was last accessed
+            int16_t columns = 0;
+            bool loaded = false;
+        };
+
+        std::unordered_map<int32_t, Page> pages; // Keyed by row / GLIMMER_ITEMGRID_PAGE_SIZE
+        IItemGridDataSource* source = nullptr;
+        int64_t frame = 0;
+        int32_t generation = 0; // Incremented when cached rows are invalidated
+        int32_t firstPage = INT32_MAX, lastPage = -1; // Pages accessed in current frame
+        int32_t direction = 1; // Scroll direction, pages are prefetched towards it
+        int32_t rows = 0;
+        float lastScroll = 0.f;
+
+        std::mutex mutex; // Guards inbox
+        std::vector<std::pair<int32_t, ItemGridRowData>> inbox; // Delivered rows with generation
+
+        void beginFrame(IItemGridDataSource* source, int32_t totalRows);
+        void endFrame(float scroll);
+        void clear();
+        std::optional<std::string_view> cell(int32_t row, int16_t col); // nullopt if row is not fetched
+        void request(int32_t page);
+    };
+
     struct ItemGridPersistentState
     {
         struct HeaderCellResizeState
@@ -157,9 +268,109 @@ namespace glimmer
             int32_t depth = -1;
         };
 
-        Vector<ItemId, int16_t, 32> selections{ false };
-        float lastSelection = -1.f;
-        float currentSelection = -1.f;
+        // Heights of rows measured while rendering, to seek the first visible row of a flat grid
+        // without building the rows before it. Rows not measured yet are assumed to be of average
+        // height of measured rows, with uniform heights only the last measured height is used.
+        struct RowHeightIndex
+        {
+            Vector<float, int32_t> heights{ false }; // Measured height of each row, 0 if not measured
+            Vector<float, int32_t> sums{ false }; // Fenwick tree of measured heights
+            Vector<int32_t, int32_t> counts{ false }; // Fenwick tree of count of measured rows
+            float total = 0.f;
+            int32_t measured = 0;
+            int32_t rows = 0;
+            bool uniform = false;
+
+            void resize(int32_t count, bool uniformHeights);
+            void update(int32_t row, float height);
+            float estimate() const;
+            float offset(int32_t row) const; // Total height of rows before `row`
+            int32_t seek(float offset) const; // Row which spans `offset`
+        } rowHeights;
+
+        // Visible nodes of a tree, children of a node occupy a contiguous block of the pool and
+        // every block keeps Fenwick trees of its nodes' visible subtree sizes and measured heights.
+        // Hence locating a row, its parent or its offset is O(depth * log(children)), and expanding
+        // or collapsing a node only updates its ancestors. Node 0 is a hidden root whose children
+        // are the root rows, rows are numbered in display (pre-order) order excluding it.
+        struct TreeIndex
+        {
+            struct Node
+            {
+                int32_t parent = -1;
+                int32_t first = 0; // Index of first child in pool
+                int32_t children = 0; // Number of direct children in index, 0 if collapsed
+                int32_t size = 1; // Number of visible rows in subtree, including the node itself
+                int32_t measured = 0; // Number of measured rows in visible subtree
+                float total = 0.f; // Total measured height of visible subtree
+                float height = 0.f; // Measured height of the node's row, 0 if not measured
+                int32_t fsize = 1; // Fenwick entries over the sibling block of `size`, `measured` and `total`
+                int32_t fmeasured = 0;
+                float ftotal = 0.f;
+                int16_t depth = -1;
+            };
+
+            struct Block { int32_t first = 0, count = 0; };
+
+            std::vector<Node> nodes;
+            std::vector<Block> freeBlocks; // Blocks of collapsed nodes, reused first fit
+            int32_t roots = -1;
+
+            bool reset(int32_t rootCount); // Returns true if index was rebuilt
+            int32_t rows() const { return nodes.empty() ? 0 : nodes[0].size - 1; }
+            int32_t at(int32_t row) const; // Node at visible `row`
+            int32_t position(int32_t node) const; // Visible row of node
+            int32_t next(int32_t node) const; // Next node in display order, 0 after last one
+            int32_t skip(int32_t node) const; // Next node in display order which is not a descendant
+            int32_t sibling(int32_t node) const { return node - nodes[nodes[node].parent].first; }
+            int32_t parent(int32_t row) const; // Visible row of parent node, -1 for root rows
+            // Set visible children of `node`, returns number of rows removed and added after it
+            std::pair<int32_t, int32_t> update(int32_t node, bool expanded, int32_t children);
+            void measure(int32_t node, float height);
+            float estimate() const;
+            float offset(int32_t row) const; // Total height of rows before `row`
+            int32_t seek(float offset) const; // Row which spans `offset`
+
+        private:
+            int32_t allocate(int32_t count);
+            void release(int32_t node);
+            void propagate(int32_t node, int32_t size, int32_t measured, float total);
+            float extent(const Node& node, float avg) const { return node.total + (float)(node.size - node.measured) * avg; }
+        } tree;
+
+        // Selected items, rows are stored as sorted disjoint ranges per depth, columns as a bitset
+        // and cells in a hash set. Range selection is a single insertion and membership checks do
+        // not depend on the number of selected items.
+        struct SelectionSet
+        {
+            struct RowRange { int32_t from = 0, to = 0; }; // Inclusive range of row ids
+
+            std::vector<std::vector<RowRange>> rows; // Indexed by depth
+            std::vector<uint64_t> cols;
+            std::unordered_set<uint64_t> cells;
+            ItemId anchor; // Last individually selected item, contiguous selection extends from it
+
+            void clear();
+            bool empty() const { return anchor.row == -1 && anchor.col == -1; }
+            int32_t size() const; // Total number of selected rows, columns and cells
+
+            void addRows(int32_t from, int32_t to, int16_t depth);
+            void addColumns(int16_t from, int16_t to);
+            void addCell(int32_t row, int16_t col, int16_t depth);
+
+            bool isRowSelected(int32_t row, int16_t depth) const;
+            bool isColumnSelected(int16_t col) const;
+            bool isCellSelected(int32_t row, int16_t col, int16_t depth) const;
+            // Keep selected rows in sync when `removed` rows from `from` are replaced by `added` rows
+            void spliceRows(int32_t from, int32_t removed, int32_t added);
+            // Move selected rows to `moved[row]`, rows mapped to -1 are deselected
+            void permuteRows(const std::vector<int32_t>& moved);
+        } selections;
+
+        std::shared_ptr<ItemGridRowOrder> rowOrder; // Created if ItemGridConfig::cellkey is set
+        std::shared_ptr<const std::vector<int32_t>> displayedOrder; // Row order selections refer to
+        int32_t displayedRows = 0; // Row count when displayed order is identity
+        std::shared_ptr<ItemGridPageCache> pageCache; // Created if ItemGridConfig::datasource is set
         
         struct 
         {
@@ -270,20 +481,14 @@ namespace glimmer
             Vector<ColumnProps, int16_t, 32>{ false },
             Vector<ColumnProps, int16_t, 32>{ false },
         };
-        Vector<int32_t, int16_t> perDepthRowCount{ false };
+        Vector<float, int16_t, 32> colEnds{ false }; // Prefix sum of non-frozen column widths
+        std::pair<int16_t, int16_t> visibleCols{ 0, -1 }; // Visual columns of last level inside viewport (excl. frozen)
 
-        struct RowYToIndexMapping
-        {
-            float from, to = 0.f;
-            int32_t depth = 0; 
-            int32_t row = 0;
-        };
-        float currentY = 0.f, startY = 0.f;
-        Vector<RowYToIndexMapping, int32_t> rowYs{ false };
         ItemGridPersistentState::ItemId clickedItem;
+        std::shared_ptr<const std::vector<int32_t>> rowOrder; // Displayed to source rows, null implies identity
 
         Vector<std::pair<std::string_view, ItemDescendentVisualState>, int16_t, 32> cellvals{ false };
-        std::pair<ItemDescendentVisualState, int16_t> childState;
+        std::pair<ItemDescendentVisualState, int32_t> childState; // Of first column in current row, children are -1 if not built
         float headerHeights[GLIMMER_MAX_ITEMGRID_COLUMN_CATEGORY_LEVEL] = { 0.f, 0.f, 0.f, 0.f };
         int32_t currRow = 0, currCol = 0;
         WidgetDrawResult event;
@@ -298,30 +503,62 @@ namespace glimmer
     struct ToggleButtonPersistentState
     {
         float btnpos = -1.f;
-        float progress = 0.f;
+        int32_t track = -1; // Animation track, see anim::StartTrack
         bool animate = false;
     };
 
     struct RadioButtonPersistentState
     {
-        float progress = 0.f;
+        int32_t track = -1;
         bool animate = false;
     };
 
     struct CheckboxPersistentState
     {
-        float progress = -1.f;
+        int32_t track = -1;
         bool animate = false;
     };
 
     enum class TextOpType { Addition, Deletion, Replacement };
 
+    // An edit replacing `removed` bytes at `position` by `added` bytes, both payloads are stored
+    // back to back in undo log's arena starting at `offset`, removed bytes first
     struct TextInputOperation
     {
-        std::pair<int32_t, int32_t> range{ -1, -1 };
-        int32_t caretpos = 0;
-        char opmem[128] = { 0 };
-        TextOpType type;
+        int32_t position = 0;
+        int32_t removed = 0;
+        int32_t added = 0;
+        int32_t offset = 0;
+        int32_t caretpos = 0; // Caret position before the edit
+        TextOpType type = TextOpType::Addition;
+    };
+
+    // Undo/redo history of a text field. Payloads of all operations are in a single byte arena,
+    // consecutive single character edits are merged until a pause or word boundary, and oldest
+    // operations are evicted once the history exceeds its memory budget
+    struct TextUndoLog
+    {
+        std::vector<TextInputOperation> ops;
+        std::vector<char> arena;
+        int32_t pos = 0; // Operations before this are undoable, and from this are redoable
+        int32_t capacity = GLIMMER_TEXT_UNDO_CAPACITY; // Memory budget in bytes
+        float sinceLastEdit = FLT_MAX;
+
+        void tick(float deltaTime) { sinceLastEdit += deltaTime; }
+        void record(int32_t position, std::string_view removed, std::string_view added, int32_t caretpos);
+        const TextInputOperation* undo();
+        const TextInputOperation* redo();
+        void clear();
+
+        bool canUndo() const { return pos > 0; }
+        bool canRedo() const { return pos < (int32_t)ops.size(); }
+        std::string_view removed(const TextInputOperation& op) const { return { arena.data() + op.offset, (size_t)op.removed }; }
+        std::string_view added(const TextInputOperation& op) const { return { arena.data() + op.offset + op.removed, (size_t)op.added }; }
+        int32_t memory() const { return (int32_t)(ops.size() * sizeof(TextInputOperation) + arena.size()); }
+
+    private:
+
+        bool merge(int32_t position, std::string_view removed, std::string_view added);
     };
 
     struct InputTextPersistentState
@@ -335,8 +572,7 @@ namespace glimmer
         float lastClickTime = -1.f;
         ScrollableRegion scroll;
         Vector<float, int16_t> pixelpos; // Cumulative pixel position of characters
-        UndoRedoStack<TextInputOperation> ops; // Text operations for redo/undo stack
-        TextInputOperation currops;
+        TextUndoLog ops; // Text operations for redo/undo
 
         void moveLeft(float amount)
         {
@@ -349,6 +585,57 @@ namespace glimmer
         }
     };
 
+    // Text of multi-line editor in a gap buffer, the gap is moved to the edit position so that
+    // consecutive edits at nearby positions are cheap. Start offsets of lines are kept in two
+    // stacks split at last edit position, lines before it as offsets from start of text and lines
+    // after it as offsets from end of text, hence edits do not shift offsets of following lines.
+    struct TextEditorBuffer
+    {
+        std::vector<char> data;
+        int32_t gapStart = 0, gapEnd = 0;
+        std::vector<int32_t> head{ 0 }; // Line starts before split, ascending from start of text
+        std::vector<int32_t> tail; // Line starts after split, as distance from end, nearest last
+
+        int32_t size() const { return (int32_t)data.size() - (gapEnd - gapStart); }
+        char at(int32_t pos) const { return data[pos < gapStart ? pos : pos + gapEnd - gapStart]; }
+        int32_t lines() const { return (int32_t)(head.size() + tail.size()); }
+        int32_t lineStart(int32_t line) const;
+        int32_t lineEnd(int32_t line) const; // Offset of line's newline, or end of text
+        int32_t lineOf(int32_t pos) const;
+
+        void assign(std::string_view text);
+        void insert(int32_t pos, std::string_view text);
+        void erase(int32_t pos, int32_t count);
+        // Contiguous view of [from, to), copied to `scratch` only if range spans the gap
+        std::string_view view(int32_t from, int32_t to, std::string& scratch) const;
+
+    private:
+        void moveGap(int32_t pos, int32_t space);
+        void moveSplit(int32_t pos);
+    };
+
+    struct TextEditorPersistentState
+    {
+        TextEditorBuffer text;
+        int32_t caretpos = 0;
+        int32_t selectionStart = -1; // Anchor of selection, selection spans till caret position
+        float caretX = -1.f; // Horizontal caret position retained when moving across lines
+        float lastCaretShowTime = 0.f;
+        float lastClickTime = -1.f;
+        float maxLineWidth = 0.f; // Widest line measured so far, determines horizontal scroll extent
+        int32_t widestLine = -1; // Line measured as maxLineWidth, edits which may shorten it reset the width
+        bool caretVisible = true;
+        bool isSelecting = false;
+        ScrollableRegion scroll;
+        TextUndoLog ops;
+
+        // Advances of code points in current font, measured as lines are displayed
+        std::array<float, 128> advances;
+        std::unordered_map<uint32_t, float> wideAdvances;
+        void* font = nullptr;
+        float fontsz = 0.f;
+    };
+
     struct AdHocLayoutState
     {
         ImVec2 nextpos{ 0.f, 0.f }; // position of next widget
@@ -429,9 +716,11 @@ namespace glimmer
             int16_t state = 0;
             int16_t pos = -1;
             ImRect extent, close, pin, text, icon;
-            float tabHoverDuration = 0.f, pinHoverDuration = 0.f, closeHoverDuration = 0.f;
+            int32_t tabHoverTrack = -1, pinHoverTrack = -1, closeHoverTrack = -1; // Tooltip delays
             TabItemDescriptor descriptor;
             bool pinned = false;
+
+            void releaseTracks();
         };
 
         int16_t current = InvalidTabIndex;
@@ -443,7 +732,7 @@ namespace glimmer
         ImRect dropdown;
         ImRect expand;
         ImRect moveForward, moveBackward;
-        float createHoverDuration = 0.f;
+        int32_t createHoverTrack = -1;
         float lastRowStarty = 0.f;
         int32_t tabBeingDragged = -1;
         ImVec2 dragPosition{};
@@ -575,8 +864,10 @@ namespace glimmer
         ImVec2 maxdim{ 0.f, 0.f }; // max dimension of widget in curren row/col
         ImVec2 cumulative{ 0.f, 0.f }, size{};
         ImRect extent{}; // max coords of widgets inside layout
-        Vector<ImVec2, int16_t> rows{ false };
-        Vector<ImVec2, int16_t> cols{ false };
+        Vector<ImVec2, int16_t> rows{ false }; // Solved grid rows, x: offset from layout start, y: height
+        Vector<ImVec2, int16_t> cols{ false }; // Solved grid columns, x: offset from layout start, y: width
+        Vector<GridTrackSize, int16_t> rowTracks{ false };
+        Vector<GridTrackSize, int16_t> colTracks{ false };
         Vector<int16_t, int16_t> griditems{ false };
         std::pair<int, int> gridsz;
         std::pair<int16_t, int16_t> currspan{ 1, 1 };
@@ -587,6 +878,7 @@ namespace glimmer
         int32_t regionIdx = -1;
         void* implData = nullptr;
         bool popSizingOnEnd = false;
+        uint64_t fingerprint = 0; // Hash of layout parameters, child sizes and nested layout inputs
 
         Vector<std::pair<int32_t, LayoutOps>, int16_t> itemIndexes{ false };
         FixedSizeStack<int32_t, 16> containerStack;
@@ -600,6 +892,16 @@ namespace glimmer
         void reset();
     };
 
+    // Solver output of a layout from an earlier frame, reused as long as the
+    // fingerprint of the layout inputs stays the same
+    struct LayoutCacheEntry
+    {
+        uint64_t fingerprint = 0;
+        ImRect bounds; // Bounds of the layout node (implicit content size for grids)
+        std::vector<ImRect> layouts; // Bounds of nested layouts solved along with this layout
+        std::vector<ImRect> items; // Bounds of child widgets or grid cells, in order of addition
+    };
+
     void AddItemToLayout(LayoutBuilder& layout, LayoutItemDescriptor& item, const StyleDescriptor& style);
 
     // Determine extent of layout/splitter/other containers
@@ -679,6 +981,10 @@ namespace glimmer
                 ImRect padding, content;
             } media;
 
+            struct {
+                ImRect content;
+            } editor;
+
             ParamsT() {}
         } params;
 
@@ -704,9 +1010,36 @@ namespace glimmer
         static EventDeferInfo ForAccordion(int32_t id, const ImRect& region, int32_t ridx);
         static EventDeferInfo ForScrollRegion(int32_t id);
         static EventDeferInfo ForMediaResource(int32_t id, const ImRect& padding, const ImRect& content);
+        static EventDeferInfo ForTextEditor(int32_t id, const ImRect& content);
         static EventDeferInfo ForCustom(int32_t id);
     };
 
+    // Uniform grid over areas of deferred events, built once over all events deferred so far and
+    // queried for each dispatched range, so that mouse related dispatch only tests the events in the
+    // cell under mouse. Events without an area and the ones of engaged widgets are dispatched
+    // irrespective of mouse position. Small ranges are scanned linearly instead.
+    using EngagedWidgets = std::unordered_map<int32_t, bool>;
+
+    struct EventHitGrid
+    {
+        Vector<ImRect, int32_t> bounds{ false }; // Area of each deferred event
+        Vector<int32_t, int32_t> cells{ false }; // Start of each cell's entries
+        Vector<int32_t, int32_t> entries{ false }; // Event indices of each cell, in ascending order
+        Vector<int32_t, int32_t> always{ false }; // Events dispatched irrespective of mouse position
+        Vector<int32_t, int32_t> candidates{ false };
+        ImRect extent;
+        ImVec2 cellsz;
+        int32_t cols = 0, rows = 0;
+        int32_t built = 0; // Events covered by the grid, it is rebuilt if a range extends past them
+
+        void reset() { built = 0; }
+        void build(const Vector<EventDeferInfo, int16_t>& events, const EngagedWidgets& engaged);
+        // Events in [start, end) to dispatch, in order of deferral
+        const Vector<int32_t, int32_t>& query(ImVec2 mousepos, int32_t start, int32_t end);
+        const Vector<int32_t, int32_t>& scan(const Vector<EventDeferInfo, int16_t>& events, int32_t start, int32_t end,
+            ImVec2 mousepos, const EngagedWidgets& engaged);
+    };
+
     enum class NestedContextSourceType
     {
         None, Region, Layout, ItemGrid, // add others...
@@ -743,6 +1076,7 @@ namespace glimmer
 
     constexpr int32_t WidgetIndexMask = 0xffff;
     constexpr int32_t WidgetTypeBits = 16;
+    constexpr int32_t AllWidgetStates = (1 << WSI_Total) - 1;
 
     // Captures widget states, is stored as a linked-list, each context representing
     // a window or overlay, this enables serialized Id's for nested overlays as well
@@ -755,6 +1089,7 @@ namespace glimmer
         std::vector<RadioButtonPersistentState> radioStates;
         std::vector<CheckboxPersistentState> checkboxStates;
         std::vector<InputTextPersistentState> inputTextStates;
+        std::vector<TextEditorPersistentState> textEditorStates;
         std::vector<SplitterPersistentState> splitterStates;
         std::vector<SpinnerPersistentState> spinnerStates;
         std::vector<TabBarPersistentState> tabBarStates;
@@ -798,10 +1133,30 @@ namespace glimmer
         static DynamicStack<NavDrawerStyleDescriptor, int16_t, GLIMMER_MAX_WIDGET_SPECIFIC_STYLES> navDrawerStyles[WSI_Total];
 
         // Resolved styles, after applying widget, class(es) and id specific styles
-        Vector<StyleDescriptor[WSI_Total], int16_t, 32> WidgetStyles[WT_TotalTypes];
+        // Stored compactly, as most widgets specify few (if any) properties per state
+        Vector<CompactStyle[WSI_Total], int16_t, 32> WidgetStyles[WT_TotalTypes];
+
+        // Memoised result of GetStyle per widget and state, valid while the version i.e. combination
+        // of style stack and style sheet versions matches. Deque keeps returned references stable.
+        struct ResolvedStyle
+        {
+            StyleDescriptor style;
+            StyleStackT const* stack = nullptr;
+            uint64_t version = 0;
+        };
+
+        // Index of resolved style in resolvedStyles per widget and state, -1 if never resolved.
+        // Only queried states of a widget hold a full StyleDescriptor.
+        std::vector<std::array<int32_t, WSI_Total>> resolvedStyleIndices[WT_TotalTypes];
+        std::deque<ResolvedStyle> resolvedStyles;
+
+        // Style sheet selectors (classes followed by id) of widgets registered with them, used to
+        // recompute WidgetStyles of only the affected widgets when style sheet rules change
+        std::unordered_map<int32_t, std::vector<std::string_view>> widgetSelectors;
 
         // Layout related members
         Vector<LayoutItemDescriptor, int16_t> layoutItems{ 128 };
+        std::vector<LayoutCacheEntry> layoutCache; // Indexed by layout id's index
         Vector<ImRect, int16_t> itemGeometries[WT_TotalTypes]{
             Vector<ImRect, int16_t>{ true },
             Vector<ImRect, int16_t>{ true },
@@ -823,6 +1178,7 @@ namespace glimmer
             Vector<ImRect, int16_t>{ true },
             Vector<ImRect, int16_t>{ true },
             Vector<ImRect, int16_t>{ true },
+            Vector<ImRect, int16_t>{ true },
             Vector<ImRect, int16_t>{ true }
         };
         Vector<ImVec2, int16_t> itemSizes[WT_TotalTypes]{
@@ -846,6 +1202,7 @@ namespace glimmer
             Vector<ImVec2, int16_t>{ true },
             Vector<ImVec2, int16_t>{ true },
             Vector<ImVec2, int16_t>{ true },
+            Vector<ImVec2, int16_t>{ true },
             Vector<ImVec2, int16_t>{ true }
         };
         DynamicStack<int32_t, int16_t> containerStack{ 16 };
@@ -871,6 +1228,10 @@ namespace glimmer
         bool usingDeferred = false;
         bool deferEvents = false;
         Vector<EventDeferInfo, int16_t> deferedEvents;
+        EventHitGrid eventGrid;
+        // Widgets in an interaction or animation as of last dispatch, mapped to whether they were
+        // dispatched in current frame. The ones which were not are dropped at frame end.
+        EngagedWidgets engagedWidgets;
         IRenderer* deferedRenderer = nullptr;
 
         ImVec2 popupOrigin{ -1.f, -1.f }, popupSize{ -1.f, -1.f };
@@ -933,6 +1294,12 @@ namespace glimmer
             return inputTextStates[index];
         }
 
+        TextEditorPersistentState& TextEditorState(int32_t id)
+        {
+            auto index = id & WidgetIndexMask;
+            return textEditorStates[index];
+        }
+
         SplitterPersistentState& SplitterState(int32_t id)
         {
             auto index = id & WidgetIndexMask;
@@ -998,11 +1365,15 @@ namespace glimmer
         WidgetDrawResult HandleEvents(ImVec2 origin, int from = 0, int to = -1);
 
         void RegisterWidgetIdClass(WidgetType wt, int32_t index, const WidgetIdClasses& idClasses);
-        StyleDescriptor GetStyle(int32_t state, int32_t id);
+        void ComputeWidgetStyles(int32_t id, int32_t states = AllWidgetStates);
+        void InvalidateResolvedStyles(int32_t id, int32_t states = AllWidgetStates);
+        void InvalidateResolvedStyles(WidgetType wt, int32_t states = AllWidgetStates);
+        const StyleDescriptor& GetStyle(int32_t state, int32_t id);
         
         void RecordForReplay(int64_t data, LayoutOps ops);
         void ResetLayoutData();
         void ClearDeferredData();
+        void ClearDeferredEvents();
 
         const ImRect& GetGeometry(int32_t id) const;
         ImVec2 GetSize(int32_t id) const;
@@ -1014,6 +1385,7 @@ namespace glimmer
         ImVec2 NextAdHocPos() const;
 
         WidgetContextData();
+        ~WidgetContextData();
     };
 
     void AddFontPtr(FontStyle& font);
@@ -1024,7 +1396,13 @@ namespace glimmer
     void PopContext();
     void Cleanup();
 
-    StyleDescriptor GetStyle(WidgetContextData& context, int32_t id, StyleStackT const* StyleStack, int32_t state);
+    // Returned reference is valid until the next call for same widget id and state
+    const StyleDescriptor& GetStyle(WidgetContextData& context, int32_t id, StyleStackT const* StyleStack, int32_t state);
+
+    // Recomputes styles of widgets (in all contexts) registered with any of the selectors, and
+    // invalidates resolved styles of widget types whose names are among the selectors. Only the
+    // states in the mask (bit per WidgetStateIndex) of each selector are recomputed.
+    void InvalidateWidgetStyles(const std::vector<std::pair<std::string_view, int32_t>>& selectors);
 
     extern NestedContextSource InvalidSource;
 
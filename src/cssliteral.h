@@ -0,0 +1,1229 @@
+#pragma once
+
+#include "style.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+// CSS value grammar shared by the runtime CSS parser (style.cpp) and compile-time parsing of
+// CSS string literals. Compile-time parsing produces a StyleLiteral, a ready to apply style delta
+// where only lengths with relative units (em, %) and scaling are resolved at runtime i.e.
+//
+//      PushStyle(css<"background-color: rgb(240, 240, 240); border: 1px solid gray; padding: 5px">);
+//
+// Malformed CSS or properties not supported in literals fail compilation.
+
+namespace glimmer
+{
+    // Sub-properties written by a CSS snippet, StyleProperty is too coarse to apply a parsed
+    // snippet as a delta i.e. `padding-top` must not overwrite left/right/bottom padding.
+    enum CompiledStyleField : uint32_t
+    {
+        CSF_BgColor = 1,
+        CSF_Gradient = 1 << 1,
+        CSF_FgColor = 1 << 2,
+        CSF_FontSize = 1 << 3,
+        CSF_FontFamily = 1 << 4,
+        CSF_Width = 1 << 5,
+        CSF_Height = 1 << 6,
+        CSF_MinWidth = 1 << 7,
+        CSF_MinHeight = 1 << 8,
+        CSF_MaxWidth = 1 << 9,
+        CSF_MaxHeight = 1 << 10,
+        CSF_PaddingTop = 1 << 11,
+        CSF_PaddingLeft = 1 << 12,
+        CSF_PaddingRight = 1 << 13,
+        CSF_PaddingBottom = 1 << 14,
+        CSF_MarginTop = 1 << 15,
+        CSF_MarginLeft = 1 << 16,
+        CSF_MarginRight = 1 << 17,
+        CSF_MarginBottom = 1 << 18,
+        CSF_BorderTop = 1 << 19,
+        CSF_BorderLeft = 1 << 20,
+        CSF_BorderRight = 1 << 21,
+        CSF_BorderBottom = 1 << 22,
+        CSF_BorderThickness = 1 << 23,
+        CSF_BorderColor = 1 << 24,
+        CSF_BorderUniform = 1 << 25,
+        CSF_RadiusTopLeft = 1 << 26,
+        CSF_RadiusTopRight = 1 << 27,
+        CSF_RadiusBottomRight = 1 << 28,
+        CSF_RadiusBottomLeft = 1 << 29,
+        CSF_Shadow = 1 << 30,
+
+        CSF_Padding = CSF_PaddingTop | CSF_PaddingLeft | CSF_PaddingRight | CSF_PaddingBottom,
+        CSF_Margin = CSF_MarginTop | CSF_MarginLeft | CSF_MarginRight | CSF_MarginBottom,
+        CSF_BorderSides = CSF_BorderTop | CSF_BorderLeft | CSF_BorderRight | CSF_BorderBottom,
+        CSF_Radius = CSF_RadiusTopLeft | CSF_RadiusTopRight | CSF_RadiusBottomRight | CSF_RadiusBottomLeft
+    };
+
+    // =============================================================================================
+    // CSS VALUE GRAMMAR
+    // =============================================================================================
+
+    [[nodiscard]] constexpr bool IsCSSSpace(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\f' || ch == '\v';
+    }
+
+    [[nodiscard]] constexpr bool IsCSSDigit(char ch) { return ch >= '0' && ch <= '9'; }
+    [[nodiscard]] constexpr char ToLowerCSS(char ch) { return (ch >= 'A' && ch <= 'Z') ? (char)(ch - 'A' + 'a') : ch; }
+
+    [[nodiscard]] constexpr int SkipCSSSpace(std::string_view text, int from)
+    {
+        while ((from < (int)text.size()) && IsCSSSpace(text[from])) from++;
+        return from;
+    }
+
+    [[nodiscard]] constexpr std::string_view TrimCSS(std::string_view text)
+    {
+        auto start = SkipCSSSpace(text, 0);
+        auto end = (int)text.size();
+        while ((end > start) && IsCSSSpace(text[end - 1])) end--;
+        return text.substr(start, end - start);
+    }
+
+    // Case-insensitive comparison of ASCII CSS identifiers
+    [[nodiscard]] constexpr bool IsSameCSS(std::string_view lhs, std::string_view rhs)
+    {
+        if (lhs.size() != rhs.size()) return false;
+
+        for (auto idx = 0; idx < (int)lhs.size(); ++idx)
+            if (ToLowerCSS(lhs[idx]) != ToLowerCSS(rhs[idx]))
+                return false;
+
+        return true;
+    }
+
+    [[nodiscard]] constexpr bool StartsWithCSS(std::string_view lhs, std::string_view rhs)
+    {
+        return lhs.size() >= rhs.size() && IsSameCSS(lhs.substr(0, rhs.size()), rhs);
+    }
+
+    // =============================================================================================
+    // PERFECT HASHING OF CSS IDENTIFIERS
+    // =============================================================================================
+
+    // ASCII lowercase of 8 packed characters at once, bytes other than 'A'-'Z' are unchanged
+    [[nodiscard]] constexpr uint64_t FoldCSSCase(uint64_t word)
+    {
+        constexpr uint64_t Ones = 0x0101010101010101ull;
+        auto heptets = word & (0x7Full * Ones);
+        auto aboveZ = heptets + ((0x7Full - 'Z') * Ones); // High bit of byte set if byte > 'Z'
+        auto fromA = heptets + ((0x80ull - 'A') * Ones);  // High bit of byte set if byte >= 'A'
+        auto upper = fromA & ~aboveZ & ~word & (0x80ull * Ones);
+        return word | (upper >> 2u);
+    }
+
+    // Loads upto 8 characters starting at `from` as a little-endian word, zero padded
+    [[nodiscard]] constexpr uint64_t LoadCSSWord(std::string_view text, size_t from)
+    {
+        auto count = std::min<size_t>(text.size() - from, 8u);
+
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            if (!std::is_constant_evaluated() && count == 8u)
+            {
+                uint64_t word = 0;
+                std::memcpy(&word, text.data() + from, 8u);
+                return word;
+            }
+        }
+
+        uint64_t word = 0;
+        for (size_t idx = 0; idx < count; ++idx)
+            word |= (uint64_t)(unsigned char)text[from + idx] << (idx * 8u);
+        return word;
+    }
+
+    [[nodiscard]] constexpr uint64_t HashCSSIdentifier(std::string_view text)
+    {
+        uint64_t hash = 0x9E3779B97F4A7C15ull ^ (uint64_t)text.size();
+
+        for (size_t from = 0; from < text.size(); from += 8u)
+        {
+            hash = (hash ^ FoldCSSCase(LoadCSSWord(text, from))) * 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 29u;
+        }
+
+        return hash;
+    }
+
+    // Same as IsSameCSS, compares 8 characters at a time
+    [[nodiscard]] constexpr bool IsSameCSSIdentifier(std::string_view lhs, std::string_view rhs)
+    {
+        if (lhs.size() != rhs.size()) return false;
+
+        for (size_t from = 0; from < lhs.size(); from += 8u)
+            if (FoldCSSCase(LoadCSSWord(lhs, from)) != FoldCSSCase(LoadCSSWord(rhs, from)))
+                return false;
+
+        return true;
+    }
+
+    // Deliberately not constexpr, calling it while building a table fails compilation
+    inline void InvalidCSSPerfectHash(const char*) {}
+
+    // Case-insensitive map of N identifiers with no collisions, built at compile time by "hash and
+    // displace": identifiers are grouped into buckets and each bucket gets a displacement that places
+    // all of its identifiers in free slots. Lookup is one hash, one displacement and one comparison.
+    template <typename ValueT, size_t N>
+    struct CSSPerfectHash
+    {
+        static constexpr size_t TotalBuckets = (N + 2u) / 3u;
+        static constexpr size_t TotalSlots = std::bit_ceil(N + (N / 2u));
+
+        struct Entry
+        {
+            std::string_view key;
+            ValueT value{};
+        };
+
+        Entry slots[TotalSlots]{};
+        uint16_t displacements[TotalBuckets]{};
+
+        consteval CSSPerfectHash(const std::pair<std::string_view, ValueT>(&entries)[N])
+        {
+            uint64_t hashes[N]{};
+            size_t bucketSizes[TotalBuckets]{};
+            size_t maxBucketSize = 0;
+            bool used[TotalSlots]{};
+
+            for (size_t idx = 0; idx < N; ++idx)
+            {
+                hashes[idx] = HashCSSIdentifier(entries[idx].first);
+                auto& size = bucketSizes[hashes[idx] % TotalBuckets];
+                maxBucketSize = std::max(maxBucketSize, ++size);
+            }
+
+            // Largest buckets are the hardest to place, hence are placed first
+            for (auto size = maxBucketSize; size > 0u; --size)
+            {
+                for (size_t bucket = 0; bucket < TotalBuckets; ++bucket)
+                {
+                    if (bucketSizes[bucket] != size) continue;
+
+                    auto placed = false;
+                    for (uint32_t displacement = 0; !placed && displacement <= UINT16_MAX; ++displacement)
+                    {
+                        size_t slotsTaken[N]{};
+                        size_t count = 0;
+                        placed = true;
+
+                        for (size_t idx = 0; placed && idx < N; ++idx)
+                        {
+                            if (hashes[idx] % TotalBuckets != bucket) continue;
+
+                            auto slot = Slot(hashes[idx], displacement);
+                            placed = !used[slot];
+                            for (size_t prev = 0; placed && prev < count; ++prev)
+                                placed = slotsTaken[prev] != slot;
+                            slotsTaken[count++] = slot;
+                        }
+
+                        if (placed)
+                        {
+                            displacements[bucket] = (uint16_t)displacement;
+
+                            for (size_t idx = 0; idx < N; ++idx)
+                            {
+                                if (hashes[idx] % TotalBuckets != bucket) continue;
+
+                                auto slot = Slot(hashes[idx], displacement);
+                                used[slot] = true;
+                                slots[slot] = Entry{ entries[idx].first, entries[idx].second };
+                            }
+                        }
+                    }
+
+                    if (!placed) InvalidCSSPerfectHash("duplicate identifiers in table");
+                }
+            }
+        }
+
+        [[nodiscard]] static constexpr size_t Slot(uint64_t hash, uint32_t displacement)
+        {
+            auto mixed = (hash ^ (displacement * 0x9E3779B97F4A7C15ull)) * 0xD6E8FEB86659FD93ull;
+            return (size_t)(mixed >> 32u) & (TotalSlots - 1u);
+        }
+
+        [[nodiscard]] constexpr const ValueT* find(std::string_view key) const
+        {
+            if (key.empty()) return nullptr;
+
+            auto hash = HashCSSIdentifier(key);
+            const auto& entry = slots[Slot(hash, displacements[hash % TotalBuckets])];
+            return IsSameCSSIdentifier(entry.key, key) ? &entry.value : nullptr;
+        }
+    };
+
+    // Properties supported by runtime CSS parsing (style.cpp) and CSS literals
+    enum class CSSProperty : uint8_t
+    {
+        Unknown, FontSize, FontFamily, FontWeight, FontStyle, TextWrap, TextOverflow, Background,
+        BackgroundColor, Color, Width, Height, MinWidth, MinHeight, MaxWidth, MaxHeight, Alignment,
+        TextAlign, VerticalAlign, Padding, PaddingTop, PaddingLeft, PaddingRight, PaddingBottom,
+        Margin, MarginTop, MarginLeft, MarginRight, MarginBottom, Border, BorderTop, BorderLeft,
+        BorderRight, BorderBottom, BorderWidth, BorderColor, BorderRadius, BorderTopLeftRadius,
+        BorderTopRightRadius, BorderBottomRightRadius, BorderBottomLeftRadius, BoxShadow,
+        ThumbColor, TrackColor, TrackOutline, ThumbOffset
+    };
+
+    inline constexpr std::pair<std::string_view, CSSProperty> CSSPropertyNames[] = {
+        { "font-size", CSSProperty::FontSize },
+        { "font-family", CSSProperty::FontFamily },
+        { "font-weight", CSSProperty::FontWeight },
+        { "font-style", CSSProperty::FontStyle },
+        { "text-wrap", CSSProperty::TextWrap },
+        { "text-overflow", CSSProperty::TextOverflow },
+        { "background", CSSProperty::Background },
+        { "background-color", CSSProperty::BackgroundColor },
+        { "color", CSSProperty::Color },
+        { "width", CSSProperty::Width },
+        { "height", CSSProperty::Height },
+        { "min-width", CSSProperty::MinWidth },
+        { "min-height", CSSProperty::MinHeight },
+        { "max-width", CSSProperty::MaxWidth },
+        { "max-height", CSSProperty::MaxHeight },
+        { "alignment", CSSProperty::Alignment },
+        { "text-align", CSSProperty::TextAlign },
+        { "vertical-align", CSSProperty::VerticalAlign },
+        { "padding", CSSProperty::Padding },
+        { "padding-top", CSSProperty::PaddingTop },
+        { "padding-left", CSSProperty::PaddingLeft },
+        { "padding-right", CSSProperty::PaddingRight },
+        { "padding-bottom", CSSProperty::PaddingBottom },
+        { "margin", CSSProperty::Margin },
+        { "margin-top", CSSProperty::MarginTop },
+        { "margin-left", CSSProperty::MarginLeft },
+        { "margin-right", CSSProperty::MarginRight },
+        { "margin-bottom", CSSProperty::MarginBottom },
+        { "border", CSSProperty::Border },
+        { "border-top", CSSProperty::BorderTop },
+        { "border-left", CSSProperty::BorderLeft },
+        { "border-right", CSSProperty::BorderRight },
+        { "border-bottom", CSSProperty::BorderBottom },
+        { "border-width", CSSProperty::BorderWidth },
+        { "border-color", CSSProperty::BorderColor },
+        { "border-radius", CSSProperty::BorderRadius },
+        { "border-top-left-radius", CSSProperty::BorderTopLeftRadius },
+        { "border-top-right-radius", CSSProperty::BorderTopRightRadius },
+        { "border-bottom-right-radius", CSSProperty::BorderBottomRightRadius },
+        { "border-bottom-left-radius", CSSProperty::BorderBottomLeftRadius },
+        { "box-shadow", CSSProperty::BoxShadow },
+        { "thumb-color", CSSProperty::ThumbColor },
+        { "track-color", CSSProperty::TrackColor },
+        { "track-outline", CSSProperty::TrackOutline },
+        { "thumb-offset", CSSProperty::ThumbOffset }
+    };
+
+    inline constexpr CSSPerfectHash<CSSProperty, std::size(CSSPropertyNames)> CSSPropertyTable{ CSSPropertyNames };
+
+    [[nodiscard]] constexpr CSSProperty GetCSSProperty(std::string_view name)
+    {
+        auto property = CSSPropertyTable.find(name);
+        return property != nullptr ? *property : CSSProperty::Unknown;
+    }
+
+    // Keyword values of the properties above
+    enum class CSSKeyword : uint8_t
+    {
+        Unknown, XXSmall, XSmall, Small, Medium, Large, XLarge, XXLarge, XXXLarge, Bold, Light,
+        Normal, Italic, Oblique, NoWrap, Ellipsis, Justify, Left, Right, Center, Top, Bottom,
+        None, Solid, Dashed, Dotted, Transparent
+    };
+
+    inline constexpr std::pair<std::string_view, CSSKeyword> CSSKeywordNames[] = {
+        { "xx-small", CSSKeyword::XXSmall },
+        { "x-small", CSSKeyword::XSmall },
+        { "small", CSSKeyword::Small },
+        { "medium", CSSKeyword::Medium },
+        { "large", CSSKeyword::Large },
+        { "x-large", CSSKeyword::XLarge },
+        { "xx-large", CSSKeyword::XXLarge },
+        { "xxx-large", CSSKeyword::XXXLarge },
+        { "bold", CSSKeyword::Bold },
+        { "light", CSSKeyword::Light },
+        { "normal", CSSKeyword::Normal },
+        { "italic", CSSKeyword::Italic },
+        { "oblique", CSSKeyword::Oblique },
+        { "nowrap", CSSKeyword::NoWrap },
+        { "ellipsis", CSSKeyword::Ellipsis },
+        { "justify", CSSKeyword::Justify },
+        { "left", CSSKeyword::Left },
+        { "right", CSSKeyword::Right },
+        { "center", CSSKeyword::Center },
+        { "top", CSSKeyword::Top },
+        { "bottom", CSSKeyword::Bottom },
+        { "none", CSSKeyword::None },
+        { "solid", CSSKeyword::Solid },
+        { "dashed", CSSKeyword::Dashed },
+        { "dotted", CSSKeyword::Dotted },
+        { "transparent", CSSKeyword::Transparent }
+    };
+
+    inline constexpr CSSPerfectHash<CSSKeyword, std::size(CSSKeywordNames)> CSSKeywordTable{ CSSKeywordNames };
+
+    [[nodiscard]] constexpr CSSKeyword GetCSSKeyword(std::string_view value)
+    {
+        auto keyword = CSSKeywordTable.find(value);
+        return keyword != nullptr ? *keyword : CSSKeyword::Unknown;
+    }
+
+    // Returns end of the token starting at `from`, tokens end at whitespace, `sep` or an unmatched
+    // closing paranthesis. Parenthesized content is part of the token i.e. rgb(0, 0, 0)
+    [[nodiscard]] constexpr int NextCSSToken(std::string_view text, int from, char sep = ' ')
+    {
+        auto depth = 0;
+
+        while (from < (int)text.size())
+        {
+            auto ch = text[from];
+            if (ch == '(') depth++;
+            else if (ch == ')') { if (depth == 0) break; depth--; }
+            else if ((depth == 0) && (IsCSSSpace(ch) || ch == sep)) break;
+            from++;
+        }
+
+        return from;
+    }
+
+    struct CSSNumber
+    {
+        float value = 0.f;
+        bool isFloat = false;
+        bool valid = false;
+        int end = 0; // Index past the number
+    };
+
+    [[nodiscard]] constexpr CSSNumber ParseCSSNumber(std::string_view input, int from = 0)
+    {
+        CSSNumber result;
+        auto idx = from;
+        auto sign = 1.f;
+
+        if ((idx < (int)input.size()) && (input[idx] == '-' || input[idx] == '+'))
+        {
+            sign = input[idx] == '-' ? -1.f : 1.f;
+            idx++;
+        }
+
+        for (; (idx < (int)input.size()) && IsCSSDigit(input[idx]); ++idx)
+        {
+            result.value = (result.value * 10.f) + (float)(input[idx] - '0');
+            result.valid = true;
+        }
+
+        if ((idx < (int)input.size()) && input[idx] == '.')
+        {
+            auto base = 0.1f;
+            result.isFloat = true;
+
+            for (++idx; (idx < (int)input.size()) && IsCSSDigit(input[idx]); ++idx)
+            {
+                result.value += (float)(input[idx] - '0') * base;
+                result.valid = true;
+                base *= 0.1f;
+            }
+        }
+
+        result.value *= sign;
+        result.end = idx;
+        return result;
+    }
+
+    enum class CSSUnit : uint8_t
+    {
+        Pixel, Point, Em, Percent
+    };
+
+    struct CSSLength
+    {
+        float value = 0.f;
+        CSSUnit unit = CSSUnit::Pixel;
+        bool valid = false;
+    };
+
+    // Parses a number with an optional unit suffix (px, pt, em or %), unitless values are pixels
+    [[nodiscard]] constexpr CSSLength ParseCSSLength(std::string_view input)
+    {
+        input = TrimCSS(input);
+        auto num = ParseCSSNumber(input);
+        if (!num.valid) return CSSLength{};
+
+        auto suffix = input.substr(num.end);
+        CSSLength result{ num.value, CSSUnit::Pixel, true };
+
+        if (suffix.empty() || IsSameCSS(suffix, "px")) result.unit = CSSUnit::Pixel;
+        else if (IsSameCSS(suffix, "pt")) result.unit = CSSUnit::Point;
+        else if (IsSameCSS(suffix, "em")) result.unit = CSSUnit::Em;
+        else if (suffix == "%") result.unit = CSSUnit::Percent;
+        else result.valid = false;
+
+        return result;
+    }
+
+    // Pixel values are multiplied by `scale`, em values by `ems` and percentages by `parent`
+    [[nodiscard]] constexpr float ResolveCSSLength(CSSLength length, float ems, float parent, float scale)
+    {
+        switch (length.unit)
+        {
+        case CSSUnit::Point: return length.value * 1.3333f;
+        case CSSUnit::Em: return length.value * ems;
+        case CSSUnit::Percent: return length.value * parent * 0.01f;
+        default: return length.value * scale;
+        }
+    }
+
+    struct CSSFourSided
+    {
+        CSSLength top, left, right, bottom;
+        int count = 0; // Number of values specified, 0 if invalid
+    };
+
+    // Parses 1-4 lengths as per CSS shorthand i.e. "top+bottom left+right" for 2 values
+    [[nodiscard]] constexpr CSSFourSided ParseCSSFourSided(std::string_view input)
+    {
+        CSSFourSided result;
+        CSSLength values[4]{};
+        auto idx = SkipCSSSpace(input, 0);
+
+        while (idx < (int)input.size())
+        {
+            if (result.count == 4) return CSSFourSided{};
+
+            auto start = idx;
+            idx = NextCSSToken(input, idx);
+            if (idx == start) return CSSFourSided{};
+
+            values[result.count] = ParseCSSLength(input.substr(start, idx - start));
+            if (!values[result.count].valid) return CSSFourSided{};
+
+            result.count++;
+            idx = SkipCSSSpace(input, idx);
+        }
+
+        switch (result.count)
+        {
+        case 1: result.top = result.left = result.right = result.bottom = values[0]; break;
+        case 2: result.top = result.bottom = values[0]; result.left = result.right = values[1]; break;
+        case 3: result.top = values[0]; result.left = result.right = values[1]; result.bottom = values[2]; break;
+        case 4: result.top = values[0]; result.right = values[1]; result.bottom = values[2]; result.left = values[3]; break;
+        default: break;
+        }
+
+        return result;
+    }
+
+    struct CSSColor
+    {
+        uint32_t value = 0;
+        bool valid = false;
+    };
+
+    [[nodiscard]] constexpr int ParseCSSHexDigit(char ch)
+    {
+        return IsCSSDigit(ch) ? ch - '0' : (ToLowerCSS(ch) >= 'a' && ToLowerCSS(ch) <= 'f') ?
+            ToLowerCSS(ch) - 'a' + 10 : -1;
+    }
+
+    // Parses #rgb, #rgba, #rrggbb and #rrggbbaa colors
+    [[nodiscard]] constexpr CSSColor ParseCSSHexColor(std::string_view input)
+    {
+        if (input.empty() || input[0] != '#') return CSSColor{};
+
+        int digits[8]{};
+        auto count = (int)input.size() - 1;
+        if (count != 3 && count != 4 && count != 6 && count != 8) return CSSColor{};
+
+        for (auto idx = 0; idx < count; ++idx)
+        {
+            digits[idx] = ParseCSSHexDigit(input[idx + 1]);
+            if (digits[idx] == -1) return CSSColor{};
+        }
+
+        if (count <= 4)
+            return CSSColor{ ToRGBA(digits[0] * 17, digits[1] * 17, digits[2] * 17, 
+                count == 4 ? digits[3] * 17 : 255), true };
+
+        return CSSColor{ ToRGBA(digits[0] * 16 + digits[1], digits[2] * 16 + digits[3], digits[4] * 16 + digits[5],
+            count == 8 ? digits[6] * 16 + digits[7] : 255), true };
+    }
+
+    // Parses rgb(r, g, b) and rgba(r, g, b, a) colors. Channels are either all integers in [0, 255]
+    // or all fractions in [0, 1], alpha is a fraction if it has a decimal point
+    [[nodiscard]] constexpr CSSColor ParseCSSRGBColor(std::string_view input)
+    {
+        if (!StartsWithCSS(input, "rgb")) return CSSColor{};
+
+        auto idx = StartsWithCSS(input, "rgba") ? 4 : 3;
+        idx = SkipCSSSpace(input, idx);
+        if ((idx >= (int)input.size()) || input[idx] != '(') return CSSColor{};
+
+        CSSNumber channels[4]{};
+        auto count = 0;
+        idx++;
+
+        while (count < 4)
+        {
+            idx = SkipCSSSpace(input, idx);
+            channels[count] = ParseCSSNumber(input, idx);
+            if (!channels[count].valid) return CSSColor{};
+
+            idx = channels[count].end;
+            if ((idx < (int)input.size()) && input[idx] == '%')
+            {
+                channels[count].value *= 0.01f;
+                channels[count].isFloat = true;
+                idx++;
+            }
+
+            count++;
+            idx = SkipCSSSpace(input, idx);
+            if ((idx < (int)input.size()) && input[idx] == ',') idx++;
+            else break;
+        }
+
+        if ((count < 3) || (idx >= (int)input.size()) || input[idx] != ')' ||
+            (SkipCSSSpace(input, idx + 1) != (int)input.size())) return CSSColor{};
+
+        auto isRelative = channels[0].isFloat && channels[1].isFloat && channels[2].isFloat;
+        auto alpha = count == 4 ? (channels[3].isFloat ? channels[3].value * 255.f : channels[3].value) : 255.f;
+        return isRelative ? CSSColor{ ToRGBA((int)(channels[0].value * 255.f), (int)(channels[1].value * 255.f),
+            (int)(channels[2].value * 255.f), (int)alpha), true } :
+            CSSColor{ ToRGBA((int)channels[0].value, (int)channels[1].value, (int)channels[2].value, (int)alpha), true };
+    }
+
+    // CSS named colors
+    inline constexpr std::pair<std::string_view, uint32_t> CSSNamedColors[] = {
+        { "black", ToRGBA(0, 0, 0) },
+        { "silver", ToRGBA(192, 192, 192) },
+        { "gray", ToRGBA(128, 128, 128) },
+        { "white", ToRGBA(255, 255, 255) },
+        { "maroon", ToRGBA(128, 0, 0) },
+        { "red", ToRGBA(255, 0, 0) },
+        { "purple", ToRGBA(128, 0, 128) },
+        { "fuchsia", ToRGBA(255, 0, 255) },
+        { "green", ToRGBA(0, 128, 0) },
+        { "lime", ToRGBA(0, 255, 0) },
+        { "olive", ToRGBA(128, 128, 0) },
+        { "yellow", ToRGBA(255, 255, 0) },
+        { "navy", ToRGBA(0, 0, 128) },
+        { "blue", ToRGBA(0, 0, 255) },
+        { "teal", ToRGBA(0, 128, 128) },
+        { "aqua", ToRGBA(0, 255, 255) },
+        { "aliceblue", ToRGBA(240, 248, 255) },
+        { "antiquewhite", ToRGBA(250, 235, 215) },
+        { "aquamarine", ToRGBA(127, 255, 212) },
+        { "azure", ToRGBA(240, 255, 255) },
+        { "beige", ToRGBA(245, 245, 220) },
+        { "bisque", ToRGBA(255, 228, 196) },
+        { "blanchedalmond", ToRGBA(255, 235, 205) },
+        { "blueviolet", ToRGBA(138, 43, 226) },
+        { "brown", ToRGBA(165, 42, 42) },
+        { "burlywood", ToRGBA(222, 184, 135) },
+        { "cadetblue", ToRGBA(95, 158, 160) },
+        { "chartreuse", ToRGBA(127, 255, 0) },
+        { "chocolate", ToRGBA(210, 105, 30) },
+        { "coral", ToRGBA(255, 127, 80) },
+        { "cornflowerblue", ToRGBA(100, 149, 237) },
+        { "cornsilk", ToRGBA(255, 248, 220) },
+        { "crimson", ToRGBA(220, 20, 60) },
+        { "darkblue", ToRGBA(0, 0, 139) },
+        { "darkcyan", ToRGBA(0, 139, 139) },
+        { "darkgoldenrod", ToRGBA(184, 134, 11) },
+        { "darkgray", ToRGBA(169, 169, 169) },
+        { "darkgreen", ToRGBA(0, 100, 0) },
+        { "darkgrey", ToRGBA(169, 169, 169) },
+        { "darkkhaki", ToRGBA(189, 183, 107) },
+        { "darkmagenta", ToRGBA(139, 0, 139) },
+        { "darkolivegreen", ToRGBA(85, 107, 47) },
+        { "darkorange", ToRGBA(255, 140, 0) },
+        { "darkorchid", ToRGBA(153, 50, 204) },
+        { "darkred", ToRGBA(139, 0, 0) },
+        { "darksalmon", ToRGBA(233, 150, 122) },
+        { "darkseagreen", ToRGBA(143, 188, 143) },
+        { "darkslateblue", ToRGBA(72, 61, 139) },
+        { "darkslategray", ToRGBA(47, 79, 79) },
+        { "darkslategrey", ToRGBA(47, 79, 79) },
+        { "darkturquoise", ToRGBA(0, 206, 209) },
+        { "darkviolet", ToRGBA(148, 0, 211) },
+        { "deeppink", ToRGBA(255, 20, 147) },
+        { "deepskyblue", ToRGBA(0, 191, 255) },
+        { "dimgray", ToRGBA(105, 105, 105) },
+        { "dimgrey", ToRGBA(105, 105, 105) },
+        { "dodgerblue", ToRGBA(30, 144, 255) },
+        { "firebrick", ToRGBA(178, 34, 34) },
+        { "floralwhite", ToRGBA(255, 250, 240) },
+        { "forestgreen", ToRGBA(34, 139, 34) },
+        { "gainsboro", ToRGBA(220, 220, 220) },
+        { "ghoshtwhite", ToRGBA(248, 248, 255) },
+        { "gold", ToRGBA(255, 215, 0) },
+        { "goldenrod", ToRGBA(218, 165, 32) },
+        { "greenyellow", ToRGBA(173, 255, 47) },
+        { "honeydew", ToRGBA(240, 255, 240) },
+        { "hotpink", ToRGBA(255, 105, 180) },
+        { "indianred", ToRGBA(205, 92, 92) },
+        { "indigo", ToRGBA(75, 0, 130) },
+        { "ivory", ToRGBA(255, 255, 240) },
+        { "khaki", ToRGBA(240, 230, 140) },
+        { "lavender", ToRGBA(230, 230, 250) },
+        { "lavenderblush", ToRGBA(255, 240, 245) },
+        { "lawngreen", ToRGBA(124, 252, 0) },
+        { "lemonchiffon", ToRGBA(255, 250, 205) },
+        { "lightblue", ToRGBA(173, 216, 230) },
+        { "lightcoral", ToRGBA(240, 128, 128) },
+        { "lightcyan", ToRGBA(224, 255, 255) },
+        { "lightgoldenrodyellow", ToRGBA(250, 250, 210) },
+        { "lightgray", ToRGBA(211, 211, 211) },
+        { "lightgreen", ToRGBA(144, 238, 144) },
+        { "lightgrey", ToRGBA(211, 211, 211) },
+        { "lightpink", ToRGBA(255, 182, 193) },
+        { "lightsalmon", ToRGBA(255, 160, 122) },
+        { "lightseagreen", ToRGBA(32, 178, 170) },
+        { "lightskyblue", ToRGBA(135, 206, 250) },
+        { "lightslategray", ToRGBA(119, 136, 153) },
+        { "lightslategrey", ToRGBA(119, 136, 153) },
+        { "lightsteelblue", ToRGBA(176, 196, 222) },
+        { "lightyellow", ToRGBA(255, 255, 224) },
+        { "lilac", ToRGBA(200, 162, 200) },
+        { "limegreen", ToRGBA(50, 255, 50) },
+        { "linen", ToRGBA(250, 240, 230) },
+        { "mediumaquamarine", ToRGBA(102, 205, 170) },
+        { "mediumblue", ToRGBA(0, 0, 205) },
+        { "mediumorchid", ToRGBA(186, 85, 211) },
+        { "mediumpurple", ToRGBA(147, 112, 219) },
+        { "mediumseagreen", ToRGBA(60, 179, 113) },
+        { "mediumslateblue", ToRGBA(123, 104, 238) },
+        { "mediumspringgreen", ToRGBA(0, 250, 154) },
+        { "mediumturquoise", ToRGBA(72, 209, 204) },
+        { "mediumvioletred", ToRGBA(199, 21, 133) },
+        { "midnightblue", ToRGBA(25, 25, 112) },
+        { "mintcream", ToRGBA(245, 255, 250) },
+        { "mistyrose", ToRGBA(255, 228, 225) },
+        { "moccasin", ToRGBA(255, 228, 181) },
+        { "navajowhite", ToRGBA(255, 222, 173) },
+        { "oldlace", ToRGBA(253, 245, 230) },
+        { "olivedrab", ToRGBA(107, 142, 35) },
+        { "orange", ToRGBA(255, 165, 0) },
+        { "orangered", ToRGBA(255, 69, 0) },
+        { "orchid", ToRGBA(218, 112, 214) },
+        { "palegoldenrod", ToRGBA(238, 232, 170) },
+        { "palegreen", ToRGBA(152, 251, 152) },
+        { "paleturquoise", ToRGBA(175, 238, 238) },
+        { "palevioletred", ToRGBA(219, 112, 147) },
+        { "papayawhip", ToRGBA(255, 239, 213) },
+        { "peachpuff", ToRGBA(255, 218, 185) },
+        { "peru", ToRGBA(205, 133, 63) },
+        { "pink", ToRGBA(255, 192, 203) },
+        { "plum", ToRGBA(221, 160, 221) },
+        { "powderblue", ToRGBA(176, 224, 230) },
+        { "rosybrown", ToRGBA(188, 143, 143) },
+        { "royalblue", ToRGBA(65, 105, 225) },
+        { "saddlebrown", ToRGBA(139, 69, 19) },
+        { "salmon", ToRGBA(250, 128, 114) },
+        { "sandybrown", ToRGBA(244, 164, 96) },
+        { "seagreen", ToRGBA(46, 139, 87) },
+        { "seashell", ToRGBA(255, 245, 238) },
+        { "sienna", ToRGBA(160, 82, 45) },
+        { "skyblue", ToRGBA(135, 206, 235) },
+        { "slateblue", ToRGBA(106, 90, 205) },
+        { "slategray", ToRGBA(112, 128, 144) },
+        { "slategrey", ToRGBA(112, 128, 144) },
+        { "snow", ToRGBA(255, 250, 250) },
+        { "springgreen", ToRGBA(0, 255, 127) },
+        { "steelblue", ToRGBA(70, 130, 180) },
+        { "tan", ToRGBA(210, 180, 140) },
+        { "thistle", ToRGBA(216, 191, 216) },
+        { "tomato", ToRGBA(255, 99, 71) },
+        { "violet", ToRGBA(238, 130, 238) },
+        { "wheat", ToRGBA(245, 222, 179) },
+        { "whitesmoke", ToRGBA(245, 245, 245) },
+        { "yellowgreen", ToRGBA(154, 205, 50) }
+    };
+
+    inline constexpr CSSPerfectHash<uint32_t, std::size(CSSNamedColors)> CSSNamedColorTable{ CSSNamedColors };
+
+    [[nodiscard]] constexpr CSSColor ParseCSSNamedColor(std::string_view input)
+    {
+        if (auto color = CSSNamedColorTable.find(input); color != nullptr) return CSSColor{ *color, true };
+        else if (GetCSSKeyword(input) == CSSKeyword::Transparent) return CSSColor{ ToRGBA(0, 0, 0, 0), true };
+        return CSSColor{};
+    }
+
+    // Parses hex, rgb/rgba and (optionally) named colors, hsl/hsv are only supported at runtime
+    [[nodiscard]] constexpr CSSColor ParseCSSColor(std::string_view input, bool named = true)
+    {
+        input = TrimCSS(input);
+        if (input.empty()) return CSSColor{};
+        else if (input[0] == '#') return ParseCSSHexColor(input);
+        else if (StartsWithCSS(input, "rgb")) return ParseCSSRGBColor(input);
+        else if (IsSameCSS(input, "transparent")) return CSSColor{ ToRGBA(0, 0, 0, 0), true };
+        else if (named) return ParseCSSNamedColor(input);
+        return CSSColor{};
+    }
+
+    struct CSSBorder
+    {
+        CSSLength thickness{ 1.f, CSSUnit::Pixel, true };
+        LineType lineType = LineType::Solid;
+        std::string_view color; // Empty if not specified
+        bool none = false;
+        bool valid = true;
+    };
+
+    // Parses `<width> <line-type> <color>` in any order, or `none`
+    [[nodiscard]] constexpr CSSBorder ParseCSSBorder(std::string_view input)
+    {
+        CSSBorder result;
+        auto idx = SkipCSSSpace(input, 0);
+
+        while (idx < (int)input.size())
+        {
+            auto start = idx;
+            idx = NextCSSToken(input, idx);
+            if (idx == start) { result.valid = false; break; }
+
+            auto token = input.substr(start, idx - start);
+            auto keyword = GetCSSKeyword(token);
+            if (keyword == CSSKeyword::None) result.none = true;
+            else if (keyword == CSSKeyword::Solid) result.lineType = LineType::Solid;
+            else if (keyword == CSSKeyword::Dashed) result.lineType = LineType::Dashed;
+            else if (keyword == CSSKeyword::Dotted) result.lineType = LineType::Dotted;
+            else if (IsCSSDigit(token[0]) || token[0] == '.' || token[0] == '-' || token[0] == '+')
+            {
+                result.thickness = ParseCSSLength(token);
+                result.valid = result.valid && result.thickness.valid;
+            }
+            else result.color = token;
+
+            idx = SkipCSSSpace(input, idx);
+        }
+
+        return result;
+    }
+
+    struct CSSLinearGradient
+    {
+        std::pair<std::string_view, float> stops[GLIMMER_MAX_COLORSTOPS + 1]; // color and position (-1 if absent)
+        int totalStops = 0;
+        float angleDegrees = 0.f;
+        ImGuiDir dir = ImGuiDir::ImGuiDir_Down;
+        bool valid = false;
+    };
+
+    // Parses linear-gradient([to <side> | <angle>deg,] <color> [<percent>], ...)
+    [[nodiscard]] constexpr CSSLinearGradient ParseCSSLinearGradient(std::string_view input)
+    {
+        CSSLinearGradient result{};
+        input = TrimCSS(input);
+        if (!StartsWithCSS(input, "linear-gradient")) return result;
+
+        auto idx = SkipCSSSpace(input, 15); // size of "linear-gradient" string
+        if ((idx >= (int)input.size()) || input[idx] != '(') return result;
+        idx++;
+
+        auto firstPart = true;
+        while (idx < (int)input.size())
+        {
+            idx = SkipCSSSpace(input, idx);
+            auto start = idx;
+            idx = NextCSSToken(input, idx, ',');
+            auto color = input.substr(start, idx - start);
+            if (color.empty()) return result;
+
+            idx = SkipCSSSpace(input, idx);
+            if (firstPart && IsSameCSS(color, "to"))
+            {
+                start = idx;
+                idx = NextCSSToken(input, idx, ',');
+                auto side = input.substr(start, idx - start);
+
+                if (IsSameCSS(side, "right")) result.dir = ImGuiDir::ImGuiDir_Right;
+                else if (IsSameCSS(side, "left")) result.dir = ImGuiDir::ImGuiDir_Left;
+                else if (IsSameCSS(side, "top")) result.dir = ImGuiDir::ImGuiDir_Up;
+                else if (IsSameCSS(side, "bottom")) result.dir = ImGuiDir::ImGuiDir_Down;
+                else return result;
+            }
+            else if (firstPart && (IsCSSDigit(color[0]) || color[0] == '-') && color.size() > 3u &&
+                IsSameCSS(color.substr(color.size() - 3u), "deg"))
+            {
+                auto angle = ParseCSSNumber(color);
+                if (!angle.valid || angle.end != (int)color.size() - 3) return result;
+                result.angleDegrees = angle.value;
+            }
+            else
+            {
+                auto pos = -1.f;
+
+                if ((idx < (int)input.size()) && input[idx] != ',' && input[idx] != ')')
+                {
+                    start = idx;
+                    idx = NextCSSToken(input, idx, ',');
+                    auto length = ParseCSSLength(input.substr(start, idx - start));
+                    if (!length.valid) return result;
+                    pos = length.value;
+                }
+
+                if (result.totalStops <= GLIMMER_MAX_COLORSTOPS)
+                    result.stops[result.totalStops++] = { color, pos };
+            }
+
+            firstPart = false;
+            idx = SkipCSSSpace(input, idx);
+            if ((idx < (int)input.size()) && input[idx] == ',') idx++;
+            else break;
+        }
+
+        result.valid = (idx < (int)input.size()) && input[idx] == ')' && result.totalStops >= 2;
+        return result;
+    }
+
+    // Creates the color gradient, consecutive color stops of the CSS gradient form a gradient segment
+    template <typename ColorResolverT>
+    [[nodiscard]] constexpr ColorGradient ToColorGradient(const CSSLinearGradient& parsed, ColorResolverT&& resolve)
+    {
+        ColorGradient gradient{};
+        gradient.dir = parsed.dir;
+        gradient.angleDegrees = parsed.angleDegrees;
+
+        auto total = 0.f, unspecified = 0.f;
+        for (auto idx = 0; idx < parsed.totalStops; ++idx)
+        {
+            if (parsed.stops[idx].second != -1.f) total += parsed.stops[idx].second;
+            else unspecified += 1.f;
+
+            if (idx > 0 && gradient.totalStops < GLIMMER_MAX_COLORSTOPS)
+            {
+                gradient.colorStops[gradient.totalStops] = ColorStop{ resolve(parsed.stops[idx - 1].first),
+                    resolve(parsed.stops[idx].first), parsed.stops[idx].second };
+                gradient.totalStops++;
+            }
+        }
+
+        unspecified -= 1.f;
+        for (auto idx = 0; idx < gradient.totalStops; ++idx)
+        {
+            auto& colorstop = gradient.colorStops[idx];
+            if (colorstop.pos == -1.f) colorstop.pos = unspecified > 0.f ? (100.f - total) / (100.f * unspecified) : 1.f;
+            else colorstop.pos /= 100.f;
+        }
+
+        return gradient;
+    }
+
+    // =============================================================================================
+    // COMPILE-TIME CSS LITERALS
+    // =============================================================================================
+
+    // Style delta from a CSS literal, fields mark the sub-properties to apply (CSF_* bits)
+    struct StyleLiteral
+    {
+        struct BorderSide
+        {
+            CSSLength thickness;
+            uint32_t color = 0;
+            LineType lineType = LineType::Solid;
+        };
+
+        uint64_t specified = 0;
+        uint32_t fields = 0;
+        uint32_t bgcolor = 0;
+        uint32_t fgcolor = 0;
+        ColorGradient gradient{};
+        CSSLength dimension[2]{}, mindim[2]{}, maxdim[2]{};
+        CSSFourSided padding{};
+        CSSFourSided margin{};
+        BorderSide border[4]{}; // top, left, right, bottom
+        bool borderUniform = false;
+        CSSLength radius[4]{}; // Indexed by BoxCorner
+        CSSLength fontSize{};
+        std::string_view fontFamily;
+        int32_t fontFlags = 0;
+        int32_t alignment = 0;
+        uint32_t relativeProps = 0;
+    };
+
+    // Not constexpr, reaching this while parsing a literal is a compilation error (see the call site)
+    inline void InvalidCSSLiteral(const char*) {}
+
+    constexpr uint32_t ParseCSSLiteralColor(std::string_view value)
+    {
+        auto color = ParseCSSColor(value);
+        if (!color.valid) InvalidCSSLiteral("invalid or unsupported color");
+        return color.value;
+    }
+
+    constexpr CSSLength ParseCSSLiteralLength(std::string_view value)
+    {
+        auto length = ParseCSSLength(value);
+        if (!length.valid) InvalidCSSLiteral("invalid length, expected number with px/pt/em/% unit");
+        return length;
+    }
+
+    constexpr CSSFourSided ParseCSSLiteralFourSided(std::string_view value)
+    {
+        auto sides = ParseCSSFourSided(value);
+        if (sides.count == 0) InvalidCSSLiteral("invalid lengths, expected 1-4 lengths");
+        return sides;
+    }
+
+    constexpr StyleLiteral::BorderSide ParseCSSLiteralBorder(std::string_view value)
+    {
+        auto border = ParseCSSBorder(value);
+        if (!border.valid) InvalidCSSLiteral("invalid border, expected <width> <line-type> <color>");
+        if (border.none) return StyleLiteral::BorderSide{ CSSLength{ 0.f, CSSUnit::Pixel, true } };
+
+        StyleLiteral::BorderSide side{ border.thickness, ToRGBA(0, 0, 0), border.lineType };
+        if (!border.color.empty()) side.color = ParseCSSLiteralColor(border.color);
+        return side;
+    }
+
+    constexpr void ParseCSSLiteralRadius(StyleLiteral& result, std::string_view value, BoxCorner corner, 
+        RelativeStyleProperty relative, CompiledStyleField field)
+    {
+        result.radius[corner] = ParseCSSLiteralLength(value);
+        if (result.radius[corner].unit == CSSUnit::Percent) result.relativeProps |= relative;
+        result.fields |= field;
+        result.specified |= StyleBorder;
+    }
+
+    constexpr void ParseCSSLiteralProperty(StyleLiteral& result, std::string_view name, std::string_view value)
+    {
+        if (IsSameCSS(name, "font-size"))
+        {
+            constexpr std::pair<std::string_view, float> keywords[] = {
+                { "xx-small", 0.6f }, { "x-small", 0.75f }, { "small", 0.89f }, { "medium", 1.f },
+                { "large", 1.2f }, { "x-large", 1.5f }, { "xx-large", 2.f }, { "xxx-large", 3.f }
+            };
+
+            auto found = false;
+            for (const auto& [keyword, ems] : keywords)
+                if (IsSameCSS(value, keyword)) { result.fontSize = CSSLength{ ems, CSSUnit::Em, true }; found = true; }
+
+            if (!found) result.fontSize = ParseCSSLiteralLength(value);
+            result.fields |= CSF_FontSize;
+            result.specified |= StyleFontSize;
+        }
+        else if (IsSameCSS(name, "font-family"))
+        {
+            if (value.size() >= 2u && (value[0] == '"' || value[0] == '\'') && value.back() == value[0])
+                value = value.substr(1, value.size() - 2u);
+            result.fontFamily = value;
+            result.fields |= CSF_FontFamily;
+            result.specified |= StyleFontFamily;
+        }
+        else if (IsSameCSS(name, "font-weight"))
+        {
+            auto weight = ParseCSSNumber(value);
+            if (IsSameCSS(value, "bold")) result.fontFlags |= FontStyleBold;
+            else if (IsSameCSS(value, "light")) result.fontFlags |= FontStyleLight;
+            else if (weight.valid && weight.end == (int)value.size())
+            {
+                if (weight.value >= 600.f) result.fontFlags |= FontStyleBold;
+                if (weight.value < 400.f) result.fontFlags |= FontStyleLight;
+            }
+            else InvalidCSSLiteral("invalid font-weight");
+            result.specified |= StyleFontWeight;
+        }
+        else if (IsSameCSS(name, "font-style"))
+        {
+            if (IsSameCSS(value, "normal")) result.fontFlags |= FontStyleNormal;
+            else if (IsSameCSS(value, "italic") || IsSameCSS(value, "oblique")) result.fontFlags |= FontStyleItalics;
+            else InvalidCSSLiteral("invalid font-style");
+            result.specified |= StyleFontStyle;
+        }
+        else if (IsSameCSS(name, "text-wrap"))
+        {
+            if (IsSameCSS(value, "nowrap")) result.fontFlags |= FontStyleNoWrap;
+            result.specified |= StyleTextWrap;
+        }
+        else if (IsSameCSS(name, "text-overflow"))
+        {
+            if (IsSameCSS(value, "ellipsis"))
+            {
+                result.fontFlags |= FontStyleOverflowEllipsis;
+                result.specified |= StyleTextOverflow;
+            }
+        }
+        else if (IsSameCSS(name, "background-color") || IsSameCSS(name, "background"))
+        {
+            if (StartsWithCSS(value, "linear-gradient"))
+            {
+                auto gradient = ParseCSSLinearGradient(value);
+                if (!gradient.valid) InvalidCSSLiteral("invalid linear-gradient");
+                result.gradient = ToColorGradient(gradient, [](std::string_view color) { 
+                    return ParseCSSLiteralColor(color); });
+                result.fields |= CSF_Gradient;
+            }
+            else
+            {
+                result.bgcolor = ParseCSSLiteralColor(value);
+                result.fields |= CSF_BgColor;
+            }
+            result.specified |= StyleBackground;
+        }
+        else if (IsSameCSS(name, "color"))
+        {
+            result.fgcolor = ParseCSSLiteralColor(value);
+            result.fields |= CSF_FgColor;
+            result.specified |= StyleFgColor;
+        }
+        else if (IsSameCSS(name, "width") || IsSameCSS(name, "min-width") || IsSameCSS(name, "max-width"))
+        {
+            auto& dest = IsSameCSS(name, "width") ? result.dimension[0] : IsSameCSS(name, "min-width") ?
+                result.mindim[0] : result.maxdim[0];
+            dest = ParseCSSLiteralLength(value);
+            result.fields |= IsSameCSS(name, "width") ? CSF_Width : IsSameCSS(name, "min-width") ? CSF_MinWidth : CSF_MaxWidth;
+            result.specified |= StyleWidth;
+        }
+        else if (IsSameCSS(name, "height") || IsSameCSS(name, "min-height") || IsSameCSS(name, "max-height"))
+        {
+            auto& dest = IsSameCSS(name, "height") ? result.dimension[1] : IsSameCSS(name, "min-height") ?
+                result.mindim[1] : result.maxdim[1];
+            dest = ParseCSSLiteralLength(value);
+            result.fields |= IsSameCSS(name, "height") ? CSF_Height : IsSameCSS(name, "min-height") ? CSF_MinHeight : CSF_MaxHeight;
+            result.specified |= StyleHeight;
+        }
+        else if (IsSameCSS(name, "alignment") || IsSameCSS(name, "text-align"))
+        {
+            result.alignment |= IsSameCSS(value, "justify") ? TextAlignJustify :
+                IsSameCSS(value, "right") ? TextAlignRight :
+                IsSameCSS(value, "center") ? TextAlignHCenter :
+                TextAlignLeft;
+            result.specified |= StyleHAlignment;
+        }
+        else if (IsSameCSS(name, "vertical-align"))
+        {
+            result.alignment |= IsSameCSS(value, "top") ? TextAlignTop :
+                IsSameCSS(value, "bottom") ? TextAlignBottom :
+                TextAlignVCenter;
+            result.specified |= StyleVAlignment;
+        }
+        else if (StartsWithCSS(name, "padding") || StartsWithCSS(name, "margin"))
+        {
+            auto isPadding = StartsWithCSS(name, "padding");
+            auto& dest = isPadding ? result.padding : result.margin;
+            auto side = name.substr(isPadding ? 7u : 6u);
+
+            if (side.empty())
+            {
+                dest = ParseCSSLiteralFourSided(value);
+                result.fields |= isPadding ? CSF_Padding : CSF_Margin;
+            }
+            else if (IsSameCSS(side, "-top")) { dest.top = ParseCSSLiteralLength(value); result.fields |= isPadding ? CSF_PaddingTop : CSF_MarginTop; }
+            else if (IsSameCSS(side, "-left")) { dest.left = ParseCSSLiteralLength(value); result.fields |= isPadding ? CSF_PaddingLeft : CSF_MarginLeft; }
+            else if (IsSameCSS(side, "-right")) { dest.right = ParseCSSLiteralLength(value); result.fields |= isPadding ? CSF_PaddingRight : CSF_MarginRight; }
+            else if (IsSameCSS(side, "-bottom")) { dest.bottom = ParseCSSLiteralLength(value); result.fields |= isPadding ? CSF_PaddingBottom : CSF_MarginBottom; }
+            else InvalidCSSLiteral("unknown padding/margin property");
+
+            result.specified |= isPadding ? StylePadding : StyleMargin;
+        }
+        else if (IsSameCSS(name, "border"))
+        {
+            result.border[0] = result.border[1] = result.border[2] = result.border[3] = ParseCSSLiteralBorder(value);
+            result.borderUniform = true;
+            result.fields |= CSF_BorderSides | CSF_BorderUniform;
+            result.specified |= StyleBorder;
+        }
+        else if (IsSameCSS(name, "border-top") || IsSameCSS(name, "border-left") || 
+            IsSameCSS(name, "border-right") || IsSameCSS(name, "border-bottom"))
+        {
+            auto side = IsSameCSS(name, "border-top") ? 0 : IsSameCSS(name, "border-left") ? 1 :
+                IsSameCSS(name, "border-right") ? 2 : 3;
+            result.border[side] = ParseCSSLiteralBorder(value);
+            result.borderUniform = false;
+            result.fields |= (CSF_BorderTop << side) | CSF_BorderUniform;
+            result.specified |= StyleBorder;
+        }
+        else if (IsSameCSS(name, "border-width"))
+        {
+            auto width = ParseCSSLiteralFourSided(value);
+            result.border[0].thickness = width.top;
+            result.border[1].thickness = width.left;
+            result.border[2].thickness = width.right;
+            result.border[3].thickness = width.bottom;
+            result.fields |= CSF_BorderThickness;
+            result.specified |= StyleBorder;
+        }
+        else if (IsSameCSS(name, "border-color"))
+        {
+            auto color = ParseCSSLiteralColor(value);
+            for (auto& side : result.border) side.color = color;
+            result.fields |= CSF_BorderColor;
+            result.specified |= StyleBorder;
+        }
+        else if (IsSameCSS(name, "border-radius"))
+        {
+            ParseCSSLiteralRadius(result, value, TopLeftCorner, RSP_BorderTopLeftRadius, CSF_RadiusTopLeft);
+            ParseCSSLiteralRadius(result, value, TopRightCorner, RSP_BorderTopRightRadius, CSF_RadiusTopRight);
+            ParseCSSLiteralRadius(result, value, BottomRightCorner, RSP_BorderBottomRightRadius, CSF_RadiusBottomRight);
+            ParseCSSLiteralRadius(result, value, BottomLeftCorner, RSP_BorderBottomLeftRadius, CSF_RadiusBottomLeft);
+        }
+        else if (IsSameCSS(name, "border-top-left-radius"))
+            ParseCSSLiteralRadius(result, value, TopLeftCorner, RSP_BorderTopLeftRadius, CSF_RadiusTopLeft);
+        else if (IsSameCSS(name, "border-top-right-radius"))
+            ParseCSSLiteralRadius(result, value, TopRightCorner, RSP_BorderTopRightRadius, CSF_RadiusTopRight);
+        else if (IsSameCSS(name, "border-bottom-right-radius"))
+            ParseCSSLiteralRadius(result, value, BottomRightCorner, RSP_BorderBottomRightRadius, CSF_RadiusBottomRight);
+        else if (IsSameCSS(name, "border-bottom-left-radius"))
+            ParseCSSLiteralRadius(result, value, BottomLeftCorner, RSP_BorderBottomLeftRadius, CSF_RadiusBottomLeft);
+        else
+            InvalidCSSLiteral("unknown property or property not supported in literals, use runtime CSS");
+    }
+
+    consteval StyleLiteral ParseStyleLiteral(std::string_view css)
+    {
+        StyleLiteral result{};
+        auto idx = 0;
+
+        while (idx < (int)css.size())
+        {
+            auto start = idx;
+            auto quote = '\0';
+
+            // Find end of declaration, ';' within quoted font family names is not a separator
+            while ((idx < (int)css.size()) && (quote != '\0' || css[idx] != ';'))
+            {
+                if (quote == '\0' && (css[idx] == '"' || css[idx] == '\'')) quote = css[idx];
+                else if (css[idx] == quote) quote = '\0';
+                idx++;
+            }
+
+            auto declaration = TrimCSS(css.substr(start, idx - start));
+            if (idx < (int)css.size()) idx++;
+            if (declaration.empty()) continue;
+
+            auto colon = declaration.find(':');
+            if (colon == std::string_view::npos) InvalidCSSLiteral("expected ':' after property name");
+
+            auto name = TrimCSS(declaration.substr(0, colon));
+            auto value = TrimCSS(declaration.substr(colon + 1u));
+            if (name.empty() || value.empty()) InvalidCSSLiteral("empty property name or value");
+
+            ParseCSSLiteralProperty(result, name, value);
+        }
+
+        return result;
+    }
+
+    template <std::size_t N>
+    struct CSSString
+    {
+        char data[N]{};
+
+        consteval CSSString(const char(&str)[N])
+        {
+            for (std::size_t idx = 0; idx < N; ++idx) data[idx] = str[idx];
+        }
+
+        constexpr std::string_view view() const { return std::string_view{ data, N - 1u }; }
+    };
+
+    // CSS parsed at compile time i.e. PushStyle(css<"color: white; padding: 5px 10px">)
+    template <CSSString Literal>
+    inline constexpr StyleLiteral css = ParseStyleLiteral(Literal.view());
+}
@@ -2,11 +2,14 @@
 
 #include "imrichtextutils.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <cstring>
 #include <optional>
 #include <string>
 #include <chrono>
 #include <deque>
+#include <map>
+#include <mutex>
 
 #include "style.h"
 #include "draw.h"
@@ -73,9 +76,11 @@ namespace ImRichText
     struct AnimationData
     {
         std::vector<float> xoffsets;
-        long long lastBlinkTime;
-        long long lastMarqueeTime;
+        float sinceBlink = 0.f; // Milliseconds since blinking text was last toggled
+        float sinceMarquee = 0.f; // Milliseconds since marquee text was last moved
         bool isVisible = true;
+        bool hasVisibleBlink = false;
+        bool hasVisibleMarquee = false;
     };
 
     struct RichTextData
@@ -134,6 +139,10 @@ namespace ImRichText
 
     static std::unordered_map<std::size_t, RichTextData> RichTextMap;
 
+    // Documents whose content changed since RelayoutRichTexts last ran, so that it does not have
+    // to scan all documents unless the config changed
+    static std::unordered_set<std::size_t> PendingRelayouts;
+
     // Using std::deque as a stable vector, could be replaced
 #ifdef IM_RICHTEXT_TARGET_IMGUI
     static std::unordered_map<ImGuiContext*, std::deque<RenderConfig>> ImRenderConfigs;
@@ -162,6 +171,17 @@ namespace ImRichText
 
     static const char* LineSpaces = "                                ";
 
+    static void PopulateNumbersAsStr()
+    {
+        if (NumbersAsStr.empty())
+        {
+            NumbersAsStr.reserve(IM_RICHTEXT_MAX_LISTITEM);
+
+            for (auto num = 1; num <= IM_RICHTEXT_MAX_LISTITEM; ++num)
+                NumbersAsStr.emplace_back(std::to_string(num));
+        }
+    }
+
     class DefaultTagVisitor final : public ITagVisitor
     {
         enum class Operation
@@ -1251,11 +1271,13 @@ namespace ImRichText
         {
             auto segmentidx = 0;
             if (lines[lineidx].Segments.empty()) continue;
+            animation.hasVisibleMarquee = animation.hasVisibleMarquee || lines[lineidx].Marquee;
 
             for (const auto& segment : lines[lineidx].Segments)
             {
                 auto linestart = initpos;
                 if (lines[lineidx].Marquee) linestart.x += animation.xoffsets[lineidx];
+                animation.hasVisibleBlink = animation.hasVisibleBlink || segment.Blink;
                 if (!DrawSegment(segment, block, linestart, bounds, result, config, tooltip, animation))
                     break;
                 ++segmentidx;
@@ -1300,13 +1322,13 @@ namespace ImRichText
         auto endpos = pos + bounds;
         TooltipData tooltip;
 
-        if (animation.xoffsets.empty())
+        if (animation.xoffsets.size() != drawables.ForegroundLines.size())
         {
             animation.xoffsets.resize(drawables.ForegroundLines.size());
             std::fill(animation.xoffsets.begin(), animation.xoffsets.end(), 0.f);
         }
 
-        auto currFrameTime = config->Platform->DeltaTime();
+        animation.hasVisibleBlink = animation.hasVisibleMarquee = false;
 
         config->Renderer->SetClipRect(pos, endpos);
         config->Renderer->DrawRect(pos, endpos, config->DefaultBgColor, true);
@@ -1315,28 +1337,48 @@ namespace ImRichText
         DrawForegroundLayer(pos, bounds, drawables, *config, tooltip, animation);
         config->Renderer->DrawTooltip(tooltip.pos, tooltip.content);
 
-        if (config->Platform != nullptr)
+        // Static content (which is most rich text) should never keep the platform rendering,
+        // hence only schedule frames when animated lines were actually drawn.
+        if (config->Platform != nullptr && !drawables.AnimatedLines.empty())
         {
-            if (!config->IsStrictHTML5 && (currFrameTime - animation.lastBlinkTime > IM_RICHTEXT_BLINK_ANIMATION_INTERVAL))
+            // Frames are requested for when the next animation step is due, rather than
+            // rendering every frame in between
+            auto delta = config->Platform->DeltaTime() * 1000.f;
+
+            if (!config->IsStrictHTML5 && animation.hasVisibleBlink)
             {
-                animation.isVisible = !animation.isVisible;
-                animation.lastBlinkTime = currFrameTime;
-                config->Platform->RequestFrame();
+                animation.sinceBlink += delta;
+
+                if (animation.sinceBlink >= IM_RICHTEXT_BLINK_ANIMATION_INTERVAL)
+                {
+                    animation.isVisible = !animation.isVisible;
+                    animation.sinceBlink = 0.f;
+                }
+
+                config->Platform->RequestFrameAfter((IM_RICHTEXT_BLINK_ANIMATION_INTERVAL - animation.sinceBlink) * 0.001f);
             }
 
-            if (currFrameTime - animation.lastMarqueeTime > IM_RICHTEXT_MARQUEE_ANIMATION_INTERVAL)
+            if (animation.hasVisibleMarquee)
             {
-                for (auto lineidx = 0; lineidx < (int)animation.xoffsets.size(); ++lineidx)
+                animation.sinceMarquee += delta;
+
+                if (animation.sinceMarquee >= IM_RICHTEXT_MARQUEE_ANIMATION_INTERVAL)
                 {
-                    animation.xoffsets[lineidx] += 1.f;
-                    auto linewidth = drawables.ForegroundLines[lineidx].Content.width;
+                    for (auto lineidx : drawables.AnimatedLines)
+                    {
+                        if (!drawables.ForegroundLines[lineidx].Marquee) continue;
+
+                        animation.xoffsets[lineidx] += 1.f;
+                        auto linewidth = drawables.ForegroundLines[lineidx].Content.width;
+
+                        if (animation.xoffsets[lineidx] >= linewidth)
+                            animation.xoffsets[lineidx] = -linewidth;
+                    }
 
-                    if (animation.xoffsets[lineidx] >= linewidth)
-                        animation.xoffsets[lineidx] = -linewidth;
+                    animation.sinceMarquee = 0.f;
                 }
 
-                config->Platform->RequestFrame();
-                animation.lastMarqueeTime = currFrameTime;
+                config->Platform->RequestFrameAfter((IM_RICHTEXT_MARQUEE_ANIMATION_INTERVAL - animation.sinceMarquee) * 0.001f);
             }
         }
 
@@ -1389,14 +1431,7 @@ namespace ImRichText
         }
         else if (token.Type == TokenType::ListItemNumbered)
         {
-            if (NumbersAsStr.empty())
-            {
-                NumbersAsStr.reserve(IM_RICHTEXT_MAX_LISTITEM);
-
-                for (auto num = 1; num <= IM_RICHTEXT_MAX_LISTITEM; ++num)
-                    NumbersAsStr.emplace_back(std::to_string(num));
-            }
-
+            PopulateNumbersAsStr();
             auto& listItem = _result.ListItemTokens[token.ListPropsIdx];
             std::memset(listItem.NestedListItemIndex, 0, IM_RICHTEXT_NESTED_ITEMCOUNT_STRSZ);
             auto currbuf = 0;
@@ -2314,6 +2349,20 @@ namespace ImRichText
             }
         }
 
+        // Record animated content, so that drawing only advances and schedules frames for these lines
+        for (auto index = 0; index < (int)_result.ForegroundLines.size(); ++index)
+        {
+            auto& line = _result.ForegroundLines[index];
+
+            for (auto& segment : line.Segments)
+            {
+                segment.Blink = !_config.IsStrictHTML5 && _result.StyleDescriptors[segment.StyleIdx + 1].blink;
+                line.HasBlink = line.HasBlink || segment.Blink;
+            }
+
+            if (line.Marquee || line.HasBlink) _result.AnimatedLines.push_back(index);
+        }
+
         // Apply alignment to geometry
         for (auto& line : _result.ForegroundLines)
         {
@@ -2730,6 +2779,7 @@ namespace ImRichText
         {
             RichTextMap[hash].richText = key;
             RichTextMap[hash].contentChanged = true;
+            PendingRelayouts.insert(hash);
         }
         
         return hash;
@@ -2750,6 +2800,7 @@ namespace ImRichText
             {
                 RichTextMap[id].richText = key;
                 RichTextMap[id].contentChanged = true;
+                PendingRelayouts.insert(id);
                 return true;
             }
         }
@@ -2764,6 +2815,7 @@ namespace ImRichText
         if (it != RichTextMap.end())
         {
             RichTextMap.erase(it);
+            PendingRelayouts.erase(id);
             return true;
         }
 
@@ -2773,10 +2825,28 @@ namespace ImRichText
     void ClearAllRichTexts()
     {
         RichTextMap.clear();
+        PendingRelayouts.clear();
     }
 
 #ifdef IM_RICHTEXT_TARGET_IMGUI
 
+    static bool IsLayoutOutdated(const RichTextData& drawdata, const RenderConfig* config, std::optional<ImVec2> sz)
+    {
+        return config != drawdata.config || config->Scale != drawdata.scale ||
+            config->FontScale != drawdata.fontScale || config->DefaultBgColor != drawdata.bgcolor
+            || (sz.has_value() && sz.value() != drawdata.specifiedBounds) || drawdata.contentChanged;
+    }
+
+    static void UpdateLayoutParams(RichTextData& drawdata, RenderConfig* config, std::optional<ImVec2> sz)
+    {
+        drawdata.contentChanged = false;
+        drawdata.config = config;
+        drawdata.bgcolor = config->DefaultBgColor;
+        drawdata.scale = config->Scale;
+        drawdata.fontScale = config->FontScale;
+        drawdata.specifiedBounds = sz.has_value() ? sz.value() : drawdata.specifiedBounds;
+    }
+
     static bool Render(ImVec2 pos, std::size_t richTextId, std::optional<ImVec2> sz, bool show)
     {
         auto it = RichTextMap.find(richTextId);
@@ -2786,16 +2856,9 @@ namespace ImRichText
             auto& drawdata = it->second;
             auto config = GetRenderConfig();
 
-            if (config != drawdata.config || config->Scale != drawdata.scale ||
-                config->FontScale != drawdata.fontScale || config->DefaultBgColor != drawdata.bgcolor
-                || (sz.has_value() && sz.value() != drawdata.specifiedBounds) || drawdata.contentChanged)
+            if (IsLayoutOutdated(drawdata, config, sz))
             {
-                drawdata.contentChanged = false;
-                drawdata.config = config;
-                drawdata.bgcolor = config->DefaultBgColor;
-                drawdata.scale = config->Scale;
-                drawdata.fontScale = config->FontScale;
-                drawdata.specifiedBounds = sz.has_value() ? sz.value() : drawdata.specifiedBounds;
+                UpdateLayoutParams(drawdata, config, sz);
 
 #ifdef _DEBUG
                 auto ts = std::chrono::duration_cast<std::chrono::microseconds>(
@@ -2824,6 +2887,193 @@ namespace ImRichText
         return false;
     }
 
+    // Advances of ASCII glyphs for a (font, size) pair, computed with the exact arithmetic of
+    // ImGui::CalcTextSize, so that layout on worker threads matches the serial layout.
+    struct GlyphAdvances
+    {
+        float advances[128];
+        float lineHeight = 0.f;
+        float ratio = 1.f;
+        float monospaceAdvance = -1.f;
+        float ellipsisWidth = 0.f;
+    };
+
+    // Guards all ImGui access from worker threads and writes to GlyphAdvanceCache
+    static std::mutex TextMeasureMutex;
+    static std::map<std::pair<void*, float>, GlyphAdvances> GlyphAdvanceCache;
+
+    // Renderer which only measures text, used to layout rich text on worker threads. Measurement
+    // of ASCII text uses resolved glyph advances, everything else falls back to the source
+    // renderer under a lock.
+    struct LayoutRenderer final : public glimmer::IRenderer
+    {
+        glimmer::IRenderer* source = nullptr;
+        bool resolveAdvances = false;
+        std::pair<void*, float> lastFont{ nullptr, -1.f };
+        const GlyphAdvances* lastAdvances = nullptr;
+
+        glimmer::RendererType Type() const override { return glimmer::RendererType::Deferred; }
+
+        void SetClipRect(ImVec2, ImVec2, bool) override {}
+        void ResetClipRect() override {}
+        void DrawLine(ImVec2, ImVec2, uint32_t, float) override {}
+        void DrawPolyline(ImVec2*, int, uint32_t, float) override {}
+        void DrawTriangle(ImVec2, ImVec2, ImVec2, uint32_t, bool, float) override {}
+        void DrawRect(ImVec2, ImVec2, uint32_t, bool, float) override {}
+        void DrawRoundedRect(ImVec2, ImVec2, uint32_t, bool, float, float, float, float, float) override {}
+        void DrawRectGradient(ImVec2, ImVec2, uint32_t, uint32_t, glimmer::Direction) override {}
+        void DrawRoundedRectGradient(ImVec2, ImVec2, float, float, float, float, uint32_t, uint32_t, glimmer::Direction) override {}
+        void DrawPolygon(ImVec2*, int, uint32_t, bool, float) override {}
+        void DrawPolyGradient(ImVec2*, uint32_t*, int) override {}
+        void DrawCircle(ImVec2, float, uint32_t, bool, float) override {}
+        void DrawSector(ImVec2, float, int, int, uint32_t, bool, bool, float) override {}
+        void DrawRadialGradient(ImVec2, float, uint32_t, uint32_t, int, int) override {}
+        void DrawText(std::string_view, ImVec2, uint32_t, float) override {}
+        void DrawTooltip(ImVec2, std::string_view) override {}
+
+        const GlyphAdvances* Advances(void* fontptr, float sz)
+        {
+            if (!resolveAdvances || fontptr == nullptr) return nullptr;
+            if (lastFont.first == fontptr && lastFont.second == sz) return lastAdvances;
+
+            std::lock_guard<std::mutex> lock{ TextMeasureMutex };
+            auto key = std::make_pair(fontptr, sz);
+            auto it = GlyphAdvanceCache.find(key);
+
+            if (it == GlyphAdvanceCache.end())
+            {
+                auto imfont = (ImFont*)fontptr;
+                GlyphAdvances entry;
+
+                ImGui::PushFont(imfont, imfont->LegacySize);
+                auto fontsz = ImGui::GetFontSize();
+                for (auto ch = 0; ch < 128; ++ch)
+                {
+                    auto text = (char)ch;
+                    entry.advances[ch] = imfont->CalcTextSizeA(fontsz, FLT_MAX, -1.f, &text, &text + 1).x;
+                }
+                ImGui::PopFont();
+
+                auto baked = imfont->GetFontBaked(sz);
+                entry.lineHeight = fontsz;
+                entry.ratio = sz / baked->Size;
+                entry.monospaceAdvance = glimmer::IsFontMonospace(fontptr) ? baked->IndexAdvanceX.Data[0] : -1.f;
+                entry.ellipsisWidth = source->EllipsisWidth(fontptr, sz);
+                it = GlyphAdvanceCache.emplace(key, entry).first;
+            }
+
+            lastFont = key;
+            lastAdvances = &(it->second);
+            return lastAdvances;
+        }
+
+        ImVec2 GetTextSize(std::string_view text, void* fontptr, float sz, float wrapWidth) override
+        {
+            if (wrapWidth == -1.f)
+            {
+                if (auto advances = Advances(fontptr, sz); advances != nullptr)
+                {
+                    if ((int)text.size() > 4 && advances->monospaceAdvance > 0.f)
+                        return ImVec2{ (float)text.size() * advances->monospaceAdvance, sz } * advances->ratio;
+
+                    auto width = 0.f;
+                    auto ascii = true;
+
+                    for (auto ch : text)
+                    {
+                        if (ch < 32 || ch > 126) { ascii = false; break; }
+                        width += advances->advances[(int)ch];
+                    }
+
+                    if (ascii) return ImVec2{ IM_TRUNC(width + 0.99999f), advances->lineHeight } * advances->ratio;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock{ TextMeasureMutex };
+            return source->GetTextSize(text, fontptr, sz, wrapWidth);
+        }
+
+        float EllipsisWidth(void* fontptr, float sz) override
+        {
+            if (auto advances = Advances(fontptr, sz); advances != nullptr)
+                return advances->ellipsisWidth;
+
+            std::lock_guard<std::mutex> lock{ TextMeasureMutex };
+            return source->EllipsisWidth(fontptr, sz);
+        }
+    };
+
+    int RelayoutRichTexts(const std::size_t* ids, int count)
+    {
+        // Layout params of the config all documents were last checked against
+        static RichTextData LastRelayoutParams;
+
+        auto config = GetRenderConfig();
+        std::vector<RichTextData*> outdated;
+
+        if (ids == nullptr)
+        {
+            if (IsLayoutOutdated(LastRelayoutParams, config, std::nullopt))
+            {
+                UpdateLayoutParams(LastRelayoutParams, config, std::nullopt);
+                for (auto& [id, drawdata] : RichTextMap)
+                    if (IsLayoutOutdated(drawdata, config, std::nullopt))
+                        outdated.push_back(&drawdata);
+            }
+            else
+            {
+                // Only documents with changed content can be outdated, which may have been laid out when shown
+                for (auto id : PendingRelayouts)
+                    if (auto it = RichTextMap.find(id); it != RichTextMap.end() &&
+                        IsLayoutOutdated(it->second, config, std::nullopt))
+                        outdated.push_back(&(it->second));
+            }
+
+            PendingRelayouts.clear();
+        }
+        else
+        {
+            for (auto idx = 0; idx < count; ++idx)
+                if (auto it = RichTextMap.find(ids[idx]); it != RichTextMap.end() &&
+                    IsLayoutOutdated(it->second, config, std::nullopt))
+                    outdated.push_back(&(it->second));
+        }
+
+        if (outdated.empty()) return 0;
+
+        // Shared state lazily populated by the visitor has to exist before workers start
+        PopulateNumbersAsStr();
+
+        std::vector<Drawables> results(outdated.size());
+        auto resolveAdvances = config->Renderer->Type() == glimmer::RendererType::ImGui;
+
+        glimmer::GetWorkerPool().ParallelFor((int32_t)outdated.size(), [&](int32_t idx) {
+            thread_local LayoutRenderer renderer;
+            renderer.source = config->Renderer;
+            renderer.resolveAdvances = resolveAdvances;
+            renderer.lastFont = { nullptr, -1.f };
+
+            auto layoutConfig = *config;
+            layoutConfig.Renderer = &renderer;
+
+            const auto& drawdata = *outdated[idx];
+            results[idx] = GetDrawables(drawdata.richText.data(),
+                drawdata.richText.data() + drawdata.richText.size(), layoutConfig,
+                drawdata.specifiedBounds);
+        });
+
+        // Swap in results on the UI thread, so that drawing never observes a partial layout
+        for (auto idx = 0; idx < (int)outdated.size(); ++idx)
+        {
+            auto& drawdata = *outdated[idx];
+            UpdateLayoutParams(drawdata, config, std::nullopt);
+            drawdata.drawables = std::move(results[idx]);
+            drawdata.computedBounds = ComputeBounds(drawdata.drawables, config, drawdata.specifiedBounds);
+        }
+
+        return (int)outdated.size();
+    }
+
     ImVec2 GetBounds(std::size_t richTextId, std::optional<ImVec2> sz)
     {
         if (Render({}, richTextId, sz, false))
@@ -148,6 +148,7 @@ namespace ImRichText
         int SubscriptDepth = 0;
         int SuperscriptDepth = 0;
         bool HasText = false;
+        bool Blink = false;
 
         float width() const { return Bounds.width; }
         float height() const { return Bounds.height; }
@@ -163,6 +164,7 @@ namespace ImRichText
         bool HasText = false;
         bool HasSuperscript = false;
         bool HasSubscript = false;
+        bool HasBlink = false;
         bool Marquee = false;
 
         float width() const { return Content.width + Offset.left + Offset.right; }
@@ -272,6 +274,7 @@ namespace ImRichText
         std::vector<StyleDescriptor> StyleDescriptors;
         std::vector<TagPropertyDescriptor>   TagDescriptors;
         std::vector<ListItemTokenDescriptor> ListItemTokens;
+        std::vector<int> AnimatedLines; // Indexes into ForegroundLines with marquee or blink content
         bool BoundsComputed = false;
     };
 
@@ -310,6 +313,11 @@ namespace ImRichText
 
 #ifdef IM_RICHTEXT_TARGET_IMGUI
     [[nodiscard]] ImVec2 GetBounds(std::size_t richTextId, std::optional<ImVec2> sz = std::nullopt);
+
+    // Re-layout rich text documents whose layout is out of date w.r.t. the current config on the
+    // worker pool (all documents if ids is nullptr). Returns the number of documents laid out. Without
+    // ids, documents are only scanned if the config changed, else only the ones whose content changed.
+    int RelayoutRichTexts(const std::size_t* ids = nullptr, int count = 0);
     bool Show(ImVec2 pos, std::size_t richTextId, std::optional<ImVec2> sz = std::nullopt);
     bool Show(std::size_t richTextId, std::optional<ImVec2> sz = std::nullopt);
     bool ToggleOverlay();
@@ -150,6 +150,8 @@ namespace ImRichText
 
         virtual void HandleHyperlink(std::string_view) = 0;
         virtual void RequestFrame() = 0;
+        // Defaults to requesting a frame right away, for platforms without timers
+        virtual void RequestFrameAfter(float seconds) { RequestFrame(); }
         virtual void HandleHover(bool) = 0;
         virtual float DeltaTime() = 0;
     };
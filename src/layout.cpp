@@ -10,6 +10,10 @@
 
 #include <limits>
 #include <cstdint>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
 
 #if GLIMMER_FLEXBOX_ENGINE == GLIMMER_CLAY_ENGINE
 #define CLAY_IMPLEMENTATION
@@ -173,6 +177,476 @@ static ImRect GetBoundingBox(YGNodeConstRef node)
 namespace glimmer
 {
     static Vector<GridLayoutItem, int16_t, 64> GridLayoutItems;
+    static Vector<GridTrackSize, int16_t, 16> GridTrackSpecs{ false }; // Row tracks followed by column tracks
+
+#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+    static LayoutPhaseStats LayoutStats{ "flat" };
+#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_CLAY_ENGINE
+    static LayoutPhaseStats LayoutStats{ "clay" };
+#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE
+    static LayoutPhaseStats LayoutStats{ "yoga" };
+#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE
+    static LayoutPhaseStats LayoutStats{ "simple-flex" };
+#endif
+
+#ifdef GLIMMER_ENABLE_LAYOUT_STATS
+    struct LayoutPhaseTimer
+    {
+        float& phase;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int32_t allocations = TotalMallocs + TotalReallocs;
+
+        explicit LayoutPhaseTimer(float& target) : phase{ target } {}
+
+        ~LayoutPhaseTimer()
+        {
+            phase += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+            LayoutStats.allocations += TotalMallocs + TotalReallocs - allocations;
+        }
+    };
+
+    // Measurement of a top-level layout spans till its EndLayout, excluding nested layout solves
+    static std::chrono::steady_clock::time_point LayoutMeasureStart;
+    static float LayoutMeasureSolveStart = 0.f;
+
+#define LAYOUT_PHASE(PHASE) LayoutPhaseTimer __phase__{ LayoutStats.PHASE }
+#define LAYOUT_STAT(FIELD) ++LayoutStats.FIELD
+#else
+#define LAYOUT_PHASE(PHASE)
+#define LAYOUT_STAT(FIELD)
+#endif
+
+#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE || GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE || \
+    GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+    // Solved bounds of flexbox children, indexed by context.layoutItems index
+    static std::vector<ImRect> FlexItemBounds;
+
+    static void SetFlexItemBounds(int32_t index, const ImRect& bbox)
+    {
+        if ((int32_t)FlexItemBounds.size() <= index) FlexItemBounds.resize(index + 1);
+        FlexItemBounds[index] = bbox;
+    }
+#endif
+
+    // FNV-1a over layout inputs, a layout is only solved again if this changes
+    static void HashLayoutInput(uint64_t& hash, const void* data, size_t size)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t idx = 0; idx < size; ++idx)
+            hash = (hash ^ bytes[idx]) * 1099511628211ull;
+    }
+
+    template <typename T>
+    static void HashLayoutInput(uint64_t& hash, T value)
+    {
+        HashLayoutInput(hash, &value, sizeof(T));
+    }
+
+    // Hashed in place of an item widget type for wrap breaks (NextRow/NextColumn), not valid widget types
+    static constexpr WidgetType RowBreakMarker = (WidgetType)-2;
+    static constexpr WidgetType ColumnBreakMarker = (WidgetType)-3;
+
+    // Unbounded extents depend on position, only their being unbounded is an input
+    static void HashLayoutExtent(uint64_t& hash, const ImRect& extent)
+    {
+        HashLayoutInput(hash, extent.Max.x == FLT_MAX ? FLT_MAX : extent.GetWidth());
+        HashLayoutInput(hash, extent.Max.y == FLT_MAX ? FLT_MAX : extent.GetHeight());
+    }
+
+    static void InitLayoutFingerprint(WidgetContextData& context, LayoutBuilder& layout)
+    {
+        auto& hash = layout.fingerprint;
+        hash = 14695981039346656037ull;
+        HashLayoutInput(hash, layout.type);
+        HashLayoutInput(hash, layout.fill);
+        HashLayoutInput(hash, layout.alignment);
+        HashLayoutInput(hash, layout.spacing);
+        HashLayoutInput(hash, layout.size);
+        HashLayoutInput(hash, layout.hofmode);
+        HashLayoutInput(hash, layout.vofmode);
+        HashLayoutInput(hash, layout.gpmethod);
+        HashLayoutInput(hash, layout.gridsz.first);
+        HashLayoutInput(hash, layout.gridsz.second);
+
+        auto relativeTracks = false;
+        for (auto track : layout.rowTracks)
+        {
+            HashLayoutInput(hash, track.type);
+            HashLayoutInput(hash, ImVec2{ track.value, track.min });
+            relativeTracks = relativeTracks || track.type == GridTrackType::Relative;
+        }
+        for (auto track : layout.colTracks)
+        {
+            HashLayoutInput(hash, track.type);
+            HashLayoutInput(hash, ImVec2{ track.value, track.min });
+            relativeTracks = relativeTracks || track.type == GridTrackType::Relative;
+        }
+
+        if (layout.fill != FD_None || relativeTracks) HashLayoutExtent(hash, layout.available);
+
+        if (layout.regionIdx != -1)
+        {
+            auto regionId = context.regions[layout.regionIdx].id;
+            auto& state = context.GetState(regionId).state.region;
+            auto style = context.GetStyle(state.state, regionId);
+
+            HashLayoutInput(hash, ImVec2{ style.margin.left, style.margin.top });
+            HashLayoutInput(hash, ImVec2{ style.margin.right, style.margin.bottom });
+            HashLayoutInput(hash, ImVec2{ style.padding.left, style.padding.top });
+            HashLayoutInput(hash, ImVec2{ style.padding.right, style.padding.bottom });
+            HashLayoutInput(hash, ImVec2{ style.border.left.thickness, style.border.top.thickness });
+            HashLayoutInput(hash, ImVec2{ style.border.right.thickness, style.border.bottom.thickness });
+        }
+    }
+
+    static LayoutCacheEntry& GetLayoutCache(WidgetContextData& context, const LayoutBuilder& layout)
+    {
+        auto index = layout.id & WidgetIndexMask;
+        if ((int32_t)context.layoutCache.size() <= index) context.layoutCache.resize(index + 1);
+        return context.layoutCache[index];
+    }
+
+    static bool IsLayoutCached(const LayoutCacheEntry& cache, const LayoutBuilder& layout, size_t layouts, size_t items)
+    {
+        auto cached = cache.fingerprint == layout.fingerprint && cache.layouts.size() == layouts &&
+            cache.items.size() == items;
+#ifdef GLIMMER_ENABLE_LAYOUT_STATS
+        ++(cached ? LayoutStats.cacheHits : LayoutStats.solves);
+#endif
+        return cached;
+    }
+
+#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+
+    enum FlatFlexNodeFlags : int32_t
+    {
+        FFN_Container = 1,
+        FFN_Row = 1 << 1,
+        FFN_Wrap = 1 << 2,
+        FFN_Layout = 1 << 3, // index refers to context.layouts instead of context.layoutItems
+        FFN_FixedW = 1 << 4,
+        FFN_FixedH = 1 << 5,
+        FFN_FullW = 1 << 6, // 100% of parent's inner width
+        FFN_FullH = 1 << 7, // 100% of parent's inner height
+        FFN_Frozen = 1 << 8 // Scratch flag used while resolving flexible lengths
+    };
+
+    // Flexbox nodes of all flat engine trees of a frame as structure of arrays. Nodes are appended
+    // in pre-order, hence children always follow their parent, which lets a tree be measured with a
+    // reverse sweep and placed with a forward sweep. Arrays keep their capacity across frames, so
+    // no allocations happen once they have grown to the frame's node count.
+    struct FlatFlexTree
+    {
+        Vector<int32_t, int32_t, 256> flags, geometry, index;
+        Vector<int32_t, int32_t, 256> root, parent, firstChild, lastChild, nextSibling;
+        Vector<ImVec2, int32_t, 256> size, mindim, maxdim, gap;
+        Vector<ImVec2, int32_t, 256> marginMin, marginMax, insetMin, insetMax;
+        Vector<ImVec2, int32_t, 256> measured, solved, pos;
+        Vector<float, int32_t, 256> basis;
+
+        void clear()
+        {
+            flags.clear(false); geometry.clear(false); index.clear(false);
+            root.clear(false); parent.clear(false); firstChild.clear(false);
+            lastChild.clear(false); nextSibling.clear(false);
+            size.clear(false); mindim.clear(false); maxdim.clear(false); gap.clear(false);
+            marginMin.clear(false); marginMax.clear(false); insetMin.clear(false); insetMax.clear(false);
+            measured.clear(false); solved.clear(false); pos.clear(false); basis.clear(false);
+        }
+    };
+
+    static FlatFlexTree FlatTree;
+
+    static float& Axis(ImVec2& vec, int axis) { return axis == 0 ? vec.x : vec.y; }
+    static float Axis(const ImVec2& vec, int axis) { return axis == 0 ? vec.x : vec.y; }
+
+    // Min wins over max, as it does in Yoga
+    static float ClampFlatSize(float value, float mn, float mx) { return std::max(mn, std::min(mx, value)); }
+
+    static int32_t GetFlatNode(const void* implData)
+    {
+        return (int32_t)reinterpret_cast<intptr_t>(implData);
+    }
+
+    static int32_t AddFlatFlexNode(int32_t parent, int32_t flags, int32_t geometry, int32_t index)
+    {
+        auto& tree = FlatTree;
+        auto node = tree.flags.size();
+        tree.flags.push_back(flags);
+        tree.geometry.push_back(geometry);
+        tree.index.push_back(index);
+        tree.root.push_back(parent == -1 ? node : tree.root[parent]);
+        tree.parent.push_back(parent);
+        tree.firstChild.push_back(-1);
+        tree.lastChild.push_back(-1);
+        tree.nextSibling.push_back(-1);
+        tree.size.push_back(ImVec2{});
+        tree.mindim.push_back(ImVec2{});
+        tree.maxdim.push_back(ImVec2{ FLT_MAX, FLT_MAX });
+        tree.gap.push_back(ImVec2{});
+        tree.marginMin.push_back(ImVec2{});
+        tree.marginMax.push_back(ImVec2{});
+        tree.insetMin.push_back(ImVec2{});
+        tree.insetMax.push_back(ImVec2{});
+        tree.measured.push_back(ImVec2{});
+        tree.solved.push_back(ImVec2{});
+        tree.pos.push_back(ImVec2{});
+        tree.basis.push_back(0.f);
+
+        if (parent != -1)
+        {
+            if (tree.lastChild[parent] == -1) tree.firstChild[parent] = node;
+            else tree.nextSibling[tree.lastChild[parent]] = node;
+            tree.lastChild[parent] = node;
+        }
+
+        return node;
+    }
+
+    // Size along axis before flexing, percentages resolve against parent's inner size
+    static float GetFlatHypotheticalSize(int32_t node, int axis, float parentInner)
+    {
+        auto& tree = FlatTree;
+        if (tree.flags[node] & (axis == 0 ? FFN_FullW : FFN_FullH))
+            return ClampFlatSize(parentInner == FLT_MAX ? 0.f : parentInner,
+                Axis(tree.mindim[node], axis), Axis(tree.maxdim[node], axis));
+        return Axis(tree.measured[node], axis);
+    }
+
+    static float GetFlatMargins(int32_t node, int axis)
+    {
+        return Axis(FlatTree.marginMin[node], axis) + Axis(FlatTree.marginMax[node], axis);
+    }
+
+    static float GetFlatInsets(int32_t node, int axis)
+    {
+        return Axis(FlatTree.insetMin[node], axis) + Axis(FlatTree.insetMax[node], axis);
+    }
+
+    // Content size of a container, breaking lines if it wraps and has a definite main size
+    static ImVec2 MeasureFlatLines(int32_t node, float innerMain, float innerCross)
+    {
+        auto& tree = FlatTree;
+        auto main = (tree.flags[node] & FFN_Row) ? 0 : 1, cross = 1 - main;
+        auto wrap = (tree.flags[node] & FFN_Wrap) && innerMain != FLT_MAX;
+        auto mainGap = Axis(tree.gap[node], 0), crossGap = Axis(tree.gap[node], 1);
+        auto linemain = 0.f, linecross = 0.f, maxmain = 0.f, totalcross = 0.f;
+        auto count = 0, lines = 0;
+
+        for (auto child = tree.firstChild[node]; child != -1; child = tree.nextSibling[child])
+        {
+            auto outer = GetFlatHypotheticalSize(child, main, innerMain) + GetFlatMargins(child, main);
+            auto outercross = GetFlatHypotheticalSize(child, cross, innerCross) + GetFlatMargins(child, cross);
+
+            if (wrap && count > 0 && (linemain + mainGap + outer) > innerMain)
+            {
+                maxmain = std::max(maxmain, linemain);
+                totalcross += linecross + (lines > 0 ? crossGap : 0.f);
+                linemain = linecross = 0.f;
+                count = 0;
+                ++lines;
+            }
+
+            linemain += outer + (count > 0 ? mainGap : 0.f);
+            linecross = std::max(linecross, outercross);
+            ++count;
+        }
+
+        maxmain = std::max(maxmain, linemain);
+        totalcross += linecross + (lines > 0 ? crossGap : 0.f);
+
+        ImVec2 content;
+        Axis(content, main) = maxmain;
+        Axis(content, cross) = totalcross;
+        return content;
+    }
+
+    static void MeasureFlatNode(int32_t node)
+    {
+        auto& tree = FlatTree;
+        auto flags = tree.flags[node];
+        ImVec2 measured;
+
+        if (flags & FFN_Container)
+        {
+            auto main = (flags & FFN_Row) ? 0 : 1, cross = 1 - main;
+            auto fixedMain = flags & (main == 0 ? FFN_FixedW : FFN_FixedH);
+            auto fixedCross = flags & (cross == 0 ? FFN_FixedW : FFN_FixedH);
+            auto innerMain = fixedMain ? Axis(tree.size[node], main) - GetFlatInsets(node, main) : FLT_MAX;
+            auto innerCross = fixedCross ? Axis(tree.size[node], cross) - GetFlatInsets(node, cross) : FLT_MAX;
+            auto content = MeasureFlatLines(node, innerMain, innerCross);
+
+            Axis(measured, main) = fixedMain ? Axis(tree.size[node], main) : Axis(content, main) + GetFlatInsets(node, main);
+            Axis(measured, cross) = fixedCross ? Axis(tree.size[node], cross) : Axis(content, cross) + GetFlatInsets(node, cross);
+        }
+        else
+        {
+            measured.x = (flags & FFN_FixedW) ? tree.size[node].x : 0.f;
+            measured.y = (flags & FFN_FixedH) ? tree.size[node].y : 0.f;
+        }
+
+        measured.x = ClampFlatSize(measured.x, tree.mindim[node].x, tree.maxdim[node].x);
+        measured.y = ClampFlatSize(measured.y, tree.mindim[node].y, tree.maxdim[node].y);
+        tree.measured[node] = measured;
+    }
+
+    // Grow or shrink items of a line [first, end) to absorb free space, items clamped by their
+    // min/max dimensions are frozen and the remaining space is redistributed among the rest
+    static void ResolveFlatFlexibleLengths(int32_t first, int32_t end, int main, float freespace)
+    {
+        auto& tree = FlatTree;
+        auto grow = freespace > 0.f;
+        auto growflag = main == 0 ? ExpandH : ExpandV, shrinkflag = main == 0 ? ShrinkH : ShrinkV;
+        auto count = 0;
+
+        for (auto child = first; child != end; child = tree.nextSibling[child], ++count)
+        {
+            auto flexible = (tree.flags[child] & FFN_Container) == 0 &&
+                (tree.geometry[child] & (grow ? growflag : shrinkflag)) != 0;
+            if (flexible) tree.flags[child] &= ~FFN_Frozen;
+            else tree.flags[child] |= FFN_Frozen;
+        }
+
+        for (auto iteration = 0; iteration <= count; ++iteration)
+        {
+            auto factors = 0.f, remaining = freespace;
+
+            for (auto child = first; child != end; child = tree.nextSibling[child])
+            {
+                if (tree.flags[child] & FFN_Frozen)
+                    remaining -= Axis(tree.solved[child], main) - tree.basis[child];
+                else factors += grow ? 1.f : tree.basis[child];
+            }
+
+            if (factors <= 0.f) break;
+            auto violated = false;
+
+            for (auto child = first; child != end; child = tree.nextSibling[child])
+            {
+                if (tree.flags[child] & FFN_Frozen) continue;
+
+                auto factor = grow ? 1.f : tree.basis[child];
+                auto target = tree.basis[child] + (remaining * factor / factors);
+                auto clamped = ClampFlatSize(target, Axis(tree.mindim[child], main), Axis(tree.maxdim[child], main));
+                Axis(tree.solved[child], main) = clamped;
+
+                if (clamped != target)
+                {
+                    tree.flags[child] |= FFN_Frozen;
+                    violated = true;
+                }
+            }
+
+            if (!violated) break;
+        }
+    }
+
+    // Place children of a container whose own size is already solved
+    static void PlaceFlatChildren(int32_t node)
+    {
+        auto& tree = FlatTree;
+        auto flags = tree.flags[node];
+        auto row = (flags & FFN_Row) != 0;
+        auto main = row ? 0 : 1, cross = 1 - main;
+        auto wrap = (flags & FFN_Wrap) != 0;
+        auto mainGap = Axis(tree.gap[node], 0), crossGap = Axis(tree.gap[node], 1);
+        auto innerMain = Axis(tree.solved[node], main) - GetFlatInsets(node, main);
+        auto innerCross = Axis(tree.solved[node], cross) - GetFlatInsets(node, cross);
+        auto crossOffset = Axis(tree.insetMin[node], cross);
+        auto alignment = tree.geometry[node];
+        auto stretchflag = cross == 0 ? ExpandH : ExpandV;
+        auto fixedCrossFlag = cross == 0 ? FFN_FixedW : FFN_FixedH;
+
+        for (auto first = tree.firstChild[node]; first != -1;)
+        {
+            // Collect the line and hypothetical sizes of its items
+            auto end = first, count = 0;
+            auto used = 0.f, linecross = 0.f;
+
+            for (; end != -1; end = tree.nextSibling[end])
+            {
+                auto basis = GetFlatHypotheticalSize(end, main, innerMain);
+                auto outer = basis + GetFlatMargins(end, main);
+                if (wrap && count > 0 && (used + mainGap + outer) > innerMain) break;
+
+                tree.basis[end] = basis;
+                Axis(tree.solved[end], main) = basis;
+                used += outer + (count > 0 ? mainGap : 0.f);
+                linecross = std::max(linecross, GetFlatHypotheticalSize(end, cross, innerCross) +
+                    GetFlatMargins(end, cross));
+                ++count;
+            }
+
+            if (first == tree.firstChild[node] && end == -1) linecross = innerCross;
+            if (used != innerMain) ResolveFlatFlexibleLengths(first, end, main, innerMain - used);
+
+            used = (float)(count - 1) * mainGap;
+            for (auto child = first; child != end; child = tree.nextSibling[child])
+                used += Axis(tree.solved[child], main) + GetFlatMargins(child, main);
+
+            // Distribute leftover space along main axis as per justify-content
+            auto leftover = std::max(innerMain - used, 0.f), offset = 0.f, between = 0.f;
+            auto atEnd = row ? (alignment & AlignRight) : (alignment & AlignBottom);
+            auto atCenter = row ? (alignment & AlignHCenter) : (alignment & AlignVCenter);
+            if (atEnd) offset = leftover;
+            else if (atCenter) offset = leftover * 0.5f;
+            else if (row && (alignment & AlignJustify)) { between = leftover / (float)count; offset = between * 0.5f; }
+
+            // Align along cross axis as per align-items, or stretch
+            auto crossEnd = row ? (alignment & AlignBottom) : (alignment & AlignRight);
+            auto crossCenter = row ? (alignment & AlignVCenter) : (alignment & AlignHCenter);
+            auto current = Axis(tree.insetMin[node], main) + offset;
+
+            for (auto child = first; child != end; child = tree.nextSibling[child])
+            {
+                auto& pos = tree.pos[child];
+                auto& solved = tree.solved[child];
+                Axis(pos, main) = current + Axis(tree.marginMin[child], main);
+                current += Axis(solved, main) + GetFlatMargins(child, main) + mainGap + between;
+
+                auto margins = GetFlatMargins(child, cross);
+                if ((tree.geometry[child] & stretchflag) && !(tree.flags[child] & (fixedCrossFlag | FFN_Container)))
+                {
+                    Axis(solved, cross) = ClampFlatSize(linecross - margins, Axis(tree.mindim[child], cross),
+                        Axis(tree.maxdim[child], cross));
+                    Axis(pos, cross) = crossOffset + Axis(tree.marginMin[child], cross);
+                }
+                else
+                {
+                    Axis(solved, cross) = GetFlatHypotheticalSize(child, cross, innerCross);
+                    auto diff = linecross - Axis(solved, cross) - margins;
+                    Axis(pos, cross) = crossOffset + Axis(tree.marginMin[child], cross) +
+                        (crossEnd ? diff : crossCenter ? diff * 0.5f : 0.f);
+                }
+            }
+
+            crossOffset += linecross + crossGap;
+            first = end;
+        }
+    }
+
+    static void SolveFlatFlexTree(int32_t rootNode)
+    {
+        auto& tree = FlatTree;
+        auto total = tree.flags.size();
+
+        for (auto node = total - 1; node >= rootNode; --node)
+            if (tree.root[node] == rootNode) MeasureFlatNode(node);
+
+        tree.solved[rootNode] = tree.measured[rootNode];
+        tree.pos[rootNode] = tree.marginMin[rootNode];
+
+        for (auto node = rootNode; node < total; ++node)
+            if (tree.root[node] == rootNode && (tree.flags[node] & FFN_Container))
+                PlaceFlatChildren(node);
+    }
+
+    static ImRect GetBoundingBox(int32_t node)
+    {
+        return ImRect{ FlatTree.pos[node], FlatTree.pos[node] + FlatTree.solved[node] };
+    }
+
+#endif
 
     std::tuple<ImRect, ImRect, ImRect, ImRect> GetBoxModelBounds(ImRect content, const StyleDescriptor& style);
     WidgetDrawResult RegionImpl(int32_t id, const StyleDescriptor& style, const ImRect& margin, const ImRect& border, const ImRect& padding,
@@ -189,6 +663,8 @@ namespace glimmer
     WidgetDrawResult SpinnerImpl(int32_t id, const SpinnerState& state, const StyleDescriptor& style, const ImRect& extent, const IODescriptor& io, IRenderer& renderer);
     WidgetDrawResult TextInputImpl(int32_t id, TextInputState& state, const StyleDescriptor& style, const ImRect& extent, const ImRect& content, 
         const ImRect& prefix, const ImRect& suffix, IRenderer& renderer, const IODescriptor& io);
+    WidgetDrawResult TextEditorImpl(int32_t id, TextEditorState& state, const StyleDescriptor& style, const ImRect& extent, 
+        const ImRect& content, IRenderer& renderer, const IODescriptor& io);
     WidgetDrawResult DropDownImpl(int32_t id, DropDownState& state, const StyleDescriptor& style, const ImRect& margin, const ImRect& border, const ImRect& padding,
         const ImRect& content, const ImRect& text, IRenderer& renderer, const IODescriptor& io);
     WidgetDrawResult ItemGridImpl(int32_t id, const StyleDescriptor& style, const ImRect& margin, const ImRect& border, const ImRect& padding,
@@ -464,247 +940,6 @@ namespace glimmer
         ReserveSpaceForScrollBars(context, layoutItem);
     }
 
-#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
-    static float GetTotalSpacing(LayoutBuilder& layout, Direction dir)
-    {
-        return dir == DIR_Horizontal ? (((float)layout.currcol + 2.f) * layout.spacing.x) :
-            (((float)layout.currow + 2.f) * layout.spacing.y);
-    }
-
-    static void TranslateX(LayoutItemDescriptor& item, float amount)
-    {
-        item.margin.TranslateX(amount);
-        item.border.TranslateX(amount);
-        item.padding.TranslateX(amount);
-        item.content.TranslateX(amount);
-        item.text.TranslateX(amount);
-    }
-
-    static void TranslateY(LayoutItemDescriptor& item, float amount)
-    {
-        item.margin.TranslateY(amount);
-        item.border.TranslateY(amount);
-        item.padding.TranslateY(amount);
-        item.content.TranslateY(amount);
-        item.text.TranslateY(amount);
-    }
-
-    static void AlignLayoutAxisItems(LayoutBuilder& layout)
-    {
-        auto& context = GetContext();
-
-        switch (layout.type)
-        {
-        case Layout::Horizontal:
-        {
-            // If wrapping is enabled and the alignment is horizontally centered,
-            // perform h-centering of the current row of widgets and move to next row
-            // Otherwise, if output should be justified, move all widgets to specific
-            // location after distributing the diff equally...
-            auto width = layout.geometry.Max.x == FLT_MAX ? layout.extent.GetWidth() : layout.geometry.GetWidth();
-
-            if ((layout.alignment & AlignHCenter) && (layout.fill & FD_Horizontal))
-            {
-                auto totalspacing = GetTotalSpacing(layout, DIR_Horizontal);
-                auto hdiff = (width - layout.rows[layout.currow].x - totalspacing) * 0.5f;
-
-                if (hdiff > 0.f)
-                {
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        if (widget.row == layout.currow) TranslateX(widget, hdiff);
-                    }
-                }
-            }
-            else if ((layout.alignment & AlignJustify) && (layout.fill & FD_Horizontal))
-            {
-                auto hdiff = (width - layout.rows[layout.currow].x) /
-                    ((float)layout.currcol + 1.f);
-
-                if (hdiff > 0.f)
-                {
-                    auto currposx = hdiff;
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-
-                        if (widget.row == layout.currow)
-                        {
-                            auto translatex = currposx - widget.margin.Min.x;
-                            TranslateX(widget, translatex);
-                            currposx += widget.margin.GetWidth() + hdiff;
-                        }
-                    }
-                }
-            }
-            break;
-        }
-
-        case Layout::Vertical:
-        {
-            // Similar logic as for horizontal alignment, implemented for vertical here
-            auto height = layout.geometry.Max.y == FLT_MAX ? layout.extent.GetHeight() : layout.geometry.GetHeight();
-
-            if ((layout.alignment & AlignVCenter) && (layout.fill & FD_Vertical))
-            {
-                auto totalspacing = GetTotalSpacing(layout, DIR_Vertical);
-                auto hdiff = (height - layout.cols[layout.currcol].y - totalspacing) * 0.5f;
-
-                if (hdiff > 0.f)
-                {
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        if (widget.col == layout.currcol) TranslateY(widget, hdiff);
-                    }
-                }
-            }
-            else if ((layout.alignment & AlignJustify) && (layout.fill & FD_Vertical))
-            {
-                auto hdiff = (height - layout.cols[layout.currcol].x) /
-                    ((float)layout.currow + 1.f);
-
-                if (hdiff > 0.f)
-                {
-                    auto currposx = hdiff;
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        if (widget.col == layout.currcol)
-                        {
-                            auto translatex = currposx - widget.margin.Min.y;
-                            TranslateY(widget, hdiff);
-                            currposx += widget.margin.GetHeight() + hdiff;
-                        }
-                    }
-                }
-            }
-            break;
-        }
-        }
-    }
-
-    static void AlignCrossAxisItems(LayoutBuilder& layout, int depth)
-    {
-        auto& context = GetContext();
-
-        if ((layout.fill & FD_Horizontal) == 0)
-            layout.geometry.Max.x = context.layoutItems[layout.itemidx].margin.Max.x = layout.maxdim.x;
-        if ((layout.fill & FD_Vertical) == 0)
-            layout.geometry.Max.y = context.layoutItems[layout.itemidx].margin.Max.y = layout.maxdim.y;
-
-        switch (layout.type)
-        {
-        case Layout::Horizontal:
-        {
-            auto height = layout.geometry.Max.y == FLT_MAX ? layout.extent.GetHeight() : layout.geometry.GetHeight();
-
-            if ((layout.alignment & AlignVCenter) && (layout.fill & FD_Vertical))
-            {
-                auto totalspacing = GetTotalSpacing(layout, DIR_Vertical);
-                auto cumulativey = layout.cumulative.y + layout.maxdim.y;
-                auto vdiff = (height - totalspacing - cumulativey) * 0.5f;
-
-                if (vdiff > 0.f)
-                {
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        TranslateY(widget, vdiff);
-                    }
-                }
-            }
-            else if ((layout.alignment & AlignJustify) && (layout.fill & FD_Vertical))
-            {
-                auto cumulativey = layout.cumulative.y + layout.maxdim.y;
-                auto vdiff = (height - cumulativey) / ((float)layout.currow + 1.f);
-
-                if (vdiff > 0.f)
-                {
-                    auto currposy = vdiff;
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        auto translatey = currposy - widget.margin.Min.y;
-                        TranslateY(widget, vdiff);
-                        currposy += vdiff + widget.margin.GetHeight();
-                    }
-                }
-            }
-            else if ((layout.alignment & AlignBottom) && (layout.fill & FD_Vertical))
-            {
-                auto totalspacing = GetTotalSpacing(layout, DIR_Vertical);
-                auto vdiff = height - layout.maxdim.y - totalspacing;
-
-                if (vdiff > 0.f)
-                {
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        TranslateY(widget, vdiff);
-                    }
-                }
-            }
-            break;
-        }
-
-        case Layout::Vertical:
-        {
-            auto width = layout.geometry.Max.x == FLT_MAX ? layout.extent.GetWidth() : layout.geometry.GetWidth();
-
-            if ((layout.alignment & AlignHCenter) && (layout.fill & FD_Horizontal))
-            {
-                auto totalspacing = GetTotalSpacing(layout, DIR_Horizontal);
-                auto cumulativex = layout.cumulative.x + layout.maxdim.x;
-                auto hdiff = (width - totalspacing - cumulativex) * 0.5f;
-
-                if (hdiff > 0.f)
-                {
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        TranslateX(widget, hdiff);
-                    }
-                }
-            }
-            else if ((layout.alignment & AlignJustify) && (layout.fill & FD_Horizontal))
-            {
-                auto cumulativex = layout.cumulative.x + layout.maxdim.x;
-                auto hdiff = (width - cumulativex) / ((float)layout.currcol + 1.f);
-
-                if (hdiff > 0.f)
-                {
-                    auto currposy = hdiff;
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        auto translatex = currposy - widget.margin.Min.x;
-                        TranslateX(widget, hdiff);
-                        currposy += hdiff + widget.margin.GetWidth();
-                    }
-                }
-            }
-            else if ((layout.alignment & AlignRight) && (layout.fill & FD_Vertical))
-            {
-                auto totalspacing = GetTotalSpacing(layout, DIR_Horizontal);
-                auto hdiff = width - layout.maxdim.x - totalspacing;
-
-                if (hdiff > 0.f)
-                {
-                    for (auto idx = layout.from; idx <= layout.to; ++idx)
-                    {
-                        auto& widget = context.layoutItems[idx];
-                        TranslateX(widget, hdiff);
-                    }
-                }
-            }
-            break;
-        }
-        }
-    }
-#endif
-
     void AddItemToLayout(LayoutBuilder& layout, LayoutItemDescriptor& item, const StyleDescriptor& style)
     {
         auto& context = GetContext();
@@ -712,118 +947,43 @@ namespace glimmer
         layout.itemIndexes.emplace_back(context.layoutItems.size(), isItemLayout ?
             LayoutOps::AddLayout : item.wtype == WT_Scrollable ? LayoutOps::PushScrollRegion : LayoutOps::AddWidget);
 
+        LAYOUT_STAT(items);
+        HashLayoutInput(layout.fingerprint, item.wtype);
+        HashLayoutInput(layout.fingerprint, item.sizing);
+        HashLayoutInput(layout.fingerprint, item.margin.GetSize());
+        HashLayoutInput(layout.fingerprint, item.relative);
+        HashLayoutInput(layout.fingerprint, style.mindim);
+        HashLayoutInput(layout.fingerprint, style.maxdim);
+        if (item.sizing & ExpandAll) HashLayoutExtent(layout.fingerprint, layout.available);
+        if (layout.type == Layout::Grid)
+        {
+            HashLayoutInput(layout.fingerprint, ImVec2{ (float)layout.currow, (float)layout.currcol });
+            HashLayoutInput(layout.fingerprint, layout.currspan.first);
+            HashLayoutInput(layout.fingerprint, layout.currspan.second);
+        }
+
         if (layout.type == Layout::Horizontal || layout.type == Layout::Vertical)
         {
             if (!WidgetContextData::CacheItemGeometry)
             {
 #if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
-                ImVec2 offset = layout.nextpos - layout.geometry.Min;
-                layout.currow = std::max(layout.currow, (int16_t)0);
-                layout.currcol = std::max(layout.currcol, (int16_t)0);
-
-                if (layout.rows.empty()) layout.rows.resize(32);
-                if (layout.cols.empty()) layout.cols.resize(16);
-
-                switch (layout.type)
-                {
-                case Layout::Horizontal:
-                {
-                    auto width = item.margin.GetWidth();
-
-                    if ((layout.fill & FD_Horizontal) && (layout.hofmode == OverflowMode::Wrap))
-                    {
-                        if (layout.nextpos.x + width > layout.geometry.Max.x)
-                        {
-                            if ((layout.fill & FD_Vertical) == 0) layout.geometry.Max.y += layout.maxdim.y;
-
-                            offset = ImVec2{ layout.spacing.x, layout.cumulative.y + layout.maxdim.y +
-                                GetTotalSpacing(layout, DIR_Vertical) };
-                            layout.nextpos.x = width + layout.spacing.x;
-                            layout.nextpos.y = offset.y + layout.spacing.y;
-                            AlignLayoutAxisItems(layout);
-
-                            layout.cumulative.y += layout.maxdim.y;
-                            layout.maxdim.y = 0.f;
-                            layout.currcol = 0;
-                            layout.currow++;
-                            item.row = layout.currow;
-                            item.col = 0;
-                            layout.rows[layout.currow].x = 0.f;
-                        }
-                        else
-                        {
-                            layout.maxdim.y = std::max(layout.maxdim.y, item.margin.GetHeight());
-                            layout.nextpos.x += width + layout.spacing.x;
-                            layout.rows[layout.currow].x += width;
-                            item.col = layout.currcol;
-                            item.row = layout.currow;
-                            layout.currcol++;
-                        }
-                    }
-                    else
-                    {
-                        if ((layout.fill & FD_Horizontal) == 0) layout.geometry.Max.x += width;
-                        layout.nextpos.x += (width + layout.spacing.x);
-                        layout.maxdim.y = std::max(layout.maxdim.y, item.margin.GetHeight());
-                        if ((layout.fill & FD_Vertical) == 0) layout.geometry.Max.y = layout.geometry.Min.y + layout.maxdim.y;
-                        else layout.cumulative.y = layout.maxdim.y;
-                        layout.currcol++;
-                        layout.rows[layout.currow].x += width;
-                    }
 
-                    break;
-                }
+                auto& tree = FlatTree;
+                auto node = AddFlatFlexNode(GetFlatNode(layout.implData), isItemLayout ? FFN_Layout : 0, item.sizing,
+                    isItemLayout ? context.layouts.size() - 1 : context.layoutItems.size());
+                auto width = item.margin.GetWidth(), height = item.margin.GetHeight();
 
-                case Layout::Vertical:
-                {
-                    auto height = item.margin.GetHeight();
+                // Mirrors the constraints set on Yoga nodes
+                if (!(item.sizing & ExpandH)) { tree.size[node].x = width; tree.flags[node] |= FFN_FixedW; }
+                if (!(item.sizing & ExpandV)) { tree.size[node].y = height; tree.flags[node] |= FFN_FixedH; }
 
-                    if ((layout.fill & FD_Vertical) && (layout.vofmode == OverflowMode::Wrap))
-                    {
-                        if (layout.nextpos.y + height > layout.geometry.Max.y)
-                        {
-                            if ((layout.fill & FD_Vertical) == 0) layout.geometry.Max.x += layout.maxdim.x;
-
-                            offset = ImVec2{ layout.cumulative.x + layout.maxdim.x + GetTotalSpacing(layout, DIR_Horizontal),
-                                layout.spacing.y };
-                            layout.nextpos.x = offset.x + layout.spacing.x;
-                            layout.nextpos.y = height + layout.spacing.y;
-                            AlignLayoutAxisItems(layout);
-
-                            layout.cumulative.x += layout.maxdim.x;
-                            layout.maxdim.x = 0.f;
-                            layout.currow = 0;
-                            layout.currcol++;
-                            item.col = layout.currcol;
-                            layout.cols[layout.currcol].y = 0.f;
-                        }
-                        else
-                        {
-                            layout.maxdim.x = std::max(layout.maxdim.x, item.margin.GetWidth());
-                            layout.nextpos.y += height + layout.spacing.y;
-                            layout.cols[layout.currcol].y += height;
-                            item.col = layout.currcol;
-                            item.row = layout.currow;
-                            layout.currow++;
-                        }
-                    }
-                    else
-                    {
-                        if ((layout.fill & FD_Vertical) == 0) layout.geometry.Max.y += height;
-                        layout.nextpos.y += (height + layout.spacing.y);
-                        layout.maxdim.x = std::max(layout.maxdim.x, item.margin.GetWidth());
-                        if ((layout.fill & FD_Horizontal) == 0) layout.geometry.Max.x = layout.geometry.Min.x + layout.maxdim.x;
-                        layout.currow++;
-                        layout.cols[layout.currcol].y += height;
-                    }
-                    break;
-                }
-                default:
-                    break;
-                }
-
-                layout.extent.Min = ImMin(layout.extent.Min, item.margin.Min);
-                layout.extent.Max = ImMax(layout.extent.Max, item.margin.Max);
+                tree.maxdim[node].x = style.maxdim.x != FLT_MAX ? style.maxdim.x : !(item.sizing & ExpandH) ? width :
+                    layout.available.GetWidth();
+                tree.maxdim[node].y = style.maxdim.y != FLT_MAX ? style.maxdim.y : !(item.sizing & ExpandV) ? height :
+                    layout.available.GetHeight();
+                tree.mindim[node].x = style.mindim.x != 0.f ? style.mindim.x : !(item.sizing & ShrinkH) ? width : 0.f;
+                tree.mindim[node].y = style.mindim.y != 0.f ? style.mindim.y : !(item.sizing & ShrinkV) ? height : 0.f;
+                item.implData = reinterpret_cast<void*>((intptr_t)node);
 
 #elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_CLAY_ENGINE
 
@@ -934,14 +1094,12 @@ namespace glimmer
                 griditem.bbox.Max = item.margin.GetSize();
                 layout.griditems.emplace_back((int16_t)(GridLayoutItems.size() - 1));
 
+                // Track sizes are resolved once all items are added, see SizeGridTracks()
                 if (layout.gpmethod == ItemGridPopulateMethod::ByRows)
                 {
                     layout.currcol += griditem.colspan;
-                    layout.maxdim.y = std::max(layout.maxdim.y, griditem.maxdim.y);
                     if (layout.currcol >= layout.gridsz.second)
                     {
-                        layout.rows.emplace_back(layout.maxdim);
-                        layout.maxdim = ImVec2{};
                         layout.currcol = 0;
                         layout.currow++;
                     }
@@ -949,11 +1107,8 @@ namespace glimmer
                 else
                 {
                     layout.currow += griditem.rowspan;
-                    layout.maxdim.x = std::max(layout.maxdim.x, griditem.maxdim.x);
                     if (layout.currow >= layout.gridsz.first)
                     {
-                        layout.cols.emplace_back(layout.maxdim);
-                        layout.maxdim = ImVec2{};
                         layout.currow = 0;
                         layout.currcol++;
                     }
@@ -974,12 +1129,6 @@ namespace glimmer
 
         if (!context.spans.empty() && (context.spans.top() & OnlyOnce) != 0) context.spans.pop(1, true);
 
-#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
-        if (layout.from == -1) layout.from = layout.to = (int16_t)(context.layoutItems.size() - 1);
-        else layout.to = (int16_t)(context.layoutItems.size() - 1);
-        layout.itemidx = layout.to;
-#endif
-
         if (item.wtype == WT_Scrollable)
         {
             context.layoutStack.push() = context.layouts.size();
@@ -1053,10 +1202,6 @@ namespace glimmer
         // No expansion if nested layout, nested layout's size is implicit, or explicit from CSS
         assert(context.layoutStack.size() == 0 || (!(geometry & ExpandH) && !(geometry & ExpandV)));
 
-#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
-        assert(context.layoutStack.empty()); // No nested layout is supported
-#endif
-
         auto& layout = context.layouts.next(true);
         context.layoutStack.push() = context.layouts.size() - 1;
         auto isParentFlexLayout = IsParentFlexLayout(context);
@@ -1295,6 +1440,52 @@ namespace glimmer
                 LayContexts.back().depth++;
             }
 
+#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+
+            auto& tree = FlatTree;
+            auto parent = isParentFlexLayout ? GetFlatNode(context.layouts[context.layoutStack.top(1)].implData) : -1;
+            auto flags = FFN_Container | FFN_Layout | (layout.type == Layout::Horizontal ? FFN_Row : 0) | (wrap ? FFN_Wrap : 0);
+            auto node = AddFlatFlexNode(parent, flags, layout.alignment, context.layouts.size() - 1);
+            layout.implData = reinterpret_cast<void*>((intptr_t)node);
+
+            // Gaps mirror the gutters set on Yoga nodes
+            tree.gap[node] = layout.type == Layout::Horizontal ? ImVec2{ spacing.y, spacing.x } : 
+                ImVec2{ spacing.x, spacing.y };
+
+            StyleDescriptor style;
+            if (regionIdx != -1)
+            {
+                auto rid = context.regions[regionIdx].id;
+                auto& state = context.GetState(rid).state.region;
+                style = context.GetStyle(state.state, rid);
+
+                tree.marginMin[node] = ImVec2{ style.margin.left, style.margin.top };
+                tree.marginMax[node] = ImVec2{ style.margin.right, style.margin.bottom };
+                tree.insetMin[node] = ImVec2{ style.padding.left + style.border.left.thickness,
+                    style.padding.top + style.border.top.thickness };
+                tree.insetMax[node] = ImVec2{ style.padding.right + style.border.right.thickness,
+                    style.padding.bottom + style.border.bottom.thickness };
+            }
+
+            if ((layout.fill & FD_Horizontal) && (available.Max.x != FLT_MAX) && (available.Max.x > 0.f))
+            {
+                tree.size[node].x = available.GetWidth() - (2.f * layout.spacing.x) - 
+                    (style.margin.left + style.margin.right);
+                tree.flags[node] |= FFN_FixedW;
+            }
+
+            if ((layout.fill & FD_Vertical) && (available.Max.y != FLT_MAX) && (available.Max.y > 0.f))
+            {
+                tree.size[node].y = available.GetHeight() - (2.f * layout.spacing.y) -
+                    (style.margin.top + style.margin.bottom);
+                tree.flags[node] |= FFN_FixedH;
+            }
+
+            if (!isParentFlexLayout)
+            {
+                AddLayoutAsChildItem(context, layout, available);
+            }
+
 #endif
         }
         else
@@ -1321,11 +1512,22 @@ namespace glimmer
         }
 
         layout.nextpos = layout.startpos;
+        InitLayoutFingerprint(context, layout);
+        LAYOUT_STAT(layouts);
+
+#ifdef GLIMMER_ENABLE_LAYOUT_STATS
+        if (context.layoutStack.size() == 1)
+        {
+            LayoutMeasureStart = std::chrono::steady_clock::now();
+            LayoutMeasureSolveStart = LayoutStats.solve;
+        }
+#endif
+
         return layout.geometry;
     }
 
-    ImRect BeginGridLayoutRegion(int rows, int cols, GridLayoutDirection dir, int32_t geometry, const std::initializer_list<float>& rowExtents,
-        const std::initializer_list<float>& colExtents, ImVec2 spacing, ImVec2 size,
+    ImRect BeginGridLayoutRegion(int rows, int cols, GridLayoutDirection dir, int32_t geometry, Span<const GridTrackSize> rowTracks,
+        Span<const GridTrackSize> colTracks, ImVec2 spacing, ImVec2 size,
         const NeighborWidgets& neighbors, int regionIdx)
     {
         auto& context = GetContext();
@@ -1336,11 +1538,10 @@ namespace glimmer
             neighbors.left == neighbors.right && neighbors.right == -1));
         // No expansion if nested layout, nested layout's size is implicit, or explicit from CSS
         assert(context.layoutStack.size() == 0 || (!(geometry & ExpandH) && !(geometry & ExpandV)));
-        // Row/Column extents only apply for top-level layouts or nested layouts with non-zero explicit size
-        assert(context.layoutStack.size() == 0 || ((size.x == 0.f && rowExtents.size() == 0) &&
-            (size.y == 0.f && colExtents.size() == 0)));
         // For row-wise addition of widgets, columns must be specified to wrap (And vice-versa)
         assert((dir == GridLayoutDirection::ByRows && cols > 0) || (dir == GridLayoutDirection::ByColumns && rows > 0));
+        assert(rowTracks.size() == 0 || rows < 0 || rowTracks.size() == rows);
+        assert(colTracks.size() == 0 || cols < 0 || colTracks.size() == cols);
 
         auto& layout = context.layouts.emplace_back();
         auto& el = context.nestedContextStack.push();
@@ -1360,112 +1561,446 @@ namespace glimmer
         if (size.x > 0.f) layout.alignment |= ExplicitH;
         if (size.y > 0.f) layout.alignment |= ExplicitV;
 
+        for (auto track : rowTracks) layout.rowTracks.push_back(track);
+        for (auto track : colTracks) layout.colTracks.push_back(track);
+
         // Record style stack states for context, will be restored in EndLayout()
         for (auto idx = 0; idx < WSI_Total; ++idx)
             layout.styleStartIdx[idx] = context.StyleStack[idx].size() - 1;
 
-        auto nextpos = context.layoutStack.size() == 1 ? context.NextAdHocPos() : ImVec2{};
-        ImRect available = context.layoutStack.size() == 1 || (geometry & ExpandAll) != 0 ?
-            GetAvailableSpace(nextpos, neighbors) : ImRect{};
-        if (size.x > 0.f) available.Max.x = available.Min.x + size.x;
-        if (size.y > 0.f) available.Max.y = available.Min.x + size.y;
+        auto nextpos = context.layoutStack.size() == 1 ? context.NextAdHocPos() : ImVec2{};
+        ImRect available = context.layoutStack.size() == 1 || (geometry & ExpandAll) != 0 ?
+            GetAvailableSpace(nextpos, neighbors) : ImRect{};
+        if (size.x > 0.f) available.Max.x = available.Min.x + size.x;
+        if (size.y > 0.f) available.Max.y = available.Min.x + size.y;
+
+        // TODO: Is this required?
+   //     if (regionIdx != -1 && available != ImRect{})
+   //     {
+   //         auto regionId = context.regions[regionIdx].id;
+   //         auto& state = context.GetState(regionId).state.region;
+   //         auto style = context.GetStyle(state.state, regionId);
+   //         
+            //available.Min.x += style.margin.left + style.border.left.thickness + style.padding.left;
+   //         available.Min.y += style.margin.top + style.border.top.thickness + style.padding.top;
+   //         available.Max.x -= style.margin.right + style.border.right.thickness + style.padding.right;
+            //available.Max.y -= style.margin.bottom + style.border.bottom.thickness + style.padding.bottom;
+   //     }
+
+        // If current layout is nested layout, create a layout item and add it
+        // to parent layout's child items
+        AddLayoutAsChildItem(context, layout, available);
+
+        layout.available = available;
+        layout.startpos = nextpos;
+        layout.extent.Min = { FLT_MAX, FLT_MAX };
+        layout.currow = layout.currcol = 0;
+        layout.geometry = ImRect{};
+        layout.regionIdx = regionIdx;
+        if (rows > 0 && cols > 0) GridLayoutItems.expand(rows * cols, true);
+
+        if (regionIdx != -1)
+        {
+            auto regionId = context.regions[regionIdx].id;
+            auto& state = context.GetState(regionId).state.region;
+            auto style = context.GetStyle(state.state, regionId);
+
+            layout.startpos += ImVec2{ style.margin.left, style.margin.top };
+        }
+
+        layout.nextpos = layout.startpos;
+        InitLayoutFingerprint(context, layout);
+        LAYOUT_STAT(layouts);
+
+#ifdef GLIMMER_ENABLE_LAYOUT_STATS
+        if (context.layoutStack.size() == 1)
+        {
+            LayoutMeasureStart = std::chrono::steady_clock::now();
+            LayoutMeasureSolveStart = LayoutStats.solve;
+        }
+#endif
+
+        return layout.geometry;
+    }
+
+    ImRect BeginFlexLayout(Direction dir, int32_t geometry, bool wrap, ImVec2 spacing, 
+        ImVec2 size, const NeighborWidgets& neighbors)
+    {
+        return BeginFlexLayoutRegion(dir, geometry, wrap, spacing, size, neighbors, -1);
+    }
+
+    ImRect BeginGridLayout(int rows, int cols, GridLayoutDirection dir, int32_t geometry, const std::initializer_list<float>& rowExtents,
+        const std::initializer_list<float>& colExtents, ImVec2 spacing, ImVec2 size, const NeighborWidgets& neighbors)
+    {
+        // Row/Column extents only apply for top-level layouts or nested layouts with non-zero explicit size
+        assert(GetContext().layoutStack.size() == 0 || ((size.x == 0.f && rowExtents.size() == 0) &&
+            (size.y == 0.f && colExtents.size() == 0)));
+
+        // Extents are fractions of available space i.e. relative tracks, which must add up to 1
+        GridTrackSpecs.clear(true);
+
+#ifdef _DEBUG
+        auto total = 0.f;
+        for (auto rowext : rowExtents) total += rowext;
+        assert(rowExtents.size() == 0 || total == 1.f);
+
+        total = 0.f;
+        for (auto colext : colExtents) total += colext;
+        assert(colExtents.size() == 0 || total == 1.f);
+#endif
+
+        for (auto rowext : rowExtents) GridTrackSpecs.push_back(GridTrackSize::Relative(rowext));
+        for (auto colext : colExtents) GridTrackSpecs.push_back(GridTrackSize::Relative(colext));
+
+        auto nrows = (int)rowExtents.size();
+        return BeginGridLayoutRegion(rows, cols, dir, geometry, Span<const GridTrackSize>{ GridTrackSpecs.data(), nrows },
+            Span<const GridTrackSize>{ GridTrackSpecs.data() + nrows, (int)colExtents.size() }, spacing, size, neighbors, -1);
+    }
+
+    ImRect BeginGridLayout(GridLayoutDirection dir, int32_t geometry, const std::initializer_list<GridTrackSize>& rowTracks,
+        const std::initializer_list<GridTrackSize>& colTracks, ImVec2 spacing, ImVec2 size, const NeighborWidgets& neighbors)
+    {
+        auto rows = rowTracks.size() > 0 ? (int)rowTracks.size() : -1;
+        auto cols = colTracks.size() > 0 ? (int)colTracks.size() : -1;
+        return BeginGridLayoutRegion(rows, cols, dir, geometry, Span<const GridTrackSize>{ rowTracks.begin(), (int)rowTracks.size() },
+            Span<const GridTrackSize>{ colTracks.begin(), (int)colTracks.size() }, spacing, size, neighbors, -1);
+    }
+
+#pragma region Layout descriptions
+
+    struct CompiledGridTrack
+    {
+        GridTrackType type = GridTrackType::Auto;
+        CSSLength value; // Length for fixed tracks, ratio for relative tracks and weight for flexible tracks
+        CSSLength min; // Invalid if minimum is content-based
+    };
+
+    // Parsed form of a layout description, lengths are resolved in BeginLayout as they depend on
+    // scaling and available space
+    struct CompiledLayout
+    {
+        bool grid = false;
+        bool wrap = false;
+        Direction dir = DIR_Horizontal;
+        GridLayoutDirection flow = GridLayoutDirection::ByRows;
+        int32_t geometry = 0;
+        std::optional<OverflowMode> hofmode, vofmode;
+        CSSLength spacing[2], size[2];
+        std::vector<CompiledGridTrack> rows, cols;
+    };
+
+    struct CompiledLayoutHasher
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+    };
+
+    // Compiled layouts are keyed by description contents, the key owns a copy
+    static std::unordered_map<std::string, CompiledLayout, CompiledLayoutHasher, std::equal_to<>> CompiledLayouts;
+
+    static bool ParseGridTrack(std::string_view value, CompiledGridTrack& track)
+    {
+        value = TrimCSS(value);
+
+        if (IsSameCSS(value, "auto"))
+        {
+            track.type = GridTrackType::Auto;
+            return true;
+        }
+
+        if (StartsWithCSS(value, "minmax(") && value.back() == ')')
+        {
+            auto args = value.substr(7u, value.size() - 8u);
+            auto comma = args.find(',');
+            if (comma == std::string_view::npos) return false;
+
+            auto min = TrimCSS(args.substr(0, comma));
+            if (!IsSameCSS(min, "auto"))
+            {
+                track.min = ParseCSSLength(min);
+                if (!track.min.valid || track.min.unit == CSSUnit::Percent) return false;
+            }
+
+            return ParseGridTrack(args.substr(comma + 1u), track);
+        }
+
+        auto num = ParseCSSNumber(value);
+        if (num.valid && IsSameCSS(value.substr(num.end), "fr"))
+        {
+            track.type = GridTrackType::Fraction;
+            track.value = CSSLength{ num.value, CSSUnit::Pixel, true };
+            return num.value > 0.f;
+        }
+
+        track.value = ParseCSSLength(value);
+        track.type = track.value.unit == CSSUnit::Percent ? GridTrackType::Relative : GridTrackType::Fixed;
+        if (track.type == GridTrackType::Relative) track.value.value *= 0.01f;
+        return track.value.valid;
+    }
+
+    // Space separated track sizes, with repeat(count, tracks...) for repeated patterns
+    static bool ParseGridTracks(std::string_view value, std::vector<CompiledGridTrack>& tracks)
+    {
+        auto idx = SkipCSSSpace(value, 0);
+
+        while (idx < (int)value.size())
+        {
+            auto start = idx;
+            idx = NextCSSToken(value, idx);
+            auto token = value.substr(start, idx - start);
+
+            if (StartsWithCSS(token, "repeat(") && token.back() == ')')
+            {
+                auto args = token.substr(7u, token.size() - 8u);
+                auto comma = args.find(',');
+                if (comma == std::string_view::npos) return false;
+
+                auto count = ParseCSSNumber(TrimCSS(args.substr(0, comma)));
+                if (!count.valid || count.isFloat || count.value < 1.f) return false;
+
+                auto from = tracks.size();
+                if (!ParseGridTracks(args.substr(comma + 1u), tracks)) return false;
+                auto to = tracks.size();
+
+                for (auto rep = 1; rep < (int)count.value; ++rep)
+                    for (auto tidx = from; tidx < to; ++tidx)
+                        tracks.push_back(tracks[tidx]);
+            }
+            else if (!token.empty())
+            {
+                auto& track = tracks.emplace_back();
+                if (!ParseGridTrack(token, track)) return false;
+            }
+            else return false;
+
+            idx = SkipCSSSpace(value, idx);
+        }
+
+        return true;
+    }
+
+    static std::optional<OverflowMode> ParseOverflowMode(std::string_view value)
+    {
+        if (IsSameCSS(value, "clip")) return OverflowMode::Clip;
+        else if (IsSameCSS(value, "scroll")) return OverflowMode::Scroll;
+        else if (IsSameCSS(value, "wrap")) return OverflowMode::Wrap;
+        return std::nullopt;
+    }
+
+    static bool ParseLayoutProperty(CompiledLayout& result, std::string_view name, std::string_view value)
+    {
+        if (IsSameCSS(name, "display"))
+        {
+            result.grid = IsSameCSS(value, "grid");
+            return result.grid || IsSameCSS(value, "flex");
+        }
+        else if (IsSameCSS(name, "flex-direction"))
+        {
+            result.dir = IsSameCSS(value, "column") ? DIR_Vertical : DIR_Horizontal;
+            return IsSameCSS(value, "column") || IsSameCSS(value, "row");
+        }
+        else if (IsSameCSS(name, "flex-wrap"))
+        {
+            result.wrap = IsSameCSS(value, "wrap");
+            return result.wrap || IsSameCSS(value, "nowrap");
+        }
+        else if (IsSameCSS(name, "grid-auto-flow"))
+        {
+            result.flow = IsSameCSS(value, "column") ? GridLayoutDirection::ByColumns : GridLayoutDirection::ByRows;
+            return IsSameCSS(value, "column") || IsSameCSS(value, "row");
+        }
+        else if (IsSameCSS(name, "grid-template-rows"))
+        {
+            result.rows.clear();
+            return ParseGridTracks(value, result.rows);
+        }
+        else if (IsSameCSS(name, "grid-template-columns"))
+        {
+            result.cols.clear();
+            return ParseGridTracks(value, result.cols);
+        }
+        else if (IsSameCSS(name, "gap") || IsSameCSS(name, "spacing"))
+        {
+            // As in CSS, first value is the gap between rows, second one between columns
+            auto split = NextCSSToken(value, 0);
+            result.spacing[1] = ParseCSSLength(value.substr(0, split));
+            result.spacing[0] = split < (int)value.size() ? ParseCSSLength(value.substr(split)) : result.spacing[1];
+            return result.spacing[0].valid && result.spacing[1].valid;
+        }
+        else if (IsSameCSS(name, "column-gap") || IsSameCSS(name, "spacing-x"))
+        {
+            result.spacing[0] = ParseCSSLength(value);
+            return result.spacing[0].valid;
+        }
+        else if (IsSameCSS(name, "row-gap") || IsSameCSS(name, "spacing-y"))
+        {
+            result.spacing[1] = ParseCSSLength(value);
+            return result.spacing[1].valid;
+        }
+        else if (IsSameCSS(name, "width") || IsSameCSS(name, "height"))
+        {
+            auto& size = result.size[IsSameCSS(name, "width") ? 0 : 1];
+            size = ParseCSSLength(value);
+            return size.valid;
+        }
+        else if (IsSameCSS(name, "fill"))
+        {
+            result.geometry &= ~ExpandAll;
+            result.geometry |= IsSameCSS(value, "all") ? ExpandAll : IsSameCSS(value, "horizontal") ? ExpandH :
+                IsSameCSS(value, "vertical") ? ExpandV : 0;
+            return (result.geometry & ExpandAll) != 0 || IsSameCSS(value, "none");
+        }
+        else if (IsSameCSS(name, "halign") || IsSameCSS(name, "horizontal-align"))
+        {
+            result.geometry &= ~(AlignLeft | AlignHCenter | AlignRight);
+            result.geometry |= IsSameCSS(value, "right") ? AlignRight : IsSameCSS(value, "center") ? 
+                AlignHCenter : AlignLeft;
+            return IsSameCSS(value, "right") || IsSameCSS(value, "center") || IsSameCSS(value, "left");
+        }
+        else if (IsSameCSS(name, "valign") || IsSameCSS(name, "vertical-align"))
+        {
+            result.geometry &= ~(AlignTop | AlignVCenter | AlignBottom);
+            result.geometry |= IsSameCSS(value, "bottom") ? AlignBottom : IsSameCSS(value, "center") ?
+                AlignVCenter : AlignTop;
+            return IsSameCSS(value, "bottom") || IsSameCSS(value, "center") || IsSameCSS(value, "top");
+        }
+        else if (IsSameCSS(name, "align"))
+        {
+            if (IsSameCSS(value, "center")) result.geometry |= AlignCenter;
+            return IsSameCSS(value, "center");
+        }
+        else if (IsSameCSS(name, "overflow-x")) return (result.hofmode = ParseOverflowMode(value)).has_value();
+        else if (IsSameCSS(name, "overflow-y")) return (result.vofmode = ParseOverflowMode(value)).has_value();
+        else if (IsSameCSS(name, "overflow")) return (result.hofmode = result.vofmode = ParseOverflowMode(value)).has_value();
+
+        return false;
+    }
 
-        // TODO: Is this required?
-   //     if (regionIdx != -1 && available != ImRect{})
-   //     {
-   //         auto regionId = context.regions[regionIdx].id;
-   //         auto& state = context.GetState(regionId).state.region;
-   //         auto style = context.GetStyle(state.state, regionId);
-   //         
-            //available.Min.x += style.margin.left + style.border.left.thickness + style.padding.left;
-   //         available.Min.y += style.margin.top + style.border.top.thickness + style.padding.top;
-   //         available.Max.x -= style.margin.right + style.border.right.thickness + style.padding.right;
-            //available.Max.y -= style.margin.bottom + style.border.bottom.thickness + style.padding.bottom;
-   //     }
+    static void ParseLayoutDescription(std::string_view desc, CompiledLayout& result)
+    {
+        auto idx = 0;
 
-        auto sz = available.GetSize();
+        while (idx < (int)desc.size())
+        {
+            auto start = idx;
+            while ((idx < (int)desc.size()) && desc[idx] != ';') idx++;
 
-#ifdef _DEBUG
-        auto total = 0.f;
+            auto declaration = TrimCSS(desc.substr(start, idx - start));
+            if (idx < (int)desc.size()) idx++;
+            if (declaration.empty()) continue;
 
-        if (rowExtents.size() > 0)
-        {
-            for (auto rowext : rowExtents)
-            {
-                layout.rows.emplace_back(0.f, sz.y * rowext);
-                total += rowext;
-            }
+            auto colon = declaration.find(':');
+            auto name = TrimCSS(declaration.substr(0, colon));
+            auto value = colon == std::string_view::npos ? std::string_view{} : TrimCSS(declaration.substr(colon + 1u));
 
-            assert(total == 1.f);
-            assert(rows < 0 || rowExtents.size() == rows);
+            if (value.empty() || !ParseLayoutProperty(result, name, value))
+                LOGERROR("Invalid layout property... [%.*s]\n", (int)declaration.size(), declaration.data());
         }
 
-        total = 0.f;
+        // Wrapping in direction of layout is same as specifying wrap overflow
+        auto& mainmode = result.dir == DIR_Horizontal ? result.hofmode : result.vofmode;
+        if (mainmode.has_value() && mainmode.value() == OverflowMode::Wrap) result.wrap = true;
 
-        if (colExtents.size() > 0)
+        // Grid items wrap after the tracks in the direction of flow are exhausted
+        auto& wrapping = result.flow == GridLayoutDirection::ByRows ? result.cols : result.rows;
+        if (result.grid && wrapping.empty())
         {
-            for (auto colext : colExtents)
-            {
-                layout.cols.emplace_back(sz.x * colext, 0.f);
-                total += colext;
-            }
-
-            assert(total == 1.f);
-            assert(cols < 0 || colExtents.size() == cols);
+            LOGERROR("Grid layout requires %s template to place items... [%.*s]\n", result.flow == GridLayoutDirection::ByRows ?
+                "column" : "row", (int)desc.size(), desc.data());
+            wrapping.emplace_back();
         }
-#else
-        assert(rows < 0 || rowExtents.size() == rows);
-        for (auto rowext : rowExtents)
-            layout.rows.emplace_back(0.f, sz.y * rowext);
+    }
 
-        assert(cols < 0 || colExtents.size() == cols);
-        for (auto colext : colExtents)
-            layout.cols.emplace_back(sz.x * colext, 0.f);
+    static const CompiledLayout& CompileLayout(std::string_view desc)
+    {
+#ifndef GLIMMER_DISABLE_CSS_CACHING
+        auto it = CompiledLayouts.find(desc);
+        if (it != CompiledLayouts.end()) return it->second;
+
+        auto& compiled = CompiledLayouts.emplace(std::string{ desc }, CompiledLayout{}).first->second;
+        ParseLayoutDescription(desc, compiled);
+#else
+        static CompiledLayout compiled;
+        compiled = CompiledLayout{};
+        ParseLayoutDescription(desc, compiled);
 #endif
+        return compiled;
+    }
 
-        // If current layout is nested layout, create a layout item and add it
-        // to parent layout's child items
-        AddLayoutAsChildItem(context, layout, available);
+    static GridTrackSize ResolveGridTrack(const CompiledGridTrack& track, float ems)
+    {
+        GridTrackSize result{ track.type, track.value.value };
+        if (track.type == GridTrackType::Fixed) result.value = ResolveCSSLength(track.value, ems, 1.f, Config.scaling);
+        if (track.min.valid) result.min = ResolveCSSLength(track.min, ems, 1.f, Config.scaling);
+        return result;
+    }
 
-        layout.available = available;
-        layout.startpos = nextpos;
-        layout.extent.Min = { FLT_MAX, FLT_MAX };
-        layout.currow = layout.currcol = 0;
-        layout.geometry = ImRect{};
-        layout.regionIdx = regionIdx;
-        if (rows > 0 && cols > 0) GridLayoutItems.expand(rows * cols, true);
+    ImRect BeginLayout(std::string_view desc, const NeighborWidgets& neighbors)
+    {
+        auto& context = GetContext();
+        const auto& compiled = CompileLayout(desc);
+        auto ems = Config.defaultFontSz * Config.fontScaling;
 
-        if (regionIdx != -1)
+        // Percentage sizes are w.r.t. space available to the layout, and only apply if it is bounded
+        ImVec2 parent{};
+        if (compiled.size[0].unit == CSSUnit::Percent || compiled.size[1].unit == CSSUnit::Percent)
         {
-            auto regionId = context.regions[regionIdx].id;
-            auto& state = context.GetState(regionId).state.region;
-            auto style = context.GetStyle(state.state, regionId);
+            auto available = context.layoutStack.empty() ? GetAvailableSpace(context.NextAdHocPos(), neighbors) :
+                context.layouts[context.layoutStack.top()].available;
+            parent.x = available.Max.x == FLT_MAX ? 0.f : available.GetWidth();
+            parent.y = available.Max.y == FLT_MAX ? 0.f : available.GetHeight();
+        }
 
-            layout.startpos += ImVec2{ style.margin.left, style.margin.top };
+        auto resolve = [ems](CSSLength length, float extent) {
+            return length.valid ? ResolveCSSLength(length, ems, extent, Config.scaling) : 0.f;
+        };
+        ImVec2 spacing{ resolve(compiled.spacing[0], 0.f), resolve(compiled.spacing[1], 0.f) };
+        ImVec2 size{ resolve(compiled.size[0], parent.x), resolve(compiled.size[1], parent.y) };
+        ImRect result;
+
+        if (compiled.grid)
+        {
+            GridTrackSpecs.clear(true);
+            for (const auto& track : compiled.rows) GridTrackSpecs.push_back(ResolveGridTrack(track, ems));
+            for (const auto& track : compiled.cols) GridTrackSpecs.push_back(ResolveGridTrack(track, ems));
+
+            auto nrows = (int)compiled.rows.size(), ncols = (int)compiled.cols.size();
+            result = BeginGridLayoutRegion(nrows > 0 ? nrows : -1, ncols > 0 ? ncols : -1, compiled.flow, compiled.geometry,
+                Span<const GridTrackSize>{ GridTrackSpecs.data(), nrows }, Span<const GridTrackSize>{ GridTrackSpecs.data() + nrows, ncols },
+                spacing, size, neighbors, -1);
         }
+        else
+            result = BeginFlexLayoutRegion(compiled.dir, compiled.geometry, compiled.wrap, spacing, size, neighbors, -1);
 
-        layout.nextpos = layout.startpos;
-        return layout.geometry;
+        // Overflow modes are part of the layout's inputs, hence recompute the fingerprint if overridden
+        if (compiled.hofmode.has_value() || compiled.vofmode.has_value())
+        {
+            auto& layout = context.layouts[context.layoutStack.top()];
+            if (compiled.hofmode.has_value()) layout.hofmode = compiled.hofmode.value();
+            if (compiled.vofmode.has_value()) layout.vofmode = compiled.vofmode.value();
+            InitLayoutFingerprint(context, layout);
+        }
+
+        return result;
     }
 
-    ImRect BeginFlexLayout(Direction dir, int32_t geometry, bool wrap, ImVec2 spacing, 
-        ImVec2 size, const NeighborWidgets& neighbors)
+    void PrecompileLayout(std::string_view desc)
     {
-        return BeginFlexLayoutRegion(dir, geometry, wrap, spacing, size, neighbors, -1);
+        if (!desc.empty()) CompileLayout(desc);
     }
 
-    ImRect BeginGridLayout(int rows, int cols, GridLayoutDirection dir, int32_t geometry, const std::initializer_list<float>& rowExtents,
-        const std::initializer_list<float>& colExtents, ImVec2 spacing, ImVec2 size, const NeighborWidgets& neighbors)
+    void PrecompileLayout(const std::initializer_list<std::string_view>& descs)
     {
-        return BeginGridLayoutRegion(rows, cols, dir, geometry, rowExtents, colExtents, spacing, size, neighbors, -1);
+        for (auto desc : descs) PrecompileLayout(desc);
     }
 
-    ImRect BeginLayout(std::string_view desc, const NeighborWidgets& neighbors)
+    void ClearLayoutDescriptionCache()
     {
-        // TODO: Implement layout CSS parsing
-        return ImRect{};
+        CompiledLayouts.clear();
     }
 
+#pragma endregion
+
     void NextRow()
     {
         if (WidgetContextData::CacheItemGeometry) return;
@@ -1478,12 +2013,10 @@ namespace glimmer
 
             if (layout.type == Layout::Horizontal && layout.hofmode == OverflowMode::Wrap)
             {
+                HashLayoutInput(layout.fingerprint, RowBreakMarker);
 #if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
-                layout.cumulative.y += layout.maxdim.y;
-                layout.maxdim.y = 0.f;
-                layout.currcol = 0;
-                layout.currow++;
-                layout.rows[layout.currow].x = 0.f;
+                auto node = AddFlatFlexNode(GetFlatNode(layout.implData), FFN_FullW | FFN_FixedH, 0, -1);
+                FlatTree.size[node].y = 0.f;
 #elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE
                 YGNodeRef child = YGNodeNew();
                 auto parent = static_cast<YGNodeRef>(layout.implData);
@@ -1511,12 +2044,10 @@ namespace glimmer
 
             if (layout.type == Layout::Horizontal && layout.hofmode == OverflowMode::Wrap)
             {
+                HashLayoutInput(layout.fingerprint, ColumnBreakMarker);
 #if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
-                layout.cumulative.x += layout.maxdim.x;
-                layout.maxdim.x = 0.f;
-                layout.currow = 0;
-                layout.currcol++;
-                layout.cols[layout.currcol].y = 0.f;
+                auto node = AddFlatFlexNode(GetFlatNode(layout.implData), FFN_FullH | FFN_FixedW, 0, -1);
+                FlatTree.size[node].x = 0.f;
 #elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE
                 YGNodeRef child = YGNodeNew();
                 auto parent = static_cast<YGNodeRef>(layout.implData);
@@ -1750,6 +2281,21 @@ namespace glimmer
             
             break;
         }
+        case glimmer::WT_TextEditor: {
+            auto& state = context.GetState(item.id).state.editor;
+            const auto& style = GetStyle(context, item.id, StyleStack, state.state);
+            UpdateGeometry(item, bbox, style);
+
+            if (render)
+            {
+                context.AddItemGeometry(item.id, bbox);
+                result = TextEditorImpl(item.id, state, style, item.border, item.content, renderer, io);
+                if (!context.nestedContextStack.empty())
+                    RecordItemGeometry(item, style);
+            }
+
+            break;
+        }
         case glimmer::WT_DropDown: {
             auto& state = context.GetState(item.id).state.dropdown;
             const auto& style = GetStyle(context, item.id, StyleStack, state.state);
@@ -1847,21 +2393,6 @@ namespace glimmer
         return result;
     }
 
-    static ImVec2 GetTotalSize(GridLayoutItem& item, const LayoutBuilder& layout, int currow, int currcol)
-    {
-        auto totalw = 0.f;
-        for (auto col = 0; col < item.colspan; ++col)
-            totalw += layout.cols[currcol + col].x;
-        totalw += (float)(item.colspan - 1) * layout.spacing.x;
-
-        auto totalh = 0.f;
-        for (auto row = 0; row < item.rowspan; ++row)
-            totalh += layout.rows[currow + row].y;
-        totalh += (float)(item.rowspan - 1) * layout.spacing.y;
-
-        return { totalw, totalh };
-    }
-
     static void HAlignItemInGridCell(GridLayoutItem& item, const LayoutBuilder& layout, ImVec2 currpos, 
         float totalw)
     {
@@ -1979,153 +2510,252 @@ namespace glimmer
         }
     }
 
-    static void PerformGridLayout(LayoutBuilder& layout)
+    struct GridTrackState
     {
-        auto currow = 0, currcol = 0;
-        ImVec2 currpos = layout.geometry.Min + layout.spacing;
+        float base = 0.f;  // Resolved size of the track
+        float limit = 0.f; // Growth limit of the track, FLT_MAX if flexible
+        float flex = 0.f;  // Weight of a flexible track
+        bool contentMin = false, contentMax = false;
+    };
+
+    // Scratch arrays for track sizing, reused across grids and frames
+    static Vector<GridTrackState, int16_t, 64> GridTracks;
+    static Vector<int16_t, int16_t, 64> GridTrackOrder;
+
+    // Resolves track sizes along one axis of the grid, following the CSS grid track sizing algorithm:
+    // 1. Fixed and relative tracks are sized upfront, content-sized tracks start at their minimum
+    // 2. Items spanning a single track contribute their size to content-sized tracks
+    // 3. Spanning items, in increasing order of span, distribute their excess size over the
+    //    content-sized tracks they span
+    // 4. Tracks grow to their limits, then flexible tracks share the leftover space by weight
+    // Resolved tracks are written as (offset, size) pairs, so that extent of a span is O(1) to compute.
+    // Returns the total extent of tracks along the axis, including spacing.
+    static float SizeGridTracks(const LayoutBuilder& layout, bool rows, Vector<ImVec2, int16_t>& tracks)
+    {
+        const auto& specs = rows ? layout.rowTracks : layout.colTracks;
+        auto count = std::max((int)specs.size(), rows ? layout.gridsz.first : layout.gridsz.second);
 
-        if (layout.gpmethod == ItemGridPopulateMethod::ByRows)
+        for (auto idx : layout.griditems)
         {
-            if (layout.cols.empty())
-            {
-                Vector<float, int16_t> colmaxs{ (int16_t)layout.gridsz.second, 0.f };
+            const auto& item = GridLayoutItems[idx];
+            count = std::max(count, rows ? item.row + item.rowspan : item.col + item.colspan);
+        }
 
-                if (layout.fill & FD_Horizontal)
-                {
-                    auto cellw = layout.available.GetWidth() / (float)layout.gridsz.second;
+        auto gap = rows ? layout.spacing.y : layout.spacing.x;
+        auto bounded = rows ? layout.available.Max.y != FLT_MAX : layout.available.Max.x != FLT_MAX;
+        auto extent = bounded ? (rows ? layout.available.GetHeight() : layout.available.GetWidth()) : 0.f;
+        auto filled = (layout.fill & (rows ? FD_Vertical : FD_Horizontal)) != 0;
+        bounded = bounded && extent > 0.f;
 
-                    for (auto idx : layout.griditems)
-                    {
-                        auto& item = GridLayoutItems[idx];
-                        if (item.colspan == 1)
-                            colmaxs[item.col] = cellw;
-                    }
-                }
-                else
-                {
-                    for (auto idx : layout.griditems)
-                    {
-                        auto& item = GridLayoutItems[idx];
-                        if (item.colspan == 1)
-                            colmaxs[item.col] = std::max(colmaxs[item.col], item.maxdim.x);
-                    }
-                }
+        // Leftover space is only distributed if size of grid along the axis is known upfront
+        auto definite = bounded && (filled || (layout.alignment & (rows ? ExplicitV : ExplicitH)));
 
-                for (auto cidx = 0; cidx < colmaxs.size(); ++cidx)
-                    layout.cols.emplace_back(colmaxs[cidx], 0.f);
-            }
+        GridTracks.clear(true);
+        GridTracks.expand_and_create((int16_t)count, true);
 
-            for (auto idx : layout.griditems)
+        for (auto tidx = 0; tidx < count; ++tidx)
+        {
+            // Unspecified tracks of a filled axis share the available space equally
+            auto spec = tidx < specs.size() ? specs[tidx] : (filled && bounded) ?
+                GridTrackSize::MinMax(0.f, GridTrackSize::Fr()) : GridTrackSize::Auto();
+            auto& track = GridTracks[tidx];
+            if (spec.type == GridTrackType::Relative && !bounded) spec.type = GridTrackType::Auto;
+
+            switch (spec.type)
             {
-                auto& item = GridLayoutItems[idx];
-                if (item.row > currow)
-                {
-                    currpos.y += layout.rows[currow].y + layout.spacing.y;
-                    currpos.x = layout.geometry.Min.x + layout.spacing.x;
+            case GridTrackType::Fixed: track.limit = spec.value; break;
+            case GridTrackType::Relative: track.limit = spec.value * extent; break;
+            case GridTrackType::Fraction: track.limit = FLT_MAX; track.flex = spec.value; break;
+            default: track.contentMax = true; break;
+            }
 
-                    for (auto col = 0; col < item.col; ++col)
-                        currpos.x += layout.cols[col].x + layout.spacing.x;
+            track.contentMin = spec.min < 0.f && (spec.type == GridTrackType::Auto || spec.type == GridTrackType::Fraction);
+            track.base = spec.min >= 0.f ? spec.min : track.contentMin ? 0.f : track.limit;
+        }
 
-                    currow = item.row;
-                    currcol = 0;
-                }
-                
-                if (item.row == currow)
-                {
-                    auto [totalw, totalh] = GetTotalSize(item, layout, currow, currcol);
-                    AlignItemInGridCell(item, layout, currpos, totalw, totalh);
-                    currpos.x += totalw + layout.spacing.x;
-                    currcol += item.colspan;
+        GridTrackOrder.clear(true);
 
-                }
-                else assert(false);
+        for (auto idx : layout.griditems)
+        {
+            const auto& item = GridLayoutItems[idx];
+            if ((rows ? item.rowspan : item.colspan) > 1)
+            {
+                GridTrackOrder.push_back(idx);
+                continue;
             }
+
+            auto& track = GridTracks[rows ? item.row : item.col];
+            auto size = rows ? item.maxdim.y : item.maxdim.x;
+            if (track.contentMin) track.base = std::max(track.base, size);
+            if (track.contentMax) track.limit = std::max(track.limit, size);
         }
-        else
+
+        // Spanning items prefer growing content-sized tracks which are not flexible, as flexible
+        // tracks will anyway receive the leftover space
+        std::sort(GridTrackOrder.begin(), GridTrackOrder.end(), [rows](int16_t lhs, int16_t rhs) {
+            return rows ? GridLayoutItems[lhs].rowspan < GridLayoutItems[rhs].rowspan :
+                GridLayoutItems[lhs].colspan < GridLayoutItems[rhs].colspan;
+        });
+
+        for (auto idx : GridTrackOrder)
         {
-            if (layout.rows.empty())
+            const auto& item = GridLayoutItems[idx];
+            auto from = rows ? item.row : item.col;
+            auto to = from + (rows ? item.rowspan : item.colspan);
+            auto excess = (rows ? item.maxdim.y : item.maxdim.x) - gap * (float)(to - from - 1);
+            auto inflexible = 0, flexible = 0;
+
+            for (auto tidx = from; tidx < to; ++tidx)
             {
-                Vector<float, int16_t> colmaxs{ (int16_t)layout.gridsz.second, 0.f };
+                const auto& track = GridTracks[tidx];
+                excess -= track.base;
+                if (track.contentMin && track.flex > 0.f) ++flexible;
+                else if (track.contentMin) ++inflexible;
+            }
 
-                if (layout.fill & FD_Vertical)
-                {
-                    auto cellh = layout.available.GetHeight() / (float)layout.gridsz.first;
+            if (excess > 0.f && (inflexible + flexible) > 0)
+            {
+                auto share = excess / (float)(inflexible > 0 ? inflexible : flexible);
 
-                    for (auto idx : layout.griditems)
-                    {
-                        auto& item = GridLayoutItems[idx];
-                        if (item.rowspan == 1)
-                            colmaxs[item.row] = cellh;
-                    }
-                }
-                else
+                for (auto tidx = from; tidx < to; ++tidx)
                 {
-                    for (auto idx : layout.griditems)
-                    {
-                        auto& item = GridLayoutItems[idx];
-                        if (item.rowspan == 1)
-                            colmaxs[item.row] = std::max(colmaxs[item.row], item.maxdim.y);
-                    }
+                    auto& track = GridTracks[tidx];
+                    if (track.contentMin && ((track.flex > 0.f) == (inflexible == 0)))
+                        track.base += share;
                 }
-
-                for (auto cidx = 0; cidx < colmaxs.size(); ++cidx)
-                    layout.rows.emplace_back(0.f, colmaxs[cidx]);
             }
+        }
 
-            for (auto idx : layout.griditems)
+        // Grow inflexible tracks up to their limits, sharing free space equally. Visiting tracks in
+        // increasing order of room to grow freezes them as they reach their limit in a single pass.
+        auto free = extent - gap * (float)(count + 1);
+        GridTrackOrder.clear(true);
+
+        for (auto tidx = 0; tidx < count; ++tidx)
+        {
+            auto& track = GridTracks[tidx];
+            if (track.contentMax) track.limit = std::max(track.limit, track.base);
+            if (track.flex == 0.f)
             {
-                auto& item = GridLayoutItems[idx];
-                if (item.col > currcol)
-                {
-                    currpos.x += layout.cols[currcol].x + layout.spacing.x;
-                    currpos.y = layout.geometry.Min.y + layout.spacing.y;
+                if (!definite) track.base = std::max(track.base, track.limit);
+                else if (track.limit > track.base) GridTrackOrder.push_back((int16_t)tidx);
+                free -= track.base;
+            }
+        }
 
-                    for (auto row = 0; row < item.row; ++row)
-                        currpos.y += layout.cols[row].y + layout.spacing.y;
+        if (definite)
+        {
+            std::sort(GridTrackOrder.begin(), GridTrackOrder.end(), [](int16_t lhs, int16_t rhs) {
+                return (GridTracks[lhs].limit - GridTracks[lhs].base) < (GridTracks[rhs].limit - GridTracks[rhs].base);
+            });
 
-                    currcol = item.col;
-                    currow = 0;
-                }
-                
-                if (item.col == currcol)
-                {
-                    auto [totalw, totalh] = GetTotalSize(item, layout, currow, currcol);
-                    AlignItemInGridCell(item, layout, currpos, totalw, totalh);
-                    currpos.y += totalh + layout.spacing.y;
-                    currow += item.rowspan;
-                }
-                else assert(false);
+            auto remaining = (float)GridTrackOrder.size();
+            for (auto tidx : GridTrackOrder)
+            {
+                auto& track = GridTracks[tidx];
+                auto grow = std::min(track.limit - track.base, std::max(free, 0.f) / remaining);
+                track.base += grow;
+                free -= grow;
+                remaining -= 1.f;
             }
         }
 
-        ImVec2 min{ FLT_MAX, FLT_MAX }, max;
-        auto widgetidx = 0;
+        // Flexible tracks share the leftover space by weight, unless their base size exceeds their
+        // share, in which case they are treated as inflexible. Visiting tracks in decreasing order of
+        // base size per weight finds such tracks in a single pass. For an indefinite extent, flexible
+        // tracks are sized so that each gets at least its base size.
+        GridTrackOrder.clear(true);
+        auto weights = 0.f, frsize = 0.f;
 
-        // Loop through all layout items, and capture min/max coordinates
-        // to determine the occupied dimension i.e. implicit dimension
-        // NOTE: This needs to be done even if explicit dimension is specified
-        //       to correctly align layout items w.r.t specified dimension i.e.
-        //       x- or y-axis centering.
-        for (const auto [data, op] : layout.itemIndexes)
+        for (auto tidx = 0; tidx < count; ++tidx)
         {
-            switch (op)
+            const auto& track = GridTracks[tidx];
+            if (track.flex > 0.f)
             {
-            case LayoutOps::AddWidget:
+                GridTrackOrder.push_back((int16_t)tidx);
+                weights += track.flex;
+                frsize = std::max(frsize, track.base / track.flex);
+            }
+        }
+
+        if (definite && !GridTrackOrder.empty())
+        {
+            std::sort(GridTrackOrder.begin(), GridTrackOrder.end(), [](int16_t lhs, int16_t rhs) {
+                return GridTracks[lhs].base / GridTracks[lhs].flex > GridTracks[rhs].base / GridTracks[rhs].flex;
+            });
+
+            for (auto tidx : GridTrackOrder)
             {
-                ImRect bbox = GridLayoutItems[layout.griditems[widgetidx]].bbox;
-                ++widgetidx;
+                const auto& track = GridTracks[tidx];
+                frsize = std::max(free, 0.f) / std::max(weights, 1.f);
+                if (track.base <= frsize * track.flex) break;
 
-                min = ImMin(min, bbox.Min);
-                max = ImMax(max, bbox.Max);
-                break;
-            }
-            default:
-                break;
+                free -= track.base;
+                weights -= track.flex;
             }
         }
 
-        auto implicitW = max.x - min.x + (2.f * layout.spacing.x);
-        auto implicitH = max.y - min.y + (2.f * layout.spacing.y);
+        for (auto tidx : GridTrackOrder)
+        {
+            auto& track = GridTracks[tidx];
+            track.base = std::max(track.base, frsize * track.flex);
+        }
+
+        tracks.clear(true);
+        auto offset = gap;
+
+        for (auto tidx = 0; tidx < count; ++tidx)
+        {
+            tracks.emplace_back(offset, GridTracks[tidx].base);
+            offset += GridTracks[tidx].base + gap;
+        }
+
+        return std::max(offset, 2.f * gap);
+    }
+
+    // Place grid items in cells in layout local coordinates, returns implicit size of the grid
+    static ImVec2 PlaceGridItems(LayoutBuilder& layout)
+    {
+        ImVec2 implicit{ SizeGridTracks(layout, false, layout.cols), SizeGridTracks(layout, true, layout.rows) };
+
+        for (auto idx : layout.griditems)
+        {
+            auto& item = GridLayoutItems[idx];
+            const auto& col = layout.cols[item.col];
+            const auto& row = layout.rows[item.row];
+            const auto& lastcol = layout.cols[item.col + item.colspan - 1];
+            const auto& lastrow = layout.rows[item.row + item.rowspan - 1];
+
+            // Nested layouts update their size once they are done, hence refresh it here
+            item.bbox = ImRect{ ImVec2{}, item.maxdim };
+            AlignItemInGridCell(item, layout, layout.geometry.Min + ImVec2{ col.x, row.x },
+                lastcol.x + lastcol.y - col.x, lastrow.x + lastrow.y - row.x);
+        }
+
+        return implicit;
+    }
+
+    static void PerformGridLayout(WidgetContextData& context, LayoutBuilder& layout)
+    {
+        auto& cache = GetLayoutCache(context, layout);
+
+        if (!IsLayoutCached(cache, layout, 0, (size_t)layout.griditems.size()))
+        {
+            cache.fingerprint = layout.fingerprint;
+            cache.bounds = ImRect{ ImVec2{}, PlaceGridItems(layout) };
+            cache.items.clear();
+
+            for (auto idx : layout.griditems)
+                cache.items.push_back(GridLayoutItems[idx].bbox);
+        }
+        else
+        {
+            for (auto idx = 0; idx < layout.griditems.size(); ++idx)
+                GridLayoutItems[layout.griditems[idx]].bbox = cache.items[idx];
+        }
+
+        auto implicitW = cache.bounds.GetWidth();
+        auto implicitH = cache.bounds.GetHeight();
 
         // Based on the layout's geometry, align layout items. If layout can expand 
         // in either x- or y-axis, center items if alignment is set accordingly.
@@ -2184,7 +2814,6 @@ namespace glimmer
             layout.geometry.Max.y = layout.geometry.Min.y + implicitH;
         }
 
-        auto& context = GetContext();
         UpdateLayoutIfRegion(context, layout);
         context.AddItemGeometry(layout.id, layout.available);
 
@@ -2206,6 +2835,12 @@ namespace glimmer
             auto& root = LayContexts[LayoutRootStack.top()];
             lay_set_size_xy(&root.ctx, node, layout.geometry.GetWidth(), layout.geometry.GetHeight());
 
+#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+
+            auto node = GetFlatNode(item.implData);
+            FlatTree.size[node] = layout.geometry.GetSize();
+            FlatTree.flags[node] |= FFN_FixedW | FFN_FixedH;
+
 #endif
         }
         else UpdateParentNode(context, layout);
@@ -2223,20 +2858,11 @@ namespace glimmer
         }
     }
 
-#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE || GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE
-#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE
-
-    static void UpdateLayoutGeometry(YGNodeRef node, WidgetContextData& context, int lidx)
-    {
-        auto bbox = GetBoundingBox(node);
-
-#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE
+#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE || GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE || \
+    GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
 
-    static void UpdateLayoutGeometry(lay_id node, int ctxidx, WidgetContextData & context, int lidx)
+    static void UpdateLayoutGeometry(const ImRect& bbox, WidgetContextData& context, int lidx)
     {
-        auto bbox = GetBoundingBox(node, ctxidx);
-
-#endif
         auto& layout = context.layouts[lidx];
 
         layout.geometry.Min = layout.startpos + bbox.Min;
@@ -2277,8 +2903,50 @@ namespace glimmer
         {
 #if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
 
-            AlignLayoutAxisItems(layout);
-            AlignCrossAxisItems(layout, depth);
+            if (!IsParentFlexLayout(context))
+            {
+                auto& tree = FlatTree;
+                auto rootNode = GetFlatNode(layout.implData);
+                auto& cache = GetLayoutCache(context, layout);
+                auto total = tree.flags.size();
+                size_t layouts = 0, widgets = 0;
+
+                for (auto node = rootNode + 1; node < total; ++node)
+                {
+                    if (tree.root[node] != rootNode || tree.index[node] == -1) continue;
+                    if (tree.flags[node] & FFN_Layout) ++layouts;
+                    else ++widgets;
+                }
+
+                if (!IsLayoutCached(cache, layout, layouts, widgets))
+                {
+                    SolveFlatFlexTree(rootNode);
+                    cache.fingerprint = layout.fingerprint;
+                    cache.bounds = GetBoundingBox(rootNode);
+                    cache.layouts.clear();
+                    cache.items.clear();
+
+                    for (auto node = rootNode + 1; node < total; ++node)
+                    {
+                        if (tree.root[node] != rootNode || tree.index[node] == -1) continue;
+                        if (tree.flags[node] & FFN_Layout) cache.layouts.push_back(GetBoundingBox(node));
+                        else cache.items.push_back(GetBoundingBox(node));
+                    }
+                }
+
+                auto lidx = 0, widx = 0;
+                for (auto node = rootNode + 1; node < total; ++node)
+                {
+                    if (tree.root[node] != rootNode || tree.index[node] == -1) continue;
+                    if (tree.flags[node] & FFN_Layout) UpdateLayoutGeometry(cache.layouts[lidx++], context, tree.index[node]);
+                    else SetFlexItemBounds(tree.index[node], cache.items[widx++]);
+                }
+
+                UpdateLayoutGeometry(cache.bounds, context, tree.index[rootNode]);
+                context.AddItemGeometry(layout.id, layout.available);
+
+                UpdateParentNode(context, layout);
+            }
 
 #elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_CLAY_ENGINE
 
@@ -2294,12 +2962,30 @@ namespace glimmer
             {
                 auto rootNode = static_cast<YGNodeRef>(layout.implData);
                 auto& root = FlexLayoutRoots[FlexLayoutRootStack.top()];
-                YGNodeCalculateLayout(rootNode, YGUndefined, YGUndefined, YGDirectionLTR);
+                auto& cache = GetLayoutCache(context, layout);
+
+                // Nested flexbox layouts are part of this tree, hence their inputs are part of
+                // the root's fingerprint, solve the tree only if any of them changed
+                if (!IsLayoutCached(cache, layout, root.layouts.size(), root.widgets.size()))
+                {
+                    YGNodeCalculateLayout(rootNode, YGUndefined, YGUndefined, YGDirectionLTR);
+                    cache.fingerprint = layout.fingerprint;
+                    cache.bounds = GetBoundingBox(rootNode);
+                    cache.layouts.clear();
+                    cache.items.clear();
+
+                    for (auto [lidx, node] : root.layouts)
+                        cache.layouts.push_back(GetBoundingBox(node));
+                    for (auto [widx, node] : root.widgets)
+                        cache.items.push_back(GetBoundingBox(node));
+                }
 
-                for (auto [lidx, node] : root.layouts)
-                    UpdateLayoutGeometry(node, context, lidx);
+                for (auto idx = 0; idx < (int)root.layouts.size(); ++idx)
+                    UpdateLayoutGeometry(cache.layouts[idx], context, root.layouts[idx].first);
+                for (auto idx = 0; idx < (int)root.widgets.size(); ++idx)
+                    SetFlexItemBounds(root.widgets[idx].first, cache.items[idx]);
 
-                UpdateLayoutGeometry(rootNode, context, root.rootIdx);
+                UpdateLayoutGeometry(cache.bounds, context, root.rootIdx);
                 context.AddItemGeometry(layout.id, layout.available);
 
                 UpdateParentNode(context, layout);
@@ -2312,13 +2998,30 @@ namespace glimmer
             if (!isParentFlex)
             {
                 auto rootNode = reinterpret_cast<lay_id>(layout.implData);
-                auto& root = LayContexts[LayoutRootStack.top()];
-                lay_run_context(&(root.ctx));
+                auto ctxidx = LayoutRootStack.top();
+                auto& root = LayContexts[ctxidx];
+                auto& cache = GetLayoutCache(context, layout);
+
+                if (!IsLayoutCached(cache, layout, root.layouts.size(), root.widgets.size()))
+                {
+                    lay_run_context(&(root.ctx));
+                    cache.fingerprint = layout.fingerprint;
+                    cache.bounds = GetBoundingBox(rootNode, ctxidx);
+                    cache.layouts.clear();
+                    cache.items.clear();
+
+                    for (auto [lidx, node] : root.layouts)
+                        cache.layouts.push_back(GetBoundingBox(node, ctxidx));
+                    for (auto [widx, node] : root.widgets)
+                        cache.items.push_back(GetBoundingBox(node, ctxidx));
+                }
 
-                for (auto [lidx, node] : root.layouts)
-                    UpdateLayoutGeometry(node, LayoutRootStack.top(), context, lidx);
+                for (auto idx = 0; idx < (int)root.layouts.size(); ++idx)
+                    UpdateLayoutGeometry(cache.layouts[idx], context, root.layouts[idx].first);
+                for (auto idx = 0; idx < (int)root.widgets.size(); ++idx)
+                    SetFlexItemBounds(root.widgets[idx].first, cache.items[idx]);
 
-                UpdateLayoutGeometry(rootNode, LayoutRootStack.top(), context, root.rootIdx);
+                UpdateLayoutGeometry(cache.bounds, context, root.rootIdx);
                 context.AddItemGeometry(layout.id, layout.available);
 
                 UpdateParentNode(context, layout);
@@ -2326,7 +3029,7 @@ namespace glimmer
 
 #endif
         }
-        else if (layout.type == Layout::Grid) PerformGridLayout(layout);
+        else if (layout.type == Layout::Grid) PerformGridLayout(context, layout);
         else if (layout.type == Layout::ScrollRegion)
         {
             // This is a scroll region inside a layout hierarchy
@@ -2341,7 +3044,8 @@ namespace glimmer
         for (auto idx = 0; idx < WSI_Total; ++idx)
         {
             stack[idx].clear(true);
-            stack[idx].push() = context.StyleStack[idx][layout.styleStartIdx[idx]];
+            auto sidx = layout.styleStartIdx[idx];
+            stack[idx].push(context.StyleStack[idx].version(sidx)) = context.StyleStack[idx][sidx];
         }
     }
 
@@ -2393,7 +3097,12 @@ namespace glimmer
 
                 if (isFlexLayout)
                 {
-#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_CLAY_ENGINE
+#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+
+                    auto bbox = FlexItemBounds[(int16_t)data];
+                    UpdateItemGeometry(context, bbox, item, sublayout);
+
+#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_CLAY_ENGINE
 
                     auto& command = renderCommands.internalArray[widgetidx];
                     if (command.commandType == CLAY_RENDER_COMMAND_TYPE_CUSTOM)
@@ -2406,14 +3115,12 @@ namespace glimmer
 
 #elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE
 
-                    auto child = static_cast<YGNodeRef>(item.implData);
-                    auto bbox = GetBoundingBox(child);
+                    auto bbox = FlexItemBounds[(int16_t)data];
                     UpdateItemGeometry(context, bbox, item, sublayout);
 
 #elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE
 
-                    auto child = reinterpret_cast<lay_id>(item.implData);
-                    auto bbox = GetBoundingBox(child, LayoutRootStack.top());
+                    auto bbox = FlexItemBounds[(int16_t)data];
                     UpdateItemGeometry(context, bbox, item, sublayout);
 
 #endif
@@ -2439,7 +3146,7 @@ namespace glimmer
                 auto index = data >> 32;
                 assert(state < WSI_Total);
                 assert(index < context.layoutStyles[state].size());
-                styleStack[state].push() = context.layoutStyles[state][index];
+                styleStack[state].push(context.layoutStyles[state].version(index)) = context.layoutStyles[state][index];
                 break;
             }
             case LayoutOps::PopStyle:
@@ -2522,7 +3229,7 @@ namespace glimmer
             {
                 auto state = data & 0xffffffff;
                 auto index = data >> 32;
-                stack[state].push() = context.layoutStyles[state][index];
+                stack[state].push(context.layoutStyles[state].version(index)) = context.layoutStyles[state][index];
                 break;
             }
             case LayoutOps::PopStyle:
@@ -2567,6 +3274,25 @@ namespace glimmer
         }
     }
 
+    // A nested layout makes its parent dirty only through what the parent's solve consumes:
+    // its inputs if both are solved as one flexbox tree, otherwise its outer size
+    static void PropagateLayoutFingerprint(WidgetContextData& context, const LayoutBuilder& layout)
+    {
+        if (context.layoutStack.size() < 2) return;
+        auto& parent = context.layouts[context.layoutStack.top(1)];
+
+#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE || GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE || \
+    GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+        if ((layout.type == Layout::Horizontal || layout.type == Layout::Vertical) && IsParentFlexLayout(context))
+        {
+            HashLayoutInput(parent.fingerprint, layout.fingerprint);
+            return;
+        }
+#endif
+
+        HashLayoutInput(parent.fingerprint, layout.geometry.GetSize());
+    }
+
     static void RenderWidgets(WidgetContextData& context, LayoutBuilder& layout, WidgetDrawResult& result)
     {
         // This stores the data for replay of style push/pop operations within a layout block
@@ -2576,8 +3302,16 @@ namespace glimmer
         InitLocalRegionStack(context, layout, RegionStack);
 
         auto io = Config.platform->CurrentIO();
-        UpdateWidgetGeometryPass(context, layout, io, RegionStack, StyleStack);
-        RenderWidgetPass(context, layout, result, io, StyleStack);
+
+        {
+            LAYOUT_PHASE(align);
+            UpdateWidgetGeometryPass(context, layout, io, RegionStack, StyleStack);
+        }
+
+        {
+            LAYOUT_PHASE(replay);
+            RenderWidgetPass(context, layout, result, io, StyleStack);
+        }
     }
 
     WidgetDrawResult EndLayout(int depth)
@@ -2593,7 +3327,19 @@ namespace glimmer
         while (depth > 0 && !context.layoutStack.empty())
         {
             auto& layout = context.layouts[context.layoutStack.top()];
-            ComputeLayoutGeometry(context, layout);
+
+#ifdef GLIMMER_ENABLE_LAYOUT_STATS
+            if (context.layoutStack.size() == 1)
+                LayoutStats.measure += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() -
+                    LayoutMeasureStart).count() - (LayoutStats.solve - LayoutMeasureSolveStart);
+#endif
+
+            {
+                LAYOUT_PHASE(solve);
+                ComputeLayoutGeometry(context, layout);
+            }
+
+            PropagateLayoutFingerprint(context, layout);
             
             if (context.layoutStack.size() == 1)
             {
@@ -2625,8 +3371,14 @@ namespace glimmer
                 lay_reset_context(&root.ctx);
 
             NextFreeContextIdx = 0;
+#elif GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+            FlatTree.clear();
 #endif
 
+#if GLIMMER_FLEXBOX_ENGINE == GLIMMER_YOGA_ENGINE || GLIMMER_FLEXBOX_ENGINE == GLIMMER_SIMPLE_FLEX_ENGINE || \
+    GLIMMER_FLEXBOX_ENGINE == GLIMMER_FLAT_ENGINE
+            FlexItemBounds.clear();
+#endif
             GridLayoutItems.clear(true);
         }
 
@@ -2641,6 +3393,20 @@ namespace glimmer
     void InvalidateLayout()
     {
         WidgetContextData::CacheItemGeometry = false;
+
+        // Cached solutions are dropped as well, so that every layout is solved again
+        for (auto& cache : GetContext().layoutCache)
+            cache.fingerprint = 0;
+    }
+
+    const LayoutPhaseStats& GetLayoutStats()
+    {
+        return LayoutStats;
+    }
+
+    void ResetLayoutStats()
+    {
+        LayoutStats = LayoutPhaseStats{ LayoutStats.engine };
     }
 
 #pragma endregion
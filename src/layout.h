@@ -26,6 +26,14 @@ namespace glimmer
     ImRect BeginGridLayout(int rows, int cols, GridLayoutDirection dir, int32_t geometry, const std::initializer_list<float>& rowExtents = {},
         const std::initializer_list<float>& colExtents = {}, ImVec2 spacing = { 0.f, 0.f }, ImVec2 size = { 0.f, 0.f },
         const NeighborWidgets& neighbors = NeighborWidgets{});
+    // Grid with CSS-grid like track sizing, number of tracks in wrapping direction is determined by
+    // number of row/column tracks, tracks not specified in the other direction are auto-sized
+    ImRect BeginGridLayout(GridLayoutDirection dir, int32_t geometry, const std::initializer_list<GridTrackSize>& rowTracks,
+        const std::initializer_list<GridTrackSize>& colTracks, ImVec2 spacing = { 0.f, 0.f }, ImVec2 size = { 0.f, 0.f },
+        const NeighborWidgets& neighbors = NeighborWidgets{});
+    // Layout from a CSS like description, supported properties are display (flex/grid), flex-direction,
+    // flex-wrap, grid-auto-flow, grid-template-rows/-columns (px/em/%/fr/auto/minmax()/repeat()),
+    // gap/row-gap/column-gap, width, height, fill, halign, valign, align and overflow(-x/-y)
     ImRect BeginLayout(std::string_view desc, const NeighborWidgets& neighbors = NeighborWidgets{});
     void NextRow();
     void NextColumn();
@@ -34,5 +42,31 @@ namespace glimmer
     WidgetDrawResult EndLayout(int depth = 1);
 
     void CacheLayout();
-    void InvalidateLayout();
+    void InvalidateLayout(); // Also drops solutions cached per layout, they are solved again in next frame
+
+    // Layout descriptions passed to BeginLayout are parsed once and cached by their contents,
+    // precompile descriptions (ideally at startup) to avoid parsing them in the first frame
+    void PrecompileLayout(std::string_view desc);
+    void PrecompileLayout(const std::initializer_list<std::string_view>& descs);
+    void ClearLayoutDescriptionCache();
+
+    // Cumulative cost of layout phases since last reset, only collected when built with
+    // GLIMMER_ENABLE_LAYOUT_STATS. Times are in milliseconds. To compare engines, build once
+    // per GLIMMER_FLEXBOX_ENGINE, see the layout benchmark in test/benchmarks.
+    struct LayoutPhaseStats
+    {
+        std::string_view engine; // Flexbox engine the library is built with
+        float measure = 0.f; // Widget measurement and solver input setup, until EndLayout
+        float solve = 0.f; // Flexbox/grid solvers, including reuse of cached solutions
+        float align = 0.f; // Applying solved geometry to widgets
+        float replay = 0.f; // Rendering and event handling of recorded widgets
+        int32_t allocations = 0; // Allocation calls (glimmer containers) during above phases
+        int32_t layouts = 0;
+        int32_t items = 0;
+        int32_t solves = 0;
+        int32_t cacheHits = 0;
+    };
+
+    const LayoutPhaseStats& GetLayoutStats();
+    void ResetLayoutStats();
 }
@@ -6,6 +6,8 @@
 
 #include <string>
 #include <stdexcept>
+#include <chrono>
+#include <cmath>
 
 #if defined(GLIMMER_ENABLE_NFDEXT) && !defined(__EMSCRIPTEN__)
 #include <mutex>
@@ -546,9 +548,20 @@ namespace glimmer
 
     bool IPlatform::EnterFrame(float width, float height, const CustomEventData& custom)
     {
+        using namespace std::chrono;
+
+        // Requests made so far are served by this frame, the ones made while it is
+        // being rendered (i.e. by widgets) remain pending for the next frame
+        pendingFrames = std::max(std::max(pendingFrames, requestedFrames.exchange(0)) - 1, 0);
+
+        auto timer = timerDeadline.load();
+        if (timer != INT64_MAX && steady_clock::duration{ timer } <= steady_clock::now().time_since_epoch())
+            timerDeadline.compare_exchange_strong(timer, INT64_MAX);
+
         auto color = ToRGBA(bgcolor[0], bgcolor[1], bgcolor[2], bgcolor[3]);
+        insideFrame = Config.renderer->InitFrame(width, height, color, softwareCursor);
 
-        if (Config.renderer->InitFrame(width, height, color, softwareCursor))
+        if (insideFrame)
         {
             PopulateIODescriptor(custom);
             InitFrameData();
@@ -562,6 +575,8 @@ namespace glimmer
     void IPlatform::ExitFrame()
     {
         ++frameCount; ++deltaFrames;
+        if (insideFrame) ++renderedFrames;
+        insideFrame = false;
         totalDeltaTime += desc.deltaTime;
         maxFrameTime = std::max(maxFrameTime, desc.deltaTime);
 
@@ -570,6 +585,8 @@ namespace glimmer
 
         ResetFrameData();
 
+        if (settleFrames > 0) --settleFrames;
+
         if (totalDeltaTime > 1.f)
         {
 #ifdef _DEBUG
@@ -583,6 +600,14 @@ namespace glimmer
             LOG("*alloc calls in last 1s: %d | Allocated: %d bytes\n", TotalMallocs, AllocatedBytes);
             TotalMallocs = 0;
             AllocatedBytes = 0;
+#endif
+#ifdef GLIMMER_ENABLE_LAYOUT_STATS
+            const auto& layout = GetLayoutStats();
+            LOG("Layout (%.*s) in last 1s: measure %.2fms | solve %.2fms | align %.2fms | replay %.2fms | "
+                "layouts %d | items %d | solves %d | cache hits %d | *alloc calls %d\n", (int)layout.engine.size(),
+                layout.engine.data(), layout.measure, layout.solve, layout.align, layout.replay, layout.layouts,
+                layout.items, layout.solves, layout.cacheHits, layout.allocations);
+            ResetLayoutStats();
 #endif
             maxFrameTime = 0.f;
             totalDeltaTime = 0.f;
@@ -592,6 +617,80 @@ namespace glimmer
         Config.renderer->FinalizeFrame((int32_t)cursor);
     }
 
+    void IPlatform::RequestFrame(int32_t frames)
+    {
+        auto current = requestedFrames.load();
+        while (current < frames && !requestedFrames.compare_exchange_weak(current, frames));
+        WakeUpIfWaiting();
+    }
+
+    void IPlatform::RequestFrameAfter(float seconds)
+    {
+        using namespace std::chrono;
+
+        auto deadline = (steady_clock::now() + duration_cast<steady_clock::duration>(duration<float>{ seconds }))
+            .time_since_epoch().count();
+        auto current = timerDeadline.load();
+        while (deadline < current && !timerDeadline.compare_exchange_weak(current, deadline));
+        if (deadline < current) WakeUpIfWaiting();
+    }
+
+    FrameCounters IPlatform::frameCounters() const
+    {
+        return FrameCounters{ renderedFrames, targetFPS > 0 ? (int64_t)(idleTime * (double)targetFPS) : 0 };
+    }
+
+    // The loop publishes `waiting` before reading pending requests, and requests are published before
+    // `waiting` is read (both sequentially consistent). Hence, either the loop observes a concurrent
+    // request and does not block, or the requesting thread observes the loop waiting and wakes it up.
+    void IPlatform::WakeUpIfWaiting()
+    {
+        if (waiting.load())
+        {
+            wakeUps.fetch_add(1);
+            WakeUp();
+        }
+    }
+
+    int32_t IPlatform::NextFrameTimeout()
+    {
+        using namespace std::chrono;
+
+        if (!eventDriven || settleFrames > 0 || pendingFrames > 0) return 0;
+        waiting.store(true);
+
+        auto animation = requestedFrames.load() > 0 ? 0.f : anim::NextAnimationDeadline();
+        auto timeout = animation >= 0.f ? (int64_t)std::ceil(animation * 1000.f) : INT64_MAX;
+        auto timer = timerDeadline.load();
+
+        if (timer != INT64_MAX)
+        {
+            auto remaining = steady_clock::duration{ timer } - steady_clock::now().time_since_epoch();
+            timeout = std::min(timeout, std::max((int64_t)ceil<milliseconds>(remaining).count(), (int64_t)0));
+        }
+
+        if (timeout == 0) waiting.store(false);
+        return timeout == INT64_MAX ? -1 : (int32_t)std::min(timeout, (int64_t)INT32_MAX);
+    }
+
+    void IPlatform::EndFrameWait(float waited)
+    {
+        waiting.store(false);
+        idleTime += waited;
+    }
+
+    // Returns true if the loop was woken up by RequestFrame/RequestFrameAfter, wake up events
+    // are platform events but are not input
+    bool IPlatform::ConsumeWakeUps()
+    {
+        return wakeUps.exchange(0) > 0;
+    }
+
+    void IPlatform::SettleAfterInput()
+    {
+        if (eventDriven) settleFrames = GLIMMER_EVENT_SETTLE_FRAMES;
+    }
+
     float IPlatform::fps() const
     {
         return (float)frameCount / totalTime;
@@ -1140,6 +1239,7 @@ namespace glimmer {
             bgcolor[2] = (float)params.bgcolor[2] / 255.f;
             bgcolor[3] = (float)params.bgcolor[3] / 255.f;
             softwareCursor = params.softwareCursor;
+            eventDriven = params.eventDriven;
 
 #ifdef _DEBUG
             _CrtSetDbgFlag(_CRTDBG_DELAY_FREE_MEM_DF);
@@ -1154,6 +1254,18 @@ namespace glimmer {
             handlers.emplace_back(data, callback);
         }
 
+        void WakeUp() override
+        {
+            if (wakeEvent != 0)
+            {
+                SDL_Event event;
+                SDL_zero(event);
+                event.type = wakeEvent;
+                event.user.data1 = this;
+                SDL_PushEvent(&event);
+            }
+        }
+
         bool PollEvents(bool (*runner)(ImVec2, IPlatform&, void*), void* data)
         {
             // TODO: If using Blend2D renderer, additional changes are required to copy
@@ -1170,15 +1282,35 @@ namespace glimmer {
                 ImGui_ImplSDLRenderer3_Init(fallback);
 
             bool done = false;
+            if (eventDriven && wakeEvent == 0) wakeEvent = SDL_RegisterEvents(1);
+
             while (!done)
             {
                 auto resetCustom = false;
+
+                // Event is left in the queue, and processed below
+                if (auto timeout = NextFrameTimeout(); timeout != 0)
+                {
+                    auto start = SDL_GetTicksNS();
+                    SDL_WaitEventTimeout(nullptr, timeout);
+                    EndFrameWait((float)(SDL_GetTicksNS() - start) / (float)SDL_NS_PER_SECOND);
+                }
+
                 int width = 0, height = 0;
                 SDL_GetWindowSize(window, &width, &height);
 
                 SDL_Event event;
+                auto hadInput = false;
                 while (SDL_PollEvent(&event))
                 {
+                    // Wake up events only unblock the loop, and may share the type with custom user events
+                    if (wakeEvent != 0 && event.type == wakeEvent && event.user.data1 == this)
+                    {
+                        ConsumeWakeUps();
+                        continue;
+                    }
+
+                    hadInput = true;
                     ImGui_ImplSDL3_ProcessEvent(&event);
                     if (event.type == SDL_EVENT_QUIT)
                         done = true;
@@ -1191,6 +1323,7 @@ namespace glimmer {
                 }
 
                 if (done) break;
+                if (hadInput) SettleAfterInput();
 
                 // [If using SDL_MAIN_USE_CALLBACKS: all code below would likely be your SDL_AppIterate() function]
                 if (SDL_GetWindowFlags(window) & SDL_WINDOW_MINIMIZED)
@@ -1550,6 +1683,7 @@ namespace glimmer {
 
         std::vector<std::pair<void*, bool(*)(void*, const IODescriptor&)>> handlers;
         std::deque<CustomEventData> custom;
+        Uint32 wakeEvent = 0;
     };
 
     IPlatform* InitPlatform(ImVec2 size)
@@ -1717,6 +1851,13 @@ namespace glimmer {
             glfwMakeContextCurrent(window);
             glfwSwapInterval(1); // Enable vsync
 
+            targetFPS = params.targetFPS;
+            if (targetFPS == -1)
+            {
+                auto mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+                targetFPS = mode != nullptr ? mode->refreshRate : 60;
+            }
+
             // Setup Dear ImGui context
             IMGUI_CHECKVERSION();
             ImGui::CreateContext();
@@ -1747,6 +1888,7 @@ namespace glimmer {
             bgcolor[2] = (float)params.bgcolor[2] / 255.f;
             bgcolor[3] = (float)params.bgcolor[3] / 255.f;
             softwareCursor = params.softwareCursor;
+            eventDriven = params.eventDriven;
 
 #ifdef _DEBUG
             _CrtSetDbgFlag(_CRTDBG_DELAY_FREE_MEM_DF);
@@ -1772,7 +1914,23 @@ namespace glimmer {
             while (!glfwWindowShouldClose(window) && !close)
 #endif
             {
+#ifndef __EMSCRIPTEN__
+                if (auto timeout = NextFrameTimeout(); timeout != 0)
+                {
+                    // GLFW does not report whether events arrived, waking up before timeout implies it,
+                    // unless the loop was woken up by glfwPostEmptyEvent for a requested frame
+                    auto start = glfwGetTime();
+                    timeout == -1 ? glfwWaitEvents() : glfwWaitEventsTimeout((double)timeout / 1000.0);
+                    auto waited = glfwGetTime() - start;
+                    EndFrameWait((float)waited);
+
+                    if (!ConsumeWakeUps() && (timeout == -1 || waited < ((double)timeout / 1000.0)))
+                        SettleAfterInput();
+                }
+                else
+#endif
                 glfwPollEvents();
+
                 if (glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0)
                 {
                     ImGui_ImplGlfw_Sleep(10);
@@ -1888,6 +2046,13 @@ namespace glimmer {
             handlers.emplace_back(data, callback);
         }
 
+        void WakeUp() override
+        {
+#ifndef __EMSCRIPTEN__
+            glfwPostEmptyEvent();
+#endif
+        }
+
         GLFWwindow* window = nullptr;
 #if defined(GLIMMER_ENABLE_NFDEXT) && !defined(__EMSCRIPTEN__)
         std::once_flag nfdInitialized;
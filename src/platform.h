@@ -10,6 +10,7 @@
 #define GLIMMER_KEY_ENUM_END 667
 #endif
 
+#include <atomic>
 #include <string_view>
 #include <vector>
 #include <stdint.h>
@@ -250,6 +251,13 @@ namespace glimmer
         GraphicsAdapter adapter = GraphicsAdapter::Integrated;
         bool fallbackSoftwareAdapter = true;
         bool softwareCursor = false;
+        bool eventDriven = false; // Render only on input, requested frames or deadlines, see IPlatform::RequestFrame
+    };
+
+    struct FrameCounters
+    {
+        int64_t rendered = 0;
+        int64_t skipped = 0; // Frames not rendered at target FPS while waiting for events
     };
 
     struct UIConfig;
@@ -298,6 +306,13 @@ namespace glimmer
         UIConfig* config() const;
         bool hasModalDialog() const;
 
+        // In event-driven mode, platform loops block until input, a requested frame, a timer or an
+        // animation deadline, and render a few follow-up frames for widgets to settle after input.
+        // Frames can be requested from any thread.
+        void RequestFrame(int32_t frames = 1);
+        void RequestFrameAfter(float seconds);
+        FrameCounters frameCounters() const;
+
         IODescriptor desc;
         int32_t targetFPS = -1;
 
@@ -306,6 +321,15 @@ namespace glimmer
         bool EnterFrame(float w, float h, const CustomEventData& event);
         void ExitFrame();
 
+        // Milliseconds to wait for events before rendering next frame, -1 to wait indefinitely.
+        // A non-zero timeout marks the loop as waiting until EndFrameWait is called.
+        int32_t NextFrameTimeout();
+        void EndFrameWait(float waited);
+        bool ConsumeWakeUps();
+        void SettleAfterInput();
+        void WakeUpIfWaiting();
+        virtual void WakeUp() {}
+
         int64_t frameCount = 0;
         int32_t deltaFrames = 0;
         int32_t totalCustomEvents = 0;
@@ -316,6 +340,16 @@ namespace glimmer
         float bgcolor[4];
         bool softwareCursor = false;
         bool modalDialog = false;
+        bool eventDriven = false;
+        int32_t settleFrames = 0;
+        int32_t pendingFrames = 0; // Requested frames not yet rendered, taken from requestedFrames at frame start
+        int64_t renderedFrames = 0;
+        double idleTime = 0.0; // Seconds spent waiting for events
+        bool insideFrame = false;
+        std::atomic<bool> waiting = false;
+        std::atomic<int32_t> wakeUps = 0; // Wake up events posted to the loop, which are not input
+        std::atomic<int32_t> requestedFrames = 0;
+        std::atomic<int64_t> timerDeadline = INT64_MAX; // Steady clock ticks
     };
 
     IPlatform* InitPlatform(ImVec2 size = { -1.f, -1.f });
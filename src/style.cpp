@@ -1,14 +1,29 @@
 #include "types.h"
 #include "context.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cfloat>
 #include <cstring>
 #include <cstdio>
 #include <unordered_map>
 #include <variant>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+#include <atomic>
+#include <thread>
 #include "style.h"
 #include "platform.h"
 
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 namespace glimmer
 {
     // This maps the styles to classes/ids which do not follow the style stack.
@@ -16,9 +31,63 @@ namespace glimmer
     // corresponding styles, merged (with the current stack as well), and then applied.
     static std::unordered_map<std::string_view, StyleDescriptor[WSI_Total]> StyleSheet;
 
-#ifndef GLIMMER_DISABLE_CSS_CACHING
-    static std::unordered_map<std::string_view, StyleDescriptor> ParsedStyleSheets;
-#endif
+    // Parsed form of a CSS snippet, values are parsed on top of a default style, and only the
+    // fields (and flag bits) written by the snippet are applied to the destination style
+    // Widget specific properties written by a CSS snippet, these are not part of StyleDescriptor
+    // and are applied to widget specific style stacks instead
+    enum SpecificStyleField : uint32_t
+    {
+        SSF_ThumbColor = 1,
+        SSF_TrackColor = 1 << 1,
+        SSF_TrackOutline = 1 << 2,
+        SSF_ThumbOffset = 1 << 3
+    };
+
+    struct CompiledStyle
+    {
+        StyleDescriptor values;
+        ToggleButtonStyleDescriptor toggle;
+        uint64_t specified = 0;
+        uint32_t fields = 0;
+        uint32_t specificFields = 0;
+        int32_t fontFlags = 0;
+        int32_t alignment = 0;
+        uint32_t relativeProps = 0;
+    };
+
+    struct CompiledStyleHasher
+    {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+    };
+
+    // Compiled styles are keyed by CSS contents (the key owns a copy, as CSS can come from
+    // transient format buffers), and depend on the scaling parameters in UIConfig.
+    static std::unordered_map<std::string, CompiledStyle, CompiledStyleHasher, std::equal_to<>> CompiledStyles;
+    static StyleCacheStats CompiledStyleStats;
+    static float CompiledStyleScales[3] = { -1.f, -1.f, -1.f };
+
+    // Style stack depths at which widget specific styles were pushed along with a style, so that
+    // they are popped along with it
+    static std::vector<int32_t> SpecificStyleDepths[WSI_Total];
+
+    static const CompiledStyle& CompileStyle(std::string_view css);
+    static void ApplySpecificStyle(const CompiledStyle& compiled, ToggleButtonStyleDescriptor& dest);
+
+    // Versions to memoise resolved styles, see StyleStackT and GetStyle in context.cpp
+    static uint64_t StyleSheetVersion = 1;
+    static uint64_t UniqueStyleVersion = 0;
+
+    static uint64_t GetStyleVersion(uint64_t parent, std::string_view css)
+    {
+        return CombineStyleVersion(parent, std::hash<std::string_view>()(css)) & ~(1ull << 63);
+    }
+
+    static uint64_t GetStyleVersion(uint64_t parent, const StyleLiteral& css)
+    {
+        // Literals are static objects, hence address identifies the contents
+        return CombineStyleVersion(parent, (uint64_t)(uintptr_t)&css) & ~(1ull << 63);
+    }
 
 //#pragma optimize( "", on )
 
@@ -151,84 +220,34 @@ namespace glimmer
 
     [[nodiscard]] IntOrFloat ExtractNumber(std::string_view input, float defaultVal)
     {
-        float result = 0.f, base = 1.f;
-        bool isInt = false;
-        auto idx = (int)input.size() - 1;
-
-        while (idx >= 0 && input[idx] != '.') idx--;
-        auto decimal = idx;
-
-        if (decimal != -1)
-        {
-            for (auto midx = decimal - 1; midx >= 0; --midx)
-            {
-                result += (input[midx] - '0') * base;
-                base *= 10.f;
-            }
-
-            base = 0.1f;
-            for (auto midx = decimal + 1; midx < (int)input.size(); ++midx)
-            {
-                result += (input[midx] - '0') * base;
-                base *= 0.1f;
-            }
-        }
-        else
-        {
-            for (auto midx = (int)input.size() - 1; midx >= 0; --midx)
-            {
-                result += (input[midx] - '0') * base;
-                base *= 10.f;
-            }
-
-            isInt = true;
-        }
-
-        return { result, !isInt };
+        auto num = ParseCSSNumber(TrimCSS(input));
+        return num.valid ? IntOrFloat{ num.value, num.isFloat } : IntOrFloat{ defaultVal, true };
     }
 
     [[nodiscard]] float ExtractFloatWithUnit(std::string_view input, float defaultVal, float ems, float parent, float scale)
     {
-        float result = defaultVal, base = 1.f;
-        auto idx = (int)input.size() - 1;
-        while (!std::isdigit(input[idx]) && idx >= 0) idx--;
-
-        if (AreSame(input.substr(idx + 1), "pt")) scale = 1.3333f;
-        else if (AreSame(input.substr(idx + 1), "em")) scale = ems;
-        else if (input[idx + 1] == '%') scale = parent * 0.01f;
+        auto length = ParseCSSLength(input);
+        if (length.valid) return ResolveCSSLength(length, ems, parent, scale);
 
-        auto num = ExtractNumber(input.substr(0, idx + 1), defaultVal);
-        result = num.value;
-
-        return result * scale;
+        // Unknown units are treated as pixels
+        auto num = ParseCSSNumber(TrimCSS(input));
+        return num.valid ? num.value * scale : defaultVal;
     }
 
     [[nodiscard]] FourSidedMeasure ExtractWithUnit(std::string_view input, float defaultVal, float ems, float parent, float scale)
     {
-        FourSidedMeasure result;
-        auto idx = SkipSpace(input, 0);
-        auto end = (int)input.size();
-        while ((idx < end) && !std::isspace(input[idx])) idx++;
-        result.top = result.bottom = result.left = result.right = ExtractFloatWithUnit(input.substr(0, idx), defaultVal, ems, parent, scale);
-        idx = SkipSpace(input, idx);
-
-        if (idx < ((int)input.size() - 1))
+        auto sides = ParseCSSFourSided(input);
+        if (sides.count == 0)
         {
-            auto start = idx;
-            while ((idx < end) && !std::isspace(input[idx])) idx++;
-            result.right = ExtractFloatWithUnit(input.substr(start, idx - start), defaultVal, ems, parent, scale);
-            idx = SkipSpace(input, idx);
-
-            start = idx;
-            while ((idx < end) && !std::isspace(input[idx])) idx++;
-            result.bottom = ExtractFloatWithUnit(input.substr(start, idx - start), defaultVal, ems, parent, scale);
-            idx = SkipSpace(input, idx);
-
-            start = idx;
-            while ((idx < end) && !std::isspace(input[idx])) idx++;
-            result.left = ExtractFloatWithUnit(input.substr(start, idx - start), defaultVal, ems, parent, scale);
+            auto value = ExtractFloatWithUnit(input, defaultVal, ems, parent, scale);
+            return FourSidedMeasure{ value, value, value, value };
         }
 
+        FourSidedMeasure result;
+        result.top = ResolveCSSLength(sides.top, ems, parent, scale);
+        result.left = ResolveCSSLength(sides.left, ems, parent, scale);
+        result.right = ResolveCSSLength(sides.right, ems, parent, scale);
+        result.bottom = ResolveCSSLength(sides.bottom, ems, parent, scale);
         return result;
     }
 
@@ -277,30 +296,12 @@ namespace glimmer
 
     [[nodiscard]] uint32_t ExtractColor(std::string_view stylePropVal, uint32_t(*NamedColor)(const char*, void*), void* userData)
     {
-        if (stylePropVal.size() >= 3u && AreSame(stylePropVal.substr(0, 3), "rgb"))
-        {
-            IntOrFloat r, g, b, a;
-            auto hasAlpha = stylePropVal[3] == 'a' || stylePropVal[3] == 'A';
-            int curr = hasAlpha ? 4 : 3;
-            std::tie(r, g, b, a) = GetCommaSeparatedNumbers(stylePropVal, curr);
-            auto isRelative = r.isFloat && g.isFloat && b.isFloat;
-            a.value = isRelative ? hasAlpha ? a.value : 1.f :
-                hasAlpha ? a.value : 255;
+        stylePropVal = TrimCSS(stylePropVal);
 
-            assert(stylePropVal[curr] == ')');
-            return isRelative ? ToRGBA(r.value, g.value, b.value, a.value) :
-                ToRGBA((int)r.value, (int)g.value, (int)b.value, (int)a.value);
-        }
-        else if (AreSame(stylePropVal, "transparent"))
-        {
-            return ToRGBA(0, 0, 0, 0);
-        }
-        else if (NamedColor != nullptr)
+        // Hex, rgb/rgba and transparent share the grammar with compile-time CSS literals
+        if (auto color = ParseCSSColor(stylePropVal, false); color.valid)
         {
-            static char buffer[32] = { 0 };
-            memset(buffer, 0, 32);
-            memcpy(buffer, stylePropVal.data(), std::min((int)stylePropVal.size(), 31));
-            return NamedColor(buffer, userData);
+            return color.value;
         }
         else if (stylePropVal.size() >= 3u && AreSame(stylePropVal.substr(0, 3), "hsv"))
         {
@@ -322,9 +323,12 @@ namespace glimmer
             assert(stylePropVal[curr] == ')');
             return ImColor::HSV(h.value, s.value, v);
         }
-        else if (stylePropVal.size() >= 1u && stylePropVal[0] == '#')
+        else if (NamedColor != nullptr)
         {
-            return (uint32_t)ExtractIntFromHex(stylePropVal.substr(1), 0);
+            static char buffer[32] = { 0 };
+            memset(buffer, 0, 32);
+            memcpy(buffer, stylePropVal.data(), std::min((int)stylePropVal.size(), 31));
+            return NamedColor(buffer, userData);
         }
         else
         {
@@ -354,269 +358,30 @@ namespace glimmer
 
     ColorGradient ExtractLinearGradient(std::string_view input, uint32_t(*NamedColor)(const char*, void*), void* userData)
     {
-        ColorGradient gradient;
-        auto idx = 15; // size of "linear-gradient" string
-
-        if (idx < (int)input.size())
-        {
-            idx = SkipSpace(input, idx);
-            assert(input[idx] == '(');
-            idx++;
-            idx = SkipSpace(input, idx);
-
-            std::optional<std::pair<uint32_t, float>> lastStop = std::nullopt;
-            auto firstPart = true;
-            auto start = idx;
-            auto total = 0.f, unspecified = 0.f;
-
-            do
-            {
-                idx = SkipSpace(input, idx);
-
-                auto start = idx;
-                while ((idx < (int)input.size()) && (input[idx] != ',') && (input[idx] != ')')
-                    && !std::isspace(input[idx])) idx++;
-                auto part = input.substr(start, idx - start);
-                idx = SkipSpace(input, idx);
-                auto isEnd = input[idx] == ')';
-
-                if ((idx < (int)input.size()) && (input[idx] == ',' || isEnd)) {
-                    if (firstPart)
-                    {
-                        if (AreSame(input, "to right")) {
-                            gradient.dir = ImGuiDir::ImGuiDir_Right;
-                        }
-                        else if (AreSame(input, "to left")) {
-                            gradient.dir = ImGuiDir::ImGuiDir_Left;
-                        }
-                        else {
-                            auto colorstop = ExtractColorStop(part, NamedColor, userData);
-                            if (colorstop.second != -1.f) total += colorstop.second;
-                            else unspecified += 1.f;
-                            lastStop = colorstop;
-                        }
-                        firstPart = false;
-                    }
-                    else {
-                        auto colorstop = ExtractColorStop(part, NamedColor, userData);
-                        if (colorstop.second != -1.f) total += colorstop.second;
-                        else unspecified += 1.f;
-
-                        if (lastStop.has_value())
-                        {
-                            gradient.colorStops[gradient.totalStops] =
-                                ColorStop{ lastStop.value().first, colorstop.first, colorstop.second };
-                            gradient.totalStops = std::min(gradient.totalStops + 1, GLIMMER_MAX_COLORSTOPS - 1);
-                        }
-
-                        lastStop = colorstop;
-                    }
-                }
-                else break;
+        auto parsed = ParseCSSLinearGradient(input);
+        if (!parsed.valid) return ColorGradient{};
 
-                if (isEnd) break;
-                else if (input[idx] == ',') idx++;
-            } while ((idx < (int)input.size()) && (input[idx] != ')'));
-
-            unspecified -= 1.f;
-            for (auto& colorstop : gradient.colorStops)
-                if (colorstop.pos == -1.f) colorstop.pos = (100.f - total) / (100.f * unspecified);
-                else colorstop.pos /= 100.f;
-        }
-
-        return gradient;
+        return ToColorGradient(parsed, [NamedColor, userData](std::string_view color) {
+            return ExtractColor(color, NamedColor, userData);
+        });
     }
 
-    template <int maxsz>
-    struct CaseInsensitiveHasher
-    {
-        std::size_t operator()(std::string_view key) const
-        {
-            thread_local static char buffer[maxsz] = { 0 };
-            memset(buffer, 0, maxsz);
-            auto limit = std::min((int)key.size(), maxsz - 1);
-
-            for (auto idx = 0; idx < limit; ++idx)
-                buffer[idx] = std::tolower(key[idx]);
-
-            return std::hash<std::string_view>()(buffer);
-        }
-    };
-
     uint32_t GetColor(const char* name, void*)
     {
-        const static std::unordered_map<std::string_view, uint32_t, CaseInsensitiveHasher<32>> Colors{
-            { "black", ToRGBA(0, 0, 0) },
-            { "silver", ToRGBA(192, 192, 192) },
-            { "gray", ToRGBA(128, 128, 128) },
-            { "white", ToRGBA(255, 255, 255) },
-            { "maroon", ToRGBA(128, 0, 0) },
-            { "red", ToRGBA(255, 0, 0) },
-            { "purple", ToRGBA(128, 0, 128) },
-            { "fuchsia", ToRGBA(255, 0, 255) },
-            { "green", ToRGBA(0, 128, 0) },
-            { "lime", ToRGBA(0, 255, 0) },
-            { "olive", ToRGBA(128, 128, 0) },
-            { "yellow", ToRGBA(255, 255, 0) },
-            { "navy", ToRGBA(0, 0, 128) },
-            { "blue", ToRGBA(0, 0, 255) },
-            { "teal", ToRGBA(0, 128, 128) },
-            { "aqua", ToRGBA(0, 255, 255) },
-            { "aliceblue", ToRGBA(240, 248, 255) },
-            { "antiquewhite", ToRGBA(250, 235, 215) },
-            { "aquamarine", ToRGBA(127, 255, 212) },
-            { "azure", ToRGBA(240, 255, 255) },
-            { "beige", ToRGBA(245, 245, 220) },
-            { "bisque", ToRGBA(255, 228, 196) },
-            { "blanchedalmond", ToRGBA(255, 235, 205) },
-            { "blueviolet", ToRGBA(138, 43, 226) },
-            { "brown", ToRGBA(165, 42, 42) },
-            { "burlywood", ToRGBA(222, 184, 135) },
-            { "cadetblue", ToRGBA(95, 158, 160) },
-            { "chartreuse", ToRGBA(127, 255, 0) },
-            { "chocolate", ToRGBA(210, 105, 30) },
-            { "coral", ToRGBA(255, 127, 80) },
-            { "cornflowerblue", ToRGBA(100, 149, 237) },
-            { "cornsilk", ToRGBA(255, 248, 220) },
-            { "crimson", ToRGBA(220, 20, 60) },
-            { "darkblue", ToRGBA(0, 0, 139) },
-            { "darkcyan", ToRGBA(0, 139, 139) },
-            { "darkgoldenrod", ToRGBA(184, 134, 11) },
-            { "darkgray", ToRGBA(169, 169, 169) },
-            { "darkgreen", ToRGBA(0, 100, 0) },
-            { "darkgrey", ToRGBA(169, 169, 169) },
-            { "darkkhaki", ToRGBA(189, 183, 107) },
-            { "darkmagenta", ToRGBA(139, 0, 139) },
-            { "darkolivegreen", ToRGBA(85, 107, 47) },
-            { "darkorange", ToRGBA(255, 140, 0) },
-            { "darkorchid", ToRGBA(153, 50, 204) },
-            { "darkred", ToRGBA(139, 0, 0) },
-            { "darksalmon", ToRGBA(233, 150, 122) },
-            { "darkseagreen", ToRGBA(143, 188, 143) },
-            { "darkslateblue", ToRGBA(72, 61, 139) },
-            { "darkslategray", ToRGBA(47, 79, 79) },
-            { "darkslategray", ToRGBA(47, 79, 79) },
-            { "darkturquoise", ToRGBA(0, 206, 209) },
-            { "darkviolet", ToRGBA(148, 0, 211) },
-            { "deeppink", ToRGBA(255, 20, 147) },
-            { "deepskyblue", ToRGBA(0, 191, 255) },
-            { "dimgray", ToRGBA(105, 105, 105) },
-            { "dimgrey", ToRGBA(105, 105, 105) },
-            { "dodgerblue", ToRGBA(30, 144, 255) },
-            { "firebrick", ToRGBA(178, 34, 34) },
-            { "floralwhite", ToRGBA(255, 250, 240) },
-            { "forestgreen", ToRGBA(34, 139, 34) },
-            { "gainsboro", ToRGBA(220, 220, 220) },
-            { "ghoshtwhite", ToRGBA(248, 248, 255) },
-            { "gold", ToRGBA(255, 215, 0) },
-            { "goldenrod", ToRGBA(218, 165, 32) },
-            { "greenyellow", ToRGBA(173, 255, 47) },
-            { "honeydew", ToRGBA(240, 255, 240) },
-            { "hotpink", ToRGBA(255, 105, 180) },
-            { "indianred", ToRGBA(205, 92, 92) },
-            { "indigo", ToRGBA(75, 0, 130) },
-            { "ivory", ToRGBA(255, 255, 240) },
-            { "khaki", ToRGBA(240, 230, 140) },
-            { "lavender", ToRGBA(230, 230, 250) },
-            { "lavenderblush", ToRGBA(255, 240, 245) },
-            { "lawngreen", ToRGBA(124, 252, 0) },
-            { "lemonchiffon", ToRGBA(255, 250, 205) },
-            { "lightblue", ToRGBA(173, 216, 230) },
-            { "lightcoral", ToRGBA(240, 128, 128) },
-            { "lightcyan", ToRGBA(224, 255, 255) },
-            { "lightgoldenrodyellow", ToRGBA(250, 250, 210) },
-            { "lightgray", ToRGBA(211, 211, 211) },
-            { "lightgreen", ToRGBA(144, 238, 144) },
-            { "lightgrey", ToRGBA(211, 211, 211) },
-            { "lightpink", ToRGBA(255, 182, 193) },
-            { "lightsalmon", ToRGBA(255, 160, 122) },
-            { "lightseagreen", ToRGBA(32, 178, 170) },
-            { "lightskyblue", ToRGBA(135, 206, 250) },
-            { "lightslategray", ToRGBA(119, 136, 153) },
-            { "lightslategrey", ToRGBA(119, 136, 153) },
-            { "lightsteelblue", ToRGBA(176, 196, 222) },
-            { "lightyellow", ToRGBA(255, 255, 224) },
-            { "lilac", ToRGBA(200, 162, 200) },
-            { "limegreen", ToRGBA(50, 255, 50) },
-            { "linen", ToRGBA(250, 240, 230) },
-            { "mediumaquamarine", ToRGBA(102, 205, 170) },
-            { "mediumblue", ToRGBA(0, 0, 205) },
-            { "mediumorchid", ToRGBA(186, 85, 211) },
-            { "mediumpurple", ToRGBA(147, 112, 219) },
-            { "mediumseagreen", ToRGBA(60, 179, 113) },
-            { "mediumslateblue", ToRGBA(123, 104, 238) },
-            { "mediumspringgreen", ToRGBA(0, 250, 154) },
-            { "mediumturquoise", ToRGBA(72, 209, 204) },
-            { "mediumvioletred", ToRGBA(199, 21, 133) },
-            { "midnightblue", ToRGBA(25, 25, 112) },
-            { "mintcream", ToRGBA(245, 255, 250) },
-            { "mistyrose", ToRGBA(255, 228, 225) },
-            { "moccasin", ToRGBA(255, 228, 181) },
-            { "navajowhite", ToRGBA(255, 222, 173) },
-            { "oldlace", ToRGBA(253, 245, 230) },
-            { "olivedrab", ToRGBA(107, 142, 35) },
-            { "orange", ToRGBA(255, 165, 0) },
-            { "orangered", ToRGBA(255, 69, 0) },
-            { "orchid", ToRGBA(218, 112, 214) },
-            { "palegoldenrod", ToRGBA(238, 232, 170) },
-            { "palegreen", ToRGBA(152, 251, 152) },
-            { "paleturquoise", ToRGBA(175, 238, 238) },
-            { "palevioletred", ToRGBA(219, 112, 147) },
-            { "papayawhip", ToRGBA(255, 239, 213) },
-            { "peachpuff", ToRGBA(255, 218, 185) },
-            { "peru", ToRGBA(205, 133, 63) },
-            { "pink", ToRGBA(255, 192, 203) },
-            { "plum", ToRGBA(221, 160, 221) },
-            { "powderblue", ToRGBA(176, 224, 230) },
-            { "rosybrown", ToRGBA(188, 143, 143) },
-            { "royalblue", ToRGBA(65, 105, 225) },
-            { "saddlebrown", ToRGBA(139, 69, 19) },
-            { "salmon", ToRGBA(250, 128, 114) },
-            { "sandybrown", ToRGBA(244, 164, 96) },
-            { "seagreen", ToRGBA(46, 139, 87) },
-            { "seashell", ToRGBA(255, 245, 238) },
-            { "sienna", ToRGBA(160, 82, 45) },
-            { "skyblue", ToRGBA(135, 206, 235) },
-            { "slateblue", ToRGBA(106, 90, 205) },
-            { "slategray", ToRGBA(112, 128, 144) },
-            { "slategrey", ToRGBA(112, 128, 144) },
-            { "snow", ToRGBA(255, 250, 250) },
-            { "springgreen", ToRGBA(0, 255, 127) },
-            { "steelblue", ToRGBA(70, 130, 180) },
-            { "tan", ToRGBA(210, 180, 140) },
-            { "thistle", ToRGBA(216, 191, 216) },
-            { "tomato", ToRGBA(255, 99, 71) },
-            { "violet", ToRGBA(238, 130, 238) },
-            { "wheat", ToRGBA(245, 222, 179) },
-            { "whitesmoke", ToRGBA(245, 245, 245) },
-            { "yellowgreen", ToRGBA(154, 205, 50) }
-        };
-
-        auto it = Colors.find(name);
-        return it != Colors.end() ? it->second : uint32_t{ 0 };
+        auto color = CSSNamedColorTable.find(name);
+        return color != nullptr ? *color : uint32_t{ 0 };
     }
 
     Border ExtractBorder(std::string_view input, float ems, float percent,
         uint32_t(*NamedColor)(const char*, void*), void* userData)
     {
         Border result;
-        auto idx = WholeWord(input);
-
-        if (AreSame(input.substr(0, idx), "none")) return result;
-        result.thickness = ExtractFloatWithUnit(input.substr(0, idx), 1.f, ems, percent, 1.f);
-        idx = SkipSpace(input, idx);
-
-        auto idx2 = WholeWord(input, idx + 1);
-        auto type = input.substr(idx + 1, idx2);
-        if (AreSame(type, "solid")) result.lineType = LineType::Solid;
-        else if (AreSame(type, "dashed")) result.lineType = LineType::Dashed;
-        else if (AreSame(type, "dotted")) result.lineType = LineType::Dotted;
-
-        idx2 = SkipSpace(input, idx2);
-        auto idx3 = WholeWord(input, idx2 + 1);
-        auto color = input.substr(idx2, idx3);
-        result.color = ExtractColor(color, NamedColor, userData);
+        auto parsed = ParseCSSBorder(input);
+        if (parsed.none) return result;
 
+        result.thickness = ResolveCSSLength(parsed.thickness, ems, percent, 1.f);
+        result.lineType = parsed.lineType;
+        result.color = parsed.color.empty() ? IM_COL32_BLACK : ExtractColor(parsed.color, NamedColor, userData);
         return result;
     }
 
@@ -800,30 +565,33 @@ namespace glimmer
         std::string_view stylePropName, std::string_view stylePropVal, UIConfig& Config)
     {
         int prop = NoStyleChange;
-
-        if (AreSame(stylePropName, "font-size"))
-        {
-            if (AreSame(stylePropVal, "xx-small")) style.font.size = Config.defaultFontSz * 0.6f * Config.fontScaling;
-            else if (AreSame(stylePropVal, "x-small")) style.font.size = Config.defaultFontSz * 0.75f * Config.fontScaling;
-            else if (AreSame(stylePropVal, "small")) style.font.size = Config.defaultFontSz * 0.89f * Config.fontScaling;
-            else if (AreSame(stylePropVal, "medium")) style.font.size = Config.defaultFontSz * Config.fontScaling;
-            else if (AreSame(stylePropVal, "large")) style.font.size = Config.defaultFontSz * 1.2f * Config.fontScaling;
-            else if (AreSame(stylePropVal, "x-large")) style.font.size = Config.defaultFontSz * 1.5f * Config.fontScaling;
-            else if (AreSame(stylePropVal, "xx-large")) style.font.size = Config.defaultFontSz * 2.f * Config.fontScaling;
-            else if (AreSame(stylePropVal, "xxx-large")) style.font.size = Config.defaultFontSz * 3.f * Config.fontScaling;
+        auto property = GetCSSProperty(stylePropName);
+
+        if (property == CSSProperty::FontSize)
+        {
+            auto keyword = GetCSSKeyword(stylePropVal);
+            if (keyword == CSSKeyword::XXSmall) style.font.size = Config.defaultFontSz * 0.6f * Config.fontScaling;
+            else if (keyword == CSSKeyword::XSmall) style.font.size = Config.defaultFontSz * 0.75f * Config.fontScaling;
+            else if (keyword == CSSKeyword::Small) style.font.size = Config.defaultFontSz * 0.89f * Config.fontScaling;
+            else if (keyword == CSSKeyword::Medium) style.font.size = Config.defaultFontSz * Config.fontScaling;
+            else if (keyword == CSSKeyword::Large) style.font.size = Config.defaultFontSz * 1.2f * Config.fontScaling;
+            else if (keyword == CSSKeyword::XLarge) style.font.size = Config.defaultFontSz * 1.5f * Config.fontScaling;
+            else if (keyword == CSSKeyword::XXLarge) style.font.size = Config.defaultFontSz * 2.f * Config.fontScaling;
+            else if (keyword == CSSKeyword::XXXLarge) style.font.size = Config.defaultFontSz * 3.f * Config.fontScaling;
             else
                 style.font.size = ExtractFloatWithUnit(stylePropVal, Config.defaultFontSz * Config.fontScaling,
                     Config.defaultFontSz * Config.fontScaling, 1.f, Config.fontScaling);
             prop = StyleFontSize;
         }
-        else if (AreSame(stylePropName, "font-weight"))
+        else if (property == CSSProperty::FontWeight)
         {
+            auto keyword = GetCSSKeyword(stylePropVal);
             auto idx = SkipDigits(stylePropVal);
 
             if (idx == 0)
             {
-                if (AreSame(stylePropVal, "bold")) style.font.flags |= FontStyleBold;
-                else if (AreSame(stylePropVal, "light")) style.font.flags |= FontStyleLight;
+                if (keyword == CSSKeyword::Bold) style.font.flags |= FontStyleBold;
+                else if (keyword == CSSKeyword::Light) style.font.flags |= FontStyleLight;
                 else LOGERROR("Invalid font-weight property value... [%.*s]\n",
                     (int)stylePropVal.size(), stylePropVal.data());
             }
@@ -836,146 +604,150 @@ namespace glimmer
 
             prop = StyleFontWeight;
         }
-        else if (AreSame(stylePropName, "text-wrap"))
+        else if (property == CSSProperty::TextWrap)
         {
-            if (AreSame(stylePropVal, "nowrap")) style.font.flags |= FontStyleNoWrap;
+            auto keyword = GetCSSKeyword(stylePropVal);
+            if (keyword == CSSKeyword::NoWrap) style.font.flags |= FontStyleNoWrap;
             prop = StyleTextWrap;
         }
-        else if (AreSame(stylePropName, "background-color") || AreSame(stylePropName, "background"))
+        else if (property == CSSProperty::BackgroundColor || property == CSSProperty::Background)
         {
             if (StartsWith(stylePropVal, "linear-gradient"))
                 style.gradient = ExtractLinearGradient(stylePropVal, GetColor, Config.userData);
             else style.bgcolor = ExtractColor(stylePropVal, GetColor, Config.userData);
             prop = StyleBackground;
         }
-        else if (AreSame(stylePropName, "color"))
+        else if (property == CSSProperty::Color)
         {
             style.fgcolor = ExtractColor(stylePropVal, GetColor, Config.userData);
             prop = StyleFgColor;
         }
-        else if (AreSame(stylePropName, "width"))
+        else if (property == CSSProperty::Width)
         {
             style.dimension.x = ExtractFloatWithUnit(stylePropVal, 0, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             prop = StyleWidth;
         }
-        else if (AreSame(stylePropName, "height"))
+        else if (property == CSSProperty::Height)
         {
             style.dimension.y = ExtractFloatWithUnit(stylePropVal, 0, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             prop = StyleHeight;
         }
-        else if (AreSame(stylePropName, "min-width"))
+        else if (property == CSSProperty::MinWidth)
         {
             style.mindim.x = ExtractFloatWithUnit(stylePropVal, 0, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             prop = StyleWidth;
         }
-        else if (AreSame(stylePropName, "min-height"))
+        else if (property == CSSProperty::MinHeight)
         {
             style.mindim.y = ExtractFloatWithUnit(stylePropVal, 0, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             prop = StyleHeight;
         }
-        else if (AreSame(stylePropName, "max-width"))
+        else if (property == CSSProperty::MaxWidth)
         {
             style.maxdim.x = ExtractFloatWithUnit(stylePropVal, 0, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             prop = StyleWidth;
         }
-        else if (AreSame(stylePropName, "max-height"))
+        else if (property == CSSProperty::MaxHeight)
         {
             style.maxdim.y = ExtractFloatWithUnit(stylePropVal, 0, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             prop = StyleHeight;
         }
-        else if (AreSame(stylePropName, "alignment") || AreSame(stylePropName, "text-align"))
+        else if (property == CSSProperty::Alignment || property == CSSProperty::TextAlign)
         {
-            style.alignment |= AreSame(stylePropVal, "justify") ? TextAlignJustify :
-                AreSame(stylePropVal, "right") ? TextAlignRight :
-                AreSame(stylePropVal, "center") ? TextAlignHCenter :
+            auto keyword = GetCSSKeyword(stylePropVal);
+            style.alignment |= keyword == CSSKeyword::Justify ? TextAlignJustify :
+                keyword == CSSKeyword::Right ? TextAlignRight :
+                keyword == CSSKeyword::Center ? TextAlignHCenter :
                 TextAlignLeft;
             prop = StyleHAlignment;
         }
-        else if (AreSame(stylePropName, "vertical-align"))
+        else if (property == CSSProperty::VerticalAlign)
         {
-            style.alignment |= AreSame(stylePropVal, "top") ? TextAlignTop :
-                AreSame(stylePropVal, "bottom") ? TextAlignBottom :
+            auto keyword = GetCSSKeyword(stylePropVal);
+            style.alignment |= keyword == CSSKeyword::Top ? TextAlignTop :
+                keyword == CSSKeyword::Bottom ? TextAlignBottom :
                 TextAlignVCenter;
             prop = StyleVAlignment;
         }
-        else if (AreSame(stylePropName, "font-family"))
+        else if (property == CSSProperty::FontFamily)
         {
             style.font.family = stylePropVal;
             prop = StyleFontFamily;
         }
-        else if (AreSame(stylePropName, "padding"))
+        else if (property == CSSProperty::Padding)
         {
             style.padding = ExtractWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             prop = StylePadding;
         }
-        else if (AreSame(stylePropName, "padding-top"))
+        else if (property == CSSProperty::PaddingTop)
         {
             auto val = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             style.padding.top = val;
             prop = StylePadding;
         }
-        else if (AreSame(stylePropName, "padding-bottom"))
+        else if (property == CSSProperty::PaddingBottom)
         {
             auto val = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             style.padding.bottom = val;
             prop = StylePadding;
         }
-        else if (AreSame(stylePropName, "padding-left"))
+        else if (property == CSSProperty::PaddingLeft)
         {
             auto val = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             style.padding.left = val;
             prop = StylePadding;
         }
-        else if (AreSame(stylePropName, "padding-right"))
+        else if (property == CSSProperty::PaddingRight)
         {
             auto val = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, Config.scaling);
             style.padding.right = val;
             prop = StylePadding;
         }
-        else if (AreSame(stylePropName, "text-overflow"))
+        else if (property == CSSProperty::TextOverflow)
         {
-            if (AreSame(stylePropVal, "ellipsis"))
+            auto keyword = GetCSSKeyword(stylePropVal);
+            if (keyword == CSSKeyword::Ellipsis)
             {
                 style.font.flags |= FontStyleOverflowEllipsis;
                 prop = StyleTextOverflow;
             }
         }
-        else if (AreSame(stylePropName, "border"))
+        else if (property == CSSProperty::Border)
         {
             style.border.top = style.border.bottom = style.border.left = style.border.right = ExtractBorder(stylePropVal,
                 Config.defaultFontSz * Config.fontScaling, 1.f, GetColor, Config.userData);
             style.border.isUniform = true;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-top"))
+        else if (property == CSSProperty::BorderTop)
         {
             style.border.top = ExtractBorder(stylePropVal, Config.defaultFontSz * Config.fontScaling,
                 1.f, GetColor, Config.userData);
             style.border.isUniform = false;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-left"))
+        else if (property == CSSProperty::BorderLeft)
         {
             style.border.left = ExtractBorder(stylePropVal, Config.defaultFontSz * Config.fontScaling,
                 1.f, GetColor, Config.userData);
             style.border.isUniform = false;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-right"))
+        else if (property == CSSProperty::BorderRight)
         {
             style.border.right = ExtractBorder(stylePropVal, Config.defaultFontSz * Config.fontScaling,
                 1.f, GetColor, Config.userData);
             style.border.isUniform = false;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-bottom"))
+        else if (property == CSSProperty::BorderBottom)
         {
             style.border.bottom = ExtractBorder(stylePropVal, Config.defaultFontSz * Config.fontScaling,
                 1.f, GetColor, Config.userData);
             prop = StyleBorder;
             style.border.isUniform = false;
         }
-        else if (AreSame(stylePropName, "border-radius"))
+        else if (property == CSSProperty::BorderRadius)
         {
             auto radius = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling,
                 1.f, 1.f);
@@ -984,7 +756,7 @@ namespace glimmer
             style.border.setRadius(radius);
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-width"))
+        else if (property == CSSProperty::BorderWidth)
         {
             auto width = ExtractWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, 1.f);
             style.border.top.thickness = width.top;
@@ -993,80 +765,81 @@ namespace glimmer
             style.border.right.thickness = width.right;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-color"))
+        else if (property == CSSProperty::BorderColor)
         {
             auto color = ExtractColor(stylePropVal, GetColor, Config.userData);
             style.border.setColor(color);
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-top-left-radius"))
+        else if (property == CSSProperty::BorderTopLeftRadius)
         {
             style.border.cornerRadius[TopLeftCorner] = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling,
                 1.f, 1.f);
             if (stylePropVal.back() == '%') style.relativeProps |= RSP_BorderTopLeftRadius;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-top-right-radius"))
+        else if (property == CSSProperty::BorderTopRightRadius)
         {
             style.border.cornerRadius[TopRightCorner] = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling,
                 1.f, 1.f);
             if (stylePropVal.back() == '%') style.relativeProps |= RSP_BorderTopRightRadius;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-bottom-right-radius"))
+        else if (property == CSSProperty::BorderBottomRightRadius)
         {
             style.border.cornerRadius[BottomRightCorner] = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling,
                 1.f, 1.f);
             if (stylePropVal.back() == '%') style.relativeProps |= RSP_BorderBottomRightRadius;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "border-bottom-left-radius"))
+        else if (property == CSSProperty::BorderBottomLeftRadius)
         {
             style.border.cornerRadius[BottomLeftCorner] = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling,
                 1.f, 1.f);
             if (stylePropVal.back() == '%') style.relativeProps |= RSP_BorderBottomLeftRadius;
             prop = StyleBorder;
         }
-        else if (AreSame(stylePropName, "margin"))
+        else if (property == CSSProperty::Margin)
         {
             style.margin = ExtractWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, 1.f);
             prop = StyleMargin;
         }
-        else if (AreSame(stylePropName, "margin-top"))
+        else if (property == CSSProperty::MarginTop)
         {
             style.margin.top = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, 1.f);
             prop = StyleMargin;
         }
-        else if (AreSame(stylePropName, "margin-left"))
+        else if (property == CSSProperty::MarginLeft)
         {
             style.margin.left = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, 1.f);
             prop = StyleMargin;
         }
-        else if (AreSame(stylePropName, "margin-right"))
+        else if (property == CSSProperty::MarginRight)
         {
             style.margin.right = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, 1.f);
             prop = StyleMargin;
         }
-        else if (AreSame(stylePropName, "margin-bottom"))
+        else if (property == CSSProperty::MarginBottom)
         {
             style.margin.bottom = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, 1.f);
             prop = StyleMargin;
         }
-        else if (AreSame(stylePropName, "font-style"))
+        else if (property == CSSProperty::FontStyle)
         {
-            if (AreSame(stylePropVal, "normal")) style.font.flags |= FontStyleNormal;
-            else if (AreSame(stylePropVal, "italic") || AreSame(stylePropVal, "oblique"))
+            auto keyword = GetCSSKeyword(stylePropVal);
+            if (keyword == CSSKeyword::Normal) style.font.flags |= FontStyleNormal;
+            else if (keyword == CSSKeyword::Italic || keyword == CSSKeyword::Oblique)
                 style.font.flags |= FontStyleItalics;
             else LOGERROR("Invalid font-style property value [%.*s]\n",
                 (int)stylePropVal.size(), stylePropVal.data());
             prop = StyleFontStyle;
         }
-        else if (AreSame(stylePropName, "box-shadow"))
+        else if (property == CSSProperty::BoxShadow)
         {
             style.shadow = ExtractBoxShadow(stylePropVal, Config.defaultFontSz, 1.f, GetColor, Config.userData);
             prop = StyleBoxShadow;
         }
-        else if (AreSame(stylePropName, "thumb-color"))
+        else if (property == CSSProperty::ThumbColor)
         {
             if (StartsWith(stylePropVal, "linear-gradient"))
             {
@@ -1075,7 +848,7 @@ namespace glimmer
             else specific.toggle.thumbColor = ExtractColor(stylePropVal, GetColor, Config.userData);
             prop = StyleThumbColor;
         }
-        else if (AreSame(stylePropName, "track-color"))
+        else if (property == CSSProperty::TrackColor)
         {
             if (StartsWith(stylePropVal, "linear-gradient"))
             {
@@ -1084,14 +857,14 @@ namespace glimmer
             else specific.toggle.trackColor = ExtractColor(stylePropVal, GetColor, Config.userData);
             prop = StyleTrackColor;
         }
-        else if (AreSame(stylePropName, "track-outline"))
+        else if (property == CSSProperty::TrackOutline)
         {
             auto brd = ExtractBorder(stylePropVal, Config.defaultFontSz, 1.f, GetColor, Config.userData);
             specific.toggle.trackBorderColor = brd.color;
             specific.toggle.trackBorderThickness = brd.thickness;
             prop = StyleTrackOutlineColor;
         }
-        else if (AreSame(stylePropName, "thumb-offset"))
+        else if (property == CSSProperty::ThumbOffset)
         {
             specific.toggle.thumbOffset = ExtractFloatWithUnit(stylePropVal, 0.f, Config.defaultFontSz * Config.fontScaling, 1.f, 1.f);
             prop = StyleThumbOffset;
@@ -1289,6 +1062,21 @@ namespace glimmer
         }
     }
 
+    static void PushSpecificStyle(int32_t state, std::string_view css)
+    {
+        if (css.empty()) return;
+        const auto& compiled = CompileStyle(css);
+        if (compiled.specificFields == 0) return;
+
+        auto& stack = WidgetContextData::toggleButtonStyles[state];
+        auto toggle = stack.top();
+        ApplySpecificStyle(compiled, toggle);
+        stack.push() = toggle;
+        SpecificStyleDepths[state].push_back(WidgetContextData::StyleStack[state].size());
+    }
+
+    static void PushSpecificStyle(int32_t, const StyleLiteral&) {}
+
     template <typename StackT>
     static int32_t PushStyle(std::string_view* css, StackT* stack)
     {
@@ -1303,16 +1091,17 @@ namespace glimmer
             {
                 if (style == WSI_Default)
                 {
-                    auto parent = stack[WSI_Default].empty() ? 
-                        GetContext().StyleStack[WSI_Default].top() : stack[WSI_Default].top();
-                    auto& pushed = stack[style].push();
+                    auto& parentStack = stack[WSI_Default].empty() ? GetContext().StyleStack[WSI_Default] :
+                        stack[WSI_Default];
+                    auto parent = parentStack.top();
+                    auto& pushed = stack[style].push(GetStyleVersion(parentStack.version(), css[style]));
                     pushed = parent;
                     ResetNonInheritableProps(pushed);
                     pushed.From(css[style]);
                 }
                 else
                 {
-                    stack[style].push().From(css[style]);
+                    stack[style].push(GetStyleVersion(0, css[style])).From(css[style]);
                 }
 
                 res |= (1 << style);
@@ -1322,8 +1111,8 @@ namespace glimmer
         return res;
     }
 
-    template <typename StackT>
-    static void PushStyle(WidgetState state, std::string_view css, StackT* stack)
+    template <typename StackT, typename CSST>
+    static void PushStyle(WidgetState state, const CSST& css, StackT* stack)
     {
         auto idx = log2((unsigned)state);
 
@@ -1332,17 +1121,17 @@ namespace glimmer
             if (!stack[idx].empty())
             {
                 auto parent = stack[idx].top();
-                auto& style = stack[idx].push();
+                auto& style = stack[idx].push(GetStyleVersion(stack[idx].version(), css));
                 style = parent;
                 ResetNonInheritableProps(style);
                 style.From(css);
             }
             else
-                stack[idx].push().From(css);
+                stack[idx].push(GetStyleVersion(0, css)).From(css);
         }
         else
         {
-            stack[idx].push().From(css);
+            stack[idx].push(GetStyleVersion(0, css)).From(css);
         }
     }
 
@@ -1369,6 +1158,9 @@ namespace glimmer
         }
        
         PushStyle(css, context.StyleStack);
+
+        for (auto idx = 0; idx < WSI_Total; ++idx)
+            PushSpecificStyle(idx, css[idx]);
     }
 
     void PushStyleFmt(int32_t state, std::string_view fmt, ...)
@@ -1399,7 +1191,8 @@ namespace glimmer
         PushStyle(buffer);
     }
 
-    void PushStyle(int32_t state, std::string_view css)
+    template <typename CSST>
+    static void PushStyleForStates(int32_t state, const CSST& css, bool isEmpty)
     {
         auto& context = GetContext();
 
@@ -1411,7 +1204,7 @@ namespace glimmer
                 {
                     PushStyle((WidgetState)(1 << style), css, context.layoutStyles);
 
-                    if (!css.empty())
+                    if (!isEmpty)
                     {
                         auto idx = style;
                         auto sz = (int64_t)(context.layoutStyles[idx].size() - 1);
@@ -1420,10 +1213,26 @@ namespace glimmer
                 }
 
                 PushStyle((WidgetState)(1 << style), css, context.StyleStack);
+                PushSpecificStyle(style, css);
             }
         }
     }
 
+    void PushStyle(int32_t state, std::string_view css)
+    {
+        PushStyleForStates(state, css, css.empty());
+    }
+
+    void PushStyle(int32_t state, const StyleLiteral& css)
+    {
+        PushStyleForStates(state, css, false);
+    }
+
+    void PushStyle(const StyleLiteral& css)
+    {
+        PushStyleForStates(WS_Default, css, false);
+    }
+
     void SetStyle(std::string_view id, const std::initializer_list<std::pair<int32_t, std::string_view>>& css)
     {
         auto& dest = StyleSheet[id];
@@ -1440,6 +1249,8 @@ namespace glimmer
                 }
             }
         }
+
+        InvalidateStyleSheet();
     }
 
     void SetStyle(std::string_view id, int32_t state, std::string_view fmt, ...)
@@ -1460,6 +1271,8 @@ namespace glimmer
             if (ws & state)
                 dest[idx].From(buffer);
         }
+
+        InvalidateStyleSheet();
     }
 
     StyleDescriptor& GetStyle(std::string_view id, WidgetStateIndex index)
@@ -1475,6 +1288,315 @@ namespace glimmer
         return GetStyle(name, index);
     }
 
+#pragma region Theme files
+
+    // Rules of a selector from a theme file, per widget state
+    struct ThemeRules
+    {
+        std::string css[WSI_Total];
+
+        bool operator==(const ThemeRules&) const = default;
+    };
+
+    // Changes are detected on a background thread, which only flags them and wakes up the platform
+    // loop captured by WatchTheme. The theme is reloaded on the UI thread at frame start.
+    struct ThemeWatcher
+    {
+        std::string path;
+        std::thread thread;
+        std::atomic<IPlatform*> platform = nullptr;
+        std::atomic<bool> changed = false;
+        std::atomic<bool> stop = false;
+#ifdef __linux__
+        int fd = -1;
+        int wd = -1;
+#endif
+
+        ~ThemeWatcher() { if (thread.joinable()) { stop = true; thread.join(); } }
+    };
+
+    static std::unordered_map<std::string, ThemeRules> LoadedTheme;
+    static ThemeWatcher WatchedTheme;
+
+    // StyleSheet keys are views, selectors from theme files are owned here and never freed
+    static std::string_view GetThemeSelector(std::string_view name)
+    {
+        static std::unordered_set<std::string> ThemeSelectors;
+        return *ThemeSelectors.emplace(name).first;
+    }
+
+    static WidgetStateIndex GetThemeState(std::string_view name)
+    {
+        if (name.empty()) return WSI_Default;
+        else if (AreSame(name, "focus") || AreSame(name, "focused")) return WSI_Focused;
+        else if (AreSame(name, "hover") || AreSame(name, "hovered")) return WSI_Hovered;
+        else if (AreSame(name, "active") || AreSame(name, "pressed")) return WSI_Pressed;
+        else if (AreSame(name, "checked")) return WSI_Checked;
+        else if (AreSame(name, "indeterminate") || AreSame(name, "partially-checked")) return WSI_PartiallyChecked;
+        else if (AreSame(name, "selected")) return WSI_Selected;
+        else if (AreSame(name, "dragged")) return WSI_Dragged;
+        else if (AreSame(name, "disabled")) return WSI_Disabled;
+        return WSI_Total;
+    }
+
+    // Position of the quote closing the string which starts at from, or size if it is unterminated
+    static size_t SkipQuoted(std::string_view text, size_t from)
+    {
+        auto idx = from + 1u;
+        for (; idx < text.size() && text[idx] != text[from]; ++idx)
+            if (text[idx] == '\\') ++idx;
+        return std::min(idx, text.size());
+    }
+
+    // Position of ch at or after from, skipping quoted strings (i.e. `font-family: "a{b}"`)
+    static size_t FindOutsideQuotes(std::string_view text, char ch, size_t from)
+    {
+        for (auto idx = from; idx < text.size(); ++idx)
+        {
+            if (text[idx] == '"' || text[idx] == '\'') idx = SkipQuoted(text, idx);
+            else if (text[idx] == ch) return idx;
+        }
+
+        return std::string_view::npos;
+    }
+
+    static bool ParseTheme(std::string_view content, std::unordered_map<std::string, ThemeRules>& rules)
+    {
+        // Strip comments upfront, they are allowed both between and inside rules
+        std::string text;
+        text.reserve(content.size());
+
+        for (size_t idx = 0; idx < content.size(); ++idx)
+        {
+            if (content[idx] == '"' || content[idx] == '\'')
+            {
+                // Quoted strings are kept as is, even if they contain comment delimiters
+                auto end = SkipQuoted(content, idx);
+                text.append(content.substr(idx, end - idx + 1u));
+                idx = end;
+            }
+            else if (content[idx] == '/' && idx + 1u < content.size() && content[idx + 1u] == '*')
+            {
+                auto end = content.find("*/", idx + 2u);
+                if (end == std::string_view::npos) break;
+                idx = end + 1u;
+            }
+            else text.push_back(content[idx]);
+        }
+
+        size_t idx = 0;
+        while (idx < text.size())
+        {
+            auto open = FindOutsideQuotes(text, '{', idx);
+            if (open == std::string::npos)
+            {
+                if (!TrimCSS(std::string_view{ text }.substr(idx)).empty())
+                {
+                    LOGERROR("Theme has trailing content without rule at [%d]\n", (int)idx);
+                    return false;
+                }
+                break;
+            }
+
+            auto close = FindOutsideQuotes(text, '}', open);
+            if (close == std::string::npos)
+            {
+                LOGERROR("Theme rule at [%d] is not closed\n", (int)open);
+                return false;
+            }
+
+            auto selectors = std::string_view{ text }.substr(idx, open - idx);
+            auto css = TrimCSS(std::string_view{ text }.substr(open + 1u, close - open - 1u));
+
+            while (!selectors.empty())
+            {
+                auto comma = selectors.find(',');
+                auto selector = TrimCSS(selectors.substr(0, comma));
+                selectors = comma == std::string_view::npos ? std::string_view{} : selectors.substr(comma + 1u);
+
+                // Ids and classes share the style sheet, hence the prefix is not part of the key
+                if (!selector.empty() && (selector[0] == '#' || selector[0] == '.')) selector = selector.substr(1);
+                auto colon = selector.find(':');
+                auto name = selector.substr(0, colon);
+                auto state = GetThemeState(colon == std::string_view::npos ? std::string_view{} :
+                    selector.substr(colon + 1u));
+
+                if (name.empty() || state == WSI_Total)
+                {
+                    LOGERROR("Invalid theme selector [%.*s]\n", (int)selector.size(), selector.data());
+                    continue;
+                }
+
+                auto& dest = rules[std::string{ name }].css[state];
+                if (!dest.empty() && dest.back() != ';') dest.push_back(';');
+                dest.append(css);
+            }
+
+            idx = close + 1u;
+        }
+
+        return true;
+    }
+
+    static bool ApplyTheme(std::string_view content)
+    {
+        std::unordered_map<std::string, ThemeRules> rules;
+        if (!ParseTheme(content, rules)) return false;
+
+        // Changed selectors with a bit per state whose rules differ from the loaded theme
+        std::vector<std::pair<std::string_view, int32_t>> changed;
+        static const ThemeRules NoRules{};
+
+        auto diff = [&changed](const std::string& name, const ThemeRules& prev, const ThemeRules& next) {
+            auto states = 0;
+            for (auto idx = 0; idx < WSI_Total; ++idx)
+                if (prev.css[idx] != next.css[idx]) states |= 1 << idx;
+            if (states != 0) changed.emplace_back(GetThemeSelector(name), states);
+        };
+
+        for (const auto& [name, rule] : rules)
+        {
+            auto it = LoadedTheme.find(name);
+            diff(name, it == LoadedTheme.end() ? NoRules : it->second, rule);
+        }
+
+        for (const auto& [name, rule] : LoadedTheme)
+            if (rules.find(name) == rules.end())
+                diff(name, rule, NoRules);
+
+        for (auto [selector, states] : changed)
+        {
+            auto& dest = StyleSheet[selector];
+            auto it = rules.find(std::string{ selector });
+
+            for (auto idx = 0; idx < WSI_Total; ++idx)
+            {
+                if (!(states & (1 << idx))) continue;
+                dest[idx] = StyleDescriptor{};
+                if (it != rules.end() && !it->second.css[idx].empty())
+                    dest[idx].From(it->second.css[idx]);
+            }
+        }
+
+        LoadedTheme = std::move(rules);
+
+        // Only the changed states of widgets (and types) using changed selectors are recomputed, rest
+        // of the resolved styles remain valid hence the style sheet version is not bumped
+        if (!changed.empty()) InvalidateWidgetStyles(changed);
+        return true;
+    }
+
+    bool LoadTheme(std::string_view path)
+    {
+        std::ifstream file{ std::string{ path }, std::ios::binary };
+        if (!file)
+        {
+            LOGERROR("Failed to open theme [%.*s]\n", (int)path.size(), path.data());
+            return false;
+        }
+
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return ApplyTheme(content);
+    }
+
+    static void DetectThemeChanges()
+    {
+        std::error_code ec;
+        auto lastWrite = std::filesystem::last_write_time(WatchedTheme.path, ec);
+#ifdef __linux__
+        auto filename = std::filesystem::path{ WatchedTheme.path }.filename().string();
+#endif
+
+        while (!WatchedTheme.stop.load())
+        {
+            auto changed = false;
+
+#ifdef __linux__
+            if (WatchedTheme.wd != -1)
+            {
+                alignas(inotify_event) char buffer[4096];
+                pollfd pfd{ WatchedTheme.fd, POLLIN, 0 };
+                if (poll(&pfd, 1, 250) <= 0) continue;
+
+                for (auto sz = read(WatchedTheme.fd, buffer, sizeof(buffer)); sz > 0;
+                    sz = read(WatchedTheme.fd, buffer, sizeof(buffer)))
+                {
+                    for (auto offset = 0; offset < (int)sz;)
+                    {
+                        auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                        if (event->len > 0 && filename == event->name) changed = true;
+                        offset += (int)(sizeof(inotify_event) + event->len);
+                    }
+                }
+            }
+            else
+#endif
+            {
+                // Without file notifications, poll the modification time a few times a second
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 250 });
+                auto current = std::filesystem::last_write_time(WatchedTheme.path, ec);
+                changed = !ec && current != lastWrite;
+                if (changed) lastWrite = current;
+            }
+
+            // Requesting a frame is safe from any thread, and is what wakes up an idle event-driven loop
+            if (changed && !WatchedTheme.changed.exchange(true))
+                if (auto platform = WatchedTheme.platform.load(); platform != nullptr)
+                    platform->RequestFrame();
+        }
+    }
+
+    bool WatchTheme(std::string_view path)
+    {
+        UnwatchTheme();
+        if (!LoadTheme(path)) return false;
+
+        WatchedTheme.path = path;
+        WatchedTheme.platform = Config.platform;
+        WatchedTheme.stop = false;
+        WatchedTheme.changed = false;
+
+#ifdef __linux__
+        // Directory is watched as editors usually replace the file on save, rather than writing to it
+        auto dir = std::filesystem::path{ WatchedTheme.path }.parent_path();
+        WatchedTheme.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (WatchedTheme.fd != -1)
+            WatchedTheme.wd = inotify_add_watch(WatchedTheme.fd, dir.empty() ? "." : dir.c_str(),
+                IN_CLOSE_WRITE | IN_MOVED_TO);
+#endif
+
+        WatchedTheme.thread = std::thread{ &DetectThemeChanges };
+        return true;
+    }
+
+    void UnwatchTheme()
+    {
+        if (WatchedTheme.thread.joinable())
+        {
+            WatchedTheme.stop = true;
+            WatchedTheme.thread.join();
+        }
+
+#ifdef __linux__
+        if (WatchedTheme.fd != -1) close(WatchedTheme.fd);
+        WatchedTheme.fd = WatchedTheme.wd = -1;
+#endif
+        WatchedTheme.path.clear();
+        WatchedTheme.platform = nullptr;
+        WatchedTheme.changed = false;
+    }
+
+    bool ReloadThemeIfChanged()
+    {
+        if (WatchedTheme.path.empty()) return false;
+
+        // The platform may have been replaced since watching started, keep waking up the current one
+        WatchedTheme.platform = Config.platform;
+        return WatchedTheme.changed.exchange(false) && LoadTheme(WatchedTheme.path);
+    }
+
+#pragma endregion
+
     void PopStyle(int depth, int32_t state)
     {
         auto& context = GetContext();
@@ -1491,6 +1613,15 @@ namespace glimmer
             {
                 auto popsz = std::min(context.StyleStack[style].size() - 1, depth);
                 context.StyleStack[style].pop(popsz, true);
+
+                // Theme entry at the bottom of widget specific stacks is never popped
+                auto& depths = SpecificStyleDepths[style];
+                auto& toggles = WidgetContextData::toggleButtonStyles[style];
+                while (!depths.empty() && depths.back() > context.StyleStack[style].size())
+                {
+                    if (toggles.size() > 1) toggles.pop(1, true);
+                    depths.pop_back();
+                }
             }
         }
     }
@@ -1508,9 +1639,10 @@ namespace glimmer
         for (auto style = 0; style < WSI_Total; ++style)
         {
             auto desc = context.StyleStack[style].top();
+            auto version = CombineStyleVersion(context.StyleStack[style].version(), (uint64_t)type + 1u) & ~(1ull << 63);
             desc.font.flags = type == TextType::RichText ? (desc.font.flags | TextIsRichText) : 
                 (desc.font.flags & ~TextIsRichText);
-            context.StyleStack[style].push() = desc;
+            context.StyleStack[style].push(version) = desc;
         }
     }
 
@@ -1543,14 +1675,109 @@ namespace glimmer
         WidgetContextData::RestoreStyleStack();
     }
 
-    // TODO: Fix layout generation from stylesheet
-    /*std::pair<Sizing, bool> ParseLayoutStyle(LayoutBuilder& layout, std::string_view css, float pwidth, float pheight)
+    StyleDescriptor::StyleDescriptor()
     {
-        auto sidx = 0;
-        Sizing sizing;
-        auto hasSizing = false;
-
-        while (sidx < (int)css.size())
+        font.size = Config.defaultFontSz * Config.fontScaling;
+        index.animation = index.custom = 0;
+        border.cornerRadius[0] = border.cornerRadius[1] = border.cornerRadius[2] = border.cornerRadius[3] = 0.f;
+    }
+
+    StyleDescriptor::StyleDescriptor(std::string_view css)
+        : StyleDescriptor{}
+    {
+        From(css);
+    }
+
+    StyleDescriptor& StyleDescriptor::BgColor(int r, int g, int b, int a) { bgcolor = ToRGBA(r, g, b, a); return *this; }
+    StyleDescriptor& StyleDescriptor::FgColor(int r, int g, int b, int a) { fgcolor = ToRGBA(r, g, b, a); return *this; }
+    StyleDescriptor& StyleDescriptor::Size(float w, float h) { dimension = ImVec2{ w, h }; return *this; }
+    StyleDescriptor& StyleDescriptor::Align(int32_t align) { alignment = align; return *this; }
+    StyleDescriptor& StyleDescriptor::Padding(float p) { padding.left = padding.top = padding.bottom = padding.right = p; return *this; }
+    StyleDescriptor& StyleDescriptor::Margin(float p) { margin.left = margin.top = margin.bottom = margin.right = p; return *this; }
+
+    StyleDescriptor& StyleDescriptor::Border(float thick, std::tuple<int, int, int, int> color)
+    {
+        border.setThickness(thick); border.setColor(ToRGBA(color));
+        return *this;
+    }
+
+    StyleDescriptor& StyleDescriptor::Raised(float amount)
+    {
+        return *this;
+    }
+
+    static uint32_t GetCompiledStyleFields(std::string_view stylePropName, std::string_view stylePropVal)
+    {
+        switch (GetCSSProperty(stylePropName))
+        {
+        case CSSProperty::FontSize: return CSF_FontSize;
+        case CSSProperty::FontFamily: return CSF_FontFamily;
+        case CSSProperty::Background: [[fallthrough]];
+        case CSSProperty::BackgroundColor:
+            return StartsWith(stylePropVal, "linear-gradient") ? CSF_Gradient : CSF_BgColor;
+        case CSSProperty::ThumbColor: [[fallthrough]];
+        case CSSProperty::TrackColor:
+            // Solid colors are widget specific, see GetSpecificStyleFields
+            return StartsWith(stylePropVal, "linear-gradient") ? CSF_Gradient : 0;
+        case CSSProperty::Color: return CSF_FgColor;
+        case CSSProperty::Width: return CSF_Width;
+        case CSSProperty::Height: return CSF_Height;
+        case CSSProperty::MinWidth: return CSF_MinWidth;
+        case CSSProperty::MinHeight: return CSF_MinHeight;
+        case CSSProperty::MaxWidth: return CSF_MaxWidth;
+        case CSSProperty::MaxHeight: return CSF_MaxHeight;
+        case CSSProperty::Padding: return CSF_Padding;
+        case CSSProperty::PaddingTop: return CSF_PaddingTop;
+        case CSSProperty::PaddingBottom: return CSF_PaddingBottom;
+        case CSSProperty::PaddingLeft: return CSF_PaddingLeft;
+        case CSSProperty::PaddingRight: return CSF_PaddingRight;
+        case CSSProperty::Margin: return CSF_Margin;
+        case CSSProperty::MarginTop: return CSF_MarginTop;
+        case CSSProperty::MarginBottom: return CSF_MarginBottom;
+        case CSSProperty::MarginLeft: return CSF_MarginLeft;
+        case CSSProperty::MarginRight: return CSF_MarginRight;
+        case CSSProperty::Border: return CSF_BorderSides | CSF_BorderUniform;
+        case CSSProperty::BorderTop: return CSF_BorderTop | CSF_BorderUniform;
+        case CSSProperty::BorderBottom: return CSF_BorderBottom | CSF_BorderUniform;
+        case CSSProperty::BorderLeft: return CSF_BorderLeft | CSF_BorderUniform;
+        case CSSProperty::BorderRight: return CSF_BorderRight | CSF_BorderUniform;
+        case CSSProperty::BorderWidth: return CSF_BorderThickness;
+        case CSSProperty::BorderColor: return CSF_BorderColor;
+        case CSSProperty::BorderRadius: return CSF_Radius;
+        case CSSProperty::BorderTopLeftRadius: return CSF_RadiusTopLeft;
+        case CSSProperty::BorderTopRightRadius: return CSF_RadiusTopRight;
+        case CSSProperty::BorderBottomRightRadius: return CSF_RadiusBottomRight;
+        case CSSProperty::BorderBottomLeftRadius: return CSF_RadiusBottomLeft;
+        case CSSProperty::BoxShadow: return CSF_Shadow;
+        default: return 0;
+        }
+    }
+
+    static uint32_t GetSpecificStyleFields(std::string_view stylePropName, std::string_view stylePropVal)
+    {
+        switch (GetCSSProperty(stylePropName))
+        {
+        case CSSProperty::ThumbColor: return StartsWith(stylePropVal, "linear-gradient") ? 0 : SSF_ThumbColor;
+        case CSSProperty::TrackColor: return StartsWith(stylePropVal, "linear-gradient") ? 0 : SSF_TrackColor;
+        case CSSProperty::TrackOutline: return SSF_TrackOutline;
+        case CSSProperty::ThumbOffset: return SSF_ThumbOffset;
+        default: return 0;
+        }
+    }
+
+    static void ParseCompiledStyle(std::string_view css, CompiledStyle& result)
+    {
+        auto sidx = 0;
+        int prop = 0;
+        CommonWidgetStyleDescriptor desc{};
+        auto& values = result.values;
+
+        // Flag like properties are OR-ed into destination, hence start with none of them set
+        values.font.flags = 0;
+        values.alignment = 0;
+        values.relativeProps = 0;
+
+        while (sidx < (int)css.size())
         {
             sidx = SkipSpace(css, sidx);
             auto stbegin = sidx;
@@ -1574,136 +1801,267 @@ namespace glimmer
 
             if (stylePropVal.has_value())
             {
-                if (AreSame(stylePropName, "width"))
-                {
-                    sizing.horizontal = ExtractFloatWithUnit(stylePropVal.value(), 0.f,
-                        Config.defaultFontSz, pwidth, 1.f);
-                    sizing.relativeh = stylePropVal.value().back() == '%';
-                    hasSizing = true;
-                }
-                else if (AreSame(stylePropName, "height"))
-                {
-                    sizing.vertical = ExtractFloatWithUnit(stylePropVal.value(), 0.f,
-                        Config.defaultFontSz, pheight, 1.f);
-                    sizing.relativev = stylePropVal.value().back() == '%';
-                    hasSizing = true;
-                }
-                else if (AreSame(stylePropName, "spacing-x")) layout.spacing.x =
-                    ExtractFloatWithUnit(stylePropVal.value(), 0.f, Config.defaultFontSz, 1.f, 1.f);
-                else if (AreSame(stylePropName, "spacing-y")) layout.spacing.x =
-                    ExtractFloatWithUnit(stylePropVal.value(), 0.f, Config.defaultFontSz, 1.f, 1.f);
-                else if (AreSame(stylePropName, "spacing")) layout.spacing.x = layout.spacing.y =
-                    ExtractFloatWithUnit(stylePropVal.value(), 0.f, Config.defaultFontSz, 1.f, 1.f);
-                else if (AreSame(stylePropName, "overflow-x")) layout.hofmode = AreSame(stylePropVal.value(), "clip") ?
-                    OverflowMode::Clip : AreSame(stylePropVal.value(), "scroll") ? OverflowMode::Scroll : OverflowMode::Wrap;
-                else if (AreSame(stylePropName, "overflow-y")) layout.vofmode = AreSame(stylePropVal.value(), "clip") ?
-                    OverflowMode::Clip : AreSame(stylePropVal.value(), "scroll") ? OverflowMode::Scroll : OverflowMode::Wrap;
-                else if (AreSame(stylePropName, "overflow")) layout.vofmode = layout.hofmode = AreSame(stylePropVal.value(), "clip") ?
-                    OverflowMode::Clip : AreSame(stylePropVal.value(), "scroll") ? OverflowMode::Scroll : OverflowMode::Wrap;
-                else if (AreSame(stylePropName, "halign") || AreSame(stylePropName, "horizontal-align"))
-                    layout.alignment |= AreSame(stylePropVal.value(), "right") ? TextAlignRight :
-                    AreSame(stylePropVal.value(), "center") ? TextAlignHCenter : TextAlignLeft;
-                else if (AreSame(stylePropName, "valign") || AreSame(stylePropName, "vertical-align"))
-                    layout.alignment |= AreSame(stylePropVal.value(), "bottom") ? TextAlignBottom :
-                    AreSame(stylePropVal.value(), "center") ? TextAlignVCenter : TextAlignTop;
-                else if (AreSame(stylePropName, "align") && AreSame(stylePropVal.value(), "center"))
-                    layout.alignment = TextAlignCenter;
-                else if (AreSame(stylePropName, "fill")) layout.fill = AreSame(stylePropVal.value(), "all") ?
-                    FD_Horizontal | FD_Vertical : AreSame(stylePropVal.value(), "horizontal") ?
-                    FD_Horizontal : AreSame(stylePropVal.value(), "vertical") ?
-                    FD_Vertical : FD_None;
+                prop |= PopulateSegmentStyle(values, desc, stylePropName, stylePropVal.value(), Config);
+                result.fields |= GetCompiledStyleFields(stylePropName, stylePropVal.value());
+                result.specificFields |= GetSpecificStyleFields(stylePropName, stylePropVal.value());
             }
         }
 
-        return { sizing, hasSizing };
-    }*/
+        if (result.specificFields != 0) result.toggle = desc.toggle;
 
-    StyleDescriptor::StyleDescriptor()
-    {
-        font.size = Config.defaultFontSz * Config.fontScaling;
-        index.animation = index.custom = 0;
-        border.cornerRadius[0] = border.cornerRadius[1] = border.cornerRadius[2] = border.cornerRadius[3] = 0.f;
+        result.specified = (uint64_t)prop;
+        result.fontFlags = values.font.flags;
+        result.alignment = values.alignment;
+        result.relativeProps = values.relativeProps;
     }
 
-    StyleDescriptor::StyleDescriptor(std::string_view css)
-        : StyleDescriptor{}
+    static void ApplyCompiledStyle(const CompiledStyle& compiled, StyleDescriptor& dest)
     {
-        From(css);
-    }
+        const auto& src = compiled.values;
+        auto fields = compiled.fields;
 
-    StyleDescriptor& StyleDescriptor::BgColor(int r, int g, int b, int a) { bgcolor = ToRGBA(r, g, b, a); return *this; }
-    StyleDescriptor& StyleDescriptor::FgColor(int r, int g, int b, int a) { fgcolor = ToRGBA(r, g, b, a); return *this; }
-    StyleDescriptor& StyleDescriptor::Size(float w, float h) { dimension = ImVec2{ w, h }; return *this; }
-    StyleDescriptor& StyleDescriptor::Align(int32_t align) { alignment = align; return *this; }
-    StyleDescriptor& StyleDescriptor::Padding(float p) { padding.left = padding.top = padding.bottom = padding.right = p; return *this; }
-    StyleDescriptor& StyleDescriptor::Margin(float p) { margin.left = margin.top = margin.bottom = margin.right = p; return *this; }
+        if (fields & CSF_BgColor) dest.bgcolor = src.bgcolor;
+        if (fields & CSF_Gradient) dest.gradient = src.gradient;
+        if (fields & CSF_FgColor) dest.fgcolor = src.fgcolor;
+        if (fields & CSF_FontSize) dest.font.size = src.font.size;
+        if (fields & CSF_FontFamily) dest.font.family = src.font.family;
+        if (fields & CSF_Width) dest.dimension.x = src.dimension.x;
+        if (fields & CSF_Height) dest.dimension.y = src.dimension.y;
+        if (fields & CSF_MinWidth) dest.mindim.x = src.mindim.x;
+        if (fields & CSF_MinHeight) dest.mindim.y = src.mindim.y;
+        if (fields & CSF_MaxWidth) dest.maxdim.x = src.maxdim.x;
+        if (fields & CSF_MaxHeight) dest.maxdim.y = src.maxdim.y;
 
-    StyleDescriptor& StyleDescriptor::Border(float thick, std::tuple<int, int, int, int> color)
-    {
-        border.setThickness(thick); border.setColor(ToRGBA(color));
-        return *this;
+        if ((fields & CSF_Padding) == CSF_Padding) dest.padding = src.padding;
+        else if (fields & CSF_Padding)
+        {
+            if (fields & CSF_PaddingTop) dest.padding.top = src.padding.top;
+            if (fields & CSF_PaddingLeft) dest.padding.left = src.padding.left;
+            if (fields & CSF_PaddingRight) dest.padding.right = src.padding.right;
+            if (fields & CSF_PaddingBottom) dest.padding.bottom = src.padding.bottom;
+        }
+
+        if ((fields & CSF_Margin) == CSF_Margin) dest.margin = src.margin;
+        else if (fields & CSF_Margin)
+        {
+            if (fields & CSF_MarginTop) dest.margin.top = src.margin.top;
+            if (fields & CSF_MarginLeft) dest.margin.left = src.margin.left;
+            if (fields & CSF_MarginRight) dest.margin.right = src.margin.right;
+            if (fields & CSF_MarginBottom) dest.margin.bottom = src.margin.bottom;
+        }
+
+        if (fields & (CSF_BorderSides | CSF_BorderThickness | CSF_BorderColor | CSF_BorderUniform | CSF_Radius))
+        {
+            auto& border = dest.border;
+            const auto& srcborder = src.border;
+
+            if (fields & CSF_BorderTop) border.top = srcborder.top;
+            if (fields & CSF_BorderLeft) border.left = srcborder.left;
+            if (fields & CSF_BorderRight) border.right = srcborder.right;
+            if (fields & CSF_BorderBottom) border.bottom = srcborder.bottom;
+
+            if (fields & CSF_BorderThickness)
+            {
+                border.top.thickness = srcborder.top.thickness;
+                border.left.thickness = srcborder.left.thickness;
+                border.right.thickness = srcborder.right.thickness;
+                border.bottom.thickness = srcborder.bottom.thickness;
+            }
+
+            if (fields & CSF_BorderColor)
+            {
+                border.top.color = srcborder.top.color;
+                border.left.color = srcborder.left.color;
+                border.right.color = srcborder.right.color;
+                border.bottom.color = srcborder.bottom.color;
+            }
+
+            if (fields & CSF_BorderUniform) border.isUniform = srcborder.isUniform;
+            if (fields & CSF_RadiusTopLeft) border.cornerRadius[TopLeftCorner] = srcborder.cornerRadius[TopLeftCorner];
+            if (fields & CSF_RadiusTopRight) border.cornerRadius[TopRightCorner] = srcborder.cornerRadius[TopRightCorner];
+            if (fields & CSF_RadiusBottomRight) border.cornerRadius[BottomRightCorner] = srcborder.cornerRadius[BottomRightCorner];
+            if (fields & CSF_RadiusBottomLeft) border.cornerRadius[BottomLeftCorner] = srcborder.cornerRadius[BottomLeftCorner];
+        }
+
+        if (fields & CSF_Shadow) dest.shadow = src.shadow;
+
+        dest.font.flags |= compiled.fontFlags;
+        dest.alignment |= compiled.alignment;
+        dest.relativeProps |= compiled.relativeProps;
+
+        if (compiled.specified & (StyleFontFamily | StyleFontSize | StyleFontWeight))
+            dest.font.font = nullptr;
+
+        AddFontPtr(dest.font);
+        dest.specified |= compiled.specified;
     }
 
-    StyleDescriptor& StyleDescriptor::Raised(float amount)
+    static void ApplySpecificStyle(const CompiledStyle& compiled, ToggleButtonStyleDescriptor& dest)
     {
-        return *this;
+        const auto& src = compiled.toggle;
+        auto fields = compiled.specificFields;
+
+        if (fields & SSF_ThumbColor) dest.thumbColor = src.thumbColor;
+        if (fields & SSF_TrackColor) dest.trackColor = src.trackColor;
+        if (fields & SSF_TrackOutline)
+        {
+            dest.trackBorderColor = src.trackBorderColor;
+            dest.trackBorderThickness = src.trackBorderThickness;
+        }
+        if (fields & SSF_ThumbOffset) dest.thumbOffset = src.thumbOffset;
     }
 
-    StyleDescriptor& StyleDescriptor::From(std::string_view css, bool checkForDuplicate)
+    static const CompiledStyle& CompileStyle(std::string_view css)
     {
-        if (css.empty()) return *this;
+        using namespace std::chrono;
 
 #ifndef GLIMMER_DISABLE_CSS_CACHING
-		auto it = ParsedStyleSheets.find(css);
-        if (it == ParsedStyleSheets.end())
+        // Compiled values have lengths resolved w.r.t. current scaling, recompile if it changes
+        if (CompiledStyleScales[0] != Config.defaultFontSz || CompiledStyleScales[1] != Config.fontScaling ||
+            CompiledStyleScales[2] != Config.scaling)
         {
+            CompiledStyles.clear();
+            InvalidateStyleSheet();
+            CompiledStyleScales[0] = Config.defaultFontSz;
+            CompiledStyleScales[1] = Config.fontScaling;
+            CompiledStyleScales[2] = Config.scaling;
+        }
+
+        auto it = CompiledStyles.find(css);
+        if (it != CompiledStyles.end())
+        {
+            CompiledStyleStats.hits++;
+            return it->second;
+        }
+
+        auto start = high_resolution_clock::now();
+        auto& [key, compiled] = *CompiledStyles.emplace(std::string{ css }, CompiledStyle{}).first;
+
+        // Parse the owned copy, so that string views in the style i.e. font-family remain valid
+        ParseCompiledStyle(key, compiled);
+#else
+        static CompiledStyle compiled;
+        auto start = high_resolution_clock::now();
+        compiled = CompiledStyle{};
+        ParseCompiledStyle(css, compiled);
 #endif
-            auto sidx = 0;
-            int prop = 0;
-            CommonWidgetStyleDescriptor desc{};
 
-            while (sidx < (int)css.size())
-            {
-                sidx = SkipSpace(css, sidx);
-                auto stbegin = sidx;
-                while ((sidx < (int)css.size()) && (css[sidx] != ':') &&
-                    !std::isspace(css[sidx])) sidx++;
-                auto stylePropName = css.substr(stbegin, sidx - stbegin);
-
-                sidx = SkipSpace(css, sidx);
-                if (css[sidx] == ':') sidx++;
-                sidx = SkipSpace(css, sidx);
-
-                auto stylePropVal = GetQuotedString(css.data(), sidx, (int)css.size());
-                if (!stylePropVal.has_value() || stylePropVal.value().empty())
-                {
-                    stbegin = sidx;
-                    while ((sidx < (int)css.size()) && css[sidx] != ';') sidx++;
-                    stylePropVal = css.substr(stbegin, sidx - stbegin);
+        CompiledStyleStats.misses++;
+        CompiledStyleStats.parseTimeUs += duration_cast<nanoseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+        return compiled;
+    }
 
-                    if ((sidx < (int)css.size()) && css[sidx] == ';') sidx++;
-                }
+    StyleDescriptor& StyleDescriptor::From(std::string_view css, bool checkForDuplicate)
+    {
+        if (css.empty()) return *this;
+        ApplyCompiledStyle(CompileStyle(css), *this);
+        return *this;
+    }
+
+    // Same as ApplyCompiledStyle, except lengths are resolved here as they depend on scaling
+    static void ApplyStyleLiteral(const StyleLiteral& css, StyleDescriptor& dest)
+    {
+        auto ems = Config.defaultFontSz * Config.fontScaling;
+        auto fields = css.fields;
+        auto resolve = [ems](CSSLength length, float scale) { return ResolveCSSLength(length, ems, 1.f, scale); };
+
+        if (fields & CSF_BgColor) dest.bgcolor = css.bgcolor;
+        if (fields & CSF_Gradient) dest.gradient = css.gradient;
+        if (fields & CSF_FgColor) dest.fgcolor = css.fgcolor;
+        if (fields & CSF_FontSize) dest.font.size = resolve(css.fontSize, Config.fontScaling);
+        if (fields & CSF_FontFamily) dest.font.family = css.fontFamily;
+        if (fields & CSF_Width) dest.dimension.x = resolve(css.dimension[0], Config.scaling);
+        if (fields & CSF_Height) dest.dimension.y = resolve(css.dimension[1], Config.scaling);
+        if (fields & CSF_MinWidth) dest.mindim.x = resolve(css.mindim[0], Config.scaling);
+        if (fields & CSF_MinHeight) dest.mindim.y = resolve(css.mindim[1], Config.scaling);
+        if (fields & CSF_MaxWidth) dest.maxdim.x = resolve(css.maxdim[0], Config.scaling);
+        if (fields & CSF_MaxHeight) dest.maxdim.y = resolve(css.maxdim[1], Config.scaling);
+
+        if (fields & CSF_PaddingTop) dest.padding.top = resolve(css.padding.top, Config.scaling);
+        if (fields & CSF_PaddingLeft) dest.padding.left = resolve(css.padding.left, Config.scaling);
+        if (fields & CSF_PaddingRight) dest.padding.right = resolve(css.padding.right, Config.scaling);
+        if (fields & CSF_PaddingBottom) dest.padding.bottom = resolve(css.padding.bottom, Config.scaling);
+        if (fields & CSF_MarginTop) dest.margin.top = resolve(css.margin.top, 1.f);
+        if (fields & CSF_MarginLeft) dest.margin.left = resolve(css.margin.left, 1.f);
+        if (fields & CSF_MarginRight) dest.margin.right = resolve(css.margin.right, 1.f);
+        if (fields & CSF_MarginBottom) dest.margin.bottom = resolve(css.margin.bottom, 1.f);
+
+        if (fields & (CSF_BorderSides | CSF_BorderThickness | CSF_BorderColor | CSF_BorderUniform | CSF_Radius))
+        {
+            Border* sides[4] = { &dest.border.top, &dest.border.left, &dest.border.right, &dest.border.bottom };
+
+            for (auto idx = 0; idx < 4; ++idx)
+            {
+                const auto& side = css.border[idx];
 
-                if (stylePropVal.has_value())
-                    prop |= PopulateSegmentStyle(*this, desc, stylePropName, stylePropVal.value(), Config);
+                if (fields & (CSF_BorderTop << idx))
+                    *sides[idx] = Border{ side.color, resolve(side.thickness, 1.f), side.lineType };
+                if (fields & CSF_BorderThickness) sides[idx]->thickness = resolve(side.thickness, 1.f);
+                if (fields & CSF_BorderColor) sides[idx]->color = side.color;
             }
 
-            if ((prop & StyleFontFamily) || (prop & StyleFontSize) || (prop & StyleFontWeight))
-                font.font = nullptr;
+            if (fields & CSF_BorderUniform) dest.border.isUniform = css.borderUniform;
+            if (fields & CSF_RadiusTopLeft) dest.border.cornerRadius[TopLeftCorner] = resolve(css.radius[TopLeftCorner], 1.f);
+            if (fields & CSF_RadiusTopRight) dest.border.cornerRadius[TopRightCorner] = resolve(css.radius[TopRightCorner], 1.f);
+            if (fields & CSF_RadiusBottomRight) dest.border.cornerRadius[BottomRightCorner] = resolve(css.radius[BottomRightCorner], 1.f);
+            if (fields & CSF_RadiusBottomLeft) dest.border.cornerRadius[BottomLeftCorner] = resolve(css.radius[BottomLeftCorner], 1.f);
+        }
 
-            AddFontPtr(font);
-            specified |= prop;
+        dest.font.flags |= css.fontFlags;
+        dest.alignment |= css.alignment;
+        dest.relativeProps |= css.relativeProps;
 
-#ifndef GLIMMER_DISABLE_CSS_CACHING
-            ParsedStyleSheets.emplace(css, *this);
-        }
-        else
-			*this = it->second;
-#endif
-        
+        if (css.specified & (StyleFontFamily | StyleFontSize | StyleFontWeight))
+            dest.font.font = nullptr;
+
+        AddFontPtr(dest.font);
+        dest.specified |= css.specified;
+    }
+
+    StyleDescriptor& StyleDescriptor::From(const StyleLiteral& css)
+    {
+        ApplyStyleLiteral(css, *this);
         return *this;
     }
 
+    void PrecompileStyle(std::string_view css)
+    {
+        if (!css.empty()) CompileStyle(css);
+    }
+
+    void PrecompileStyle(const std::initializer_list<std::string_view>& css)
+    {
+        for (auto style : css) PrecompileStyle(style);
+    }
+
+    StyleCacheStats GetStyleCacheStats()
+    {
+        return CompiledStyleStats;
+    }
+
+    void ClearStyleCache()
+    {
+        CompiledStyles.clear();
+        CompiledStyleStats = StyleCacheStats{};
+        InvalidateStyleSheet();
+    }
+
+    uint64_t NextStyleVersion()
+    {
+        // Keep the top bit set so that these never match versions derived from CSS contents
+        return ++UniqueStyleVersion | (1ull << 63);
+    }
+
+    uint64_t GetStyleSheetVersion()
+    {
+        return StyleSheetVersion;
+    }
+
+    void InvalidateStyleSheet()
+    {
+        ++StyleSheetVersion;
+    }
+
     StyleDescriptor& StyleDescriptor::From(const StyleDescriptor& style, bool overwrite)
     {
         for (auto idx = 0; idx < StyleTotal; ++idx)
@@ -1776,9 +2134,560 @@ namespace glimmer
         return *this;
     }
 
+    // Property values of compact styles. Styles are re-encoded when theme or selectors change, in
+    // which case a style reuses its words if the new encoding fits, or else returns them to the free
+    // list (first fit), so that the pool is bounded by the live styles rather than reloads.
+    static std::vector<uint32_t> CompactStylePool;
+    static std::vector<std::pair<int32_t, int32_t>> CompactStyleFreeList; // offset, words
+
+    // Persistent widget states may release their compact styles after the pool is destroyed at exit,
+    // declared after the pool so that it is destroyed first
+    static bool IsCompactStylePoolAlive = true;
+    static struct CompactStylePoolGuard { ~CompactStylePoolGuard() { IsCompactStylePoolAlive = false; } } CompactStylePoolState;
+
+    template <typename T>
+    static void WriteCompactStyleValue(std::vector<uint32_t>& words, const T& value)
+    {
+        static_assert(sizeof(T) % sizeof(uint32_t) == 0, "Compact style values are 4-byte words");
+        static_assert(std::is_trivially_copyable_v<T>, "Compact style values are copied as bytes");
+
+        auto start = words.size();
+        words.resize(start + (sizeof(T) / sizeof(uint32_t)));
+        std::memcpy(words.data() + start, &value, sizeof(T));
+    }
+
+    template <typename T>
+    static T ReadCompactStyleValue(int32_t& offset)
+    {
+        T value;
+        std::memcpy(&value, CompactStylePool.data() + offset, sizeof(T));
+        offset += (int32_t)(sizeof(T) / sizeof(uint32_t));
+        return value;
+    }
+
+    static void EncodeCompactStyle(const StyleDescriptor& style, std::vector<uint32_t>& words)
+    {
+        // Values are stored in order of property bits, for properties copied by StyleDescriptor::From
+        for (auto idx = 0; idx < StyleTotal; ++idx)
+        {
+            auto styleprop = 1ll << idx;
+            if (!(styleprop & style.specified)) continue;
+
+            switch (styleprop)
+            {
+            case StyleBackground:
+                WriteCompactStyleValue(words, style.bgcolor);
+                WriteCompactStyleValue(words, style.gradient.totalStops);
+                WriteCompactStyleValue(words, style.gradient.angleDegrees);
+                WriteCompactStyleValue(words, (int32_t)style.gradient.dir);
+                for (auto stop = 0; stop < style.gradient.totalStops; ++stop)
+                    WriteCompactStyleValue(words, style.gradient.colorStops[stop]);
+                break;
+            case StyleFgColor: WriteCompactStyleValue(words, style.fgcolor); break;
+            case StyleFontSize: WriteCompactStyleValue(words, style.font.size); break;
+            case StyleFontFamily: WriteCompactStyleValue(words, style.font.family); break;
+            case StyleHeight: WriteCompactStyleValue(words, style.dimension.y); break;
+            case StyleWidth: WriteCompactStyleValue(words, style.dimension.x); break;
+            case StylePadding: WriteCompactStyleValue(words, style.padding); break;
+            case StyleMargin: WriteCompactStyleValue(words, style.margin); break;
+            case StyleBorder: WriteCompactStyleValue(words, style.border); break;
+            case StyleBoxShadow: WriteCompactStyleValue(words, style.shadow); break;
+            case StyleBorderRadius: WriteCompactStyleValue(words, style.border.cornerRadius); break;
+            default: break;
+            }
+        }
+    }
+
+    static int32_t AllocateCompactStyleWords(int32_t count)
+    {
+        for (auto it = CompactStyleFreeList.begin(); it != CompactStyleFreeList.end(); ++it)
+        {
+            if (it->second < count) continue;
+
+            auto offset = it->first;
+            if (it->second == count) CompactStyleFreeList.erase(it);
+            else { it->first += count; it->second -= count; }
+            return offset;
+        }
+
+        auto offset = (int32_t)CompactStylePool.size();
+        CompactStylePool.resize(CompactStylePool.size() + count);
+        return offset;
+    }
+
+    CompactStyle::CompactStyle(const StyleDescriptor& style)
+    {
+        assign(style);
+    }
+
+    CompactStyle::CompactStyle(CompactStyle&& src) noexcept
+        : specified{ src.specified }, fontFlags{ src.fontFlags }, alignment{ src.alignment },
+        offset{ src.offset }, capacity{ src.capacity }
+    {
+        src.offset = src.capacity = 0;
+        src.specified = 0;
+    }
+
+    CompactStyle::~CompactStyle()
+    {
+        release();
+    }
+
+    CompactStyle& CompactStyle::operator=(CompactStyle&& src) noexcept
+    {
+        if (this != &src)
+        {
+            release();
+            specified = src.specified;
+            fontFlags = src.fontFlags;
+            alignment = src.alignment;
+            offset = src.offset;
+            capacity = src.capacity;
+            src.offset = src.capacity = 0;
+            src.specified = 0;
+        }
+
+        return *this;
+    }
+
+    void CompactStyle::assign(const StyleDescriptor& style)
+    {
+        static std::vector<uint32_t> words;
+        words.clear();
+        EncodeCompactStyle(style, words);
+
+        auto required = (int32_t)words.size();
+        if (required > capacity)
+        {
+            release();
+            offset = AllocateCompactStyleWords(required);
+            capacity = required;
+        }
+
+        if (required > 0) std::memcpy(CompactStylePool.data() + offset, words.data(), words.size() * sizeof(uint32_t));
+        specified = style.specified;
+        fontFlags = style.font.flags;
+        alignment = style.alignment;
+    }
+
+    void CompactStyle::release()
+    {
+        if (capacity > 0 && IsCompactStylePoolAlive) CompactStyleFreeList.emplace_back(offset, capacity);
+        specified = 0;
+        fontFlags = alignment = offset = capacity = 0;
+    }
+
+    int64_t CompactStylePoolSize()
+    {
+        return (int64_t)CompactStylePool.size() * (int64_t)sizeof(uint32_t);
+    }
+
+    StyleDescriptor& StyleDescriptor::From(const CompactStyle& style, bool overwrite)
+    {
+        auto offset = style.offset;
+
+        for (auto idx = 0; idx < StyleTotal; ++idx)
+        {
+            auto styleprop = 1ll << idx;
+            if (!(styleprop & style.specified)) continue;
+
+            // Values have to be read even if not applied, to reach the next property's values
+            auto apply = overwrite || !(styleprop & specified);
+
+            switch (styleprop)
+            {
+            case StyleBackground:
+            {
+                auto color = ReadCompactStyleValue<uint32_t>(offset);
+                ColorGradient grad;
+                grad.totalStops = ReadCompactStyleValue<int>(offset);
+                grad.angleDegrees = ReadCompactStyleValue<float>(offset);
+                grad.dir = (ImGuiDir)ReadCompactStyleValue<int32_t>(offset);
+                for (auto stop = 0; stop < grad.totalStops; ++stop)
+                    grad.colorStops[stop] = ReadCompactStyleValue<ColorStop>(offset);
+                if (apply) { bgcolor = color; gradient = grad; }
+                break;
+            }
+            case StyleFgColor:
+            {
+                auto color = ReadCompactStyleValue<uint32_t>(offset);
+                if (apply) fgcolor = color;
+                break;
+            }
+            case StyleFontSize:
+            {
+                auto size = ReadCompactStyleValue<float>(offset);
+                if (apply) font.size = size;
+                break;
+            }
+            case StyleFontFamily:
+            {
+                auto family = ReadCompactStyleValue<std::string_view>(offset);
+                if (apply) font.family = family;
+                break;
+            }
+            case StyleFontWeight:
+                if (apply) font.flags |= style.fontFlags & FontStyleBold ? FontStyleBold : FontStyleNormal;
+                break;
+            case StyleHeight:
+            {
+                auto height = ReadCompactStyleValue<float>(offset);
+                if (apply) dimension.y = height;
+                break;
+            }
+            case StyleWidth:
+            {
+                auto width = ReadCompactStyleValue<float>(offset);
+                if (apply) dimension.x = width;
+                break;
+            }
+            case StyleHAlignment:
+                if (apply) alignment |= style.alignment & (TextAlignLeft | TextAlignRight | TextAlignHCenter);
+                break;
+            case StyleVAlignment:
+                if (apply) alignment |= style.alignment & (TextAlignTop | TextAlignBottom | TextAlignVCenter);
+                break;
+            case StylePadding:
+            {
+                auto value = ReadCompactStyleValue<FourSidedMeasure>(offset);
+                if (apply) padding = value;
+                break;
+            }
+            case StyleMargin:
+            {
+                auto value = ReadCompactStyleValue<FourSidedMeasure>(offset);
+                if (apply) margin = value;
+                break;
+            }
+            case StyleBorder:
+            {
+                auto value = ReadCompactStyleValue<FourSidedBorder>(offset);
+                if (apply) border = value;
+                break;
+            }
+            case StyleBoxShadow:
+            {
+                auto value = ReadCompactStyleValue<BoxShadow>(offset);
+                if (apply) shadow = value;
+                break;
+            }
+            case StyleBorderRadius:
+            {
+                for (auto corner = 0; corner < 4; ++corner)
+                {
+                    auto radius = ReadCompactStyleValue<float>(offset);
+                    if (apply) border.cornerRadius[corner] = radius;
+                }
+                break;
+            }
+            default: break;
+            }
+
+            if (apply) specified |= styleprop;
+        }
+
+        return *this;
+    }
+
 #pragma endregion
 
     void (*StyleDescriptor::GlobalThemeProvider)(GlobalWidgetTheme*) = nullptr;
+
+#pragma region Animation tracks
+
+    // Animation tracks as structure of arrays. Started tracks (running or delayed) are packed at the
+    // front of the arrays i.e. in [0, active) positions, so that the per-frame update is a contiguous
+    // pass proportional to the animations in flight. Track handles map to positions through `pos`,
+    // finished or stopped tracks leave the packed arrays and keep their final value per track.
+    // Released handles are reused through the free list.
+    struct AnimationTracks
+    {
+        // Packed, indexed by position
+        std::vector<double> start;
+        std::vector<float> invDuration;
+        std::vector<float> from;
+        std::vector<float> to;
+        std::vector<float> progress;
+        std::vector<float> value;
+        std::vector<anim::Easing> easing;
+        std::vector<int32_t> track; // Handle of the track at a position
+
+        // Indexed by track handle
+        std::vector<int32_t> pos; // Position in packed arrays, -1 if not active
+        std::vector<float> finalProgress;
+        std::vector<float> finalValue;
+        std::vector<int32_t> freeList;
+
+        double now = 0.0;
+        float deadline = -1.f;
+
+        ~AnimationTracks();
+    };
+
+    // Persistent widget states releasing their tracks at exit may outlive the scheduler
+    static bool IsAnimationTracksAlive = true;
+
+    AnimationTracks::~AnimationTracks()
+    {
+        IsAnimationTracksAlive = false;
+    }
+
+    static AnimationTracks& GetAnimationTracks()
+    {
+        static AnimationTracks tracks;
+        return tracks;
+    }
+
+    static void DeactivateTrack(AnimationTracks& tracks, int32_t track)
+    {
+        auto pos = tracks.pos[track];
+        if (pos == -1) return;
+
+        tracks.finalProgress[track] = tracks.progress[pos];
+        tracks.finalValue[track] = tracks.value[pos];
+
+        auto last = (int32_t)tracks.track.size() - 1;
+        if (pos != last)
+        {
+            tracks.start[pos] = tracks.start[last];
+            tracks.invDuration[pos] = tracks.invDuration[last];
+            tracks.from[pos] = tracks.from[last];
+            tracks.to[pos] = tracks.to[last];
+            tracks.progress[pos] = tracks.progress[last];
+            tracks.value[pos] = tracks.value[last];
+            tracks.easing[pos] = tracks.easing[last];
+            tracks.track[pos] = tracks.track[last];
+            tracks.pos[tracks.track[pos]] = pos;
+        }
+
+        tracks.start.pop_back();
+        tracks.invDuration.pop_back();
+        tracks.from.pop_back();
+        tracks.to.pop_back();
+        tracks.progress.pop_back();
+        tracks.value.pop_back();
+        tracks.easing.pop_back();
+        tracks.track.pop_back();
+        tracks.pos[track] = -1;
+    }
+
+    static float EaseTrack(anim::Easing easing, float t)
+    {
+        constexpr float overshoot = 1.70158f;
+
+        switch (easing)
+        {
+        case anim::Easing::EaseIn: return t * t;
+        case anim::Easing::EaseOut: return t * (2.f - t);
+        case anim::Easing::EaseInOut: return t < 0.5f ? (2.f * t * t) : ((-2.f * t * t) + (4.f * t) - 1.f);
+        case anim::Easing::EaseInSharp: return t * t * t;
+        case anim::Easing::EaseOutSharp: return 1.f - ((1.f - t) * (1.f - t) * (1.f - t));
+        case anim::Easing::EaseInBack: return ((overshoot + 1.f) * t * t * t) - (overshoot * t * t);
+        case anim::Easing::EaseOutBack:
+        {
+            auto x = t - 1.f;
+            return 1.f + ((overshoot + 1.f) * x * x * x) + (overshoot * x * x);
+        }
+        case anim::Easing::EaseInBounce: return 1.f - EaseTrack(anim::Easing::EaseOutBounce, 1.f - t);
+        case anim::Easing::EaseOutBounce:
+        {
+            constexpr float tempo = 3.5f, gravity = tempo * tempo;
+            if (t < 1.f / tempo) return gravity * t * t;
+            else if (t < 2.f / tempo) { t -= 1.5f / tempo; return gravity * t * t + 0.75f; }
+            else if (t < 2.5f / tempo) { t -= 2.25f / tempo; return gravity * t * t + 0.9375f; }
+            t -= 2.625f / tempo;
+            return gravity * t * t + 0.984375f;
+        }
+        default: return t;
+        }
+    }
+
+    void anim::StartTrack(int32_t& track, float duration, Easing easing, float from, float to, float delay)
+    {
+        auto& tracks = GetAnimationTracks();
+
+        if (track == -1 && !tracks.freeList.empty())
+        {
+            track = tracks.freeList.back();
+            tracks.freeList.pop_back();
+        }
+        else if (track == -1)
+        {
+            track = (int32_t)tracks.pos.size();
+            tracks.pos.emplace_back(-1);
+            tracks.finalProgress.emplace_back(1.f);
+            tracks.finalValue.emplace_back();
+        }
+
+        auto pos = tracks.pos[track];
+        if (pos == -1)
+        {
+            pos = tracks.pos[track] = (int32_t)tracks.track.size();
+            tracks.start.emplace_back();
+            tracks.invDuration.emplace_back();
+            tracks.from.emplace_back();
+            tracks.to.emplace_back();
+            tracks.progress.emplace_back();
+            tracks.value.emplace_back();
+            tracks.easing.emplace_back();
+            tracks.track.emplace_back(track);
+        }
+
+        tracks.start[pos] = tracks.now + (double)delay;
+        tracks.invDuration[pos] = duration > 0.f ? 1.f / duration : FLT_MAX;
+        tracks.from[pos] = from;
+        tracks.to[pos] = to;
+        tracks.progress[pos] = 0.f;
+        tracks.value[pos] = from;
+        tracks.easing[pos] = easing;
+
+        if (delay <= 0.f) tracks.deadline = 0.f;
+        else if (tracks.deadline != 0.f)
+            tracks.deadline = tracks.deadline < 0.f ? delay : std::min(tracks.deadline, delay);
+    }
+
+    void anim::StopTrack(int32_t track)
+    {
+        if (track == -1) return;
+
+        // Stopped tracks are finished, i.e. at their final value
+        auto& tracks = GetAnimationTracks();
+        auto pos = tracks.pos[track];
+        if (pos != -1)
+        {
+            tracks.progress[pos] = 1.f;
+            tracks.value[pos] = tracks.to[pos];
+            DeactivateTrack(tracks, track);
+        }
+        else tracks.finalProgress[track] = 1.f;
+    }
+
+    void anim::ReleaseTrack(int32_t& track)
+    {
+        if (track == -1) return;
+
+        if (IsAnimationTracksAlive)
+        {
+            auto& tracks = GetAnimationTracks();
+            DeactivateTrack(tracks, track);
+            tracks.finalProgress[track] = 1.f;
+            tracks.freeList.push_back(track);
+        }
+
+        track = -1;
+    }
+
+    float anim::TrackValue(int32_t track)
+    {
+        if (track == -1) return 1.f;
+
+        const auto& tracks = GetAnimationTracks();
+        auto pos = tracks.pos[track];
+        return pos == -1 ? tracks.finalValue[track] : tracks.value[pos];
+    }
+
+    float anim::TrackProgress(int32_t track)
+    {
+        if (track == -1) return 1.f;
+
+        const auto& tracks = GetAnimationTracks();
+        auto pos = tracks.pos[track];
+        return pos == -1 ? tracks.finalProgress[track] : tracks.progress[pos];
+    }
+
+    bool anim::IsTrackActive(int32_t track)
+    {
+        return TrackProgress(track) < 1.f;
+    }
+
+    void anim::UpdateTracks(float deltaTime)
+    {
+        auto& tracks = GetAnimationTracks();
+        tracks.now += (double)deltaTime;
+
+        auto now = tracks.now;
+        auto total = (int32_t)tracks.track.size();
+        auto nextStart = DBL_MAX;
+        auto running = false;
+
+        // Linear progress of started tracks, branch-free and vectorisable
+        auto start = tracks.start.data();
+        auto invDuration = tracks.invDuration.data();
+        auto progress = tracks.progress.data();
+        for (auto pos = 0; pos < total; ++pos)
+        {
+            auto elapsed = (float)std::max(now - start[pos], 0.0);
+            progress[pos] = std::clamp(elapsed * invDuration[pos], 0.f, 1.f);
+        }
+
+        // Eased values, delayed tracks stay at their start value
+        for (auto pos = 0; pos < total; ++pos)
+        {
+            auto from = tracks.from[pos];
+            auto eased = from + ((tracks.to[pos] - from) * EaseTrack(tracks.easing[pos], progress[pos]));
+            tracks.value[pos] = start[pos] > now ? from : progress[pos] < 1.f ? eased : tracks.to[pos];
+        }
+
+        // Finished tracks keep their final value and leave the packed arrays, order of the rest is kept
+        auto kept = 0;
+        for (auto pos = 0; pos < total; ++pos)
+        {
+            auto track = tracks.track[pos];
+
+            if (progress[pos] >= 1.f)
+            {
+                tracks.finalProgress[track] = 1.f;
+                tracks.finalValue[track] = tracks.value[pos];
+                tracks.pos[track] = -1;
+                continue;
+            }
+
+            if (start[pos] > now) nextStart = std::min(nextStart, start[pos]);
+            else running = true;
+
+            if (kept != pos)
+            {
+                tracks.start[kept] = tracks.start[pos];
+                tracks.invDuration[kept] = tracks.invDuration[pos];
+                tracks.from[kept] = tracks.from[pos];
+                tracks.to[kept] = tracks.to[pos];
+                tracks.progress[kept] = tracks.progress[pos];
+                tracks.value[kept] = tracks.value[pos];
+                tracks.easing[kept] = tracks.easing[pos];
+                tracks.track[kept] = track;
+                tracks.pos[track] = kept;
+            }
+
+            ++kept;
+        }
+
+        tracks.start.resize(kept);
+        tracks.invDuration.resize(kept);
+        tracks.from.resize(kept);
+        tracks.to.resize(kept);
+        tracks.progress.resize(kept);
+        tracks.value.resize(kept);
+        tracks.easing.resize(kept);
+        tracks.track.resize(kept);
+
+        tracks.deadline = running ? 0.f : nextStart != DBL_MAX ? (float)(nextStart - now) : -1.f;
+    }
+
+    float anim::NextAnimationDeadline()
+    {
+        return GetAnimationTracks().deadline;
+    }
+
+#pragma endregion
+}
+
+// Legacy progress based animations are not known to the track scheduler, hence
+// keep event driven loops rendering until they reach the end
+static float AdvanceEasing(float progress, float duration)
+{
+    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    if (progress < 1.f) glimmer::Config.platform->RequestFrame();
+    return progress;
 }
 
 float glimmer::anim::EaseIn(float& progress, float duration)
@@ -1788,7 +2697,7 @@ float glimmer::anim::EaseIn(float& progress, float duration)
 
     auto t = progress;
     auto ratio = t * t;
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
 
@@ -1799,7 +2708,7 @@ float glimmer::anim::EaseOut(float& progress, float duration)
 
     auto t = progress;
     float ratio = t * (2.f - t);
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
 
@@ -1810,7 +2719,7 @@ float glimmer::anim::EaseInOut(float& progress, float duration)
 
     auto t = progress;
     auto ratio = progress < 0.5f ? (2.f * t * t) : ((-2.f * t * t) + (4.f * t) - 1.f);
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
 
@@ -1821,7 +2730,7 @@ float glimmer::anim::EaseInSharp(float& progress, float duration)
 
     auto t = progress;
     auto ratio = t * t * t;
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
 
@@ -1833,7 +2742,7 @@ float glimmer::anim::EaseOutSharp(float& progress, float duration)
     auto t = progress;
     auto x = (1.f - t);
     auto ratio = 1.f - (x * x * x);
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
 
@@ -1845,7 +2754,7 @@ float glimmer::anim::EaseInBack(float& progress, float duration, float overshoot
     auto t = progress, s = overshoot;
     float sqr = t * t; float cube = sqr * t;
     auto ratio = (s + 1.f) * cube - (s * sqr);
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
 
@@ -1857,7 +2766,7 @@ float glimmer::anim::EaseOutBack(float& progress, float duration, float overshoo
     auto t = progress - 1.f, s = overshoot;
     float sqr = t * t; float cube = sqr * t;
     auto ratio = 1.f + (s + 1.f) * cube - (s * sqr);
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
 
@@ -1893,7 +2802,7 @@ float glimmer::anim::EaseInBounce(float& progress, float duration, float bounceT
         ratio = gravity * t * t + 0.984375f;
     }
 
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return 1.f - ratio;
 }
 
@@ -1929,6 +2838,6 @@ float glimmer::anim::EaseOutBounce(float& progress, float duration, float bounce
         ratio = gravity * t * t + 0.984375f;
     }
 
-    progress = glimmer::clamp(progress + (glimmer::Config.platform->desc.deltaTime / duration), 0.f, 1.f);
+    progress = AdvanceEasing(progress, duration);
     return ratio;
 }
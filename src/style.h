@@ -5,6 +5,8 @@
 namespace glimmer
 {
     struct LayoutBuilder;
+    struct StyleLiteral;
+    struct CompactStyle;
 
     [[nodiscard]] uint32_t GetColor(const char* name, void*);
 
@@ -196,11 +198,77 @@ namespace glimmer
 
         StyleDescriptor& From(std::string_view css, bool checkForDuplicate = true);
         StyleDescriptor& From(const StyleDescriptor& style, bool overwrite = true);
+        StyleDescriptor& From(const StyleLiteral& css);
+        StyleDescriptor& From(const CompactStyle& style, bool overwrite = true);
 
         static void(*GlobalThemeProvider)(GlobalWidgetTheme*);
     };
 
-    using StyleStackT = DynamicStack<StyleDescriptor, int16_t, GLIMMER_MAX_STYLE_STACKSZ>;
+    // Sparse representation of a style for bulk storage i.e. per widget styles. Only the specified
+    // properties are stored (as 4-byte words in a shared pool), unspecified ones come from defaults.
+    // dest.From(CompactStyle{ style }) is equivalent to dest.From(style). A compact style owns its words
+    // in the pool, hence it is move-only and returns them when destroyed or assigned to. The owner
+    // re-encodes it with assign, and may return the words early with release.
+    struct CompactStyle
+    {
+        uint64_t specified = 0;
+        int32_t fontFlags = 0;
+        int32_t alignment = 0;
+        int32_t offset = 0; // Start of property values in the pool
+        int32_t capacity = 0; // Words owned in the pool
+
+        CompactStyle() = default;
+        explicit CompactStyle(const StyleDescriptor& style);
+        CompactStyle(const CompactStyle&) = delete;
+        CompactStyle(CompactStyle&& src) noexcept;
+        ~CompactStyle();
+
+        CompactStyle& operator=(const CompactStyle&) = delete;
+        CompactStyle& operator=(CompactStyle&& src) noexcept;
+
+        void assign(const StyleDescriptor& style);
+        void release();
+    };
+
+    // Bytes used by the compact style pool, including free words
+    [[nodiscard]] int64_t CompactStylePoolSize();
+
+    // Returns a version not shared with any other style, used for styles pushed without CSS
+    [[nodiscard]] uint64_t NextStyleVersion();
+    [[nodiscard]] inline uint64_t CombineStyleVersion(uint64_t lhs, uint64_t rhs)
+    {
+        return lhs ^ (rhs + 0x9e3779b97f4a7c15ull + (lhs << 6) + (lhs >> 2));
+    }
+
+    // Style stack which also tracks a version per entry, the version identifies the contents of
+    // the entry i.e. the same CSS pushed on top of the same parent yields the same version across
+    // frames. This is used to memoise resolved styles per widget, see GetStyle in context.cpp
+    struct StyleStackT : public DynamicStack<StyleDescriptor, int16_t, GLIMMER_MAX_STYLE_STACKSZ>
+    {
+        using BaseT = DynamicStack<StyleDescriptor, int16_t, GLIMMER_MAX_STYLE_STACKSZ>;
+        using BaseT::BaseT;
+
+        StyleDescriptor& push(uint64_t version = 0)
+        {
+            versions.push() = version == 0 ? NextStyleVersion() : version;
+            return BaseT::push();
+        }
+
+        void pop(int depth, bool definit)
+        {
+            versions.pop(depth, false);
+            BaseT::pop(depth, definit);
+        }
+
+        void clear(bool definit) { pop(size(), definit); }
+
+        uint64_t version() const { return versions.empty() ? 0 : versions.top(); }
+        uint64_t version(int idx) const { return versions[idx]; }
+
+    private:
+
+        DynamicStack<uint64_t, int16_t, GLIMMER_MAX_STYLE_STACKSZ> versions;
+    };
 
     struct ToggleButtonStyleDescriptor
     {
@@ -359,6 +427,27 @@ namespace glimmer
         float EaseOutBack(float& progress, float duration, float overshoot = 1.70158f);
         float EaseInBounce(float& progress, float duration, float bounceTempo = 3.5);
         float EaseOutBounce(float& progress, float duration, float bounceTempo = 3.5);
+
+        enum class Easing : uint8_t
+        {
+            Linear, EaseIn, EaseOut, EaseInOut, EaseInSharp, EaseOutSharp, EaseInBack, EaseOutBack,
+            EaseInBounce, EaseOutBounce
+        };
+
+        // Animation tracks go from `from` to `to` over `duration` seconds (after `delay`) and are
+        // updated once per frame for all widgets. A widget owns its track handle (-1 initially) until
+        // it is released, starting it again restarts the same track.
+        void StartTrack(int32_t& track, float duration, Easing easing, float from = 0.f, float to = 1.f,
+            float delay = 0.f);
+        void StopTrack(int32_t track);
+        void ReleaseTrack(int32_t& track); // Returns the slot for reuse, and resets handle to -1
+        [[nodiscard]] float TrackValue(int32_t track); // Eased value, 1 if track was never started
+        [[nodiscard]] float TrackProgress(int32_t track); // Linear progress in [0, 1]
+        [[nodiscard]] bool IsTrackActive(int32_t track);
+        void UpdateTracks(float deltaTime);
+
+        // Seconds until a track needs the next frame, 0 if a track is running, -1 if none will
+        [[nodiscard]] float NextAnimationDeadline();
     }
 
     // Set all styles for ids/classes as a stylesheet (This should be done before event loop, or at the start
@@ -368,12 +457,48 @@ namespace glimmer
     StyleDescriptor& GetStyle(std::string_view id, WidgetStateIndex index);
     StyleDescriptor& GetWidgetStyle(WidgetType type, WidgetStateIndex index);
 
+    // Theme files are CSS-like style sheets, where rules are keyed by widget type name (Config.widgetNames),
+    // #id or .class with an optional state, i.e. `button:hover, .primary { color: white; }`. Rules of a
+    // selector replace styles set for it by SetStyle. Reloading a theme only recomputes styles of the
+    // widgets and widget types whose rules changed. Watched themes are reloaded at frame start on change,
+    // a background thread wakes up the platform loop when the file changes (UnwatchTheme before destroying
+    // the platform).
+    bool LoadTheme(std::string_view path);
+    bool WatchTheme(std::string_view path);
+    void UnwatchTheme();
+    bool ReloadThemeIfChanged();
+
+    struct StyleCacheStats
+    {
+        int64_t hits = 0;
+        int64_t misses = 0;
+        double parseTimeUs = 0.0; // Total time spent parsing CSS which was not cached
+
+        float hitRate() const { return (hits + misses) > 0 ? (float)hits / (float)(hits + misses) : 0.f; }
+    };
+
+    // CSS passed to PushStyle/SetStyle/StyleDescriptor::From is parsed once and cached by its contents,
+    // precompile styles (ideally at startup) to avoid parsing them in the first frame
+    void PrecompileStyle(std::string_view css);
+    void PrecompileStyle(const std::initializer_list<std::string_view>& css);
+    [[nodiscard]] StyleCacheStats GetStyleCacheStats();
+    void ClearStyleCache();
+
+    // Version of style sheet i.e. styles set by SetStyle, resolved styles are recomputed when it changes.
+    // Invalidate explicitly if styles returned by GetStyle/GetWidgetStyle are modified in place.
+    [[nodiscard]] uint64_t GetStyleSheetVersion();
+    void InvalidateStyleSheet();
+
     // Push/Pop styles for a widget for temporary style changes
     void PushStyle(std::string_view defcss, std::string_view hovercss = "", std::string_view pressedcss = "",
         std::string_view focusedcss = "", std::string_view checkedcss = "", std::string_view disblcss = "");
     void PushStyleFmt(int32_t state, std::string_view fmt, ...);
     void PushStyleFmt(std::string_view fmt, ...);
     void PushStyle(int32_t state, std::string_view css);
+
+    // Push styles parsed at compile time i.e. PushStyle(css<"padding: 5px">), see cssliteral.h
+    void PushStyle(const StyleLiteral& css);
+    void PushStyle(int32_t state, const StyleLiteral& css);
     void PopStyle(int depth = 1, int32_t state = WS_Default);
 
 #ifndef GLIMMER_DISABLE_RICHTEXT
@@ -389,8 +514,6 @@ namespace glimmer
     }
     void RestoreStyleStack();
 
-    std::pair<Sizing, bool> ParseLayoutStyle(LayoutBuilder& layout, std::string_view css, float pwidth, float pheight);
-
 #ifndef GLIMMER_DISABLE_RICHTEXT
 
     [[nodiscard]] int SkipSpace(const char* text, int idx, int end);
@@ -420,3 +543,5 @@ namespace glimmer
 
 #endif
 }
+
+#include "cssliteral.h"
@@ -8,7 +8,7 @@
 #include <charconv>
 #include <string>
 #include <deque>
-#include <varargs.h>
+#include <cstdarg>
 
 #include "utils.h"
 
@@ -3,6 +3,7 @@
 #include "config.h"
 #include "utils.h"
 
+#include <string>
 #include <string_view>
 #include <optional>
 #include <vector>
@@ -120,6 +121,7 @@ namespace glimmer
         WT_Charts,
         WT_MediaResource,
         WT_NavDrawer,
+        WT_TextEditor,
         WT_TotalTypes,
 
         WT_Custom = 1 << 15,
@@ -429,6 +431,16 @@ namespace glimmer
 		bool isSelectable = true;
     };
 
+    // Multi-line text editor, text is owned by the widget's persistent state and accessed
+    // through SetTextEditorText/GetTextEditorText, as copying it every frame is expensive
+    struct TextEditorState : public CommonWidgetData
+    {
+        std::string_view placeholder;
+        int32_t tabWidth = 4; // Tab key inserts these many spaces
+        int32_t visibleLines = 10; // Lines to fit if height is not specified in style
+        bool readOnly = false;
+    };
+
     struct DropDownState : public CommonWidgetData
     {
         struct OptionDescriptor
@@ -457,10 +469,18 @@ namespace glimmer
         bool (*ShowList)(int32_t, ImVec2, ImVec2, DropDownState&) = nullptr;
         std::pair<std::string_view, TextType> (*CurrentSelectedOption)(int32_t) = nullptr;
         OptionStyleDescriptor(*OptionStyle)(int32_t) = nullptr;
+
+        // Virtualised options, only visible options are fetched from OptionText (or `options` if
+        // not provided) and drawn as plain text. Typing while the popup is open filters options.
+        std::string_view (*OptionText)(int32_t) = nullptr;
+        std::string_view filterHint = "Type to filter";
+        int32_t optionCount = 0;
+        int32_t visibleOptions = 10;
         
         bool isComboBox = false;
         bool opened = false;
         bool hasSelection = true;
+        bool isVirtualised = false;
     };
 
     enum TabItemProperty
@@ -534,7 +554,7 @@ namespace glimmer
     struct ItemGridItemProps
     {
         int16_t rowsdpan = 1, colspan = 1;
-        int16_t children = 0;
+        int32_t children = 0;
         ItemDescendentVisualState vstate = ItemDescendentVisualState::NoDescendent;
         int32_t alignment = TextAlignCenter;
         uint32_t highlightBgColor = ToRGBA(186, 244, 250);
@@ -583,6 +603,28 @@ namespace glimmer
 
     using GridLayoutDirection = ItemGridPopulateMethod;
 
+    // Sizing function of a grid layout track (row or column), modelled after CSS grid
+    enum class GridTrackType : int8_t
+    {
+        Auto,     // Sized to fit content of items placed in the track
+        Fixed,    // Fixed size in pixels
+        Relative, // Fraction of available size of grid, in [0, 1]
+        Fraction  // Flexible track i.e. `fr` unit, shares leftover space by weight
+    };
+
+    struct GridTrackSize
+    {
+        GridTrackType type = GridTrackType::Auto;
+        float value = 0.f; // Pixels for Fixed, [0, 1] for Relative, weight for Fraction
+        float min = -1.f;  // Lower bound in pixels i.e. minmax(min, ...), content-based if negative
+
+        static constexpr GridTrackSize Auto() { return GridTrackSize{}; }
+        static constexpr GridTrackSize Px(float px) { return GridTrackSize{ GridTrackType::Fixed, px }; }
+        static constexpr GridTrackSize Relative(float ratio) { return GridTrackSize{ GridTrackType::Relative, ratio }; }
+        static constexpr GridTrackSize Fr(float weight = 1.f) { return GridTrackSize{ GridTrackType::Fraction, weight }; }
+        static constexpr GridTrackSize MinMax(float min, GridTrackSize max) { max.min = min; return max; }
+    };
+
     enum ItemGridHighlightType
     {
         IG_HighlightRows = 1, 
@@ -605,6 +647,43 @@ namespace glimmer
         IG_Selected = 1, IG_Highlighted = 2
     };
 
+    // Key of a cell used to sort and filter item grid rows in background, see ItemGridConfig::cellkey.
+    // Keys are compared by number if text of both is empty, by text otherwise.
+    struct ItemGridCellKey
+    {
+        std::string_view text;
+        double number = 0.0;
+    };
+
+    // Rows fetched by an IItemGridDataSource, cells are in row-major order
+    struct ItemGridRowData
+    {
+        int32_t rowStart = 0;
+        int16_t columns = 0;
+        std::vector<std::string> cells;
+    };
+
+    using ItemGridDeliverFn = std::function<void(ItemGridRowData&&)>;
+
+    // Range of selected items in an item grid, row ranges have columns as -1 and vice versa,
+    // selected cells are reported individually. Bounds are inclusive.
+    struct ItemGridSelectedRange
+    {
+        int32_t fromRow = -1, toRow = -1;
+        int16_t fromCol = -1, toCol = -1;
+        int16_t depth = -1;
+    };
+
+    // Node of a tree item grid at a displayed row, row is the index among siblings (as passed to
+    // ItemGridConfig callbacks) and parent is the displayed row of parent node (-1 for roots)
+    struct ItemGridTreeNode
+    {
+        int32_t row = -1, parent = -1;
+        int16_t depth = -1;
+    };
+
+    struct IItemGridDataSource;
+
     struct ItemGridConfig : public CommonWidgetData
     {
         struct ColumnConfig
@@ -635,6 +714,7 @@ namespace glimmer
         uint32_t highlightFgColor = ToRGBA(0, 0, 0);
         uint32_t selectionBgColor = ToRGBA(0, 0, 120);
         uint32_t selectionFgColor = ToRGBA(255, 255, 255);
+        uint32_t placeholderColor = ToRGBA(200, 200, 200, 128); // Cells not fetched from datasource yet
         
         int16_t sortedcol = -1;
         int16_t coldrag = -1;
@@ -643,13 +723,21 @@ namespace glimmer
         int32_t selection = 0;
         int32_t scrollprops = ST_Always_H | ST_Always_V;
         ItemGridPopulateMethod populateMethod = ItemGridPopulateMethod::ByRows;
-        bool uniformRowHeights = false;
+        bool uniformRowHeights = false; // Visible rows are located without measuring rows before them
         bool isTree = false;
 
         ItemGridItemProps (*cellprops)(int32_t, int16_t, int16_t, int32_t, int32_t) = nullptr;
         void (*cellwidget)(std::pair<float, float>, int32_t, int16_t, int16_t) = nullptr;
         std::pair<std::string_view, TextType> (*cellcontent)(std::pair<float, float>, int32_t, int16_t, int16_t) = nullptr;
         void (*header)(ImVec2, float, int16_t, int16_t, int16_t) = nullptr;
+        // If set, rows of a flat grid are sorted by the sorted column and filtered by the filter row on worker
+        // threads, hence must be thread-safe and text must stay valid until InvalidateItemGridRows is called.
+        // Cell callbacks then receive source rows, whereas events and selection refer to displayed rows.
+        // Selected rows follow their source rows when a new order is published, filtered out rows are deselected.
+        ItemGridCellKey (*cellkey)(int32_t, int16_t) = nullptr;
+        // If set, cell text is fetched asynchronously in pages from the source instead of cellcontent,
+        // cells of pages which are not fetched yet are drawn as placeholders
+        IItemGridDataSource* datasource = nullptr;
 
         void setColumnResizable(int16_t col, bool resizable);
         void setColumnProps(int16_t col, ColumnProperty prop, bool set = true);
@@ -670,6 +758,7 @@ namespace glimmer
             SliderState slider;
             RangeSliderState rangeSlider;
             TextInputState input;
+            TextEditorState editor;
             DropDownState dropdown;
             TabBarState tab;
             ItemGridConfig grid;
@@ -5,6 +5,14 @@
 #include <optional>
 #include <assert.h>
 #include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <algorithm>
 
 #include "config.h"
 
@@ -77,6 +85,26 @@ namespace glimmer
     inline void* (*AllocateFunc)(size_t amount) = &AllocateImpl;
     inline void* (*ReallocateFunc)(void* ptr, size_t amount) = &ReallocateImpl;
     inline void (*DeallocateFunc)(void* ptr) = &DeallocateImpl;
+#elif defined(GLIMMER_ENABLE_LAYOUT_STATS)
+    // Allocation calls are counted for layout statistics, without tracking individual allocations
+    inline int32_t TotalMallocs = 0;
+    inline int32_t TotalReallocs = 0;
+
+    inline void* AllocateImpl(size_t amount)
+    {
+        TotalMallocs++;
+        return std::malloc(amount);
+    }
+
+    inline void* ReallocateImpl(void* ptr, size_t amount)
+    {
+        ++(ptr == nullptr ? TotalMallocs : TotalReallocs);
+        return std::realloc(ptr, amount);
+    }
+
+    inline void* (*AllocateFunc)(size_t amount) = &AllocateImpl;
+    inline void* (*ReallocateFunc)(void* ptr, size_t amount) = &ReallocateImpl;
+    inline void (*DeallocateFunc)(void* ptr) = &std::free;
 #else
     inline void* (*AllocateFunc)(size_t amount) = &std::malloc;
     inline void* (*ReallocateFunc)(void* ptr, size_t amount) = &std::realloc;
@@ -575,4 +603,126 @@ namespace glimmer
 
     template <typename ItrT>
     Span(ItrT start, ItrT end) -> Span<std::decay_t<decltype(*start)>>;
+
+    // Fixed size pool of background threads, used for jobs which do not touch 
+    // ImGui/platform state i.e. text layout and sorting.
+    struct WorkerPool
+    {
+        explicit WorkerPool(int32_t threads = GLIMMER_MAX_WORKER_THREADS)
+        {
+            if (threads <= 0) threads = std::max((int32_t)std::thread::hardware_concurrency() - 1, 1);
+            for (auto idx = 0; idx < threads; ++idx)
+                _workers.emplace_back([this] { Run(); });
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ _mutex };
+                _exit = true;
+            }
+
+            _cv.notify_all();
+            for (auto& worker : _workers) worker.join();
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        void Enqueue(std::function<void()> task)
+        {
+            {
+                std::lock_guard<std::mutex> lock{ _mutex };
+                _tasks.emplace_back(std::move(task));
+            }
+
+            _cv.notify_one();
+        }
+
+        // Invokes fn(idx) for idx in [0, count), the calling thread participates and the call
+        // returns once all indexes are processed. Must not be called from a worker thread.
+        // Helpers may be queued behind other jobs, hence the caller only waits for helpers which
+        // started before it ran out of indexes, helpers starting later exit without touching fn.
+        template <typename FnT>
+        void ParallelFor(int32_t count, FnT&& fn)
+        {
+            if (count <= 0) return;
+
+            auto helpers = std::min(count - 1, (int32_t)_workers.size());
+            if (helpers <= 0) 
+            {
+                for (auto idx = 0; idx < count; ++idx) fn(idx);
+                return;
+            }
+
+            struct SharedState
+            {
+                std::atomic<int32_t> next = 0;
+                std::mutex mutex;
+                std::condition_variable done;
+                int32_t active = 0;
+                bool closed = false;
+            };
+
+            auto state = std::make_shared<SharedState>();
+            auto func = &fn;
+            auto body = [count](SharedState& state, FnT& fn) {
+                for (auto idx = state.next.fetch_add(1); idx < count; idx = state.next.fetch_add(1))
+                    fn(idx);
+            };
+
+            for (auto idx = 0; idx < helpers; ++idx)
+                Enqueue([state, func, body] {
+                    {
+                        std::lock_guard<std::mutex> lock{ state->mutex };
+                        if (state->closed) return;
+                        ++state->active;
+                    }
+
+                    body(*state, *func);
+                    std::lock_guard<std::mutex> lock{ state->mutex };
+                    if (--state->active == 0) state->done.notify_all();
+                });
+
+            body(*state, fn);
+            std::unique_lock<std::mutex> lock{ state->mutex };
+            state->closed = true;
+            state->done.wait(lock, [&] { return state->active == 0; });
+        }
+
+        int32_t size() const { return (int32_t)_workers.size(); }
+
+    private:
+
+        void Run()
+        {
+            while (true)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock{ _mutex };
+                    _cv.wait(lock, [this] { return _exit || !_tasks.empty(); });
+                    if (_exit && _tasks.empty()) return;
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+
+                task();
+            }
+        }
+
+        std::vector<std::thread> _workers;
+        std::deque<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        bool _exit = false;
+    };
+
+    // Lazily created process-wide worker pool
+    inline WorkerPool& GetWorkerPool()
+    {
+        static WorkerPool pool;
+        return pool;
+    }
 }
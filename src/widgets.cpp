@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cctype>
 #include <charconv>
+#include <numeric>
 #include "style.h"
 #include "draw.h"
 #include "context.h"
@@ -31,8 +32,8 @@ namespace glimmer
     WidgetDrawResult Widget(int32_t id, WidgetType type, int32_t geometry, const NeighborWidgets& neighbors);
     ImRect BeginFlexLayoutRegion(Direction dir, int32_t geometry, bool wrap,
         ImVec2 spacing, ImVec2 size, const NeighborWidgets& neighbors, int regionIdx);
-    ImRect BeginGridLayoutRegion(int rows, int cols, GridLayoutDirection dir, int32_t geometry, const std::initializer_list<float>& rowExtents,
-        const std::initializer_list<float>& colExtents, ImVec2 spacing, ImVec2 size,
+    ImRect BeginGridLayoutRegion(int rows, int cols, GridLayoutDirection dir, int32_t geometry, Span<const GridTrackSize> rowTracks,
+        Span<const GridTrackSize> colTracks, ImVec2 spacing, ImVec2 size,
         const NeighborWidgets& neighbors, int regionIdx);
 
 #pragma region Widget ID Handling
@@ -93,9 +94,10 @@ namespace glimmer
         auto it = NamedIds[type].find(id);
         if (it == NamedIds[type].end())
         {
+            // Keyed by the full string (id and classes), as that is what is looked up
             auto key = CreatePermanentCopy(id);
             auto idClasses = ExtractIdClasses(key);
-            it = NamedIds[type].emplace(idClasses.id, GetNextId(type)).first;
+            it = NamedIds[type].emplace(key, GetNextId(type)).first;
             GetContext().RegisterWidgetIdClass(type, it->second, idClasses);
             if (Config.RecordWidgetId) (*Config.RecordWidgetId)(key, it->second);
             if (Config.logger) Config.logger->RegisterId(it->second, id);
@@ -149,6 +151,7 @@ namespace glimmer
         case WT_Slider: new (&state.slider) SliderState{}; break;
         case WT_RangeSlider: new (&state.slider) RangeSliderState{}; break;
         case WT_TextInput: new (&state.input) TextInputState{}; break;
+        case WT_TextEditor: new (&state.editor) TextEditorState{}; break;
         case WT_DropDown: new (&state.dropdown) DropDownState{}; break;
         case WT_SplitterRegion: [[fallthrough]];
         case WT_Scrollable: new (&state.scroll) ScrollableRegion{}; break;
@@ -174,6 +177,7 @@ namespace glimmer
         case WT_Slider: state.slider = src.state.slider; break;
         case WT_RangeSlider: state.rangeSlider = src.state.rangeSlider; break;
         case WT_TextInput: state.input = src.state.input; break;
+        case WT_TextEditor: state.editor = src.state.editor; break;
         case WT_DropDown: state.dropdown = src.state.dropdown; break;
         case WT_SplitterRegion: [[fallthrough]];
         case WT_Scrollable: state.scroll = src.state.scroll; break;
@@ -199,6 +203,7 @@ namespace glimmer
         case WT_Slider: state.slider = src.state.slider; break;
         case WT_RangeSlider: state.rangeSlider = src.state.rangeSlider; break;
         case WT_TextInput: state.input = src.state.input; break;
+        case WT_TextEditor: state.editor = src.state.editor; break;
         case WT_DropDown: state.dropdown = src.state.dropdown; break;
         case WT_SplitterRegion: [[fallthrough]];
         case WT_Scrollable: state.scroll = src.state.scroll; break;
@@ -224,6 +229,7 @@ namespace glimmer
         case WT_Slider: state.slider.~SliderState(); break;
         case WT_RangeSlider: state.rangeSlider.~RangeSliderState(); break;
         case WT_TextInput: state.input.~TextInputState(); break;
+        case WT_TextEditor: state.editor.~TextEditorState(); break;
         case WT_DropDown: state.dropdown.~DropDownState(); break;
         case WT_Scrollable: state.scroll.~ScrollableRegion(); break;
         case WT_TabBar: state.tab.~TabBarState(); break;
@@ -255,6 +261,7 @@ namespace glimmer
         case WT_Slider: state.state.slider.id = wid; break;
         case WT_RangeSlider: state.state.rangeSlider.id = wid; break;
         case WT_TextInput: state.state.input.id = wid; break;
+        case WT_TextEditor: state.state.editor.id = wid; break;
         case WT_DropDown: state.state.dropdown.id = wid; break;
         case WT_ItemGrid: state.state.grid.id = wid; break;
         default: break;
@@ -407,31 +414,47 @@ namespace glimmer
         }
     }
 
+    static void DrawTooltip(const ImRect& area, std::string_view tooltip, const IODescriptor& io)
+    {
+        auto font = GetFont(Config.tooltipFontFamily, Config.tooltipFontSz, FT_Normal);
+        auto textsz = Config.renderer->GetTextSize(tooltip, font, Config.tooltipFontSz);
+
+        ImVec2 tooltippos;
+        auto halfw = ((area.GetWidth() - textsz.x) * 0.5f);
+        auto startx = io.mousepos.x - halfw, endx = io.mousepos.x + halfw;
+        auto hdiff1 = std::min(startx, 0.f), hdiff2 = std::min(0.f, GetContext().WindowSize().x - endx);
+        tooltippos.x = io.mousepos.x - halfw - hdiff1 + hdiff2;
+
+        tooltippos.y = io.mousepos.y - (textsz.y + 2.f);
+        if (tooltippos.y < 0.f) tooltippos.y = io.mousepos.y + 2.f;
+        Config.renderer->DrawTooltip(tooltippos, tooltip);
+    }
+
     void ShowTooltip(float& hoverDuration, const ImRect& area, std::string_view tooltip, const IODescriptor& io)
     {
         if (area.Contains(io.mousepos) && !tooltip.empty() && !io.isMouseDown())
         {
             hoverDuration += io.deltaTime;
 
-            if (hoverDuration >= Config.tooltipDelay)
-            {
-                auto font = GetFont(Config.tooltipFontFamily, Config.tooltipFontSz, FT_Normal);
-                auto textsz = Config.renderer->GetTextSize(tooltip, font, Config.tooltipFontSz);
-
-                ImVec2 tooltippos;
-                auto halfw = ((area.GetWidth() - textsz.x) * 0.5f);
-                auto startx = io.mousepos.x - halfw, endx = io.mousepos.x + halfw;
-                auto hdiff1 = std::min(startx, 0.f), hdiff2 = std::min(0.f, GetContext().WindowSize().x - endx);
-                tooltippos.x = io.mousepos.x - halfw - hdiff1 + hdiff2;
-
-                tooltippos.y = io.mousepos.y - (textsz.y + 2.f);
-                if (tooltippos.y < 0.f) tooltippos.y = io.mousepos.y + 2.f;
-                Config.renderer->DrawTooltip(tooltippos, tooltip);
-            }
+            if (hoverDuration < Config.tooltipDelay)
+                Config.platform->RequestFrameAfter(Config.tooltipDelay - hoverDuration);
+            else DrawTooltip(area, tooltip, io);
         }
         else hoverDuration = 0;
     }
 
+    // Hover delay is a track delayed by the tooltip delay, so that the scheduler wakes up the
+    // frame when it is due, and the track is released once the area is no longer hovered
+    static void ShowTooltip(int32_t& hoverTrack, const ImRect& area, std::string_view tooltip, const IODescriptor& io)
+    {
+        if (area.Contains(io.mousepos) && !tooltip.empty() && !io.isMouseDown())
+        {
+            if (hoverTrack == -1) anim::StartTrack(hoverTrack, 0.f, anim::Easing::Linear, 0.f, 1.f, Config.tooltipDelay);
+            else if (!anim::IsTrackActive(hoverTrack)) DrawTooltip(area, tooltip, io);
+        }
+        else anim::ReleaseTrack(hoverTrack);
+    }
+
     void SetTooltip(int32_t id, std::string_view tooltip)
     {
         auto wtype = (WidgetType)(id >> WidgetTypeBits);
@@ -466,6 +489,9 @@ namespace glimmer
         case glimmer::WT_TextInput:
             state.input.tooltip = tooltip;
             break;
+        case glimmer::WT_TextEditor:
+            state.editor.tooltip = tooltip;
+            break;
         case glimmer::WT_DropDown:
             state.dropdown.tooltip = tooltip;
             break;
@@ -1980,7 +2006,8 @@ namespace glimmer
                 result.event = WidgetEvent::Clicked;
                 state.checked = !state.checked;
                 toggle.animate = true;
-                toggle.progress = 0.018f;
+                anim::StartTrack(toggle.track, context.toggleButtonStyles[log2((unsigned)state.state)].top().animationDuration,
+                    anim::Easing::EaseOut);
             }
 
             toggle.btnpos = toggle.animate ? center.x : -1.f;
@@ -2011,7 +2038,7 @@ namespace glimmer
         auto extra = (-specificStyle.thumbOffset + specificStyle.trackBorderThickness);
         auto radius = (extent.GetHeight() * 0.5f) - (2.f * extra);
         auto movement = extent.GetWidth() - (2.f * (radius + extra));
-        auto ratio = anim::EaseOut(toggle.progress, specificStyle.animationDuration);
+        auto ratio = anim::TrackValue(toggle.track);
         auto moveAmount = toggle.animate ? ratio * movement * (state.checked ? 1.f : -1.f) : 0.f;
 
         auto center = toggle.btnpos == -1.f ? state.checked ? extent.Max - ImVec2{ extra + radius, extra + radius }
@@ -2025,7 +2052,7 @@ namespace glimmer
         auto tcol = toggle.animate ? anim::InterpolateColor(state.checked ? 
             context.toggleButtonStyles[WSI_Default].top().trackColor :
             context.toggleButtonStyles[WSI_Checked].top().trackColor,
-            specificStyle.trackColor, toggle.progress) :
+            specificStyle.trackColor, anim::TrackProgress(toggle.track)) :
             specificStyle.trackColor;
 
         renderer.DrawRoundedRect(extent.Min, extent.Max, tcol, true, rounded, rounded, rounded, rounded);
@@ -2099,7 +2126,8 @@ namespace glimmer
                 result.event = WidgetEvent::Clicked;
                 state.checked = !state.checked;
                 radio.animate = true;
-                radio.progress = 0.018f;
+                anim::StartTrack(radio.track, context.radioButtonStyles[log2((unsigned)state.state)].top().animationDuration,
+                    anim::Easing::EaseOut);
             }
 
             state.state = mouseover && io.isLeftMouseDown() ? WS_Hovered | WS_Pressed :
@@ -2133,7 +2161,7 @@ namespace glimmer
         
         if (radio.animate)
         {
-            auto ratio = anim::EaseOut(radio.progress, specificStyle.animationDuration);
+            auto ratio = anim::TrackValue(radio.track);
             radius =  state.checked ? ratio * maxrad : (1.f - ratio) * maxrad;
         }
         else radius = state.checked ? maxrad : 0.f;
@@ -2201,7 +2229,7 @@ namespace glimmer
                 state.state = state.check == CheckState::Unchecked ? state.state & ~WS_Checked : state.state | WS_Checked;
                 result.event = WidgetEvent::Clicked;
                 check.animate = state.check != CheckState::Unchecked;
-                check.progress = 0.f;
+                if (check.animate) anim::StartTrack(check.track, 0.25f, anim::Easing::Linear);
             }
 
             if (mouseover) WidgetContextData::CurrentWidgetId = id;
@@ -2228,8 +2256,7 @@ namespace glimmer
         DrawBackground(padding.Min, padding.Max, style, renderer);
         auto height = padding.GetHeight(), width = padding.GetWidth();
 
-        if (check.animate && check.progress < 1.f)
-            check.progress += (io.deltaTime / 0.25f);
+        auto progress = check.animate ? anim::TrackValue(check.track) : 1.f;
 
         switch (state.check)
         {
@@ -2239,8 +2266,8 @@ namespace glimmer
             auto end = ImVec2{ padding.Min.x + (width * 0.333f), padding.Max.y };
             auto tickw = padding.Max.x - end.x;
             renderer.DrawLine(start, end, style.fgcolor, 2.f);
-            renderer.DrawLine(end, ImVec2{ padding.Max.x - ((1.f - check.progress) * tickw), padding.Min.y +
-                ((1.f - check.progress) * height) }, style.fgcolor, 2.f);
+            renderer.DrawLine(end, ImVec2{ padding.Max.x - ((1.f - progress) * tickw), padding.Min.y +
+                ((1.f - progress) * height) }, style.fgcolor, 2.f);
             break;
         }
         case CheckState::Partial:
@@ -3061,13 +3088,6 @@ namespace glimmer
     static void RemoveCharAt(int position, TextInputState& state, InputTextPersistentState& input)
     {
         auto diff = input.pixelpos[position] - (position == 0 ? 0.f : input.pixelpos[position - 1]);
-        auto& op = input.ops.push();
-        op.type = TextOpType::Deletion;
-        op.opmem[0] = state.text[position - 1];
-        op.opmem[1] = 0;
-        op.caretpos = input.caretpos;
-        op.range = std::make_pair(position - 1, 1);
-
         for (auto idx = position; idx < (int)state.text.size(); ++idx)
         {
             state.text[idx - 1] = state.text[idx];
@@ -3081,14 +3101,7 @@ namespace glimmer
 
     static void ClearAllText(TextInputState& state, InputTextPersistentState& input)
     {
-        auto& op = input.ops.push();
-        auto selectionsz = (int)state.text.size();
-        op.type = TextOpType::Deletion;
-        op.range = std::make_pair(0, selectionsz);
-        op.caretpos = input.caretpos;
-        memcpy(op.opmem, state.text.data(), selectionsz);
-        op.opmem[selectionsz] = 0;
-
+        input.ops.record(0, std::string_view{ state.text.data(), state.text.size() }, {}, input.caretpos);
         state.text.clear();
         input.pixelpos.clear(true);
 
@@ -3107,16 +3120,9 @@ namespace glimmer
             ClearAllText(state, input);
         else
         {
-            float shift = input.pixelpos[from - 1] - input.pixelpos[to - 1];
+            float shift = input.pixelpos[from - 1] - (to > 0 ? input.pixelpos[to - 1] : 0.f);
             auto textsz = (int)state.text.size();
-
-            auto& op = input.ops.push();
-            auto selectionsz = to - from;
-            op.type = TextOpType::Deletion;
-            op.range = std::make_pair(from, selectionsz);
-            op.caretpos = input.caretpos;
-            memcpy(op.opmem, state.text.data() + to, selectionsz);
-            op.opmem[selectionsz] = 0;
+            input.ops.record(to, std::string_view{ state.text.data() + to, (size_t)(from - to) }, {}, input.caretpos);
 
             for (; from < textsz; ++from, ++to)
             {
@@ -3137,6 +3143,25 @@ namespace glimmer
         }
     }
 
+    // Replaces `erase` bytes at `position` with `insert`, used to replay undo/redo operations. Operations
+    // recorded before text was modified externally may no longer apply, in which case nothing is done.
+    static bool ReplaceText(int position, int erase, std::string_view insert, TextInputState& state, InputTextPersistentState& input,
+        const StyleDescriptor& style, IRenderer& renderer)
+    {
+        if (position + erase > (int)state.text.size()) return false;
+
+        state.text.erase(state.text.begin() + position, state.text.begin() + position + erase);
+        state.text.insert(state.text.begin() + position, insert.begin(), insert.end());
+        input.pixelpos.resize((int16_t)state.text.size(), false);
+        UpdatePosition(state, position, input, style, renderer);
+
+        auto width = input.pixelpos.empty() ? 0.f : input.pixelpos.back();
+        input.scroll.state.pos.x = std::clamp(input.scroll.state.pos.x, 0.f, std::max(width - input.scroll.viewport.GetWidth(), 0.f));
+        state.selection.first = state.selection.second = -1;
+        input.selectionStart = -1.f;
+        return true;
+    }
+
     void HandleTextInputEvent(int32_t id, const ImRect& content, const ImRect& suffix, const IODescriptor& io,
         IRenderer& renderer, WidgetDrawResult& result)
     {
@@ -3158,6 +3183,7 @@ namespace glimmer
             isclicked ? state.state |= WS_Focused : state.state &= ~WS_Focused;
             if (input.lastClickTime != -1.f) input.lastClickTime += io.deltaTime;
             if (mouseover) WidgetContextData::CurrentWidgetId = id;
+            input.ops.tick(io.deltaTime);
 
             if (mouseover) 
                 Config.platform->SetMouseCursor(MouseCursor::TextInput);
@@ -3294,6 +3320,7 @@ namespace glimmer
                         input.lastCaretShowTime = 0.f;
                     }
                     else input.lastCaretShowTime += io.deltaTime;
+                    Config.platform->RequestFrameAfter(0.5f - input.lastCaretShowTime);
 
                     for (auto kidx = 0; io.key[kidx] != Key_Invalid; ++kidx)
                     {
@@ -3363,12 +3390,8 @@ namespace glimmer
                                 auto caretAtEnd = input.caretpos == (int)text.size();
                                 if (text.empty()) continue;
 
-                                auto& op = input.ops.push();
-                                op.type = TextOpType::Deletion;
-                                op.opmem[0] = state.text[input.caretpos - 1];
-                                op.opmem[1] = 0;
-                                op.range = std::make_pair(input.caretpos - 1, 1);
-                                op.caretpos = input.caretpos;
+                                if (input.caretpos == 0) continue;
+                                input.ops.record(input.caretpos - 1, text.substr(input.caretpos - 1, 1), {}, input.caretpos);
 
                                 if (caretAtEnd)
                                 {
@@ -3397,7 +3420,9 @@ namespace glimmer
                                 auto caretAtEnd = input.caretpos == (int)text.size();
                                 if (text.empty()) continue;
 
-                                if (!caretAtEnd) RemoveCharAt(input.caretpos + 1, state, input);
+                                if (caretAtEnd) continue;
+                                input.ops.record(input.caretpos, text.substr(input.caretpos, 1), {}, input.caretpos);
+                                RemoveCharAt(input.caretpos + 1, state, input);
                             }
                             else DeleteSelectedText(state, input);
 
@@ -3436,12 +3461,7 @@ namespace glimmer
                                         UpdatePosition(state, input.caretpos, input, style, renderer);
                                     }
 
-                                    auto& op = input.ops.push();
-                                    op.type = TextOpType::Addition;
-                                    op.range = std::make_pair(input.caretpos, std::min(length, 127));
-                                    memcpy(op.opmem, content.data(), std::min(length, 127));
-                                    op.opmem[length] = 0;
-
+                                    input.ops.record(input.caretpos, {}, content, input.caretpos);
                                     input.caretpos += length;
                                     result.event = WidgetEvent::Edited;
                                 }
@@ -3465,32 +3485,22 @@ namespace glimmer
                                     input.caretVisible = false;
                                 }
                             }
-                            else if (key == Key_Z && (io.modifiers & CtrlKeyMod))
+                            else if (key == Key_Z && (io.modifiers & CtrlKeyMod) && !(io.modifiers & ShiftKeyMod))
                             {
-                                if (!input.ops.empty())
+                                if (auto op = input.ops.undo(); op != nullptr &&
+                                    ReplaceText(op->position, op->added, input.ops.removed(*op), state, input, style, renderer))
                                 {
-                                    auto op = input.ops.undo().value();
-
-                                    switch (op.type)
-                                    {
-                                    case TextOpType::Deletion:
-                                    {
-                                        auto length = op.range.second;
-                                        input.pixelpos.expand(length, 0.f);
-                                        state.text.resize(state.text.size() + length);
-
-                                        for (auto idx = (int)state.text.size() - 1; idx >= op.range.first; --idx)
-                                            state.text[idx] = state.text[idx - length];
-                                        for (auto idx = 0; idx < length; ++idx)
-                                            state.text[idx + op.range.first] = op.opmem[idx];
-
-                                        UpdatePosition(state, op.range.first, input, style, renderer);
-                                        input.caretpos = op.caretpos;
-                                        break;
-                                    }
-                                    default:
-                                        break;
-                                    }
+                                    input.caretpos = op->caretpos;
+                                    result.event = WidgetEvent::Edited;
+                                }
+                            }
+                            else if ((key == Key_Y || key == Key_Z) && (io.modifiers & CtrlKeyMod))
+                            {
+                                if (auto op = input.ops.redo(); op != nullptr &&
+                                    ReplaceText(op->position, op->removed, input.ops.added(*op), state, input, style, renderer))
+                                {
+                                    input.caretpos = op->position + op->added;
+                                    result.event = WidgetEvent::Edited;
                                 }
                             }
                             else
@@ -3499,6 +3509,8 @@ namespace glimmer
                                 auto ch = io.modifiers & ShiftKeyMod ? KeyMappings[key].second : KeyMappings[key].first;
                                 ch = io.capslock ? std::toupper(ch) : std::tolower(ch);
                                 auto caretAtEnd = input.caretpos == (int)text.size();
+                                input.ops.record(input.caretpos, caretAtEnd || !io.insert ? std::string_view{} : text.substr(input.caretpos, 1),
+                                    std::string_view{ &ch, 1 }, input.caretpos);
 
                                 if (caretAtEnd)
                                 {
@@ -3758,48 +3770,857 @@ namespace glimmer
 
 #pragma endregion
 
+#pragma region TextEditor
+
+    static void SyncTextEditorFont(TextEditorPersistentState& editor, const StyleDescriptor& style)
+    {
+        if (editor.font != style.font.font || editor.fontsz != style.font.size)
+        {
+            editor.advances.fill(-1.f);
+            editor.wideAdvances.clear();
+            editor.font = style.font.font;
+            editor.fontsz = style.font.size;
+            editor.maxLineWidth = 0.f;
+            editor.widestLine = -1;
+        }
+    }
+
+    // Caret positions are byte offsets at start of UTF-8 sequences, invalid bytes are stepped over one at a time
+    static bool IsUTF8Continuation(char ch)
+    {
+        return ((unsigned char)ch & 0xC0u) == 0x80u;
+    }
+
+    static int32_t NextTextEditorPos(const TextEditorBuffer& text, int32_t pos)
+    {
+        auto end = text.size();
+        if (pos >= end) return end;
+        auto lead = (unsigned char)text.at(pos);
+        auto length = lead >= 0xF0u ? 4 : lead >= 0xE0u ? 3 : lead >= 0xC0u ? 2 : 1;
+        auto next = pos + 1;
+        while (next < end && next < pos + length && IsUTF8Continuation(text.at(next))) ++next;
+        return next;
+    }
+
+    static int32_t PrevTextEditorPos(const TextEditorBuffer& text, int32_t pos)
+    {
+        if (pos <= 0) return 0;
+        auto prev = pos - 1;
+        while (prev > 0 && prev > pos - 4 && IsUTF8Continuation(text.at(prev))) --prev;
+        return NextTextEditorPos(text, prev) == pos ? prev : pos - 1;
+    }
+
+    static float GetCharAdvance(TextEditorPersistentState& editor, char ch, const StyleDescriptor& style, IRenderer& renderer)
+    {
+        auto& advance = editor.advances[(unsigned char)ch & 0x7Fu];
+        if (advance < 0.f) advance = renderer.GetTextSize(std::string_view{ &ch, 1 }, style.font.font, style.font.size).x;
+        return advance;
+    }
+
+    // Advance of the code point at `pos`, `next` is set to the position after it. ASCII is looked up
+    // in an array, rest of the code points in a map.
+    static float GetCharAdvance(TextEditorPersistentState& editor, int32_t pos, int32_t& next, const StyleDescriptor& style, 
+        IRenderer& renderer)
+    {
+        auto ch = editor.text.at(pos);
+        if (!((unsigned char)ch & 0x80u))
+        {
+            next = pos + 1;
+            return GetCharAdvance(editor, ch, style, renderer);
+        }
+
+        char bytes[4];
+        uint32_t codepoint = 0;
+        next = NextTextEditorPos(editor.text, pos);
+        for (auto idx = pos; idx < next; ++idx)
+        {
+            bytes[idx - pos] = editor.text.at(idx);
+            codepoint = (codepoint << 8) | (unsigned char)bytes[idx - pos];
+        }
+
+        auto [it, inserted] = editor.wideAdvances.try_emplace(codepoint, 0.f);
+        if (inserted) it->second = renderer.GetTextSize(std::string_view{ bytes, (size_t)(next - pos) }, 
+            style.font.font, style.font.size).x;
+        return it->second;
+    }
+
+    // Horizontal offset of `pos` from start of its line
+    static float GetTextEditorLineX(TextEditorPersistentState& editor, int32_t line, int32_t pos, const StyleDescriptor& style, 
+        IRenderer& renderer)
+    {
+        auto x = 0.f;
+        for (auto idx = editor.text.lineStart(line), next = idx; idx < pos; idx = next)
+            x += GetCharAdvance(editor, idx, next, style, renderer);
+        return x;
+    }
+
+    static int32_t GetTextEditorPosAtX(TextEditorPersistentState& editor, int32_t line, float x, const StyleDescriptor& style,
+        IRenderer& renderer)
+    {
+        auto pos = editor.text.lineStart(line), end = editor.text.lineEnd(line);
+        auto current = 0.f;
+
+        for (auto next = pos; pos < end; pos = next)
+        {
+            auto advance = GetCharAdvance(editor, pos, next, style, renderer);
+            if (x < current + (advance * 0.5f)) break;
+            current += advance;
+        }
+
+        return pos;
+    }
+
+    static int32_t GetTextEditorPosAt(TextEditorPersistentState& editor, const ImRect& content, ImVec2 mousepos, 
+        const StyleDescriptor& style, IRenderer& renderer)
+    {
+        auto line = (int32_t)((mousepos.y - content.Min.y + editor.scroll.state.pos.y) / style.font.size);
+        line = std::clamp(line, 0, editor.text.lines() - 1);
+        return GetTextEditorPosAtX(editor, line, mousepos.x - content.Min.x + editor.scroll.state.pos.x, style, renderer);
+    }
+
+    // Replaces `erase` bytes at `from` with `text`. Widest line is measured again if the edit may
+    // have shortened it i.e. it removes or splits lines, or removes text from the widest line.
+    static void SpliceTextEditorText(TextEditorPersistentState& editor, int32_t from, int32_t erase, std::string_view text)
+    {
+        auto lines = editor.text.lines();
+        auto line = editor.text.lineOf(from);
+        editor.text.erase(from, erase);
+        editor.text.insert(from, text);
+
+        auto delta = editor.text.lines() - lines;
+        if (delta < 0 || (line == editor.widestLine && (erase > 0 || delta > 0)))
+        {
+            editor.maxLineWidth = 0.f;
+            editor.widestLine = -1;
+        }
+        else if (line < editor.widestLine) editor.widestLine += delta;
+    }
+
+    // Replaces [from, to) with `text` and records the edit in undo log, caret is placed after inserted text
+    static void ReplaceTextEditorRange(TextEditorPersistentState& editor, int32_t from, int32_t to, std::string_view text)
+    {
+        static std::string scratch;
+        editor.ops.record(from, editor.text.view(from, to, scratch), text, editor.caretpos);
+        SpliceTextEditorText(editor, from, to - from, text);
+        editor.caretpos = from + (int32_t)text.size();
+        editor.selectionStart = -1;
+    }
+
+    static bool DeleteTextEditorSelection(TextEditorPersistentState& editor)
+    {
+        if (editor.selectionStart == -1 || editor.selectionStart == editor.caretpos) 
+        {
+            editor.selectionStart = -1;
+            return false;
+        }
+
+        auto from = std::min(editor.selectionStart, editor.caretpos), to = std::max(editor.selectionStart, editor.caretpos);
+        ReplaceTextEditorRange(editor, from, to, {});
+        return true;
+    }
+
+    static void InsertTextEditorText(TextEditorPersistentState& editor, std::string_view text, bool overwrite = false)
+    {
+        if (editor.selectionStart != -1 && editor.selectionStart != editor.caretpos)
+            ReplaceTextEditorRange(editor, std::min(editor.selectionStart, editor.caretpos), 
+                std::max(editor.selectionStart, editor.caretpos), text);
+        else if (overwrite && editor.caretpos < editor.text.lineEnd(editor.text.lineOf(editor.caretpos)))
+            ReplaceTextEditorRange(editor, editor.caretpos, NextTextEditorPos(editor.text, editor.caretpos), text);
+        else ReplaceTextEditorRange(editor, editor.caretpos, editor.caretpos, text);
+    }
+
+    // Applies an undo/redo operation by replacing `erase` bytes at `position` with `text`
+    static void ReplayTextEditorEdit(TextEditorPersistentState& editor, int32_t position, int32_t erase, std::string_view text)
+    {
+        SpliceTextEditorText(editor, position, erase, text);
+        editor.selectionStart = -1;
+        editor.caretX = -1.f;
+    }
+
+    static void CopyTextEditorSelection(const TextEditorPersistentState& editor)
+    {
+        if (editor.selectionStart == -1 || editor.selectionStart == editor.caretpos) return;
+
+        std::string scratch;
+        auto from = std::min(editor.selectionStart, editor.caretpos), to = std::max(editor.selectionStart, editor.caretpos);
+        auto text = editor.text.view(from, to, scratch);
+        Config.platform->SetClipboardText(text);
+    }
+
+    static void ScrollToTextEditorCaret(TextEditorPersistentState& editor, const ImRect& content, const StyleDescriptor& style,
+        IRenderer& renderer)
+    {
+        auto line = editor.text.lineOf(editor.caretpos);
+        auto y = (float)line * style.font.size;
+        auto x = GetTextEditorLineX(editor, line, editor.caretpos, style, renderer);
+        auto& pos = editor.scroll.state.pos;
+
+        if (y < pos.y) pos.y = y;
+        else if (y + style.font.size > pos.y + content.GetHeight()) pos.y = y + style.font.size - content.GetHeight();
+        if (x < pos.x) pos.x = x;
+        else if (x > pos.x + content.GetWidth()) pos.x = x - content.GetWidth() + style.font.size;
+    }
+
+    void HandleTextEditorEvent(int32_t id, const ImRect& content, const IODescriptor& io,
+        IRenderer& renderer, WidgetDrawResult& result)
+    {
+        auto& context = GetContext();
+
+        if (!context.deferEvents)
+        {
+            auto& state = context.GetState(id).state.editor;
+            auto& editor = context.TextEditorState(id);
+            auto style = context.GetStyle(state.state, state.id);
+            auto& text = editor.text;
+            auto lineh = style.font.size;
+            SyncTextEditorFont(editor, style);
+            editor.ops.tick(io.deltaTime);
+
+            auto mousepos = io.mousepos;
+            auto onScrollbar = editor.scroll.state.mouseDownOnVGrip || editor.scroll.state.mouseDownOnHGrip;
+            auto mouseover = content.Contains(mousepos) || (state.state & WS_Pressed);
+            auto ispressed = mouseover && io.isLeftMouseDown() && !onScrollbar;
+            auto hasclick = io.clicked();
+            auto isclicked = (hasclick && mouseover) || (!hasclick && (state.state & WS_Focused));
+            mouseover ? state.state |= WS_Hovered : state.state &= ~WS_Hovered;
+            ispressed ? state.state |= WS_Pressed : state.state &= ~WS_Pressed;
+            isclicked ? state.state |= WS_Focused : state.state &= ~WS_Focused;
+            if (mouseover) WidgetContextData::CurrentWidgetId = id;
+            if (mouseover && !onScrollbar) Config.platform->SetMouseCursor(MouseCursor::TextInput);
+
+            // Pressing mouse places the caret and anchors selection, dragging extends the selection,
+            // and double click selects the word under mouse
+            if (mouseover && !onScrollbar && io.isLeftMouseDoubleClicked())
+            {
+                auto pos = GetTextEditorPosAt(editor, content, mousepos, style, renderer);
+                auto isWordChar = [&text](int32_t idx) {
+                    auto ch = text.at(idx); return std::isalnum((unsigned char)ch) || ch == '_' || ((unsigned char)ch & 0x80u); };
+                auto from = pos, to = pos;
+                while (from > 0 && isWordChar(from - 1)) --from;
+                while (to < text.size() && isWordChar(to)) ++to;
+                editor.selectionStart = from;
+                editor.caretpos = to;
+                editor.caretX = -1.f;
+                result.event = WidgetEvent::Selected;
+            }
+            else if (ispressed)
+            {
+                auto pos = GetTextEditorPosAt(editor, content, mousepos, style, renderer);
+
+                if (!editor.isSelecting)
+                {
+                    if (!(io.modifiers & ShiftKeyMod)) editor.selectionStart = pos;
+                    else if (editor.selectionStart == -1) editor.selectionStart = editor.caretpos;
+                    editor.caretpos = pos;
+                    editor.isSelecting = true;
+                    result.event = WidgetEvent::Focused;
+                }
+                else editor.caretpos = pos;
+
+                editor.caretX = -1.f;
+                editor.caretVisible = true;
+                editor.lastCaretShowTime = 0.f;
+                ScrollToTextEditorCaret(editor, content, style, renderer);
+            }
+            else if (editor.isSelecting)
+            {
+                editor.isSelecting = false;
+                if (editor.selectionStart == editor.caretpos) editor.selectionStart = -1;
+                else result.event = WidgetEvent::Selected;
+            }
+
+            if (state.state & WS_Focused)
+            {
+                if (editor.lastCaretShowTime > 0.5f && editor.selectionStart == -1)
+                {
+                    editor.caretVisible = !editor.caretVisible;
+                    editor.lastCaretShowTime = 0.f;
+                }
+                else editor.lastCaretShowTime += io.deltaTime;
+                Config.platform->RequestFrameAfter(0.5f - editor.lastCaretShowTime);
+
+                auto pagelines = std::max((int32_t)(content.GetHeight() / lineh) - 1, 1);
+                auto ctrl = (io.modifiers & CtrlKeyMod) != 0, shift = (io.modifiers & ShiftKeyMod) != 0;
+
+                for (auto kidx = 0; io.key[kidx] != Key_Invalid; ++kidx)
+                {
+                    auto key = io.key[kidx];
+                    auto caretline = text.lineOf(editor.caretpos);
+                    auto moved = true, edited = false;
+                    editor.lastCaretShowTime = 0.f;
+                    editor.caretVisible = true;
+
+                    // Caret movement extends selection when shift is pressed, and collapses it otherwise
+                    if (key == Key_LeftArrow || key == Key_RightArrow || key == Key_UpArrow || key == Key_DownArrow ||
+                        key == Key_PageUp || key == Key_PageDown || key == Key_Home || key == Key_End)
+                    {
+                        if (!shift) editor.selectionStart = -1;
+                        else if (editor.selectionStart == -1) editor.selectionStart = editor.caretpos;
+                    }
+
+                    switch (key)
+                    {
+                    case Key_LeftArrow:
+                        editor.caretpos = PrevTextEditorPos(text, editor.caretpos);
+                        editor.caretX = -1.f;
+                        break;
+                    case Key_RightArrow:
+                        editor.caretpos = NextTextEditorPos(text, editor.caretpos);
+                        editor.caretX = -1.f;
+                        break;
+                    case Key_UpArrow: [[fallthrough]];
+                    case Key_DownArrow: [[fallthrough]];
+                    case Key_PageUp: [[fallthrough]];
+                    case Key_PageDown:
+                    {
+                        // Caret keeps its horizontal position when moving across shorter lines
+                        auto delta = key == Key_UpArrow ? -1 : key == Key_DownArrow ? 1 : key == Key_PageUp ? -pagelines : pagelines;
+                        auto target = std::clamp(caretline + delta, 0, text.lines() - 1);
+                        if (editor.caretX < 0.f) editor.caretX = GetTextEditorLineX(editor, caretline, editor.caretpos, style, renderer);
+                        editor.caretpos = GetTextEditorPosAtX(editor, target, editor.caretX, style, renderer);
+                        break;
+                    }
+                    case Key_Home:
+                        editor.caretpos = ctrl ? 0 : text.lineStart(caretline);
+                        editor.caretX = -1.f;
+                        break;
+                    case Key_End:
+                        editor.caretpos = ctrl ? text.size() : text.lineEnd(caretline);
+                        editor.caretX = -1.f;
+                        break;
+                    default: moved = false; break;
+                    }
+
+                    if (moved)
+                    {
+                        ScrollToTextEditorCaret(editor, content, style, renderer);
+                        continue;
+                    }
+
+                    if (ctrl && key == Key_A)
+                    {
+                        editor.selectionStart = 0;
+                        editor.caretpos = text.size();
+                        result.event = WidgetEvent::Selected;
+                    }
+                    else if (ctrl && key == Key_C) CopyTextEditorSelection(editor);
+                    else if (state.readOnly) continue;
+                    else if (ctrl && key == Key_X)
+                    {
+                        CopyTextEditorSelection(editor);
+                        edited = DeleteTextEditorSelection(editor);
+                    }
+                    else if (ctrl && key == Key_V)
+                    {
+                        auto clipboard = Config.platform->GetClipboardText();
+                        if (!clipboard.empty()) InsertTextEditorText(editor, clipboard);
+                        edited = !clipboard.empty();
+                    }
+                    else if (ctrl && key == Key_Z && !shift)
+                    {
+                        if (auto op = editor.ops.undo(); op != nullptr)
+                        {
+                            ReplayTextEditorEdit(editor, op->position, op->added, editor.ops.removed(*op));
+                            editor.caretpos = op->caretpos;
+                            edited = true;
+                        }
+                    }
+                    else if (ctrl && (key == Key_Y || key == Key_Z))
+                    {
+                        if (auto op = editor.ops.redo(); op != nullptr)
+                        {
+                            ReplayTextEditorEdit(editor, op->position, op->removed, editor.ops.added(*op));
+                            editor.caretpos = op->position + op->added;
+                            edited = true;
+                        }
+                    }
+                    else if (key == Key_Backspace)
+                    {
+                        edited = DeleteTextEditorSelection(editor);
+                        if (!edited && editor.caretpos > 0)
+                        {
+                            ReplaceTextEditorRange(editor, PrevTextEditorPos(text, editor.caretpos), editor.caretpos, {});
+                            edited = true;
+                        }
+                    }
+                    else if (key == Key_Delete)
+                    {
+                        edited = DeleteTextEditorSelection(editor);
+                        if (!edited && editor.caretpos < text.size())
+                        {
+                            ReplaceTextEditorRange(editor, editor.caretpos, NextTextEditorPos(text, editor.caretpos), {});
+                            edited = true;
+                        }
+                    }
+                    else if (key == Key_Enter || key == Key_KeypadEnter)
+                    {
+                        InsertTextEditorText(editor, "\n");
+                        edited = true;
+                    }
+                    else if (key == Key_Tab)
+                    {
+                        InsertTextEditorText(editor, std::string((size_t)state.tabWidth, ' '));
+                        edited = true;
+                    }
+                    else if (key == Key_Space || (key >= Key_0 && key <= Key_Z) ||
+                        (key >= Key_Apostrophe && key <= Key_GraveAccent) ||
+                        (key >= Key_Keypad0 && key <= Key_KeypadEqual))
+                    {
+                        auto ch = shift ? KeyMappings[key].second : KeyMappings[key].first;
+                        if (std::isalpha((unsigned char)ch)) ch = (shift != io.capslock) ? std::toupper(ch) : std::tolower(ch);
+
+                        // In overwrite mode, typed character replaces the one after caret (except newline)
+                        InsertTextEditorText(editor, std::string_view{ &ch, 1 }, io.insert);
+                        edited = true;
+                    }
+
+                    if (edited)
+                    {
+                        editor.caretX = -1.f;
+                        ScrollToTextEditorCaret(editor, content, style, renderer);
+                        result.event = WidgetEvent::Edited;
+                    }
+                }
+
+                ShowTooltip(state._hoverDuration, content, state.tooltip, io);
+            }
+            else editor.caretVisible = false;
+
+            editor.scroll.viewport = content;
+            editor.scroll.content = ImVec2{ editor.maxLineWidth + lineh, (float)text.lines() * lineh };
+            auto hasHScroll = HandleHScroll(editor.scroll, renderer, io, Config.scrollbar.width);
+            HandleVScroll(editor.scroll, renderer, io, Config.scrollbar.width, hasHScroll);
+            HandleContextMenu(id, content, io);
+
+            WITH_WIDGET_LOG(id, content);
+            LOG_STATE(state.state);
+            LOG_NUM(text.size());
+            LOG_STYLE2(state.state, id);
+        }
+        else context.deferedEvents.emplace_back(EventDeferInfo::ForTextEditor(id, content));
+    }
+
+    WidgetDrawResult TextEditorImpl(int32_t id, TextEditorState& state, const StyleDescriptor& style, const ImRect& extent, 
+        const ImRect& content, IRenderer& renderer, const IODescriptor& io)
+    {
+        WidgetDrawResult result;
+        auto& context = GetContext();
+        auto& editor = context.TextEditorState(id);
+        auto& text = editor.text;
+        auto lineh = style.font.size;
+        SyncTextEditorFont(editor, style);
+
+        if (state.state & WS_Focused)
+            renderer.DrawRect(extent.Min, extent.Max, Config.focuscolor, false, 2.f);
+
+        DrawBackground(extent.Min, extent.Max, style, renderer);
+        DrawBorderRect(extent.Min, extent.Max, style.border, style.bgcolor, renderer);
+        renderer.SetCurrentFont(style.font.font, style.font.size);
+
+        if (text.size() == 0 && !(state.state & WS_Focused))
+        {
+            auto phstyle = style;
+            auto [fr, fg, fb, fa] = DecomposeColor(phstyle.fgcolor);
+            phstyle.fgcolor = ToRGBA(fr, fg, fb, 150);
+            auto sz = renderer.GetTextSize(state.placeholder, style.font.font, style.font.size);
+            DrawText(content.Min, content.Max, { content.Min, content.Min + sz }, state.placeholder, state.state & WS_Disabled,
+                phstyle, renderer, FontStyleOverflowMarquee | TextIsPlainText);
+        }
+        else
+        {
+            // Only lines inside the viewport are drawn, lines have uniform height hence
+            // first visible line is known from vertical scroll position
+            const auto& selstyle = context.GetStyle(WS_Selected, state.id);
+            auto firstLine = std::max((int32_t)(editor.scroll.state.pos.y / lineh), 0);
+            auto lastLine = std::min((int32_t)((editor.scroll.state.pos.y + content.GetHeight()) / lineh), text.lines() - 1);
+            auto hasSelection = editor.selectionStart != -1 && editor.selectionStart != editor.caretpos;
+            auto selection = std::make_pair(std::min(editor.selectionStart, editor.caretpos), std::max(editor.selectionStart, editor.caretpos));
+            static std::string scratch;
+            renderer.SetClipRect(content.Min, content.Max);
+
+            for (auto line = firstLine; line <= lastLine; ++line)
+            {
+                auto from = text.lineStart(line), to = text.lineEnd(line);
+                ImVec2 startpos{ content.Min.x - editor.scroll.state.pos.x, content.Min.y + ((float)line * lineh) - editor.scroll.state.pos.y };
+                auto width = GetTextEditorLineX(editor, line, to, style, renderer);
+                if (width >= editor.maxLineWidth)
+                {
+                    editor.maxLineWidth = width;
+                    editor.widestLine = line;
+                }
+
+                if (hasSelection && selection.first <= to && selection.second > from)
+                {
+                    auto selfrom = std::max(selection.first, from), selto = std::min(selection.second, to);
+                    auto x1 = GetTextEditorLineX(editor, line, selfrom, style, renderer);
+                    auto x2 = GetTextEditorLineX(editor, line, selto, style, renderer);
+
+                    // Selected newline is shown as a space wide block
+                    if (selection.second > to) x2 += GetCharAdvance(editor, ' ', style, renderer);
+                    renderer.DrawRect(startpos + ImVec2{ x1, 0.f }, startpos + ImVec2{ x2, lineh }, selstyle.bgcolor, true);
+                }
+
+                if (to > from) renderer.DrawText(text.view(from, to, scratch), startpos, style.fgcolor);
+            }
+
+            if ((state.state & WS_Focused) && editor.caretVisible)
+            {
+                auto line = text.lineOf(editor.caretpos);
+                auto x = GetTextEditorLineX(editor, line, editor.caretpos, style, renderer) - editor.scroll.state.pos.x;
+                auto y = ((float)line * lineh) - editor.scroll.state.pos.y;
+                renderer.DrawLine(content.Min + ImVec2{ x, y + 1.f }, content.Min + ImVec2{ x, y + lineh - 1.f }, style.fgcolor, 2.f);
+            }
+
+            renderer.ResetClipRect();
+        }
+
+        DrawFocusRect(state.state, extent.Min, extent.Max, renderer);
+        HandleTextEditorEvent(id, content, io, renderer, result);
+        renderer.ResetFont();
+
+        result.geometry = extent;
+        return result;
+    }
+
+    WidgetDrawResult TextEditor(int32_t id, int32_t geometry, const NeighborWidgets& neighbors)
+    {
+        return Widget(id, WT_TextEditor, geometry, neighbors);
+    }
+
+    WidgetDrawResult TextEditor(std::string_view id, std::string_view text, std::string_view placeholder, int32_t geometry, const NeighborWidgets& neighbors)
+    {
+        auto [wid, initial] = GetIdFromString(id, WT_TextEditor);
+        auto& config = CreateWidgetConfig(wid).state.editor;
+        config.placeholder = placeholder;
+        if (initial) GetContext().TextEditorState(wid).text.assign(text);
+        return Widget(wid, WT_TextEditor, geometry, neighbors);
+    }
+
+    void SetTextEditorText(int32_t id, std::string_view text)
+    {
+        auto& editor = GetContext().TextEditorState(id);
+        editor.text.assign(text);
+        editor.ops.clear();
+        editor.caretpos = 0;
+        editor.selectionStart = -1;
+        editor.caretX = -1.f;
+        editor.maxLineWidth = 0.f;
+        editor.widestLine = -1;
+        editor.scroll.state.pos = ImVec2{};
+    }
+
+    void GetTextEditorText(int32_t id, std::string& out)
+    {
+        const auto& text = GetContext().TextEditorState(id).text;
+        std::string scratch;
+        auto view = text.view(0, text.size(), scratch);
+        out.assign(view.data(), view.size());
+    }
+
+    int32_t GetTextEditorLineCount(int32_t id)
+    {
+        return GetContext().TextEditorState(id).text.lines();
+    }
+
+#pragma endregion
+
 #pragma region DropDown
 
-    void CreateDropDownOptionWidget(const DropDownState::OptionDescriptor& option,
-        DropDownPersistentState& optstates, int32_t optidx, DropDownState& state,
-        bool& hasWidgets)
-    {
-        auto& optstate = optidx < (int32_t)optstates.children.size() ? optstates.children[optidx] : 
-            optstates.children.emplace_back(-1, -1);
+    void CreateDropDownOptionWidget(const DropDownState::OptionDescriptor& option,
+        DropDownPersistentState& optstates, int32_t optidx, DropDownState& state,
+        bool& hasWidgets)
+    {
+        auto& optstate = optidx < (int32_t)optstates.children.size() ? optstates.children[optidx] : 
+            optstates.children.emplace_back(-1, -1);
+
+        switch (option.prefixType)
+        {
+        case WT_Checkbox:
+        {
+            if (optstate.prefix == -1) optstate.prefix = GetNextId(WT_Checkbox);
+            if (optstate.label == -1) optstate.label = GetNextId(WT_Label);
+            /*CreateWidgetConfig(optstate.first).state.checkbox.check = state.selected == optidx ?
+                CheckState::Checked : CheckState::Unchecked;*/
+            CreateWidgetConfig(optstate.prefix);
+            auto& label = CreateWidgetConfig(optstate.label).state.label;
+            label.text = option.text; label.type = option.textType;
+            hasWidgets = true;
+            break;
+        }
+        case WT_ToggleButton:
+        {
+            if (optstate.prefix == -1) optstate.prefix = GetNextId(WT_ToggleButton);
+            if (optstate.label == -1) optstate.label = GetNextId(WT_Label);
+            //CreateWidgetConfig(optstate.first).state.toggle.checked = state.selected == optidx;
+            CreateWidgetConfig(optstate.prefix);
+            auto& label = CreateWidgetConfig(optstate.label).state.label;
+            label.text = option.text; label.type = option.textType;
+            hasWidgets = true;
+            break;
+        }
+        default:
+        {
+            optstate.prefix = -1;
+            if (optstate.label == -1) optstate.label = GetNextId(WT_Label);
+            auto& label = CreateWidgetConfig(optstate.label).state.label;
+            label.text = option.text; label.type = option.textType;
+            break;
+        }
+        }
+    }
+
+    static int32_t GetDropDownOptionCount(const DropDownState& state)
+    {
+        return state.OptionText != nullptr ? state.optionCount : (int32_t)state.options.size();
+    }
+
+    static std::string_view GetDropDownOptionText(const DropDownState& state, int32_t index)
+    {
+        return state.OptionText != nullptr ? state.OptionText(index) : state.options[index].text;
+    }
+
+    static bool IsDropDownOptionSelectable(const DropDownState& state, int32_t index)
+    {
+        return state.OptionStyle != nullptr ? state.OptionStyle(index).isSelectable : state.hasSelection;
+    }
+
+    // Search index of virtualised dropdown is built on first use (and again if option count changes).
+    // Option texts are collected here as OptionText is user code, but the index itself is built on
+    // the worker pool, all options are shown unfiltered until it is ready. Matches of previous filter 
+    // are refined if the filter is extended, which is the case when typing
+    static void FilterDropDownOptions(const DropDownState& state, DropDownPersistentState& ddstate)
+    {
+        auto count = GetDropDownOptionCount(state);
+
+        if (!ddstate.indexed || ddstate.search.size() != count)
+        {
+            if (ddstate.pending == nullptr || ddstate.pending->index.size() != count)
+            {
+                auto pending = std::make_shared<DropDownPersistentState::PendingSearchIndex>();
+                for (auto idx = 0; idx < count; ++idx)
+                    pending->index.add(GetDropDownOptionText(state, idx));
+
+                ddstate.pending = pending;
+                GetWorkerPool().Enqueue([pending] {
+                    pending->index.finalize();
+                    pending->ready = true;
+                });
+            }
+
+            if (!ddstate.pending->ready)
+            {
+                if ((int32_t)ddstate.matches.size() != count)
+                {
+                    ddstate.matches.resize(count);
+                    std::iota(ddstate.matches.begin(), ddstate.matches.end(), 0);
+                    ddstate.cursor = std::min(ddstate.cursor, count - 1);
+                }
+
+                ddstate.filtered = false;
+                Config.platform->RequestFrame();
+                return;
+            }
+
+            ddstate.search = std::move(ddstate.pending->index);
+            ddstate.pending = nullptr;
+            ddstate.indexed = true;
+            ddstate.filtered = false;
+        }
+
+        if (!ddstate.filtered || ddstate.filter != ddstate.matchedFilter)
+        {
+            auto refine = ddstate.filtered && ddstate.filter.starts_with(ddstate.matchedFilter);
+            ddstate.search.search(ddstate.filter, refine ? &ddstate.matches : nullptr, ddstate.scratch);
+            std::swap(ddstate.matches, ddstate.scratch);
+            ddstate.matchedFilter = ddstate.filter;
+            ddstate.filtered = true;
+            ddstate.cursor = ddstate.matches.empty() ? -1 : 0;
+            ddstate.scroll.state.pos.y = 0.f;
+        }
+    }
+
+    static void ScrollToDropDownCursor(DropDownPersistentState& ddstate, float rowh, float viewh)
+    {
+        if (ddstate.cursor == -1) return;
+
+        auto& pos = ddstate.scroll.state.pos.y;
+        auto y = (float)ddstate.cursor * rowh;
+        if (y < pos) pos = y;
+        else if (y + rowh > pos + viewh) pos = y + rowh - viewh;
+    }
+
+    // Options popup of virtualised dropdown, only the rows inside the popup are fetched and drawn,
+    // hence cost of a frame is independent of total number of options
+    static void ShowVirtualDropDownOptions(WidgetContextData& parent, DropDownState& state, int32_t id, 
+        const ImRect& border, const ImRect& padding)
+    {
+        auto& ddstate = parent.dropDownOptions[id & WidgetIndexMask];
+        const auto& ddstyle = WidgetContextData::dropdownStyles[log2((unsigned)state.state)].top();
+        auto style = parent.GetStyle(WS_Default, state.id);
+        FilterDropDownOptions(state, ddstate);
+
+        auto rowh = style.font.size + (2.f * ddstyle.optionSpacing.y);
+        auto width = border.GetWidth();
+        auto rows = std::clamp((int32_t)ddstate.matches.size(), 1, std::max(state.visibleOptions, 1));
+        ImRect filter{ { 0.f, 0.f }, { width, rowh } };
+        ImRect list{ { 0.f, filter.Max.y + ddstyle.separator.thickness }, 
+            { width, filter.Max.y + ddstyle.separator.thickness + ((float)rows * rowh) } };
+        auto selected = state.out ? *state.out : state.selected;
+
+        // When opened, keyboard navigation starts from currently selected option
+        if (ddstate.revealSelection)
+        {
+            auto it = std::lower_bound(ddstate.matches.begin(), ddstate.matches.end(), selected);
+            if (it != ddstate.matches.end() && *it == selected)
+            {
+                ddstate.cursor = (int32_t)(it - ddstate.matches.begin());
+                ScrollToDropDownCursor(ddstate, rowh, list.GetHeight());
+            }
+
+            ddstate.revealSelection = false;
+        }
+
+        if (BeginPopup(id, { border.Min.x, padding.Max.y }, { width, list.Max.y }))
+        {
+            auto& renderer = *GetContext().deferedRenderer;
+            auto scroll = ddstate.scroll.state.pos.y;
+            auto first = std::max((int32_t)(scroll / rowh), 0);
+            auto last = std::min(first + rows + 1, (int32_t)ddstate.matches.size());
+            auto [fr, fg, fb, fa] = DecomposeColor(style.fgcolor);
+
+            renderer.SetCurrentFont(style.font.font, style.font.size);
+            renderer.DrawRect(filter.Min, list.Max, ddstyle.bgcolor, true);
+            renderer.DrawText(ddstate.filter.empty() ? state.filterHint : std::string_view{ ddstate.filter }, 
+                filter.Min + ddstyle.optionSpacing, ddstate.filter.empty() ? ToRGBA(fr, fg, fb, 150) : style.fgcolor);
+            renderer.DrawLine({ 0.f, filter.Max.y }, { width, filter.Max.y }, ddstyle.separator.color, 
+                ddstyle.separator.thickness);
+
+            renderer.SetClipRect(list.Min, list.Max);
+            for (auto idx = first; idx < last; ++idx)
+            {
+                auto option = ddstate.matches[idx];
+                ImVec2 start{ list.Min.x, list.Min.y + ((float)idx * rowh) - scroll };
+                auto highlighted = idx == ddstate.cursor || option == state.hovered;
+
+                if (highlighted) renderer.DrawRect(start, { list.Max.x, start.y + rowh }, ddstyle.optionHoverColor, true);
+                else if (option == selected) renderer.DrawRect(start, { list.Max.x, start.y + rowh }, ddstyle.optionSelectionColor, true);
+                renderer.DrawText(GetDropDownOptionText(state, option), start + ddstyle.optionSpacing, 
+                    highlighted ? ToRGBA(255, 255, 255) : style.fgcolor);
+            }
+
+            renderer.ResetClipRect();
+            renderer.ResetFont();
+
+            struct Data
+            {
+                DropDownState& state;
+                DropDownPersistentState& ddstate;
+                ImRect list;
+                float rowh;
+                int32_t id;
+                int32_t selected;
+                bool closed;
+            };
+
+            Data data{ state, ddstate, list, rowh, id, selected, false };
+
+            SetPopupCallback(PCB_HandleEvents, [](void* ptr, IRenderer& renderer, ImVec2 offset, const ImRect&) {
+                auto& data = *(Data*)ptr;
+                auto& state = data.state;
+                auto& ddstate = data.ddstate;
+                const auto& io = Config.platform->desc;
+                auto count = (int32_t)ddstate.matches.size();
+                auto viewport = data.list;
+                viewport.Translate(offset);
+
+                ddstate.scroll.viewport = viewport;
+                ddstate.scroll.content = ImVec2{ viewport.GetWidth(), (float)count * data.rowh };
+                auto hasVScroll = HandleVScroll(ddstate.scroll, renderer, io, Config.scrollbar.width);
+                auto onScrollbar = ddstate.scroll.state.mouseDownOnVGrip || 
+                    (hasVScroll && io.mousepos.x >= (viewport.Max.x - Config.scrollbar.width));
+                state.hovered = -1;
+
+                if (viewport.Contains(io.mousepos) && !onScrollbar)
+                {
+                    auto row = (int32_t)((io.mousepos.y - viewport.Min.y + ddstate.scroll.state.pos.y) / data.rowh);
+
+                    if (row < count)
+                    {
+                        auto option = ddstate.matches[row];
+                        if (IsDropDownOptionSelectable(state, option)) state.hovered = option;
+
+                        if (io.clicked() && state.hovered == option)
+                        {
+                            data.selected = option;
+                            data.closed = true;
+                        }
+
+                        if (HandleContextMenu(data.id, viewport, io))
+                            WidgetContextData::RightClickContext.optidx = option;
+                    }
+                }
+
+                auto pagerows = std::max((int32_t)(viewport.GetHeight() / data.rowh), 1);
+                auto shift = (io.modifiers & ShiftKeyMod) != 0;
+
+                for (auto kidx = 0; io.key[kidx] != Key_Invalid; ++kidx)
+                {
+                    auto key = io.key[kidx];
+                    auto cursor = ddstate.cursor;
+
+                    switch (key)
+                    {
+                    case Key_UpArrow: cursor--; break;
+                    case Key_DownArrow: cursor++; break;
+                    case Key_PageUp: cursor -= pagerows; break;
+                    case Key_PageDown: cursor += pagerows; break;
+                    case Key_Home: cursor = 0; break;
+                    case Key_End: cursor = count - 1; break;
+                    case Key_Enter: [[fallthrough]];
+                    case Key_KeypadEnter:
+                        if (cursor != -1 && IsDropDownOptionSelectable(state, ddstate.matches[cursor]))
+                        {
+                            data.selected = ddstate.matches[cursor];
+                            data.closed = true;
+                        }
+                        break;
+                    case Key_Backspace:
+                        if (!ddstate.filter.empty()) ddstate.filter.pop_back();
+                        break;
+                    default:
+                        if (key == Key_Space || (key >= Key_0 && key <= Key_Z) ||
+                            (key >= Key_Apostrophe && key <= Key_GraveAccent) ||
+                            (key >= Key_Keypad0 && key <= Key_KeypadEqual))
+                            ddstate.filter.push_back(shift ? KeyMappings[key].second : KeyMappings[key].first);
+                        break;
+                    }
+
+                    // Navigation keys following typed characters in the same frame act on the new matches
+                    if (ddstate.filter != ddstate.matchedFilter)
+                    {
+                        FilterDropDownOptions(state, ddstate);
+                        count = (int32_t)ddstate.matches.size();
+                        cursor = ddstate.cursor;
+                        ddstate.scroll.content.y = (float)count * data.rowh;
+                    }
+
+                    if (cursor != ddstate.cursor && count > 0)
+                    {
+                        ddstate.cursor = std::clamp(cursor, 0, count - 1);
+                        ScrollToDropDownCursor(ddstate, data.rowh, viewport.GetHeight());
+                    }
+                }
+            }, &data);
+
+            EndPopUp(true, ddstyle.bgcolor, ddstyle.occludeBg);
 
-        switch (option.prefixType)
-        {
-        case WT_Checkbox:
-        {
-            if (optstate.prefix == -1) optstate.prefix = GetNextId(WT_Checkbox);
-            if (optstate.label == -1) optstate.label = GetNextId(WT_Label);
-            /*CreateWidgetConfig(optstate.first).state.checkbox.check = state.selected == optidx ?
-                CheckState::Checked : CheckState::Unchecked;*/
-            CreateWidgetConfig(optstate.prefix);
-            auto& label = CreateWidgetConfig(optstate.label).state.label;
-            label.text = option.text; label.type = option.textType;
-            hasWidgets = true;
-            break;
-        }
-        case WT_ToggleButton:
-        {
-            if (optstate.prefix == -1) optstate.prefix = GetNextId(WT_ToggleButton);
-            if (optstate.label == -1) optstate.label = GetNextId(WT_Label);
-            //CreateWidgetConfig(optstate.first).state.toggle.checked = state.selected == optidx;
-            CreateWidgetConfig(optstate.prefix);
-            auto& label = CreateWidgetConfig(optstate.label).state.label;
-            label.text = option.text; label.type = option.textType;
-            hasWidgets = true;
-            break;
-        }
-        default:
-        {
-            optstate.prefix = -1;
-            if (optstate.label == -1) optstate.label = GetNextId(WT_Label);
-            auto& label = CreateWidgetConfig(optstate.label).state.label;
-            label.text = option.text; label.type = option.textType;
-            break;
-        }
+            if (data.closed)
+            {
+                if (state.out) *state.out = data.selected;
+                state.selected = data.selected;
+                state.opened = false;
+                WidgetContextData::RemovePopup();
+            }
         }
     }
 
@@ -4048,6 +4869,14 @@ namespace glimmer
             {
                 result.event = WidgetEvent::Clicked; 
                 state.opened = !state.opened;
+
+                if (state.opened && state.isVirtualised)
+                {
+                    auto& ddstate = context.dropDownOptions[id & WidgetIndexMask];
+                    ddstate.filter.clear();
+                    ddstate.revealSelection = true;
+                    state.hovered = -1;
+                }
             }
             else if (ismouseover && io.isLeftMouseDoubleClicked())
             {
@@ -4076,7 +4905,8 @@ namespace glimmer
             if (state.opened)
             {
                 auto prev = state.selected;
-                ShowDropDownOptions(context, state, id, margin, border, padding, content, renderer);
+                if (state.isVirtualised) ShowVirtualDropDownOptions(context, state, id, border, padding);
+                else ShowDropDownOptions(context, state, id, margin, border, padding, content, renderer);
                 if (state.selected != prev)
                 {
                     result.event = WidgetEvent::Clicked;
@@ -4129,6 +4959,13 @@ namespace glimmer
                 auto txtflags = ToTextFlags(textType) | FontStyleOverflowMarquee;
                 DrawText(content.Min, content.Max, text, dt, state.state & WS_Disabled, style, renderer, txtflags);
             }
+            else if (state.isVirtualised)
+            {
+                auto dt = state.selected >= 0 && state.selected < GetDropDownOptionCount(state) ? 
+                    GetDropDownOptionText(state, state.selected) : state.text;
+                auto txtflags = TextIsPlainText | FontStyleOverflowMarquee;
+                DrawText(content.Min, content.Max, text, dt, state.state & WS_Disabled, style, renderer, txtflags);
+            }
             else
             {
                 auto index = id & WidgetIndexMask;
@@ -4215,6 +5052,37 @@ namespace glimmer
         return Widget(wid, WT_DropDown, geometry, neighbors);
     }
 
+    WidgetDrawResult DropDown(int32_t* selection, std::string_view text, int32_t count, std::string_view(*option)(int32_t), int32_t geometry, const NeighborWidgets& neighbors)
+    {
+        auto id = GetIdFromOutPtr(selection, WT_DropDown).first;
+        auto& config = CreateWidgetConfig(id).state.dropdown;
+        config.OptionText = option;
+        config.optionCount = count;
+        config.isVirtualised = true;
+        config.out = selection;
+        config.text = text;
+        return Widget(id, WT_DropDown, geometry, neighbors);
+    }
+
+    WidgetDrawResult DropDown(std::string_view id, int32_t* selection, std::string_view text, int32_t count, std::string_view(*option)(int32_t), int32_t geometry, const NeighborWidgets& neighbors)
+    {
+        auto wid = GetIdFromString(id, WT_DropDown).first;
+        auto& config = CreateWidgetConfig(wid).state.dropdown;
+        config.OptionText = option;
+        config.optionCount = count;
+        config.isVirtualised = true;
+        config.out = selection;
+        config.text = text;
+        return Widget(wid, WT_DropDown, geometry, neighbors);
+    }
+
+    void InvalidateDropDownOptions(int32_t id)
+    {
+        auto& ddstate = GetContext().dropDownOptions[id & WidgetIndexMask];
+        ddstate.indexed = false;
+        ddstate.filtered = false;
+    }
+
     bool BeginDropDown(int32_t id, std::string_view text, TextType type, int32_t geometry, const NeighborWidgets& neighbors)
     {
         auto& context = GetContext();
@@ -4626,9 +5494,9 @@ namespace glimmer
                     }
                 }
 
-                ShowTooltip(tab.tabHoverDuration, rect, tab.descriptor.tooltip, io);
-                ShowTooltip(tab.pinHoverDuration, tab.pin, Config.pinTabsTooltip, io);
-                ShowTooltip(tab.closeHoverDuration, tab.close, Config.closeTabsTooltip, io);
+                ShowTooltip(tab.tabHoverTrack, rect, tab.descriptor.tooltip, io);
+                ShowTooltip(tab.pinHoverTrack, tab.pin, Config.pinTabsTooltip, io);
+                ShowTooltip(tab.closeHoverTrack, tab.close, Config.closeTabsTooltip, io);
 
                 if (HandleContextMenu(id, rect, io))
                     WidgetContextData::RightClickContext.tabidx = tabidx;
@@ -4691,7 +5559,7 @@ namespace glimmer
             }
 
             const auto& config = CreateWidgetConfig(id).state.tab;
-            ShowTooltip(state.createHoverDuration, state.create, config.newTabTooltip, io);
+            ShowTooltip(state.createHoverTrack, state.create, config.newTabTooltip, io);
 
             if (state.moveBackward.Contains(io.mousepos))
             {
@@ -4942,6 +5810,9 @@ namespace glimmer
             context.layouts[context.layoutStack.top()].tabbar;
         tab.newTabButton = canAddTab.has_value() ? canAddTab.value() : tab.newTabButton;
         auto& state = context.TabBarState(tab.id);
+
+        for (auto idx = (int16_t)tab.items.size(); idx < state.tabs.size(); ++idx)
+            state.tabs[idx].releaseTracks();
         state.tabs.resize(tab.items.size());
         auto result = Widget(tab.id, WT_TabBar, tab.geometry, tab.neighbors);
         if (result.event != WidgetEvent::Clicked) result.tabidx = state.current;
@@ -5606,7 +6477,7 @@ namespace glimmer
         content.Max = { accordion.content.Max.x, accordion.content.Min.y + offset.y };
         content.Max += ImVec2{ accordion.spacing.right, accordion.spacing.bottom };
         content.Min -= ImVec2{ accordion.spacing.left, accordion.spacing.top };
-        context.deferedEvents.clear(true);
+        context.ClearDeferredEvents();
         context.ToggleDeferedRendering(false, true);
         context.AddItemGeometry(accordion.id, content);
         context.accordions.pop(1, false);
@@ -6183,6 +7054,36 @@ namespace glimmer
         EndHeaderColumn();
     }
 
+    // Determine visual columns [first, last] at a header level which are (partially) inside the viewport,
+    // frozen columns are excluded as they are always visible. Header extents must not be scrolled yet.
+    static std::pair<int16_t, int16_t> VisibleColumnRange(ItemGridBuilder& builder, const ItemGridPersistentState& state,
+        const ItemGridConfig& config, int level)
+    {
+        const auto& headers = builder.headers[level];
+        const auto& colmap = state.colmap[level];
+        auto& ends = builder.colEnds;
+        int16_t total = headers.size(), frozen = 0;
+        while (frozen < total && colmap.vtol[frozen] < config.frozencols) frozen++;
+
+        ends.clear(false);
+        auto sum = 0.f;
+        for (auto vcol = frozen; vcol < total; ++vcol)
+        {
+            sum += headers[colmap.vtol[vcol]].extent.GetWidth() + config.gridwidth;
+            ends.emplace_back(sum);
+        }
+
+        if (ends.empty()) return { total, (int16_t)(total - 1) };
+
+        // Non-frozen columns start right after frozen ones, and are shifted left by scroll amount
+        auto start = headers[colmap.vtol[frozen]].extent.Min.x - builder.origin.x;
+        auto scroll = state.scroll.state.pos.x;
+        auto first = (int16_t)(std::upper_bound(ends.begin(), ends.end(), scroll) - ends.begin());
+        auto last = (int16_t)(std::lower_bound(ends.begin(), ends.end(), scroll + builder.size.x - start) - ends.begin());
+        return { (int16_t)(frozen + std::min<int16_t>(first, ends.size() - 1)), 
+            (int16_t)(frozen + std::min<int16_t>(last, ends.size() - 1)) };
+    }
+
     WidgetDrawResult EndItemGridHeader()
     {
         WidgetDrawResult result;
@@ -6253,6 +7154,8 @@ namespace glimmer
         for (auto level = 0; level < builder.levels; ++level)
         {
             auto frozenWidth = 0.f;
+            auto visible = VisibleColumnRange(builder, state, config, level);
+            if (level == builder.levels - 1) builder.visibleCols = visible;
 
             for (int16_t vcol = 0; vcol < (int16_t)headers[level].size(); ++vcol)
             {
@@ -6282,9 +7185,15 @@ namespace glimmer
                     if (level == builder.levels - 1)
                         builder.movingCols = nextMovingRange;
                 }
+                else if (col >= config.frozencols && (vcol < visible.first || vcol > visible.second))
+                {
+                    // Columns outside viewport are only positioned, as total extent is determined from them
+                    hdr.extent.TranslateX(hshift);
+                    continue;
+                }
                 else
                 {
-                    if (col == config.frozencols)
+                    if (vcol == visible.first && config.frozencols != -1)
                         renderer.SetClipRect(builder.origin + ImVec2{ frozenWidth, 0.f }, builder.origin + builder.size);
                     else if (col < config.frozencols)
                         frozenWidth = (hdr.extent.Max.x - builder.origin.x);
@@ -6380,7 +7289,6 @@ namespace glimmer
         END_LOG_ARRAY();
         builder.nextpos.y = ypos - state.scroll.state.pos.y;
         builder.nextpos.x = builder.origin.x;
-        builder.startY = builder.nextpos.y;
         builder.phase = ItemGridConstructPhase::Headers;
         builder.currlevel = builder.levels - 1;
         builder.totalsz.x = builder.headers[builder.currlevel].back().extent.Max.x + config.gridwidth;
@@ -6409,15 +7317,18 @@ namespace glimmer
 
         auto coloffset = 1;
         auto maxh = 0.f, starty = builder.nextpos.y;
-        builder.currentY = builder.nextpos.y;
         builder.nextpos.y += config.cellpadding.y;
 
         if (builder.headers[GLIMMER_MAX_ITEMGRID_COLUMN_CATEGORY_LEVEL].empty())
             builder.headers[GLIMMER_MAX_ITEMGRID_COLUMN_CATEGORY_LEVEL].resize(builder.headers[builder.levels - 1].size());
 
-        // Add filter row for each column
-        for (auto vcol = 0; vcol < builder.headers[builder.levels - 1].size(); vcol += coloffset)
+        // Add filter row for frozen columns and the ones in viewport
+        auto [firstcol, lastcol] = builder.visibleCols;
+        for (auto vcol = 0; vcol <= lastcol; vcol += coloffset)
         {
+            if (vcol < firstcol && state.colmap[builder.levels - 1].vtol[vcol] >= config.frozencols)
+                vcol = firstcol;
+
             auto col = state.colmap[builder.levels - 1].vtol[vcol];
 
             if (col < builder.movingCols.first || col > builder.movingCols.second)
@@ -6502,7 +7413,7 @@ namespace glimmer
 
         // Draw non-frozen columns after setting appropriate clipping rect for frozen part
         Config.renderer->SetClipRect(builder.origin + ImVec2{ frozensz.x, 0.f }, builder.origin + builder.size);
-        for (; vcol < builder.headers[builder.levels - 1].size(); vcol += coloffset)
+        for (vcol = std::max(vcol, (int)firstcol); vcol <= lastcol; vcol += coloffset)
         {
             auto col = state.colmap[builder.levels - 1].vtol[vcol];
             if (col < builder.movingCols.first || col > builder.movingCols.second)
@@ -6612,31 +7523,12 @@ namespace glimmer
 
     static bool IsItemSelected(const ItemGridPersistentState& state, const ItemGridConfig& config, int32_t row, int16_t col, int16_t depth)
     {
-        auto selectRow = (config.selection & IG_SelectRow) != 0;
-        auto selectCol = (config.selection & IG_SelectColumn) != 0;
-        auto selectCell = (config.selection & IG_SelectCell) != 0;
-
-        for (auto idx = 0; idx < state.selections.size(); ++idx)
-        {
-            if (selectCell)
-            {
-                if (state.selections[idx].row == row && state.selections[idx].col == col &&
-                    state.selections[idx].depth == depth)
-                    return true;
-            }
-            else if (selectRow)
-            {
-                if (state.selections[idx].row == row && state.selections[idx].depth == depth)
-                    return true;
-            }
-            else
-            {
-                if (state.selections[idx].col == col && state.selections[idx].depth == depth)
-                    return true;
-            }
-        }
-
-        return false;
+        if (config.selection & IG_SelectCell)
+            return state.selections.isCellSelected(row, col, depth);
+        else if (config.selection & IG_SelectRow)
+            return state.selections.isRowSelected(row, depth);
+        else
+            return state.selections.isColumnSelected(col);
     }
 
     static void ExtractColumnProps(ColumnProps& colprops, const ItemGridPersistentState& state, ItemGridBuilder& builder,
@@ -6679,15 +7571,26 @@ namespace glimmer
         const ItemGridPersistentState& state, const ItemGridConfig& config, const ItemGridItemProps& props,
         ColumnProps& colprops, const std::pair<float, float>& bounds, int16_t col, int32_t row)
     {
-        assert(config.cellwidget || config.cellcontent);
+        assert(config.cellwidget || config.cellcontent || config.datasource);
         assert(!props.isContentWidget || (props.isContentWidget && config.cellwidget));
         std::string_view result;
+        std::optional<std::string_view> fetched;
+        if (config.datasource != nullptr && !props.isContentWidget) fetched = state.pageCache->cell(row, col);
 
-        if (props.isContentWidget || (!config.cellcontent && config.cellwidget))
+        if (props.isContentWidget || (!config.cellcontent && !config.datasource && config.cellwidget))
             config.cellwidget(bounds, row, col, builder.depth);
+        else if (config.datasource != nullptr && !fetched.has_value())
+        {
+            // Page of the row is not fetched yet, draw a placeholder bar of line height
+            auto style = context.GetStyle(props.disabled ? WS_Disabled : WS_Default);
+            auto width = std::max(bounds.second - builder.nextpos.x, 0.f) * 0.6f;
+            builder.maxCellExtent = builder.nextpos + ImVec2{ width, style.font.size };
+            context.deferedRenderer->DrawRect(builder.nextpos, builder.maxCellExtent, config.placeholderColor, true);
+        }
         else
         {
-            auto [text, txtype] = config.cellcontent(bounds, row, col, builder.depth);
+            auto [text, txtype] = fetched.has_value() ? std::make_pair(*fetched, TextType::PlainText) :
+                config.cellcontent(bounds, row, col, builder.depth);
             auto style = context.GetStyle(props.disabled ? WS_Disabled :
                 colprops.selected ? WS_Selected : colprops.highlighted ? WS_Hovered : WS_Default);
             auto textsz = GetTextSize(txtype, text, style.font, props.wrapText ? 
@@ -6710,65 +7613,54 @@ namespace glimmer
     static void UpdateSingleSelection(ItemGridPersistentState& state, const ItemGridConfig& config, int32_t col, int32_t row, int32_t depth)
     {
         if (config.selection & IG_SelectRow)
-            state.selections.emplace_back(row, -1, depth);
+        {
+            state.selections.addRows(row, row, depth);
+            state.selections.anchor = ItemGridPersistentState::ItemId{ row, -1, depth };
+        }
         else if (config.selection & IG_SelectColumn)
-            state.selections.emplace_back(-1, col, depth);
+        {
+            state.selections.addColumns(col, col);
+            state.selections.anchor = ItemGridPersistentState::ItemId{ -1, col, depth };
+        }
         else
-            state.selections.emplace_back(row, col, depth);
+        {
+            state.selections.addCell(row, col, depth);
+            state.selections.anchor = ItemGridPersistentState::ItemId{ row, col, depth };
+        }
     }
 
     static void UpdateContiguosSelection(ItemGridPersistentState& state, ItemGridBuilder& builder, const ItemGridConfig& config, int32_t index, int32_t depth)
     {
-        static Vector<ItemGridPersistentState::ItemId, int16_t> temp;
-        auto selectRow = (config.selection & IG_SelectRow) != 0;
-
-        const auto last = state.selections.back();
-        auto start = std::min(selectRow ? last.row : last.col, index);
-        auto end = std::max(selectRow ? last.row : last.col, index);
-        auto idx = 0;
-
-        for (; idx < state.selections.size(); ++idx)
-            if (state.selections[idx].col < start)
-                temp.emplace_back(state.selections[idx]);
-            else break;
+        auto& selections = state.selections;
+        const auto& anchor = selections.anchor;
 
-        if (!selectRow)
+        if (!(config.selection & IG_SelectRow))
+            selections.addColumns(anchor.col, index);
+        else if (!config.isTree)
         {
-            for (; start <= end; ++start)
-                temp.emplace_back(-1, start, depth);
+            // Rows outside the viewport are not built for flat grids, hence select by row index
+            selections.addRows(anchor.row, index, depth);
         }
         else
         {
-            auto firstPoint = state.lastSelection == -1.f;
-            auto from = firstPoint ? state.currentSelection : std::min(state.lastSelection, state.currentSelection);
-            auto to = firstPoint ? state.currentSelection : std::max(state.lastSelection, state.currentSelection);
+            // Tree rows are identified by their position in the flattened tree, select every visible
+            // row in between, runs of rows at same depth are merged into a single range
+            const auto& tree = state.tree;
+            auto from = std::min(anchor.row, index), to = std::max(anchor.row, index);
+            to = std::min(to, tree.rows() - 1);
+            if (from > to) return;
 
-            for (const auto& range : builder.rowYs)
+            auto node = tree.at(from);
+            for (auto row = from; row <= to;)
             {
-                if ((range.from <= from && range.to >= from) || (range.to >= to && range.from <= to) ||
-                    (range.from > from && range.to < to))
-                {
-                    auto exists = false;
-                    for (const auto& select : state.selections)
-                        if (select.depth == range.depth && select.row == range.row)
-                        {
-                            exists = true; break;
-                        }
-
-                    if (!exists)
-                        temp.emplace_back(range.row, -1, range.depth);
-                }
+                auto depth = tree.nodes[node].depth;
+                auto next = row + 1;
+                node = tree.next(node);
+                while (next <= to && tree.nodes[node].depth == depth) { ++next; node = tree.next(node); }
+                selections.addRows(row, next - 1, depth);
+                row = next;
             }
         }
-
-        for (; idx < state.selections.size(); ++idx)
-            if (state.selections[idx].col > end)
-                temp.emplace_back(state.selections[idx]);
-
-        state.selections.clear(true);
-        state.selections.resize(temp.size(), false);
-        for (idx = 0; idx < temp.size(); ++idx)
-            state.selections.emplace_back(temp[idx]);
     }
 
     static void UpdateItemSelection(ItemGridPersistentState& state, ItemGridBuilder& builder, const ItemGridConfig& config, const IODescriptor& io, int32_t col, int32_t row, int32_t depth)
@@ -6780,19 +7672,19 @@ namespace glimmer
             else if (io.modifiers & ShiftKeyMod)
                 if (config.selection & IG_SelectRow)
                 {
-                    if (state.selections.empty()) state.selections.emplace_back(row, -1);
+                    if (state.selections.empty()) UpdateSingleSelection(state, config, col, row, depth);
                     else UpdateContiguosSelection(state, builder, config, row, depth);
                 }
                 else if (config.selection & IG_SelectColumn)
                 {
-                    if (state.selections.empty()) state.selections.emplace_back(col, -1);
+                    if (state.selections.empty()) UpdateSingleSelection(state, config, col, row, depth);
                     else UpdateContiguosSelection(state, builder, config, col, -1);
                 }
                 else // TODO: Ambiguous here, need to decide
-                    state.selections.emplace_back(row, col, depth);
+                    UpdateSingleSelection(state, config, col, row, depth);
             else
             {
-                state.selections.clear(true);
+                state.selections.clear();
                 UpdateSingleSelection(state, config, col, row, depth);
             }
         }
@@ -6801,39 +7693,89 @@ namespace glimmer
             if (io.modifiers & ShiftKeyMod)
                 if (config.selection & IG_SelectRow)
                 {
-                    if (state.selections.empty()) state.selections.emplace_back(row, -1);
+                    if (state.selections.empty()) UpdateSingleSelection(state, config, col, row, depth);
                     else UpdateContiguosSelection(state, builder, config, row, depth);
                 }
                 else if (config.selection & IG_SelectColumn)
                 {
-                    if (state.selections.empty()) state.selections.emplace_back(col, -1);
+                    if (state.selections.empty()) UpdateSingleSelection(state, config, col, row, depth);
                     else UpdateContiguosSelection(state, builder, config, col, -1);
                 }
                 else
-                    state.selections.emplace_back(row, col);
+                    UpdateSingleSelection(state, config, col, row, depth);
             else
             {
-                state.selections.clear(true);
+                state.selections.clear();
                 UpdateSingleSelection(state, config, col, row, depth);
             }
         }
         else
         {
-            state.selections.clear(true);
+            state.selections.clear();
             UpdateSingleSelection(state, config, col, row, depth);
         }
 
-        if ((config.selection & IG_SelectRow) && !(io.modifiers & ShiftKeyMod))
-        {
-            state.lastSelection = -1.f;
-        }
-
         LOG_NUM2("selected-row-count", state.selections.size());
     }
 
-    static int32_t GetRowId(const ItemGridBuilder& builder, const ItemGridConfig& config, int32_t row)
+    static int32_t GetSourceRow(const ItemGridBuilder& builder, int32_t row)
+    {
+        return builder.rowOrder != nullptr ? (*builder.rowOrder)[row] : row;
+    }
+
+    // Submit sorted column and filters to background sort/filter engine, and display rows in the order
+    // published by it. Filters of columns outside the viewport are not created, last known text is used.
+    static void UpdateItemGridRowOrder(WidgetContextData& context, ItemGridBuilder& builder, ItemGridPersistentState& state,
+        const ItemGridConfig& config)
     {
-        return config.isTree ? builder.perDepthRowCount[builder.depth] : row;
+        if (state.rowOrder == nullptr) state.rowOrder = std::make_shared<ItemGridRowOrder>();
+
+        auto& order = *state.rowOrder;
+        const auto& headers = builder.headers[builder.levels - 1];
+        auto request = order.submitted;
+        request.cellkey = config.cellkey;
+        request.rows = builder.rowcount;
+        request.version = order.version;
+        request.sortcol = state.sortedLevel == builder.levels - 1 ? state.sortedCol : -1;
+        request.ascending = state.sortedAscending;
+        request.filters.resize(headers.size());
+
+        for (int16_t col = 0; col < headers.size(); ++col)
+            if (headers[col].genid != -1)
+            {
+                const auto& text = context.GetState(headers[col].genid).state.input.text;
+                request.filters[col].assign(text.begin(), text.end());
+            }
+
+        order.update(request);
+        builder.rowOrder = order.rows(builder.rowcount);
+        if (builder.rowOrder != nullptr) builder.rowcount = (int32_t)builder.rowOrder->size();
+
+        // Selections refer to displayed rows, hence follow their source rows into a newly published order
+        if (builder.rowOrder != state.displayedOrder && !state.selections.empty())
+        {
+            const auto* previous = state.displayedOrder.get();
+            const auto* current = builder.rowOrder.get();
+            std::vector<int32_t> displayed(request.rows, -1), moved(previous != nullptr ?
+                previous->size() : (size_t)state.displayedRows, -1);
+
+            for (auto row = 0; row < builder.rowcount; ++row)
+            {
+                auto source = current != nullptr ? (*current)[row] : row;
+                if (source >= 0 && source < request.rows) displayed[source] = row;
+            }
+
+            for (auto row = 0; row < (int32_t)moved.size(); ++row)
+            {
+                auto source = previous != nullptr ? (*previous)[row] : row;
+                if (source >= 0 && source < request.rows) moved[row] = displayed[source];
+            }
+
+            state.selections.permuteRows(moved);
+        }
+
+        state.displayedOrder = builder.rowOrder;
+        state.displayedRows = builder.rowcount;
     }
 
     static ImVec2 RenderItemGridCell(WidgetContextData& context, ItemGridBuilder& builder,
@@ -6895,10 +7837,8 @@ namespace glimmer
                 {
                     if (isClicked && !state.scroll.state.mouseDownOnVGrip && !state.scroll.state.mouseDownOnHGrip)
                     {
-                        state.lastSelection = state.currentSelection;
-                        state.currentSelection = io.mousepos.y - builder.startY;
                         state.cellstate.state |= WS_Selected;
-                        builder.clickedItem.row = GetRowId(builder, config, row);
+                        builder.clickedItem.row = row;
                         builder.clickedItem.col = col;
                         builder.clickedItem.depth = builder.depth;
                     }
@@ -6984,19 +7924,6 @@ namespace glimmer
         return cellGeometry.extent.GetSize();
     }
 
-    static void RecordRowYRange(ItemGridBuilder& builder, const ItemGridConfig& config, float height, int32_t totalRows, int32_t row)
-    {
-        if (config.selection & IG_SelectRow)
-        {
-            if (builder.rowYs.empty()) builder.rowYs.expand(totalRows, true);
-            auto& range = builder.rowYs.emplace_back();
-            range.depth = builder.depth; range.row = GetRowId(builder, config, row);
-            range.from = builder.currentY - builder.startY; range.to = range.from + height + config.cellpadding.y;
-            builder.currentY = range.to;
-            builder.perDepthRowCount[builder.depth]++;
-        }
-    }
-
     static void RecordCellContentDimension(ItemGridBuilder& builder, ColumnProps& colprops, const ItemGridConfig& config,
         const std::pair<float, float>& bounds, const ImRect& extent, float height)
     {
@@ -7009,6 +7936,26 @@ namespace glimmer
         colprops.extent.Max.x = extent.Max.x;
     }
 
+    // Expanded state of a tree node is only reported by `cellprops` of its first column, query it for
+    // every descendant of `node` so that row count and content extent also account for the rows
+    // outside of viewport, which are never built.
+    static void DiscoverItemGridTree(ItemGridPersistentState& state, const ItemGridBuilder& builder,
+        const ItemGridConfig& config, int32_t node)
+    {
+        if (!config.cellprops) return;
+
+        auto& tree = state.tree;
+        auto col = state.colmap[builder.levels - 1].vtol[0];
+        auto row = tree.position(node) + 1;
+        auto stop = tree.skip(node);
+
+        for (auto current = tree.next(node); current != stop; current = tree.next(current), ++row)
+        {
+            auto props = config.cellprops(tree.sibling(current), col, tree.nodes[current].depth, row, 0);
+            tree.update(current, props.vstate == ItemDescendentVisualState::Expanded, props.children);
+        }
+    }
+
     static void AddRowData(WidgetContextData& context, ItemGridBuilder& builder,
         ItemGridPersistentState& state, const ItemGridConfig& config, WidgetDrawResult& result,
         int totalRows)
@@ -7018,36 +7965,72 @@ namespace glimmer
         builder.phase = ItemGridConstructPhase::Rows;
         if (builder.headers[GLIMMER_MAX_ITEMGRID_COLUMN_CATEGORY_LEVEL].empty())
             builder.headers[GLIMMER_MAX_ITEMGRID_COLUMN_CATEGORY_LEVEL].resize(builder.headers[builder.levels - 1].size());
-        
-        if ((config.selection & IG_SelectRow) && (builder.perDepthRowCount.empty()) && config.isTree)
-        {
-            builder.perDepthRowCount.resize(32, false);
-            builder.perDepthRowCount[builder.depth] = 0;
-        }
 
         builder.cellvals.resize(builder.headers[builder.levels - 1].size(), true);
         BEGIN_LOG_ARRAY("itemgrid-rows");
 
-        while (totalRows > 0)
+        // Only rows in the viewport (and a few around it) are built, positions of the rest are
+        // determined from the row height index. Trees are built from their index of visible
+        // nodes, which also aggregates row heights, where `totalRows` is the number of root rows.
+        auto& tree = state.tree;
+        auto& index = state.rowHeights;
+        auto rowsStartY = builder.nextpos.y;
+        auto viewportEndY = builder.origin.y + builder.size.y;
+        auto viewportStartY = builder.origin.y + builder.headerHeight + builder.filterRowHeight;
+        auto overscan = GLIMMER_ITEMGRID_ROW_OVERSCAN;
+        auto [firstcol, lastcol] = builder.visibleCols;
+        auto node = 0;
+
+        if (config.isTree)
+        {
+            if (tree.reset(totalRows)) DiscoverItemGridTree(state, builder, config, 0);
+            totalRows = tree.rows();
+            row = std::max(tree.seek(viewportStartY - rowsStartY) - GLIMMER_ITEMGRID_ROW_OVERSCAN, 0);
+            builder.nextpos.y = rowsStartY + tree.offset(row);
+            if (row < totalRows) node = tree.at(row);
+        }
+        else
+        {
+            index.resize(totalRows, config.uniformRowHeights);
+            row = std::max(index.seek(viewportStartY - rowsStartY) - GLIMMER_ITEMGRID_ROW_OVERSCAN, 0);
+            builder.nextpos.y = rowsStartY + index.offset(row);
+        }
+
+        context.adhocLayout.top().nextpos = builder.nextpos;
+
+        while (row < totalRows)
         {
+            if (builder.nextpos.y >= viewportEndY && overscan-- <= 0) break;
+
             auto coloffset = 1;
             auto maxh = 0.f;
-            builder.currentY = builder.nextpos.y;
+            auto rowStartY = builder.nextpos.y;
+            auto srcrow = GetSourceRow(builder, row);
             builder.nextpos.y += config.cellpadding.y;
+            builder.childState = std::make_pair(ItemDescendentVisualState::NoDescendent, -1);
+
+            if (config.isTree)
+            {
+                srcrow = tree.sibling(node);
+                builder.depth = tree.nodes[node].depth;
+                builder.cellIndent = (float)builder.depth * config.config.indent;
+            }
 
-            // Determine cell geometry for current row
-            for (auto vcol = 0; vcol < builder.headers[builder.levels - 1].size(); vcol += coloffset)
+            // Determine cell geometry for current row, only frozen columns and the ones in viewport
+            for (auto vcol = 0; vcol <= lastcol; vcol += coloffset)
             {
+                if (vcol < firstcol && state.colmap[builder.levels - 1].vtol[vcol] >= config.frozencols)
+                    vcol = firstcol;
+
                 auto col = state.colmap[builder.levels - 1].vtol[vcol];
 
                 if (col < builder.movingCols.first || col > builder.movingCols.second)
                 {
-                    auto rowid = GetRowId(builder, config, row);
-                    auto selected = IsItemSelected(state, config, rowid, col, builder.depth);
+                    auto selected = IsItemSelected(state, config, row, col, builder.depth);
                     auto highlighted = IsItemHighlighted(state, config, row, col, builder.depth);
                     auto itemprops = selected ? IG_Selected : 0;
                     itemprops |= highlighted ? IG_Highlighted : 0;
-                    auto props = config.cellprops ? config.cellprops(row, col, builder.depth, rowid, itemprops) : ItemGridItemProps{};
+                    auto props = config.cellprops ? config.cellprops(srcrow, col, builder.depth, row, itemprops) : ItemGridItemProps{};
                     auto& colprops = builder.headers[GLIMMER_MAX_ITEMGRID_COLUMN_CATEGORY_LEVEL][col];
 
                     builder.currCol = col;
@@ -7071,7 +8054,7 @@ namespace glimmer
                         builder.nextpos.x += config.cellpadding.x;
                     }
 
-                    auto text = InvokeItemGridCellContent(context, builder, state, config, props, colprops, bounds, col, row);
+                    auto text = InvokeItemGridCellContent(context, builder, state, config, props, colprops, bounds, col, srcrow);
                     builder.cellvals.emplace_back(text, props.vstate);
                     context.RecordDeferRange(header.range, false);
 
@@ -7107,7 +8090,7 @@ namespace glimmer
 
             // Draw non-frozen columns after setting appropriate clipping rect for frozen part
             Config.renderer->SetClipRect(builder.origin + ImVec2{ frozensz.x, 0.f }, builder.origin + builder.size);
-            for (; vcol < builder.headers[builder.levels - 1].size(); vcol += coloffset)
+            for (vcol = std::max(vcol, (int)firstcol); vcol <= lastcol; vcol += coloffset)
             {
                 auto col = state.colmap[builder.levels - 1].vtol[vcol];
                 if (col < builder.movingCols.first || col > builder.movingCols.second)
@@ -7120,25 +8103,40 @@ namespace glimmer
             builder.nextpos.x = startx;
             context.adhocLayout.top().nextpos = builder.nextpos;
 
-            RecordRowYRange(builder, config, maxh, totalRows, row);
+            context.ClearDeferredData();
 
-            // Draw child rows
-            if (builder.childState.first == ItemDescendentVisualState::Expanded &&
-                builder.childState.second > 0)
+            if (!config.isTree) index.update(row, builder.nextpos.y - rowStartY);
+            else
             {
-                builder.cellIndent += config.config.indent;
-                builder.depth++;
-                auto res = PopulateData(builder.childState.second);
-                if (res.event != WidgetEvent::None) result = res;
-                builder.cellIndent -= config.config.indent;
-                builder.depth--;
+                tree.measure(node, builder.nextpos.y - rowStartY);
+
+                // Splice children of expanded/collapsed node right after it, so that they are built next.
+                // Child state is unknown if first column was not built i.e. scrolled out of view.
+                if (builder.childState.second != -1)
+                {
+                    auto [removed, added] = tree.update(node, builder.childState.first == ItemDescendentVisualState::Expanded,
+                        builder.childState.second);
+
+                    if (removed > 0 || added > 0)
+                    {
+                        DiscoverItemGridTree(state, builder, config, node);
+                        added = tree.nodes[node].size - 1;
+                        if (!state.selections.empty()) state.selections.spliceRows(row + 1, removed, added);
+                        totalRows = tree.rows();
+                    }
+                }
+
+                node = tree.next(node);
             }
 
-            context.ClearDeferredData();
-            --totalRows;
             ++row;
         }
 
+        // Rows after the viewport are not built, extent of content is known from the index
+        builder.nextpos.y = rowsStartY + (config.isTree ? tree.offset(totalRows) : index.offset(totalRows));
+        builder.depth = 0;
+        builder.cellIndent = 0.f;
+
         END_LOG_ARRAY();
         builder.totalsz.y = builder.nextpos.y;
         builder.totalsz.x = builder.headers[builder.currlevel].back().extent.Max.x + config.gridwidth;
@@ -7158,12 +8156,12 @@ namespace glimmer
 
         for (auto row = 0; row < totalRows; ++row)
         {
-            auto rowid = GetRowId(builder, config, row);
-            auto selected = IsItemSelected(state, config, rowid, col, builder.depth);
+            auto srcrow = GetSourceRow(builder, row);
+            auto selected = IsItemSelected(state, config, row, col, builder.depth);
             auto highlighted = IsItemHighlighted(state, config, row, col, builder.depth);
             auto itemprops = selected ? IG_Selected : 0;
             itemprops |= highlighted ? IG_Highlighted : 0;
-            auto props = config.cellprops ? config.cellprops(row, col, builder.depth, rowid, itemprops) : ItemGridItemProps{};
+            auto props = config.cellprops ? config.cellprops(srcrow, col, builder.depth, row, itemprops) : ItemGridItemProps{};
 
             builder.currCol = col;
             builder.currRow = row;
@@ -7177,7 +8175,7 @@ namespace glimmer
             context.deferEvents = true;
 
             context.RecordDeferRange(header.range, true);
-            InvokeItemGridCellContent(context, builder, state, config, props, colprops, bounds, col, row);
+            InvokeItemGridCellContent(context, builder, state, config, props, colprops, bounds, col, srcrow);
             context.RecordDeferRange(header.range, false);
 
             auto rowh = builder.maxCellExtent.y - builder.nextpos.y;
@@ -7185,7 +8183,6 @@ namespace glimmer
             header.alignment = props.alignment;
 
             RenderItemGridCell(context, builder, state, config, rowh, col, row, result);
-            RecordRowYRange(builder, config, rowh, totalRows, row);
 
             builder.nextpos.y += rowh + config.cellpadding.y + config.gridwidth;
             builder.maxCellExtent = ImVec2{};
@@ -7205,7 +8202,7 @@ namespace glimmer
         auto& renderer = context.GetRenderer();
         auto io = Config.platform->CurrentIO();
         auto& ctx = GetContext();
-        assert(config.cellwidget != nullptr || config.cellcontent != nullptr);
+        assert(config.cellwidget != nullptr || config.cellcontent != nullptr || config.datasource != nullptr);
 
         if (builder.method == ItemGridPopulateMethod::ByRows) 
             AddRowData(ctx, builder, state, config, result, totalRows);
@@ -7240,6 +8237,7 @@ namespace glimmer
                 else break;
             }
 
+            // Columns outside viewport are skipped, only their widths are accumulated
             Config.renderer->SetClipRect(builder.origin + ImVec2{ frozenWidth, 0.f }, builder.origin + builder.size);
             for (; vcol < builder.headers[builder.levels - 1].size(); vcol++)
             {
@@ -7247,7 +8245,7 @@ namespace glimmer
                 if (col < builder.movingCols.first || col > builder.movingCols.second)
                 {
                     auto ystart = builder.nextpos.y;
-                    if (col < builder.movingCols.first || col > builder.movingCols.second)
+                    if (vcol >= builder.visibleCols.first && vcol <= builder.visibleCols.second)
                         AddColumnData(ctx, builder, state, config, result, io, totalRows, col);
                     builder.nextpos.y = ystart;
                     auto width = builder.headers[builder.levels - 1][col].extent.GetWidth() +
@@ -7329,7 +8327,7 @@ namespace glimmer
             UpdateItemSelection(state, builder, config, io, builder.clickedItem.col, builder.clickedItem.row, builder.clickedItem.depth);
 
         ctx.ToggleDeferedRendering(false, true);
-        ctx.deferedEvents.clear(true);
+        ctx.ClearDeferredEvents();
         return result;
     }
 
@@ -7346,7 +8344,15 @@ namespace glimmer
         ImRect viewport{ builder.origin + ImVec2{ 0.f, builder.headerHeight + builder.filterRowHeight }, 
             builder.origin + builder.size };
         renderer.SetClipRect(viewport.Min, viewport.Max);
+        if (config.datasource != nullptr)
+        {
+            if (state.pageCache == nullptr) state.pageCache = std::make_shared<ItemGridPageCache>();
+            state.pageCache->beginFrame(config.datasource, builder.rowcount);
+        }
+
+        if (config.cellkey != nullptr && !config.isTree) UpdateItemGridRowOrder(GetContext(), builder, state, config);
         result = PopulateData(builder.rowcount);
+        if (config.datasource != nullptr) state.pageCache->endFrame(state.scroll.state.pos.y);
         renderer.ResetClipRect();
         END_WIDGET_LOG();
 
@@ -7391,6 +8397,138 @@ namespace glimmer
         return result;
     }
 
+    int32_t EnumerateItemGridSelection(int32_t id, bool (*visitor)(const ItemGridSelectedRange&, void*), void* data)
+    {
+        const auto& selections = GetContext().GridState(id).selections;
+        auto count = 0;
+
+        for (auto depth = 0; depth < (int)selections.rows.size(); ++depth)
+            for (const auto& range : selections.rows[depth])
+            {
+                ++count;
+                if (!visitor(ItemGridSelectedRange{ range.from, range.to, -1, -1, (int16_t)depth }, data))
+                    return count;
+            }
+
+        // Adjacent selected columns are reported as a single range
+        auto total = (int32_t)selections.cols.size() * 64;
+        for (auto col = 0; col < total;)
+        {
+            if (!(selections.cols[col / 64] & ((uint64_t)1 << (col % 64)))) { ++col; continue; }
+
+            auto end = col;
+            while (end + 1 < total && (selections.cols[(end + 1) / 64] & ((uint64_t)1 << ((end + 1) % 64)))) ++end;
+
+            ++count;
+            if (!visitor(ItemGridSelectedRange{ -1, -1, (int16_t)col, (int16_t)end, -1 }, data))
+                return count;
+            col = end + 1;
+        }
+
+        for (auto key : selections.cells)
+        {
+            auto row = (int32_t)(uint32_t)(key & 0xFFFFFFFFu);
+            auto col = (int16_t)(uint16_t)((key >> 32) & 0xFFFFu);
+            auto depth = (int16_t)(uint16_t)(key >> 48);
+
+            ++count;
+            if (!visitor(ItemGridSelectedRange{ row, row, col, col, depth }, data))
+                return count;
+        }
+
+        return count;
+    }
+
+    int32_t GetItemGridSourceRow(int32_t id, int32_t row)
+    {
+        const auto& state = GetContext().GridState(id);
+        auto rows = state.rowOrder != nullptr ? state.rowOrder->rows(INT32_MAX) : nullptr;
+        return rows != nullptr && row >= 0 && row < (int32_t)rows->size() ? (*rows)[row] : row;
+    }
+
+    void InvalidateItemGridRows(int32_t id)
+    {
+        auto& state = GetContext().GridState(id);
+        if (state.rowOrder != nullptr) state.rowOrder->version++;
+        if (state.pageCache != nullptr) state.pageCache->clear();
+    }
+
+    ItemGridTreeNode GetItemGridTreeNode(int32_t id, int32_t row)
+    {
+        const auto& tree = GetContext().GridState(id).tree;
+        ItemGridTreeNode result;
+
+        if (row >= 0 && row < tree.rows())
+        {
+            auto node = tree.at(row);
+            result.row = tree.sibling(node);
+            result.depth = tree.nodes[node].depth;
+            result.parent = tree.parent(row);
+        }
+
+        return result;
+    }
+
+    bool IsItemGridSortPending(int32_t id)
+    {
+        const auto& state = GetContext().GridState(id);
+        return state.rowOrder != nullptr && state.rowOrder->pending();
+    }
+
+    LocalItemGridDataSource::LocalItemGridDataSource(std::string(*cell)(int32_t, int16_t), int16_t columns, int32_t latencyMs)
+        : _cell{ cell }, _columns{ columns }, _latency{ latencyMs }, _worker{ [this] { Run(); } }
+    {}
+
+    LocalItemGridDataSource::~LocalItemGridDataSource()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ _mutex };
+            _exit = true;
+        }
+
+        _cv.notify_all();
+        _worker.join();
+    }
+
+    void LocalItemGridDataSource::RequestRange(int32_t rowStart, int32_t rowEnd, ItemGridDeliverFn deliver)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ _mutex };
+            _requests.push_back(PendingRequest{ std::chrono::steady_clock::now() + std::chrono::milliseconds{ _latency },
+                rowStart, rowEnd, std::move(deliver) });
+        }
+
+        _cv.notify_one();
+    }
+
+    void LocalItemGridDataSource::Run()
+    {
+        while (true)
+        {
+            PendingRequest request;
+
+            {
+                // Latency is same for all requests, hence they are due in order of arrival
+                std::unique_lock<std::mutex> lock{ _mutex };
+                _cv.wait(lock, [this] { return _exit || !_requests.empty(); });
+                if (_exit || _cv.wait_until(lock, _requests.front().due, [this] { return _exit; })) return;
+                request = std::move(_requests.front());
+                _requests.pop_front();
+            }
+
+            ItemGridRowData data;
+            data.rowStart = request.rowStart;
+            data.columns = _columns;
+            data.cells.reserve((size_t)(request.rowEnd - request.rowStart) * _columns);
+
+            for (auto row = request.rowStart; row < request.rowEnd; ++row)
+                for (int16_t col = 0; col < _columns; ++col)
+                    data.cells.emplace_back(_cell(row, col));
+
+            request.deliver(std::move(data));
+        }
+    }
+
     WidgetDrawResult ItemGridImpl(int32_t id, const StyleDescriptor& style, const ImRect& margin, const ImRect& border, const ImRect& padding,
         const ImRect& content, const ImRect& text, IRenderer& renderer, const IODescriptor& io)
     {
@@ -7773,7 +8911,7 @@ namespace glimmer
         }
 
         overlayctx.ToggleDeferedRendering(false);
-        overlayctx.deferedEvents.clear(true);
+        overlayctx.ClearDeferredEvents();
         PopContext();
         return result;
     }
@@ -8063,9 +9201,10 @@ namespace glimmer
         ImVec2 GetCurrentMousePos() { return Config.platform->CurrentIO().mousepos; }
         bool IsMouseClicked() { return Config.platform->CurrentIO().clicked(); }
 
-        // TODO: Implement these methods to provide full hyperlink and frame support
+        // TODO: Implement these methods to provide full hyperlink support
         void HandleHyperlink(std::string_view) {}
-        void RequestFrame() {}
+        void RequestFrame() { Config.platform->RequestFrame(); }
+        void RequestFrameAfter(float seconds) { Config.platform->RequestFrameAfter(seconds); }
         void HandleHover(bool) {}
 
         float DeltaTime() { return Config.platform->CurrentIO().deltaTime; }
@@ -8448,6 +9587,34 @@ namespace glimmer
             
             break;
         }
+        case WT_TextEditor: {
+            auto& state = context.GetState(wid).state.editor;
+            auto style = context.GetStyle(state.state, wid);
+            ImVec2 textsz{ style.dimension.x, (float)state.visibleLines * style.font.size };
+            UpdateTooltip(state.tooltip);
+
+            if (nestedCtx.source == NestedContextSourceType::Layout && !context.layoutStack.empty())
+            {
+                auto& layout = context.layouts[context.layoutStack.top()];
+                auto pos = layout.nextpos;
+                if (geometry & ExpandH) layoutItem.sizing |= ExpandH;
+                if (geometry & ExpandV) layoutItem.sizing |= ExpandV;
+                DetermineBounds(textsz, {}, {}, pos, layoutItem, style, renderer, geometry, neighbors);
+                AddItemToLayout(layout, layoutItem, style);
+            }
+            else
+            {
+                auto pos = context.NextAdHocPos();
+                DetermineBounds(textsz, {}, {}, pos, layoutItem, style, renderer, geometry, neighbors);
+                renderer.SetClipRect(layoutItem.margin.Min, layoutItem.margin.Max);
+                result = TextEditorImpl(wid, state, style, layoutItem.border, layoutItem.content, renderer, io);
+                context.AddItemGeometry(wid, layoutItem.margin);
+                renderer.ResetClipRect();
+                RecordItemGeometry(layoutItem, style);
+            }
+
+            break;
+        }
         case WT_DropDown: {
             static char DummyString[256];
             memset(DummyString, 'X', 254);
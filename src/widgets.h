@@ -3,6 +3,9 @@
 #include "style.h"
 #include "platform.h"
 
+#include <chrono>
+#include <string>
+
 namespace glimmer
 {
     UIConfig& GetUIConfig();
@@ -95,11 +98,24 @@ namespace glimmer
         return TextInput(id, out, placeholder, geometry, neighbors);
     }
 
+    // Multi-line text editor, text is owned by the editor and only visible lines are built
+    WidgetDrawResult TextEditor(int32_t id, int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
+    WidgetDrawResult TextEditor(std::string_view id, std::string_view text, std::string_view placeholder = "", int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
+    void SetTextEditorText(int32_t id, std::string_view text);
+    void GetTextEditorText(int32_t id, std::string& out);
+    int32_t GetTextEditorLineCount(int32_t id);
+
     WidgetDrawResult DropDown(int32_t id, int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
     WidgetDrawResult DropDown(int32_t* selection, std::string_view text, bool(*options)(int32_t), int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
     WidgetDrawResult DropDown(std::string_view id, int32_t* selection, std::string_view text, bool(*options)(int32_t), int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
     WidgetDrawResult DropDown(int32_t* selection, std::string_view text, const std::initializer_list<std::string_view>& options, int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
     WidgetDrawResult DropDown(std::string_view id, int32_t* selection, std::string_view text, const std::initializer_list<std::string_view>& options, int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
+    // Virtualised dropdown for large option lists, only visible options are fetched from `option` and
+    // options are filtered by typing while open. Options are indexed for filtering when first shown,
+    // call InvalidateDropDownOptions if options change without a change in their count.
+    WidgetDrawResult DropDown(int32_t* selection, std::string_view text, int32_t count, std::string_view(*option)(int32_t), int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
+    WidgetDrawResult DropDown(std::string_view id, int32_t* selection, std::string_view text, int32_t count, std::string_view(*option)(int32_t), int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
+    void InvalidateDropDownOptions(int32_t id);
     bool BeginDropDown(int32_t id, std::string_view text, TextType type = TextType::PlainText, int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
     bool BeginDropDown(std::string_view id, std::string_view text, TextType type = TextType::PlainText, int32_t geometry = ToBottomRight, const NeighborWidgets& neighbors = NeighborWidgets{});
     void AddOption(std::string_view optionText, TextType type = TextType::PlainText, std::string_view prefix = "", ResourceType rt = RT_INVALID);
@@ -160,6 +176,56 @@ namespace glimmer
     WidgetDrawResult AddFilterRow();
     void PopulateItemGrid(int totalRows, ItemGridPopulateMethod method = ItemGridPopulateMethod::ByRows);
     WidgetDrawResult EndItemGrid();
+    // Visit selected ranges of item grid with given id (drawn in current context), enumeration
+    // stops when visitor returns false. Returns number of ranges visited.
+    int32_t EnumerateItemGridSelection(int32_t id, bool (*visitor)(const ItemGridSelectedRange&, void*), void* data = nullptr);
+    // Background sorting and filtering of item grid rows, see ItemGridConfig::cellkey
+    int32_t GetItemGridSourceRow(int32_t id, int32_t row); // Source row displayed at `row`
+    void InvalidateItemGridRows(int32_t id); // Sort and filter again, i.e. when data has changed
+    bool IsItemGridSortPending(int32_t id); // Previous order is displayed while a job is pending
+    // Rows of tree item grids (events, selection and `rowid` of callbacks) are positions in
+    // the flattened list of visible nodes, map them back to nodes with this
+    ItemGridTreeNode GetItemGridTreeNode(int32_t id, int32_t row);
+
+    // Asynchronous source of item grid rows, see ItemGridConfig::datasource
+    struct IItemGridDataSource
+    {
+        virtual ~IItemGridDataSource() = default;
+
+        // Request rows in [rowStart, rowEnd) and return immediately. Fetched rows are passed to
+        // deliver, which can be invoked from any thread, even after the grid is gone.
+        virtual void RequestRange(int32_t rowStart, int32_t rowEnd, ItemGridDeliverFn deliver) = 0;
+    };
+
+    // In-process data source, serves cells from a synchronous callback on its own thread after
+    // an artificial delay. Stand-in for remote/on-disk sources while testing.
+    struct LocalItemGridDataSource : public IItemGridDataSource
+    {
+        LocalItemGridDataSource(std::string(*cell)(int32_t, int16_t), int16_t columns, int32_t latencyMs);
+        ~LocalItemGridDataSource();
+
+        void RequestRange(int32_t rowStart, int32_t rowEnd, ItemGridDeliverFn deliver) override;
+
+    private:
+
+        struct PendingRequest
+        {
+            std::chrono::steady_clock::time_point due;
+            int32_t rowStart = 0, rowEnd = 0;
+            ItemGridDeliverFn deliver;
+        };
+
+        void Run();
+
+        std::string(*_cell)(int32_t, int16_t) = nullptr;
+        int16_t _columns = 0;
+        int32_t _latency = 0;
+        std::deque<PendingRequest> _requests;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        bool _exit = false;
+        std::thread _worker; // Must be last, started after other members are initialized
+    };
 
 #ifndef GLIMMER_DISABLE_PLOTS
     bool BeginPlot(std::string_view id, ImVec2 size = { FLT_MAX, FLT_MAX }, int32_t flags = 0);
@@ -0,0 +1,167 @@
+#include "benchmark.h"
+#include "../../src/im_font_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+
+namespace glimmer::bench
+{
+    static NullRenderer Renderer;
+    static TestPlatform* Platform = nullptr;
+    static ImVec2 Size;
+
+    struct FrameRunner
+    {
+        FrameFuncT frame = nullptr;
+        void* data = nullptr;
+    };
+
+    static FrameRunner Runner;
+
+    ImVec2 NullRenderer::GetTextSize(std::string_view text, void* fontptr, float sz, float wrapWidth)
+    {
+        auto lines = 1, longest = 0, current = 0;
+
+        for (auto ch : text)
+        {
+            if (ch == '\n') { ++lines; current = 0; }
+            else longest = std::max(longest, ++current);
+        }
+
+        auto width = (float)longest * sz * 0.5f;
+        if (wrapWidth > 0.f && width > wrapWidth)
+        {
+            lines += (int)(width / wrapWidth);
+            width = wrapWidth;
+        }
+
+        return ImVec2{ width, (float)lines * sz };
+    }
+
+    void Initialize(ImVec2 size)
+    {
+        Size = size;
+        auto& config = CreateUIConfig(false);
+        config.renderer = &Renderer;
+        Platform = InitTestPlatform(size);
+        config.platform = Platform;
+        Platform->CreateWindow({ .size = size, .title = "glimmer-bench", .targetFPS = 60 });
+
+        // Widgets resolve fonts while computing styles, even though text is measured by the renderer
+        ImGui::CreateContext();
+        ImGui::GetIO().IniFilename = nullptr;
+        FontDescriptor desc;
+        desc.sizes.push_back(config.defaultFontSz);
+        LoadDefaultFonts(&desc, 1, false);
+
+        Platform->PollEvents([](ImVec2, IPlatform&, void*) {
+            Runner.frame(Runner.data);
+            return true;
+        }, nullptr);
+    }
+
+    void RunFrames(FrameFuncT frame, void* data, int frames)
+    {
+        Runner = FrameRunner{ frame, data };
+
+        // Test platform renders a frame per queued event
+        for (auto idx = 0; idx < frames; ++idx)
+            Platform->PushMouseMoveEvent(ImVec2{ -1.f, -1.f });
+        Platform->NextFrame(frames);
+    }
+
+    ImVec2 WindowSize()
+    {
+        return Size;
+    }
+
+    bool WriteRects(std::string_view path, const std::vector<SolvedRect>& rects)
+    {
+        auto file = std::fopen(std::string{ path }.c_str(), "w");
+        if (file == nullptr) return false;
+
+        for (const auto& [key, rect] : rects)
+            std::fprintf(file, "%s %.2f %.2f %.2f %.2f\n", key.c_str(), rect.Min.x, rect.Min.y, rect.Max.x, rect.Max.y);
+
+        std::fclose(file);
+        return true;
+    }
+
+    bool ReadRects(std::string_view path, std::vector<SolvedRect>& rects)
+    {
+        auto file = std::fopen(std::string{ path }.c_str(), "r");
+        if (file == nullptr) return false;
+
+        char key[256];
+        ImRect rect;
+        while (std::fscanf(file, "%255s %f %f %f %f", key, &rect.Min.x, &rect.Min.y, &rect.Max.x, &rect.Max.y) == 5)
+            rects.push_back(SolvedRect{ key, rect });
+
+        std::fclose(file);
+        return true;
+    }
+
+    int CompareRects(const std::vector<SolvedRect>& expected, const std::vector<SolvedRect>& actual,
+        float tolerance, int maxReported)
+    {
+        std::unordered_map<std::string_view, ImRect> lookup;
+        for (const auto& [key, rect] : actual) lookup.emplace(key, rect);
+
+        auto mismatches = 0;
+        auto differs = [tolerance](float lhs, float rhs) { return std::fabs(lhs - rhs) > tolerance; };
+
+        for (const auto& [key, rect] : expected)
+        {
+            auto it = lookup.find(key);
+            auto missing = it == lookup.end();
+            if (!missing && !differs(rect.Min.x, it->second.Min.x) && !differs(rect.Min.y, it->second.Min.y) &&
+                !differs(rect.Max.x, it->second.Max.x) && !differs(rect.Max.y, it->second.Max.y))
+                continue;
+
+            if (mismatches++ >= maxReported) continue;
+            if (missing) std::printf("  %s: missing\n", key.c_str());
+            else std::printf("  %s: expected (%.1f, %.1f)-(%.1f, %.1f), got (%.1f, %.1f)-(%.1f, %.1f)\n",
+                key.c_str(), rect.Min.x, rect.Min.y, rect.Max.x, rect.Max.y, it->second.Min.x,
+                it->second.Min.y, it->second.Max.x, it->second.Max.y);
+        }
+
+        if (mismatches > maxReported) std::printf("  ... %d more\n", mismatches - maxReported);
+        return mismatches;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace glimmer::bench;
+
+    struct Benchmark
+    {
+        std::string_view name, usage;
+        int (*run)(const std::vector<std::string_view>&);
+    };
+
+    static const Benchmark benchmarks[] = {
+        { "layout", "layout [--items N] [--frames N] [--dump <file>] [--compare <file>]", &RunLayoutBenchmark },
+        { "conformance", "conformance [--dump <file>] [--compare <file>]", &RunFlexConformance },
+        { "css", "css [--iterations N] [--theme <file>]...", &RunCssBenchmark },
+        { "style", "style [--widgets N] [--reloads N] [--iterations N]", &RunStyleBenchmark },
+    };
+
+    std::string_view name = argc > 1 ? argv[1] : "";
+    std::vector<std::string_view> args(argv + std::min(argc, 2), argv + argc);
+
+    for (const auto& benchmark : benchmarks)
+    {
+        if (benchmark.name != name) continue;
+
+        Initialize(ImVec2{ 1280.f, 800.f });
+        return benchmark.run(args);
+    }
+
+    std::printf("Usage: %s <benchmark> [options]\n", argc > 0 ? argv[0] : "glimmer_bench");
+    for (const auto& benchmark : benchmarks)
+        std::printf("  %.*s\n", (int)benchmark.usage.size(), benchmark.usage.data());
+    return 1;
+}
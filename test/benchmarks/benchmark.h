@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+Benchmarks of glimmer's layout and style machinery, run headless on the test platform (see
+src/testing.h). Text is measured by a fixed per-character advance, so that solved geometry only
+depends on the layout engine, which is selected at compile time by GLIMMER_FLEXBOX_ENGINE. Hence
+the benchmark executable is built once per engine (see CMakeLists.txt), and geometry dumped by one
+build can be compared against another's.
+*/
+
+#include "../../src/glimmer.h"
+#include "../../src/testing.h"
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace glimmer::bench
+{
+    // Renders nothing, text is measured as `size * 0.5` per character and `size` per line
+    struct NullRenderer final : public IRenderer
+    {
+        RendererType Type() const override { return RendererType::Deferred; }
+
+        void SetClipRect(ImVec2 startpos, ImVec2 endpos, bool intersect) override {}
+        void ResetClipRect() override {}
+
+        void DrawLine(ImVec2 startpos, ImVec2 endpos, uint32_t color, float thickness) override {}
+        void DrawPolyline(ImVec2* points, int sz, uint32_t color, float thickness) override {}
+        void DrawTriangle(ImVec2 pos1, ImVec2 pos2, ImVec2 pos3, uint32_t color, bool filled, float thickness) override {}
+        void DrawRect(ImVec2 startpos, ImVec2 endpos, uint32_t color, bool filled, float thickness) override {}
+        void DrawRoundedRect(ImVec2 startpos, ImVec2 endpos, uint32_t color, bool filled, float topleftr, float toprightr,
+            float bottomrightr, float bottomleftr, float thickness) override {}
+        void DrawRectGradient(ImVec2 startpos, ImVec2 endpos, uint32_t colorfrom, uint32_t colorto, Direction dir) override {}
+        void DrawRoundedRectGradient(ImVec2 startpos, ImVec2 endpos, float topleftr, float toprightr, float bottomrightr,
+            float bottomleftr, uint32_t colorfrom, uint32_t colorto, Direction dir) override {}
+        void DrawPolygon(ImVec2* points, int sz, uint32_t color, bool filled, float thickness) override {}
+        void DrawPolyGradient(ImVec2* points, uint32_t* colors, int sz) override {}
+        void DrawCircle(ImVec2 center, float radius, uint32_t color, bool filled, float thickness) override {}
+        void DrawSector(ImVec2 center, float radius, int start, int end, uint32_t color, bool filled, bool inverted,
+            float thickness) override {}
+        void DrawRadialGradient(ImVec2 center, float radius, uint32_t in, uint32_t out, int start, int end) override {}
+
+        ImVec2 GetTextSize(std::string_view text, void* fontptr, float sz, float wrapWidth) override;
+        void DrawText(std::string_view text, ImVec2 pos, uint32_t color, float wrapWidth) override {}
+        void DrawTooltip(ImVec2 pos, std::string_view text) override {}
+    };
+
+    // Geometry of a widget solved by the layout engine, keyed by benchmark case and item index
+    struct SolvedRect
+    {
+        std::string key;
+        ImRect rect;
+    };
+
+    using FrameFuncT = void(*)(void* data);
+
+    // Sets up UI config, test platform and fonts, must be called once before running frames
+    void Initialize(ImVec2 size);
+    // Renders `frames` frames invoking `frame` to build the UI in each of them
+    void RunFrames(FrameFuncT frame, void* data, int frames);
+    [[nodiscard]] ImVec2 WindowSize();
+
+    [[nodiscard]] inline double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Dump of solved geometry, one `key x1 y1 x2 y2` line per rect
+    bool WriteRects(std::string_view path, const std::vector<SolvedRect>& rects);
+    bool ReadRects(std::string_view path, std::vector<SolvedRect>& rects);
+    // Reports rects which differ by more than `tolerance` (or are missing), returns number of mismatches
+    int CompareRects(const std::vector<SolvedRect>& expected, const std::vector<SolvedRect>& actual,
+        float tolerance, int maxReported = 20);
+
+    // Benchmark entry points, `args` excludes the executable and benchmark names
+    int RunLayoutBenchmark(const std::vector<std::string_view>& args);
+    int RunFlexConformance(const std::vector<std::string_view>& args);
+    int RunCssBenchmark(const std::vector<std::string_view>& args);
+    int RunStyleBenchmark(const std::vector<std::string_view>& args);
+}
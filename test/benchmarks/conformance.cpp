@@ -0,0 +1,223 @@
+#include "benchmark.h"
+
+#include <cstdio>
+#include <iterator>
+
+// Flexbox conformance cases, covering grow/shrink/wrap/alignment as used by BeginFlexLayout.
+// Reference geometry is produced by the Yoga build (`conformance --dump`), and other engines
+// are checked against it (`conformance --compare`), see CMakeLists.txt for the test setup.
+
+namespace glimmer::bench
+{
+    struct FlexCase;
+
+    struct FlexItem
+    {
+        float width = 0.f, height = 0.f; // Explicit size, 0 if determined by content
+        int32_t geometry = ToBottomRight;
+        std::string_view css; // Additional style i.e. margins or min/max sizes
+        const FlexCase* nested = nullptr; // Item is a nested (implicitly sized) layout instead of a label
+    };
+
+    struct FlexCase
+    {
+        std::string_view name;
+        Direction dir = DIR_Horizontal;
+        int32_t geometry = ToBottomRight;
+        bool wrap = false;
+        ImVec2 spacing;
+        ImVec2 size;
+        std::vector<FlexItem> items;
+    };
+
+    static const FlexCase NestedColumn{ "nested-column", DIR_Vertical, ToBottomRight, false, { 4.f, 4.f }, {},
+        { { 60.f, 20.f }, { 80.f, 20.f }, { 40.f, 20.f, ExpandH } } };
+
+    static const FlexCase FlexCases[] = {
+        { "row-fixed", DIR_Horizontal, ToBottomRight, false, {}, { 400.f, 100.f },
+            { { 100.f, 40.f }, { 100.f, 40.f }, { 100.f, 40.f } } },
+        { "row-gap", DIR_Horizontal, ToBottomRight, false, { 10.f, 10.f }, { 400.f, 100.f },
+            { { 100.f, 40.f }, { 50.f, 30.f }, { 100.f, 20.f } } },
+        { "row-gap-xy", DIR_Horizontal, ToBottomRight, false, { 12.f, 4.f }, { 400.f, 100.f },
+            { { 100.f, 40.f }, { 50.f, 30.f }, { 100.f, 20.f, ExpandH } } },
+        { "row-grow-one", DIR_Horizontal, ToBottomRight, false, {}, { 400.f, 100.f },
+            { { 100.f, 40.f }, { 100.f, 40.f, ExpandH }, { 100.f, 40.f } } },
+        { "row-grow-all", DIR_Horizontal, ToBottomRight, false, { 5.f, 5.f }, { 400.f, 100.f },
+            { { 50.f, 40.f, ExpandH }, { 100.f, 40.f, ExpandH }, { 150.f, 40.f, ExpandH } } },
+        { "row-grow-max", DIR_Horizontal, ToBottomRight, false, {}, { 400.f, 100.f },
+            { { 50.f, 40.f, ExpandH, "max-width: 120px;" }, { 50.f, 40.f, ExpandH }, { 100.f, 40.f } } },
+        { "row-shrink", DIR_Horizontal, ToBottomRight, false, {}, { 400.f, 100.f },
+            { { 120.f, 40.f, ShrinkH }, { 120.f, 40.f, ShrinkH }, { 120.f, 40.f, ShrinkH }, { 120.f, 40.f, ShrinkH },
+              { 120.f, 40.f, ShrinkH } } },
+        { "row-shrink-min", DIR_Horizontal, ToBottomRight, false, {}, { 400.f, 100.f },
+            { { 200.f, 40.f, ShrinkH, "min-width: 180px;" }, { 200.f, 40.f, ShrinkH }, { 200.f, 40.f, ShrinkH } } },
+        { "row-stretch", DIR_Horizontal, ToBottomRight, false, {}, { 400.f, 100.f },
+            { { 100.f, 40.f }, { 100.f, 0.f, ExpandV }, { 100.f, 60.f } } },
+        { "row-wrap", DIR_Horizontal, ToBottomRight, true, { 5.f, 5.f }, { 400.f, 200.f },
+            { { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 40.f },
+              { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 50.f }, { 90.f, 30.f } } },
+        { "row-wrap-grow", DIR_Horizontal, ToBottomRight, true, { 5.f, 5.f }, { 400.f, 200.f },
+            { { 150.f, 30.f, ExpandH }, { 150.f, 30.f }, { 150.f, 30.f, ExpandH }, { 100.f, 30.f }, { 100.f, 30.f, ExpandH } } },
+        { "row-wrap-xy", DIR_Horizontal, ToBottomRight, true, { 12.f, 4.f }, { 400.f, 200.f },
+            { { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 40.f }, { 90.f, 30.f },
+              { 90.f, 50.f }, { 90.f, 30.f } } },
+        { "row-wrap-yx", DIR_Horizontal, ToBottomRight, true, { 3.f, 9.f }, { 400.f, 200.f },
+            { { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 30.f }, { 90.f, 40.f }, { 90.f, 30.f, ExpandH },
+              { 90.f, 50.f }, { 90.f, 30.f } } },
+        { "row-center", DIR_Horizontal, AlignHCenter | AlignVCenter, false, {}, { 400.f, 100.f },
+            { { 100.f, 40.f }, { 50.f, 20.f } } },
+        { "row-end", DIR_Horizontal, AlignRight | AlignBottom, false, {}, { 400.f, 100.f },
+            { { 100.f, 40.f }, { 50.f, 20.f } } },
+        { "row-justify", DIR_Horizontal, AlignJustify, false, {}, { 400.f, 100.f },
+            { { 50.f, 40.f }, { 50.f, 40.f }, { 50.f, 40.f } } },
+        { "row-margins", DIR_Horizontal, ToBottomRight, false, {}, { 400.f, 100.f },
+            { { 100.f, 40.f, ToBottomRight, "margin: 5px;" }, { 100.f, 40.f, ExpandH, "margin: 0px 10px;" }, { 50.f, 40.f } } },
+        { "column-fixed", DIR_Vertical, ToBottomRight, false, { 4.f, 4.f }, { 200.f, 300.f },
+            { { 100.f, 40.f }, { 150.f, 40.f }, { 50.f, 40.f } } },
+        { "column-gap-xy", DIR_Vertical, ToBottomRight, false, { 3.f, 9.f }, { 200.f, 300.f },
+            { { 100.f, 40.f }, { 150.f, 40.f, ExpandV }, { 50.f, 40.f } } },
+        { "column-grow", DIR_Vertical, ToBottomRight, false, {}, { 200.f, 300.f },
+            { { 100.f, 40.f }, { 100.f, 40.f, ExpandV }, { 100.f, 40.f, ExpandH } } },
+        { "column-wrap", DIR_Vertical, ToBottomRight, true, { 5.f, 5.f }, { 300.f, 200.f },
+            { { 80.f, 50.f }, { 80.f, 50.f }, { 60.f, 50.f }, { 80.f, 50.f }, { 80.f, 70.f }, { 80.f, 50.f },
+              { 40.f, 50.f }, { 80.f, 50.f } } },
+        { "column-wrap-xy", DIR_Vertical, ToBottomRight, true, { 12.f, 4.f }, { 300.f, 200.f },
+            { { 80.f, 50.f }, { 80.f, 50.f }, { 60.f, 50.f }, { 80.f, 50.f }, { 80.f, 70.f }, { 80.f, 50.f },
+              { 40.f, 50.f }, { 80.f, 50.f } } },
+        { "column-wrap-yx", DIR_Vertical, ToBottomRight, true, { 3.f, 9.f }, { 300.f, 200.f },
+            { { 80.f, 50.f }, { 80.f, 50.f }, { 60.f, 50.f }, { 80.f, 50.f }, { 80.f, 70.f }, { 80.f, 50.f, ExpandV },
+              { 40.f, 50.f }, { 80.f, 50.f } } },
+        { "column-center", DIR_Vertical, AlignHCenter | AlignVCenter, false, {}, { 200.f, 300.f },
+            { { 100.f, 40.f }, { 150.f, 40.f } } },
+        { "nested", DIR_Horizontal, ToBottomRight, false, { 8.f, 8.f }, { 400.f, 200.f },
+            { { 100.f, 40.f }, { 0.f, 0.f, ToBottomRight, {}, &NestedColumn }, { 50.f, 40.f, ExpandH } } },
+    };
+
+    struct ConformanceData
+    {
+        std::vector<int32_t> labels; // Labels of every case, in order of rendering
+        std::vector<std::string> styles;
+        int32_t offsets[std::size(FlexCases) + 1];
+        int32_t current = 0, next = 0;
+        std::vector<SolvedRect> rects;
+        bool capture = false;
+    };
+
+    static void PrepareCase(ConformanceData& data, const FlexCase& flex)
+    {
+        for (const auto& item : flex.items)
+        {
+            if (item.nested != nullptr)
+            {
+                PrepareCase(data, *item.nested);
+                continue;
+            }
+
+            auto id = GetNextId(WT_Label);
+            CreateWidgetConfig(id).state.label.text = "x";
+            data.labels.push_back(id);
+
+            auto& css = data.styles.emplace_back("margin: 0px; padding: 0px; border: none;");
+            if (item.width > 0.f) css.append(" width: ").append(std::to_string(item.width)).append("px;");
+            if (item.height > 0.f) css.append(" height: ").append(std::to_string(item.height)).append("px;");
+            css.append(" ").append(item.css);
+        }
+    }
+
+    static void RenderCase(ConformanceData& data, const FlexCase& flex)
+    {
+        BeginFlexLayout(flex.dir, flex.geometry, flex.wrap, flex.spacing, flex.size);
+
+        for (const auto& item : flex.items)
+        {
+            if (item.nested != nullptr)
+            {
+                RenderCase(data, *item.nested);
+                continue;
+            }
+
+            PushStyle(data.styles[data.next]);
+            Label(data.labels[data.next], item.geometry);
+            PopStyle();
+            ++data.next;
+        }
+
+        EndLayout();
+    }
+
+    static void RenderConformanceCase(void* ptr)
+    {
+        auto& data = *(ConformanceData*)ptr;
+        const auto& flex = FlexCases[data.current];
+        auto from = data.offsets[data.current], to = data.offsets[data.current + 1];
+
+        data.next = from;
+        RenderCase(data, flex);
+        if (!data.capture) return;
+
+        for (auto idx = from; idx < to; ++idx)
+        {
+            std::string key{ flex.name };
+            key.append("/").append(std::to_string(idx - from));
+            data.rects.push_back(SolvedRect{ std::move(key), ICustomWidget::GetBounds(data.labels[idx]) });
+        }
+    }
+
+    int RunFlexConformance(const std::vector<std::string_view>& args)
+    {
+        std::string_view dumpPath, comparePath;
+
+        for (auto idx = 0; idx + 1 < (int)args.size(); idx += 2)
+        {
+            if (args[idx] == "--dump") dumpPath = args[idx + 1];
+            else if (args[idx] == "--compare") comparePath = args[idx + 1];
+        }
+
+        static ConformanceData data;
+        data.styles.reserve(256);
+
+        for (auto idx = 0; idx < (int)std::size(FlexCases); ++idx)
+        {
+            data.offsets[idx] = (int32_t)data.labels.size();
+            PrepareCase(data, FlexCases[idx]);
+        }
+
+        data.offsets[std::size(FlexCases)] = (int32_t)data.labels.size();
+
+        // Second frame is captured, so that results do not depend on first frame measurements
+        for (data.current = 0; data.current < (int)std::size(FlexCases); ++data.current)
+        {
+            data.capture = false;
+            RunFrames(&RenderConformanceCase, &data, 1);
+            data.capture = true;
+            RunFrames(&RenderConformanceCase, &data, 1);
+        }
+
+        const auto& engine = GetLayoutStats().engine;
+        std::printf("%d flexbox cases, %d items solved with %.*s engine\n", (int)std::size(FlexCases),
+            (int)data.rects.size(), (int)engine.size(), engine.data());
+
+        if (!dumpPath.empty() && !WriteRects(dumpPath, data.rects))
+        {
+            std::printf("Failed to write %.*s\n", (int)dumpPath.size(), dumpPath.data());
+            return 1;
+        }
+
+        if (!comparePath.empty())
+        {
+            std::vector<SolvedRect> expected;
+            if (!ReadRects(comparePath, expected))
+            {
+                std::printf("Failed to read %.*s\n", (int)comparePath.size(), comparePath.data());
+                return 1;
+            }
+
+            auto mismatches = CompareRects(expected, data.rects, 0.5f, (int)expected.size());
+            std::printf("%d of %d items differ from %.*s\n", mismatches, (int)expected.size(),
+                (int)comparePath.size(), comparePath.data());
+            return mismatches == 0 ? 0 : 1;
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,204 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+// CSS parsing over theme files (test/benchmarks/themes by default):
+// parse    - Declaration blocks parsed by StyleDescriptor::From, with the style cache cleared every pass
+// cached   - Same blocks once the style cache is warm i.e. cost of a PushStyle with known CSS
+// theme    - Full LoadTheme of the file with a cold style cache, alternating with an empty theme so that
+//            all rules are reapplied
+// lookup   - Property names and value tokens looked up in the perfect hash tables (cssliteral.h)
+
+#ifndef GLIMMER_BENCHMARK_THEMES_DIR
+#define GLIMMER_BENCHMARK_THEMES_DIR "test/benchmarks/themes"
+#endif
+
+namespace glimmer::bench
+{
+    struct ThemeCorpus
+    {
+        std::string path;
+        std::string content;
+        std::vector<std::string_view> blocks; // Contents of { ... }
+        std::vector<std::string_view> properties;
+        std::vector<std::string_view> tokens; // Space separated tokens of property values
+    };
+
+    static std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && std::isspace((unsigned char)text.front())) text.remove_prefix(1);
+        while (!text.empty() && std::isspace((unsigned char)text.back())) text.remove_suffix(1);
+        return text;
+    }
+
+    static bool LoadCorpus(const std::string& path, ThemeCorpus& corpus)
+    {
+        std::ifstream file{ path, std::ios::binary };
+        if (!file) return false;
+
+        corpus.path = path;
+        corpus.content.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        // Comments are blanked out (not removed) so that blocks remain views into the content
+        for (auto start = corpus.content.find("/*"); start != std::string::npos; start = corpus.content.find("/*", start))
+        {
+            auto end = corpus.content.find("*/", start + 2u);
+            end = end == std::string::npos ? corpus.content.size() : end + 2u;
+            std::fill(corpus.content.begin() + (std::ptrdiff_t)start, corpus.content.begin() + (std::ptrdiff_t)end, ' ');
+        }
+
+        std::string_view text{ corpus.content };
+        for (auto open = text.find('{'); open != std::string_view::npos; open = text.find('{', open))
+        {
+            auto close = text.find('}', open);
+            if (close == std::string_view::npos) break;
+
+            auto block = Trim(text.substr(open + 1u, close - open - 1u));
+            corpus.blocks.push_back(block);
+            open = close;
+
+            while (!block.empty())
+            {
+                auto semicolon = block.find(';');
+                auto declaration = block.substr(0, semicolon);
+                block = semicolon == std::string_view::npos ? std::string_view{} : block.substr(semicolon + 1u);
+
+                auto colon = declaration.find(':');
+                if (colon == std::string_view::npos) continue;
+                corpus.properties.push_back(Trim(declaration.substr(0, colon)));
+
+                auto value = Trim(declaration.substr(colon + 1u));
+                for (auto from = 0; from < (int)value.size();)
+                {
+                    auto to = NextCSSToken(value, from);
+                    if (to > from) corpus.tokens.push_back(value.substr(from, to - from));
+                    from = to + 1;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    static void ReportPhase(std::string_view phase, double elapsedMs, int iterations, size_t bytes, size_t ops)
+    {
+        auto perIteration = elapsedMs * 1000.0 / (double)iterations;
+        auto mbps = ((double)bytes * (double)iterations) / (elapsedMs * 1000.0);
+        std::printf("  %-8.*s %12.2f %10.2f %12.1f\n", (int)phase.size(), phase.data(), perIteration, mbps,
+            perIteration * 1000.0 / (double)std::max<size_t>(ops, 1u));
+    }
+
+    static void RunCorpus(const ThemeCorpus& corpus, const std::string& emptyTheme, int iterations)
+    {
+        size_t blockBytes = 0;
+        for (auto block : corpus.blocks) blockBytes += block.size();
+
+        std::printf("%s: %d bytes, %d blocks, %d declarations\n", corpus.path.c_str(), (int)corpus.content.size(),
+            (int)corpus.blocks.size(), (int)corpus.properties.size());
+        std::printf("  %-8s %12s %10s %12s\n", "phase", "us/pass", "MB/s", "ns/op");
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto it = 0; it < iterations; ++it)
+        {
+            ClearStyleCache();
+            for (auto block : corpus.blocks)
+                StyleDescriptor{}.From(block, false);
+        }
+        ReportPhase("parse", ElapsedMs(start), iterations, blockBytes, corpus.blocks.size());
+
+        ClearStyleCache();
+        for (auto block : corpus.blocks) StyleDescriptor{}.From(block, false);
+
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0; it < iterations; ++it)
+            for (auto block : corpus.blocks)
+                StyleDescriptor{}.From(block, false);
+        ReportPhase("cached", ElapsedMs(start), iterations, blockBytes, corpus.blocks.size());
+
+        auto stats = GetStyleCacheStats();
+        std::printf("  cache    %lld hits, %lld misses, %.1f us parsing\n", (long long)stats.hits,
+            (long long)stats.misses, stats.parseTimeUs);
+
+        auto elapsed = 0.0;
+        for (auto it = 0; it < iterations; ++it)
+        {
+            ClearStyleCache();
+            LoadTheme(emptyTheme);
+            start = std::chrono::steady_clock::now();
+            LoadTheme(corpus.path);
+            elapsed += ElapsedMs(start);
+        }
+        ReportPhase("theme", elapsed, iterations, corpus.content.size(), corpus.blocks.size());
+
+        // Results are accumulated so that lookups are not optimized away
+        auto found = 0;
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0; it < iterations; ++it)
+        {
+            for (auto property : corpus.properties)
+                found += GetCSSProperty(property) != CSSProperty::Unknown ? 1 : 0;
+            for (auto token : corpus.tokens)
+                found += GetCSSKeyword(token) != CSSKeyword::Unknown ? 1 : 0;
+        }
+
+        size_t lookupBytes = 0;
+        for (auto property : corpus.properties) lookupBytes += property.size();
+        for (auto token : corpus.tokens) lookupBytes += token.size();
+        ReportPhase("lookup", ElapsedMs(start), iterations, lookupBytes, corpus.properties.size() + corpus.tokens.size());
+        std::printf("  %d of %d identifiers known\n\n", found / std::max(iterations, 1),
+            (int)(corpus.properties.size() + corpus.tokens.size()));
+
+        LoadTheme(emptyTheme);
+    }
+
+    int RunCssBenchmark(const std::vector<std::string_view>& args)
+    {
+        std::vector<std::string> themes;
+        int iterations = 200;
+
+        for (auto idx = 0; idx + 1 < (int)args.size(); idx += 2)
+        {
+            if (args[idx] == "--theme") themes.emplace_back(args[idx + 1]);
+            else if (args[idx] == "--iterations")
+                std::from_chars(args[idx + 1].data(), args[idx + 1].data() + args[idx + 1].size(), iterations);
+        }
+
+        if (themes.empty())
+        {
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator{ GLIMMER_BENCHMARK_THEMES_DIR, ec })
+                if (entry.path().extension() == ".css") themes.push_back(entry.path().string());
+            std::sort(themes.begin(), themes.end());
+        }
+
+        if (themes.empty() || iterations <= 0)
+        {
+            std::printf("No themes found in %s\n", GLIMMER_BENCHMARK_THEMES_DIR);
+            return 1;
+        }
+
+        // Loading an empty theme removes all rules, so that the next load reapplies every rule
+        auto emptyTheme = (std::filesystem::temp_directory_path() / "glimmer_bench_empty.css").string();
+        std::ofstream{ emptyTheme, std::ios::trunc };
+
+        for (const auto& path : themes)
+        {
+            ThemeCorpus corpus;
+            if (!LoadCorpus(path, corpus))
+            {
+                std::printf("Failed to read %s\n", path.c_str());
+                return 1;
+            }
+
+            RunCorpus(corpus, emptyTheme, iterations);
+        }
+
+        std::filesystem::remove(emptyTheme);
+        return 0;
+    }
+}
@@ -0,0 +1,275 @@
+#include "benchmark.h"
+
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+
+// Canonical layouts, each rendered with 100/1k/10k labels of varying text length:
+// flex     - Wrapping horizontal flex layout
+// mixed    - Wrapping justified flex layout, items alternate between grow, shrink and cross-axis alignment
+// grid     - Grid layout of 10 columns, auto-sized rows
+// region   - Vertical flex layout of 10 flex regions, each wrapping its share of items
+// splitter - Split region of 4 panes, each a vertical flex layout of its share of items
+// Per-phase cost is reported from GetLayoutStats, averaged over rendered frames. Frames are identical,
+// hence each case is run cold (cached solutions dropped every frame by InvalidateLayout, so that the
+// engine solves every layout) and warm (solutions reused from the layout cache).
+
+namespace glimmer::bench
+{
+    enum class LayoutKind { Flex, Mixed, Grid, Region, Splitter };
+
+    struct LayoutCase
+    {
+        std::string_view name;
+        LayoutKind kind;
+        int32_t items = 0;
+    };
+
+    constexpr int32_t RegionCount = 10;
+    constexpr int32_t SplitPanes = 4;
+    constexpr int32_t GridColumns = 10;
+
+    struct LayoutBenchmarkData
+    {
+        LayoutCase current;
+        std::vector<int32_t> labels;
+        std::vector<std::string> texts;
+        int32_t regions[RegionCount];
+        int32_t splitter = -1;
+
+        LayoutPhaseStats total;
+        std::vector<SolvedRect> rects;
+        bool capture = false;
+        bool cold = false;
+    };
+
+    static void Accumulate(LayoutPhaseStats& total)
+    {
+        // Stats are also reset by the platform periodically, hence collected every frame
+        const auto& stats = GetLayoutStats();
+        total.engine = stats.engine;
+        total.measure += stats.measure;
+        total.solve += stats.solve;
+        total.align += stats.align;
+        total.replay += stats.replay;
+        total.allocations += stats.allocations;
+        total.layouts += stats.layouts;
+        total.items += stats.items;
+        total.solves += stats.solves;
+        total.cacheHits += stats.cacheHits;
+        ResetLayoutStats();
+    }
+
+    static void CaptureRects(LayoutBenchmarkData& data, std::string_view scope, int32_t from, int32_t to)
+    {
+        if (!data.capture) return;
+
+        for (auto idx = from; idx < to; ++idx)
+        {
+            std::string key{ data.current.name };
+            key.append("/").append(scope).append("/").append(std::to_string(idx));
+            data.rects.push_back(SolvedRect{ std::move(key), ICustomWidget::GetBounds(data.labels[idx]) });
+        }
+    }
+
+    static void AddLabels(LayoutBenchmarkData& data, int32_t from, int32_t to)
+    {
+        for (auto idx = from; idx < to; ++idx)
+            Label(data.labels[idx]);
+    }
+
+    static void RenderLayoutCase(void* ptr)
+    {
+        auto& data = *(LayoutBenchmarkData*)ptr;
+        auto count = data.current.items;
+        if (data.cold) InvalidateLayout();
+        PushStyle("padding: 2px; margin: 1px; border: 1px solid black;");
+
+        switch (data.current.kind)
+        {
+        case LayoutKind::Flex:
+            BeginFlexLayout(DIR_Horizontal, ExpandAll, true, ImVec2{ 4.f, 4.f });
+            AddLabels(data, 0, count);
+            EndLayout();
+            CaptureRects(data, "item", 0, count);
+            break;
+
+        case LayoutKind::Mixed:
+        {
+            constexpr int32_t geometries[] = { ToBottomRight | ExpandH, ToBottomRight, ToBottomRight | ShrinkH,
+                ToBottomRight | AlignVCenter, ToBottomRight | ExpandH | ExpandV };
+            BeginFlexLayout(DIR_Horizontal, ExpandAll | AlignJustify, true, ImVec2{ 4.f, 4.f });
+            for (auto idx = 0; idx < count; ++idx)
+                Label(data.labels[idx], geometries[idx % (int32_t)std::size(geometries)]);
+            EndLayout();
+            CaptureRects(data, "item", 0, count);
+            break;
+        }
+
+        case LayoutKind::Grid:
+            BeginGridLayout((count + GridColumns - 1) / GridColumns, GridColumns, GridLayoutDirection::ByRows,
+                ExpandAll, {}, {}, ImVec2{ 4.f, 4.f });
+            AddLabels(data, 0, count);
+            EndLayout();
+            CaptureRects(data, "item", 0, count);
+            break;
+
+        case LayoutKind::Region:
+        {
+            auto share = count / RegionCount;
+            BeginFlexLayout(DIR_Vertical, ExpandAll, false, ImVec2{ 4.f, 4.f });
+
+            for (auto region = 0; region < RegionCount; ++region)
+            {
+                BeginFlexRegion(data.regions[region], DIR_Horizontal, ImVec2{ 4.f, 4.f }, true, 0, ExpandH);
+                BeginFlexLayout(DIR_Horizontal, ExpandH, true, ImVec2{ 4.f, 4.f });
+                AddLabels(data, region * share, (region + 1) * share);
+                EndLayout();
+
+                // Geometry of region contents is relative to the region
+                CaptureRects(data, "region" + std::to_string(region), region * share, (region + 1) * share);
+                EndRegion();
+            }
+
+            EndLayout();
+            if (data.capture)
+            {
+                for (auto region = 0; region < RegionCount; ++region)
+                    data.rects.push_back(SolvedRect{ std::string{ data.current.name } + "/region/" + std::to_string(region),
+                        ICustomWidget::GetBounds(data.regions[region]) });
+            }
+            break;
+        }
+
+        case LayoutKind::Splitter:
+        {
+            auto share = count / SplitPanes;
+            BeginSplitRegion(data.splitter, DIR_Horizontal, {
+                SplitRegion{ .min = 0.1f, .max = 0.7f, .initial = 0.25f }, SplitRegion{ .min = 0.1f, .max = 0.7f, .initial = 0.25f },
+                SplitRegion{ .min = 0.1f, .max = 0.7f, .initial = 0.25f }, SplitRegion{ .min = 0.1f, .max = 0.7f, .initial = 0.25f } },
+                ExpandAll);
+
+            for (auto pane = 0; pane < SplitPanes; ++pane)
+            {
+                if (pane > 0) NextSplitRegion();
+                BeginFlexLayout(DIR_Vertical, ExpandAll, true, ImVec2{ 4.f, 4.f });
+                AddLabels(data, pane * share, (pane + 1) * share);
+                EndLayout();
+                CaptureRects(data, "pane" + std::to_string(pane), pane * share, (pane + 1) * share);
+            }
+
+            EndSplitRegion();
+            break;
+        }
+        }
+
+        PopStyle();
+        Accumulate(data.total);
+    }
+
+    static int32_t ParseCount(std::string_view value, int32_t fallback)
+    {
+        auto result = fallback;
+        std::from_chars(value.data(), value.data() + value.size(), result);
+        return result;
+    }
+
+    int RunLayoutBenchmark(const std::vector<std::string_view>& args)
+    {
+        std::string_view dumpPath, comparePath;
+        int32_t frames = 20, onlyItems = -1;
+
+        for (auto idx = 0; idx + 1 < (int)args.size(); idx += 2)
+        {
+            if (args[idx] == "--frames") frames = ParseCount(args[idx + 1], frames);
+            else if (args[idx] == "--items") onlyItems = ParseCount(args[idx + 1], onlyItems);
+            else if (args[idx] == "--dump") dumpPath = args[idx + 1];
+            else if (args[idx] == "--compare") comparePath = args[idx + 1];
+        }
+
+        static const LayoutCase cases[] = {
+            { "flex-100", LayoutKind::Flex, 100 }, { "flex-1k", LayoutKind::Flex, 1000 }, { "flex-10k", LayoutKind::Flex, 10000 },
+            { "mixed-100", LayoutKind::Mixed, 100 }, { "mixed-1k", LayoutKind::Mixed, 1000 }, { "mixed-10k", LayoutKind::Mixed, 10000 },
+            { "grid-100", LayoutKind::Grid, 100 }, { "grid-1k", LayoutKind::Grid, 1000 }, { "grid-10k", LayoutKind::Grid, 10000 },
+            { "region-100", LayoutKind::Region, 100 }, { "region-1k", LayoutKind::Region, 1000 }, { "region-10k", LayoutKind::Region, 10000 },
+            { "splitter-100", LayoutKind::Splitter, 100 }, { "splitter-1k", LayoutKind::Splitter, 1000 },
+            { "splitter-10k", LayoutKind::Splitter, 10000 },
+        };
+
+        // Labels are shared by all cases, their text length varies so that items are of different sizes
+        static LayoutBenchmarkData data;
+        data.texts.reserve(10000);
+        for (auto idx = 0; idx < 10000; ++idx)
+        {
+            data.texts.push_back("Item " + std::string((size_t)(idx * 7) % 13, 'x') + std::to_string(idx));
+            data.labels.push_back(GetNextId(WT_Label));
+            CreateWidgetConfig(data.labels.back()).state.label.text = data.texts.back();
+        }
+
+        for (auto& region : data.regions)
+        {
+            region = GetNextId(WT_Region);
+            CreateWidgetConfig(region);
+        }
+
+        data.splitter = GetNextId(WT_Splitter);
+        CreateWidgetConfig(data.splitter);
+
+        std::printf("%-14s %6s %5s %10s %10s %10s %10s %10s %8s %8s %8s\n", "case", "engine", "mode", "frame(ms)",
+            "measure", "solve", "align", "replay", "allocs", "solves", "hits");
+
+        for (const auto& current : cases)
+        {
+            if (onlyItems != -1 && current.items != onlyItems) continue;
+
+            data.current = current;
+            data.capture = false;
+
+            for (auto cold : { true, false })
+            {
+                data.cold = cold;
+                RunFrames(&RenderLayoutCase, &data, 1); // Warm up widget states (and layout cache if warm)
+                data.total = LayoutPhaseStats{};
+
+                auto start = std::chrono::steady_clock::now();
+                RunFrames(&RenderLayoutCase, &data, frames);
+                auto elapsed = ElapsedMs(start);
+
+                const auto& total = data.total;
+                auto perFrame = 1.f / (float)frames;
+                std::printf("%-14.*s %6.*s %5s %10.3f %10.3f %10.3f %10.3f %10.3f %8d %8d %8d\n", (int)current.name.size(),
+                    current.name.data(), (int)total.engine.size(), total.engine.data(), cold ? "cold" : "warm",
+                    elapsed / (double)frames, total.measure * perFrame, total.solve * perFrame, total.align * perFrame,
+                    total.replay * perFrame, (int)((float)total.allocations * perFrame),
+                    (int)((float)total.solves * perFrame), (int)((float)total.cacheHits * perFrame));
+            }
+
+            data.cold = false;
+            data.capture = true;
+            RunFrames(&RenderLayoutCase, &data, 1);
+        }
+
+        if (!dumpPath.empty() && !WriteRects(dumpPath, data.rects))
+        {
+            std::printf("Failed to write %.*s\n", (int)dumpPath.size(), dumpPath.data());
+            return 1;
+        }
+
+        if (!comparePath.empty())
+        {
+            std::vector<SolvedRect> expected;
+            if (!ReadRects(comparePath, expected))
+            {
+                std::printf("Failed to read %.*s\n", (int)comparePath.size(), comparePath.data());
+                return 1;
+            }
+
+            // Engines are expected to differ, differences are reported but do not fail the benchmark
+            std::printf("Geometry differences against %.*s:\n", (int)comparePath.size(), comparePath.data());
+            auto mismatches = CompareRects(expected, data.rects, 0.5f);
+            std::printf("%d of %d rects differ\n", mismatches, (int)expected.size());
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,190 @@
+#include "benchmark.h"
+#include "../../src/context.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+
+// Per widget style storage and copies, for labels styled by id and class rules of a theme:
+// memory   - Compact styles (CompactStyle per state + pool words) vs. expanded StyleDescriptor per state
+// reload   - Compact style pool size across theme reloads, which should stay bounded
+// resolve  - GetStyle for every widget and state, with resolved styles invalidated (cold) and cached (warm)
+// copy     - CopyStyle (inheritance from default state) vs. StyleDescriptor assignment vs. expanding
+//            a compact style, per style
+
+#ifndef GLIMMER_BENCHMARK_THEMES_DIR
+#define GLIMMER_BENCHMARK_THEMES_DIR "test/benchmarks/themes"
+#endif
+
+namespace glimmer
+{
+    void CopyStyle(const StyleDescriptor& src, StyleDescriptor& dest);
+}
+
+namespace glimmer::bench
+{
+    constexpr int32_t ResolvedStates[] = { WS_Default, WS_Hovered, WS_Pressed, WS_Focused, WS_Disabled };
+
+    struct StyleBenchmarkData
+    {
+        std::vector<std::string> names; // "#item<n> .card .row-odd" etc.
+        std::vector<int32_t> labels; // Recorded as named ids are created
+        int32_t iterations = 100;
+        bool measure = false;
+    };
+
+    static void RenderLabels(StyleBenchmarkData& data)
+    {
+        BeginFlexLayout(DIR_Horizontal, ExpandAll, true, ImVec2{ 4.f, 4.f });
+
+        for (const auto& name : data.names)
+            Label(name, "Item");
+
+        EndLayout();
+    }
+
+    static void MeasureStyles(StyleBenchmarkData& data)
+    {
+        auto& context = GetContext();
+        auto count = (int64_t)data.labels.size() * (int64_t)std::size(ResolvedStates);
+        auto sink = 0u;
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto id : data.labels)
+        {
+            context.InvalidateResolvedStyles(id);
+            for (auto state : ResolvedStates)
+                sink += context.GetStyle(state, id).bgcolor;
+        }
+        auto cold = ElapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0; it < data.iterations; ++it)
+            for (auto id : data.labels)
+                for (auto state : ResolvedStates)
+                    sink += context.GetStyle(state, id).bgcolor;
+        auto warm = ElapsedMs(start) / (double)data.iterations;
+
+        std::printf("resolve  %10.1f ns/style cold, %10.1f ns/style warm (%d widgets x %d states)\n",
+            cold * 1e6 / (double)count, warm * 1e6 / (double)count, (int)data.labels.size(), (int)std::size(ResolvedStates));
+
+        // Copies of styles resolved for the theme, so that sources have a realistic mix of properties
+        std::vector<StyleDescriptor> sources;
+        std::vector<CompactStyle> compact;
+        for (auto id : data.labels)
+        {
+            for (auto state : ResolvedStates)
+            {
+                sources.push_back(context.GetStyle(state, id));
+                compact.emplace_back(sources.back());
+            }
+        }
+
+        auto total = (int64_t)sources.size() * data.iterations;
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0; it < data.iterations; ++it)
+        {
+            for (const auto& src : sources)
+            {
+                StyleDescriptor dest;
+                CopyStyle(src, dest);
+                sink += dest.fgcolor;
+            }
+        }
+        auto copy = ElapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0; it < data.iterations; ++it)
+        {
+            for (const auto& src : sources)
+            {
+                StyleDescriptor dest;
+                dest = src;
+                sink += dest.fgcolor;
+            }
+        }
+        auto assign = ElapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0; it < data.iterations; ++it)
+        {
+            for (const auto& src : compact)
+            {
+                StyleDescriptor dest;
+                dest.From(src);
+                sink += dest.fgcolor;
+            }
+        }
+        auto expand = ElapsedMs(start);
+
+        std::printf("copy     %10.1f ns/style CopyStyle, %10.1f ns/style assignment, %10.1f ns/style from compact\n",
+            copy * 1e6 / (double)total, assign * 1e6 / (double)total, expand * 1e6 / (double)total);
+        std::printf("(checksum %u)\n", sink);
+    }
+
+    static void RenderStyleCase(void* ptr)
+    {
+        auto& data = *(StyleBenchmarkData*)ptr;
+        RenderLabels(data);
+        if (data.measure) MeasureStyles(data);
+    }
+
+    static void ReportMemory(const StyleBenchmarkData& data, std::string_view when)
+    {
+        auto states = (int64_t)WSI_Total * (int64_t)data.labels.size();
+        auto pool = CompactStylePoolSize();
+        auto compact = states * (int64_t)sizeof(CompactStyle) + pool;
+        auto expanded = states * (int64_t)sizeof(StyleDescriptor);
+        std::printf("memory   %-14.*s compact %8.1f KB (pool %8.1f KB), expanded %8.1f KB, %5.1fx smaller, %4d resolved styles\n",
+            (int)when.size(), when.data(), (double)compact / 1024.0, (double)pool / 1024.0, (double)expanded / 1024.0,
+            (double)expanded / (double)std::max<int64_t>(compact, 1), (int)GetContext().resolvedStyles.size());
+    }
+
+    static StyleBenchmarkData StyleData;
+
+    int RunStyleBenchmark(const std::vector<std::string_view>& args)
+    {
+        int32_t widgets = 5000, reloads = 20;
+        auto& data = StyleData;
+        GetUIConfig().RecordWidgetId = [](std::string_view, int32_t id) { StyleData.labels.push_back(id); };
+
+        for (auto idx = 0; idx + 1 < (int)args.size(); idx += 2)
+        {
+            auto value = args[idx + 1];
+            if (args[idx] == "--widgets") std::from_chars(value.data(), value.data() + value.size(), widgets);
+            else if (args[idx] == "--reloads") std::from_chars(value.data(), value.data() + value.size(), reloads);
+            else if (args[idx] == "--iterations") std::from_chars(value.data(), value.data() + value.size(), data.iterations);
+        }
+
+        std::string themes[2] = { GLIMMER_BENCHMARK_THEMES_DIR "/light.css", GLIMMER_BENCHMARK_THEMES_DIR "/dark.css" };
+        if (!LoadTheme(themes[0])) return 1;
+
+        static constexpr std::string_view classes[] = { " .card", " .row-odd", " .row-even .muted", " .primary",
+            " .badge", "", " .numeric .row-odd", " .danger" };
+        data.names.reserve(widgets);
+        for (auto idx = 0; idx < widgets; ++idx)
+            data.names.push_back("#item" + std::to_string(idx) + std::string{ classes[idx % (int)std::size(classes)] });
+
+        std::printf("%d labels, sizeof(StyleDescriptor) = %d, sizeof(CompactStyle) = %d, %d states\n", widgets,
+            (int)sizeof(StyleDescriptor), (int)sizeof(CompactStyle), (int)WSI_Total);
+
+        RunFrames(&RenderStyleCase, &data, 2);
+        ReportMemory(data, "initial");
+
+        auto peak = CompactStylePoolSize();
+        for (auto reload = 0; reload < reloads; ++reload)
+        {
+            if (!LoadTheme(themes[(reload + 1) % 2])) return 1;
+            RunFrames(&RenderStyleCase, &data, 1);
+            peak = std::max(peak, CompactStylePoolSize());
+        }
+
+        ReportMemory(data, "after reloads");
+        std::printf("reload   %d theme reloads, peak pool %.1f KB\n", reloads, (double)peak / 1024.0);
+
+        data.measure = true;
+        RunFrames(&RenderStyleCase, &data, 1);
+        return 0;
+    }
+}